@@ -57,7 +57,7 @@ export default function FridgeInfoPage() {
 							humidity: mqttStatus.humidity,
 							power: mqttStatus.power,
 							target: mqttStatus.target,
-							updatedAt: mqttStatus.ts,
+							updatedAt: Math.floor(mqttStatus.ts / 1000),
 						},
 						isOnline: mqttStatus.peltier_enabled,
 						avg24h: { temp: 0, humidity: 0, count: 0 },
@@ -72,7 +72,7 @@ export default function FridgeInfoPage() {
 						humidity: mqttStatus.humidity,
 						power: mqttStatus.power,
 						target: mqttStatus.target,
-						updatedAt: mqttStatus.ts,
+						updatedAt: Math.floor(mqttStatus.ts / 1000),
 					},
 					isOnline: mqttStatus.peltier_enabled,
 				};
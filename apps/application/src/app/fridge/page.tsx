@@ -119,7 +119,7 @@ export default function FridgePage() {
 							humidity: mqttStatus.humidity,
 							power: mqttStatus.power,
 							target: mqttStatus.target,
-							updatedAt: mqttStatus.ts,
+							updatedAt: Math.floor(mqttStatus.ts / 1000),
 						},
 						isOnline: mqttStatus.peltier_enabled,
 						avg24h: { temp: 0, humidity: 0, count: 0 },
@@ -135,7 +135,7 @@ export default function FridgePage() {
 						humidity: mqttStatus.humidity,
 						power: mqttStatus.power,
 						target: mqttStatus.target,
-						updatedAt: mqttStatus.ts,
+						updatedAt: Math.floor(mqttStatus.ts / 1000),
 					},
 					isOnline: mqttStatus.peltier_enabled,
 				};
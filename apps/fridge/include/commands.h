@@ -0,0 +1,21 @@
+#pragma once
+
+#include "state.h"
+
+// MQTT 콜백에서 호출: 페이로드를 복사해 명령 큐에 넣기만 한다 (실행은 commandsTick).
+// zone = 수신한 cmd 토픽의 존 (zoneFromCmdTopic)
+void handleCommandMessage(uint8_t zone, const char* payload, size_t len);
+
+void commandsBegin();   // 큐/캐시 초기화, 저장된 restart id 를 캐시에 등록 (loadFromNVS 이후)
+void commandsTick();    // loop 태스크: 큐에 쌓인 명령 실행 + ack (mqtt.loop() 직후)
+
+struct CommandStats {
+  uint32_t received;
+  uint32_t executed;
+  uint32_t duplicates;
+  uint32_t queueDrops;
+  uint32_t oversize;
+  uint32_t cached;      // 캐시에 있는 id 수 (전 존 합계)
+  uint32_t evictions;   // LRU 로 밀려난 id 수
+};
+CommandStats commandStats();
@@ -0,0 +1,283 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ===================== TOPICS =====================
+// 존이 하나면 <ROOT>/<suffix>, 여럿이면 <ROOT>/<zone>/<suffix> (zone.h 의 zoneTopic())
+static const char* const TOPIC_ROOT            = "/homebrew";
+static const char* const TOPIC_STATUS          = "status";           // publish QoS1
+static const char* const TOPIC_CMD             = "cmd";              // subscribe QoS1
+static const char* const TOPIC_ACK             = "ack";              // publish QoS2
+static const char* const TOPIC_STATUS_BACKLOG  = "status/backlog";   // publish QoS1 (재전송 배치)
+static const char* const TOPIC_STATUS_BATCH    = "status/batch";     // publish QoS1 (바이너리 배치)
+static const char* const TOPIC_STATUS_AGG      = "status/agg";       // publish QoS1 (분 단위 집계)
+static const size_t      TOPIC_MAX             = 48;                 // 완성된 토픽 최대 길이 (NUL 포함)
+
+static const float     TARGET_MIN          = 2.0f;
+static const float     TARGET_MAX          = 30.0f;
+static const size_t    CMD_ID_MAX          = 40;     // 명령 id 최대 길이 (NUL 포함)
+static const size_t    CMD_NAME_MAX        = 16;     // ack 캐시에 보관하는 cmd 이름 길이 (NUL 포함)
+static const size_t    CMD_PAYLOAD_MAX     = 320;    // 명령 큐 항목 크기 (넘으면 버림, set_schedule 8구간 ≈ 260B)
+static const uint32_t  CMD_QUEUE_DEPTH     = 8;      // MQTT 콜백 → loop 명령 큐 (2의 거듭제곱)
+static const uint32_t  CMD_CACHE_SIZE      = 16;     // 중복 판별용 최근 명령 id 수 (LRU)
+
+// Sensor sanity check
+static const float SENSOR_TEMP_MIN       = -10.0f;   // 물리적으로 가능한 최저 온도
+static const float SENSOR_TEMP_MAX       = 50.0f;    // 물리적으로 가능한 최고 온도
+static const float SENSOR_HUM_MIN        = 5.0f;     // 최소 습도
+static const float SENSOR_HUM_MAX        = 99.0f;    // 최대 습도
+static const unsigned long SENSOR_SCAN_MS = 2000;    // DHT21 최소 샘플링 간격 2초
+
+// 센서 추정 필터 (track_filter.h): 범위 체크를 통과한 값은 칼만 필터 혁신 게이트로 이상치 판정
+static const float   SENSOR_TEMP_NOISE        = 0.1f;    // DHT21 온도 잡음 (°C, 0.1 양자화 포함)
+static const float   SENSOR_TEMP_ACCEL        = 0.002f;  // 온도 변화율의 변화 (°C/s²)
+static const float   SENSOR_HUM_NOISE         = 1.0f;    // 습도 잡음 (%)
+static const float   SENSOR_HUM_ACCEL         = 0.01f;   // (%/s²)
+static const float   SENSOR_GATE_SIGMA        = 5.0f;    // 혁신이 5σ 를 넘으면 이상치
+static const uint8_t SENSOR_RECOVER_N         = 3;       // 연속 3회(6초) 거부되면 계단 변화 검사
+static const float   SENSOR_TEMP_RECOVER_BAND = 1.0f;    // 거부값들이 이 폭 안에 모이면 새 기준으로 채택 (°C)
+static const float   SENSOR_HUM_RECOVER_BAND  = 5.0f;    // (%)
+
+// DHT21 (AM2301). 데이터 핀 / RMT 채널은 존마다 (ZONE_TABLE)
+static const uint32_t DHT_START_LOW_US       = 1100;   // 호스트 시작 신호 LOW 유지 시간
+static const uint16_t DHT_RMT_IDLE_US        = 200;    // 이 시간 동안 엣지가 없으면 프레임 끝
+static const uint32_t DHT_CAPTURE_TIMEOUT_MS = 20;     // 시작 ~ 프레임 수신 최대 대기
+
+// ===================== PELTIER CONFIG =====================
+// MOSFET gate PWM 핀 / LEDC 채널은 존마다 (ZONE_TABLE)
+static const int   PELTIER_PWM_FREQ  = 25000;       // 25kHz PWM (MOSFET 스위칭에 적합)
+static const uint32_t PELTIER_LEDC_CLK_HZ = 80000000; // LEDC 소스 클럭 (APB)
+
+// 주파수에서 쓸 수 있는 최대 LEDC 해상도: floor(log2(클럭 / 주파수))
+static constexpr int ledcMaxResBits(uint32_t ratio, int bits = 0) {
+  return ratio > 1 ? ledcMaxResBits(ratio / 2, bits + 1) : bits;
+}
+static constexpr int PELTIER_PWM_RES = ledcMaxResBits(PELTIER_LEDC_CLK_HZ / PELTIER_PWM_FREQ);   // 25kHz → 11비트
+static constexpr int PELTIER_PWM_MAX = (1 << PELTIER_PWM_RES) - 1;                             // 2047
+static const int     PELTIER_PWM_MIN = 0;
+
+// 구동 레이어 (peltier_drive.h): PID 출력은 2초마다 바뀌지만 실제 LEDC 듀티는 구동 틱마다
+// 슬루 제한 + 시그마-델타 디더링으로 움직인다 (전류 계단 완화, 코드 사이 값도 평균으로 표현)
+static const uint32_t PELTIER_DRIVE_TICK_MS          = 20;      // 구동 틱 (50Hz)
+static constexpr float PELTIER_SLEW_PCT_PER_SEC       = 25.0f;  // 최대 변화율 (전체 듀티 %/s)
+static constexpr float PELTIER_SOFT_START_PCT_PER_SEC = 5.0f;   // 꺼짐 → 켜짐 직후 변화율
+static const uint32_t PELTIER_SOFT_START_MS          = 5000;    // 소프트 스타트 길이
+
+// ===================== ZONES =============================
+// MCU 하나가 냉장고(존) 여러 대를 독립적으로 제어한다. 존마다 센서 / 펠티어 / 목표 / NVS / 토픽이 따로.
+// 존 수는 빌드 플래그로 정한다 (-DFRIDGE_ZONE_COUNT=N). 첫 존은 기존 단일 존 배선과 NVS 를 그대로 쓴다.
+struct ZoneConfig {
+  const char* name;            // 토픽 경로 / /status?zone= 에 쓰는 이름
+  const char* nvsNamespace;    // 15자 이내
+  int         dhtPin;          // DHT21 DATA (노란선)
+  int         dhtRmtChannel;   // RMT 수신 채널
+  int         pwmPin;          // MOSFET gate
+  int         pwmChannel;      // LEDC 채널 (짝수/홀수 채널은 타이머를 공유하지만 주파수/해상도가 같아 무방)
+};
+
+#ifndef FRIDGE_ZONE_COUNT
+#define FRIDGE_ZONE_COUNT 1
+#endif
+
+static constexpr ZoneConfig ZONE_TABLE[] = {
+  {"fridge1", "homebrew",   4, 4, 18, 0},
+  {"fridge2", "homebrew2", 16, 5, 19, 1},
+  {"fridge3", "homebrew3", 17, 6, 21, 2},
+  {"fridge4", "homebrew4", 25, 7, 22, 3},
+};
+static constexpr uint8_t ZONE_MAX   = sizeof(ZONE_TABLE) / sizeof(ZONE_TABLE[0]);
+static constexpr uint8_t ZONE_COUNT = FRIDGE_ZONE_COUNT;
+static_assert(ZONE_COUNT >= 1 && ZONE_COUNT <= ZONE_MAX, "FRIDGE_ZONE_COUNT out of range");
+
+// ===================== PID CONFIG =========================
+// 냉각 전용: error = temp - target (양수 = 냉각 필요)
+// constexpr: PID 코어(pid_core.h)가 기본 게인/한계값을 컴파일 시 고정소수점으로 환산
+static constexpr float PID_KP_DEFAULT    = 30.0f;   // 비례 게인
+static constexpr float PID_KI_DEFAULT    = 0.25f;   // 적분 게인 (%/°C·s)
+static constexpr float PID_KD_DEFAULT    = 20.0f;   // 미분 게인 (%/(°C/s)), 필터 추정 변화율에 곱함
+static constexpr float PID_GAIN_MAX      = 1000.0f; // /pid 로 받는 kp/ki/kd 상한 (0 ~ 이 값, PWM 단위로 환산해도 Q15.16 안)
+static constexpr float PID_INTEGRAL_MAX  = 400.0f;  // 적분 와인드업 방지 상한 (°C·s)
+static constexpr float PID_INTEGRAL_MIN  = -100.0f; // 적분 와인드업 방지 하한 (역방향 제한)
+static constexpr float PID_DEADBAND      = 0.2f;    // ±0.2°C 이내면 현재 출력 유지
+static constexpr float PID_COMPUTE_SEC   = SENSOR_SCAN_MS / 1000.0f;   // 실제 연산 주기 (초) = 제어 주기
+static constexpr int   PID_Q_FRAC_BITS   = 16;      // PID 고정소수점 소수부 비트 (Q15.16)
+
+// 냉각 시작/정지 히스테리시스
+static constexpr float COOL_START_OFFSET = 0.3f;    // target + 0.3°C 이상이면 냉각 시작
+static constexpr float COOL_STOP_OFFSET  = -0.1f;   // target - 0.1°C 이하면 냉각 정지
+
+// 안전 제한
+static constexpr float PELTIER_MAX_DUTY_PCT = 85.0f;   // 최대 듀티 85% (과열 방지)
+static constexpr int   PELTIER_ABS_MAX_PWM  = (int)(PELTIER_PWM_MAX * PELTIER_MAX_DUTY_PCT / 100.0f);
+
+// ===================== CONTROL TASK CONFIG ================
+// 센서 → PID → 펠티어 경로는 네트워크와 분리된 전용 태스크에서 고정 주기로 실행
+static const uint32_t CONTROL_PERIOD_MS     = SENSOR_SCAN_MS;  // 제어 주기 (DHT21 샘플링 간격)
+static const uint32_t CONTROL_TASK_STACK    = 4096;
+static const uint32_t CONTROL_TASK_PRIO     = 10;    // loopTask(1) 위, lwIP(18)/WiFi(23) 아래
+static const uint32_t CONTROL_CMD_QUEUE     = 8;     // 네트워크 → 제어 명령 큐 (2의 거듭제곱)
+static const uint32_t CONTROL_SNAP_QUEUE    = 16;    // 제어 → 네트워크 스냅샷 큐 (2의 거듭제곱, 주기당 존 수만큼 들어옴)
+static_assert(CONTROL_SNAP_QUEUE >= 2u * ZONE_COUNT, "snapshot queue must hold two control periods");
+
+// ===================== SCHEDULER ==========================
+// loop() 는 타이머 휠에 등록된 작업의 다음 마감(또는 제어 태스크/WiFi 이벤트 알림)까지 잠든다
+static const uint32_t SCHED_TICK_MS         = 10;      // 타이머 휠 해상도
+static const uint32_t WIFI_RETRY_MS         = 3000;    // WiFi 재연결 시도 간격
+static const uint32_t NET_POLL_ACTIVE_MS    = 10;      // HTTP/OTA/MQTT 처리 중 폴링 간격
+static const uint32_t NET_POLL_IDLE_MS      = 100;     // 한가할 때 폴링 간격 (명령 수신 지연 상한)
+static const uint32_t NET_ACTIVE_HOLD_MS    = 2000;    // 마지막 요청 이후 빠른 폴링 유지 시간
+
+// ===================== TIME (SNTP) ========================
+// 단조 시계(부팅 후 ms) 위에 SNTP 로 맞춘 unix ms 를 얹는다 (timesync.h). 요청/응답 모두 논블로킹
+static const char* const NTP_SERVER         = "pool.ntp.org";
+static const uint16_t NTP_PORT              = 123;
+static const uint32_t NTP_RETRY_MS          = 5000;    // 시간 미동기 상태에서 재시도 간격 (응답 없음 / 거절)
+static const uint32_t NTP_TIMEOUT_MS        = 1000;    // 요청 후 응답을 기다리는 시간
+static const uint32_t NTP_RTT_MAX_MS        = 500;     // 왕복이 이보다 길면 샘플을 버림 (오차 = 왕복/2 이내)
+static const uint32_t NTP_POLL_MIN_MS       = 64000;   // 동기 직후 / 오차가 커졌을 때 폴링 간격
+static const uint32_t NTP_REFRESH_MS        = 10UL * 60UL * 1000UL;   // 오차가 작으면 두 배씩 늘려 이 간격까지
+static const uint32_t TIME_STEP_MS          = 128;     // 오차가 이보다 크면 한 번에 맞춤, 작으면 천천히 (slew)
+static const uint32_t TIME_SLEW_MS_PER_S    = 5;       // slew 속도 (1초에 5ms = 0.5%)
+static const uint32_t TIME_STABLE_MS        = 20;      // 오차가 이 안이면 폴링 간격을 늘림
+static const uint32_t TIME_FREQ_MIN_MS      = 240000;  // 드리프트 추정에 쓰는 최소 기준 구간
+static constexpr float TIME_FREQ_GAIN       = 0.5f;    // 드리프트 추정 반영 비율 (구간이 길어질수록 잡음이 줄어듦)
+static const int32_t  TIME_DRIFT_MAX_PPM    = 500;     // 추정 드리프트 한계 (수정 발진기 ±수십 ppm)
+static const uint32_t TIME_SYNC_WAIT_MS     = 120000;  // 시각을 모르는 부팅 직후 이 동안은 상태를 버퍼에 모았다가
+                                                       // 동기 후 시각을 붙여 보냄 (넘으면 ts=0 으로 바로 발행)
+
+// ===================== WARM BOOT ==========================
+// 재시작(restart 명령 / OTA / 브라운아웃) 뒤 RTC 메모리 기록으로 바로 복귀 (warm_boot.h)
+static const uint32_t  WARM_MAX_AGE_MS  = 60000;  // 제어 기록이 이보다 오래됐으면 콜드 (재부팅 자체는 ~1초)
+static constexpr float WARM_TARGET_TOL  = 0.5f;   // 기록 당시 목표와 이만큼 다르면 그 존은 콜드 (램프 중 재시작은 허용)
+static const uint32_t  WARM_FREEZE_MS   = 10000;  // controlForceOff 뒤 이 동안은 제어 기록을 덮어쓰지 않음 (꺼진 상태를 남기지 않게)
+static const bool      WARM_REUSE_IP    = false;  // 마지막 DHCP 주소를 고정 IP 로 (DHCP 생략, 임대가 바뀌면 주소 충돌 위험)
+
+// ===================== NVS PERSISTENCE ====================
+// 설정 변경은 RAM 에 모았다가 잠잠해지면 한 번에 기록 (UI 연타 시 플래시 마모 방지)
+static const uint32_t NVS_TICK_MS       = 500;     // 기록 조건 확인 간격
+static const uint32_t NVS_COALESCE_MS   = 3000;    // 마지막 변경 후 이만큼 조용하면 기록
+static const uint32_t NVS_MAX_DELAY_MS  = 15000;   // 변경이 계속돼도 첫 변경 후 이 안에는 기록
+
+// ===================== TELEMETRY BUFFER ===================
+// MQTT 끊김 동안 상태를 쌓아두었다가 재연결 후 배치로 재전송
+static const uint32_t TELEMETRY_RING_RECORDS = 512;     // RAM 링 (12B × 512 = 6KB, 10초 간격 ≈ 85분)
+static const uint32_t TELEMETRY_RECORD_MS    = 10000;   // 끊김 중 기록 간격
+static const uint32_t TELEMETRY_BATCH_MAX    = 20;      // 배치 메시지당 기록 수 (MQTT 버퍼 1024B 이내)
+static const uint32_t TELEMETRY_DRAIN_MS     = 1000;    // 배치 발행 간격 (재연결 폭주 방지)
+static const bool     TELEMETRY_FLASH_SPILL  = true;    // RAM 링이 차면 SPIFFS 파티션으로 넘김
+
+// ===================== MQTT OUTBOUND ======================
+// 발행은 PUBLISH 패킷을 미리 직렬화해 큐에 넣고 바로 돌아온다 (mqtt_out.h).
+// 브로커 응답은 net 작업이 받은 바이트에서 찾으므로 loop 가 왕복 시간을 기다리지 않는다.
+static const uint32_t MQTT_OUT_SLOTS     = 16;     // 큐 메시지 수 (대기 + 응답 대기)
+static const uint32_t MQTT_OUT_BUF       = 6144;   // 패킷 버퍼 (4존 backlog 배치 ≈ 4 × 0.95KB + 상태 여러 개)
+static const uint32_t MQTT_OUT_WINDOW    = 4;      // 응답을 기다리는 QoS1/2 메시지 상한 (브로커 수신 한도 이하로)
+static const uint32_t MQTT_OUT_RETRY_MS  = 5000;   // 응답이 없으면 DUP 로 재전송
+static const uint8_t  MQTT_OUT_MAX_TRIES = 4;      // 첫 전송 포함. 넘기면 포기하고 실패 콜백
+static const uint32_t MQTT_OUT_FLUSH_MS  = 2000;   // 라이브러리가 쓰기 전에 반쯤 보낸 패킷을 마저 보내는 제한 시간
+
+// ===================== STATUS BATCH =======================
+// 바이너리 배치 토픽 (opt-in). 켜면 모든 샘플은 배치로 보내고,
+// 기존 JSON 토픽은 실시간 화면용으로 보고 정책(REPORT_*)에 따라 계속 발행한다.
+static const bool     STATUS_BATCH_ENABLED     = false;
+static const uint32_t STATUS_BATCH_SAMPLES     = 30;    // 배치당 샘플 수 (14 + 4×30 = 134B)
+static const uint32_t STATUS_BATCH_MAX_AGE_MS  = 60000; // 덜 찼어도 이 시간이 지나면 발행
+
+// ===================== MINUTE AGGREGATES =================
+// 제어 주기 샘플을 빠짐없이 1분 단위 min/max/mean, 냉각 시간, 에너지로 묶어 status/agg 로 발행.
+// 서버는 분마다 한 줄로 저장하고, JSON 상태 토픽은 실시간 화면용으로 남는다.
+static const bool     STATUS_AGG_ENABLED     = true;
+static const uint32_t STATUS_AGG_WINDOW_SEC  = 60;     // NTP 가 맞으면 벽시계 분 경계에 맞춤
+static const uint32_t STATUS_AGG_BACKLOG     = 60;     // 끊김 동안 존별로 보관할 집계 (1시간)
+static const uint32_t STATUS_AGG_PUBLISH_MAX = 4;      // statusTick 한 번에 발행할 밀린 집계 수
+static const float    PELTIER_RATED_W        = 110.0f; // 듀티 100% 소비전력 (에너지 적산용)
+
+// ===================== STATUS REPORT POLICY ==============
+// JSON 상태 토픽은 이벤트(냉각 전이, 목표/펠티어 변경, 센서 이상, 출력 계단)면 바로,
+// 온도/습도가 dead-band 를 넘으면 최소 간격을 두고, 조용하면 heartbeat 로만 보낸다.
+// 존별로 set_report 명령으로 바꿀 수 있다 (report_policy.h).
+static const uint16_t REPORT_HEARTBEAT_SEC = 60;
+static const float    REPORT_TEMP_BAND     = 0.3f;    // °C (PID 데드밴드 ±0.2 보다 넓게)
+static const float    REPORT_HUM_BAND      = 3.0f;    // %
+static const uint8_t  REPORT_POWER_BAND    = 20;      // %p, 이만큼 바뀌면 출력 계단으로 보고 바로
+static const uint32_t REPORT_MIN_GAP_MS    = 10000;   // dead-band 발행 사이 최소 간격 (이벤트는 예외)
+static const uint16_t REPORT_HEARTBEAT_MIN_SEC = 10;  // set_report 허용 범위
+static const uint16_t REPORT_HEARTBEAT_MAX_SEC = 3600;
+
+// ===================== FERMENTATION SCHEDULE ==============
+// 존마다 ramp / hold 구간을 기기에 두고 NTP 시각으로 직접 진행 (schedule.h)
+static const uint8_t  SCHEDULE_SEGMENTS_MAX = 8;
+
+// ===================== EVENT STREAM (SSE) =================
+// /stream 구독자에게 상태 변화 / 냉각 전이를 바로 밀어준다. 동기 WebServer 는 연결을
+// 붙잡아 둘 수 없으므로 별도 포트의 논블로킹 소켓으로 받고, 포트 80 /stream 은 리다이렉트.
+static const uint16_t STREAM_PORT          = 81;
+static const uint8_t  STREAM_MAX_CLIENTS   = 3;       // 동시 구독자 수
+static const uint32_t STREAM_CLIENT_BUF    = 1536;    // 구독자별 송신 대기 버퍼 (첫 스냅샷 4존 ≈ 1.1KB)
+static const uint32_t STREAM_STALL_MS      = 10000;   // 대기 데이터가 이만큼 안 나가면 느린 구독자로 끊음
+static const uint32_t STREAM_KEEPALIVE_MS  = 15000;   // 이벤트가 없을 때 주석 줄로 연결 유지
+static const uint32_t STREAM_HANDSHAKE_MS  = 2000;    // 요청 헤더 수신 제한 시간
+static const size_t   STREAM_REQ_MAX       = 256;     // 요청 헤더 버퍼 (첫 줄만 해석)
+
+// ===================== HISTORY =====================
+// 제어 주기(2초)마다 존별 6바이트 샘플을 RAM 링에 남긴다 (재부팅하면 비어 있음).
+// 1존 1시간 = 1800 샘플 = 10.5KB → 64KB 예산으로 1존 ~6시간, 4존 존당 ~1.5시간.
+// /history 는 기기에서 LTTB 로 줄여서 chunked 로 보낸다.
+static const uint32_t HISTORY_BUDGET_BYTES   = 64 * 1024;   // 모든 존 합계
+static const uint32_t HISTORY_POINTS_DEFAULT = 300;         // ?points= 생략 시
+static const uint32_t HISTORY_POINTS_MAX     = 2000;
+static const size_t   HISTORY_CHUNK_BYTES    = 512;         // chunked 전송 한 조각
+
+// ===================== OTA ================================
+// PUT /ota?offset=N 조각으로 받아 (압축이면 풀면서) 비활성 앱 파티션에 바로 쓴다 (ota.h).
+// 받는 동안 제어는 계속 돌고, 검증이 끝난 뒤 재시작 직전에만 펠티어를 끈다.
+static const uint32_t OTA_SESSION_IDLE_MS  = 10UL * 60 * 1000;   // 이어받기를 기다리는 최대 시간 (넘으면 폐기)
+static const uint32_t OTA_REBOOT_DELAY_MS  = 1000;    // 검증 성공 응답을 보낸 뒤 재시작까지
+static const size_t   OTA_FLASH_PAGE       = 4096;    // 풀어낸 이미지를 이 단위로 기록 (플래시 섹터)
+#define OTA_LZ_WINDOW_BITS 12                          // LZSS 창 4KB (압축기와 같아야 함)
+
+// ===================== LOG ================================
+// 로그 호출은 인자 원본만 태스크별 링에 복사하고, 포맷은 log 작업 / GET /logs 에서 나중에 (log.h)
+static const uint32_t LOG_TASK_RING_BYTES = 2048;    // 태스크별 대기 링 (제어 / loop, 2의 거듭제곱)
+static const uint32_t LOG_HISTORY_BYTES   = 8192;    // 포맷 전 기록 링 (/logs, 2의 거듭제곱, ~150줄)
+static const uint32_t LOG_DRAIN_MS        = 50;      // 대기 링 → 기록 링 + 시리얼
+static const uint32_t LOG_IDLE_MS         = 1000;    // 옮길 줄도 보낼 줄도 없을 때 (light sleep 방해 않게)
+static const size_t   LOG_RECORD_MAX      = 128;     // 레코드 한 줄 (호출 위치 + 시각 + 인자)
+static const size_t   LOG_STR_MAX         = 64;      // 문자열 인자 복사 상한 (넘으면 잘림)
+static const size_t   LOG_LINE_MAX        = 256;     // 포맷한 한 줄
+static const size_t   LOG_SERIAL_TX_BUF   = 1024;    // 시리얼 TX 버퍼 (log 작업은 빈 만큼만 쓴다)
+
+// =========================================================
+
+// ===================== DEBUG CONFIG =====================
+extern bool isDEBUG;   // 시리얼이 붙어 있음 → 로그를 시리얼로도 내보냄
+
+// 로그 레벨 (숫자가 작을수록 중요)
+#define LOG_LVL_ERROR  0
+#define LOG_LVL_WARN   1
+#define LOG_LVL_INFO   2
+#define LOG_LVL_DEBUG  3   // 주기마다 나오는 줄 (PID / 센서 값, 상태 발행, HTTP 요청)
+
+// 로그 분류 (비트 마스크)
+#define LOG_CAT_SYS     0x0001
+#define LOG_CAT_WIFI    0x0002
+#define LOG_CAT_MQTT    0x0004
+#define LOG_CAT_HTTP    0x0008
+#define LOG_CAT_SENSOR  0x0010
+#define LOG_CAT_PID     0x0020
+#define LOG_CAT_CMD     0x0040
+#define LOG_CAT_STATUS  0x0080
+#define LOG_CAT_NVS     0x0100
+#define LOG_CAT_SCHED   0x0200
+#define LOG_CAT_OTA     0x0400
+#define LOG_CAT_TIME    0x0800
+#define LOG_CAT_ALL     0x0FFF
+
+// 컴파일 필터: 이보다 자세한 레벨 / 마스크 밖 분류의 호출은 코드에서 빠진다
+#define LOG_COMPILE_LEVEL  LOG_LVL_DEBUG
+#define LOG_COMPILE_CATS   LOG_CAT_ALL
+// 실행 중 필터 기본값 (POST /logs 로 변경)
+#define LOG_RUNTIME_LEVEL  LOG_LVL_INFO
+#define LOG_RUNTIME_CATS   LOG_CAT_ALL
+// =======================================================
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "state.h"
+
+// ===== 네트워크 태스크 → 제어 태스크 명령 =====
+enum ControlCmdType : uint8_t {
+  CTL_CMD_SET_TARGET  = 0,   // flag = hasTarget, a = target
+  CTL_CMD_SET_ENABLED = 1,   // flag = peltierEnabled
+  CTL_CMD_SET_GAINS   = 2,   // a/b/c = kp/ki/kd
+  CTL_CMD_FORCE_OFF   = 3,   // 모든 존 펠티어 OFF + PID 리셋 (zone 무시)
+  CTL_CMD_SET_RAMP    = 4    // a → b 를 c 초 동안 직선으로 (적분 유지, SET_TARGET 이 오면 취소)
+};
+
+struct ControlCommand {
+  ControlCmdType type;
+  bool    flag;
+  float   a;
+  float   b;
+  float   c;
+  uint8_t zone;   // 적용할 존 (0..ZONE_COUNT-1)
+};
+
+// 초기 입력(gZone) 복사 + 펠티어/센서 초기화.
+// ESP32 에서는 loop() 와 다른 코어에 고정된 제어 태스크를 시작한다.
+void controlBegin();
+
+// 제어 주기 1회: 명령 반영 → 존별 센서 → 존별 PID/펠티어 → 존마다 스냅샷 발행.
+// ESP32 는 제어 태스크가, 네이티브 빌드는 시뮬레이터가 CONTROL_PERIOD_MS 마다 호출한다.
+void controlStep();
+
+// 구동 틱 1회: 존마다 슬루 제한 + 시그마-델타 디더링한 듀티를 LEDC 에 쓴다.
+// ESP32 는 출력이 있는 동안 esp_timer 가, 네이티브 빌드는 시뮬레이터가 PELTIER_DRIVE_TICK_MS 마다 호출한다.
+void peltierDriveTick();
+
+// 아래는 네트워크 태스크(loop) 전용
+bool     controlPost(const ControlCommand& cmd);   // false = 명령 큐 가득 참
+bool     controlPoll(ControlSnapshot& out);        // 스냅샷 하나 꺼내기
+void     controlForceOff();                        // 재시작/OTA 전 안전 정지 (재부팅까지 유지)
+uint32_t controlCmdDrops();
+
+#ifdef ESP32
+// 스냅샷을 넣을 때마다 task 에 알림 (loop 가 ulTaskNotifyTake 로 잠들어 있다가 바로 깨어남)
+void controlNotifyOnSnapshot(TaskHandle_t task);
+#endif
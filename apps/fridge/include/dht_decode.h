@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ===================== DHT21 (AM2301) 펄스열 디코더 =====================
+// 하드웨어와 무관한 순수 함수. RMT 캡처 결과든 시뮬레이터가 만든 펄스열이든
+// (레벨, 지속시간) 목록만 넘기면 된다.
+//
+// 와이어 프로토콜 (호스트 시작 신호 해제 이후):
+//   [HIGH 20~40us] LOW 80us, HIGH 80us          ← 센서 응답
+//   40비트 × (LOW 50us, HIGH 26~28us=0 / 70us=1)  ← MSB 먼저, 5바이트
+//   LOW 50us                                     ← 종료
+// 바이트: 습도 H/L, 온도 H/L (최상위 비트 = 부호), 체크섬 (앞 4바이트 합의 하위 8비트)
+
+struct DhtPulse {
+  uint8_t  level;   // 0 = LOW, 1 = HIGH
+  uint16_t us;      // 지속 시간
+};
+
+enum DhtStatus : uint8_t {
+  DHT_OK              = 0,
+  DHT_ERR_NO_RESPONSE = 1,   // 응답 펄스(80/80us) 없음: 배선/전원/센서 미응답
+  DHT_ERR_TIMING      = 2,   // 비트 펄스 폭 이상 또는 40비트 미만
+  DHT_ERR_CHECKSUM    = 3    // 40비트는 받았으나 체크섬 불일치
+};
+
+struct DhtReading {
+  float   temp;       // °C
+  float   humidity;   // %
+  uint8_t raw[5];
+};
+
+// 응답/비트 펄스 허용 범위 (us)
+static const uint16_t DHT_RESP_MIN_US     = 55;
+static const uint16_t DHT_RESP_MAX_US     = 110;
+static const uint16_t DHT_BIT_LOW_MIN_US  = 30;
+static const uint16_t DHT_BIT_LOW_MAX_US  = 80;
+static const uint16_t DHT_BIT_HIGH_MIN_US = 10;
+static const uint16_t DHT_BIT_HIGH_MAX_US = 95;
+static const uint16_t DHT_BIT_ONE_US      = 48;    // 이 이상 HIGH 면 1
+
+DhtStatus   dhtDecode(const DhtPulse* pulses, size_t n, DhtReading& out);
+const char* dhtStatusName(DhtStatus s);
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "dht_decode.h"
+
+// DHT21 드라이버. 펄스열은 ESP32 에서는 RMT 가 캡처하고(dht_rmt.cpp),
+// 네이티브 빌드에서는 시뮬레이터가 만든다(sim/dht_sim.cpp). 디코딩은 공통 dhtDecode().
+// 존마다 센서 하나 (핀 / RMT 채널은 ZONE_TABLE).
+bool dhtSensorBegin(uint8_t zone, int pin, int rmtChannel);
+
+// 측정 시작 → 캡처 완료 대기 → 디코드. 제어 태스크에서만 호출.
+// 캡처를 기다리는 동안 호출 태스크는 잠들며 인터럽트를 막지 않는다.
+DhtStatus dhtSensorRead(uint8_t zone, DhtReading& out);
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ===================== SSE 이벤트 스트림 =====================
+// GET /stream[?zone=<이름|번호>] 구독자에게 text/event-stream 으로 밀어준다.
+//   event: status  접속 직후 존별 전체 상태, 이후에는 바뀐 필드만 (temp/humidity/power/target/...)
+//   event: pid     냉각 START/STOP 전이 (제어 스냅샷이 도착하는 즉시)
+// 모든 소켓 I/O 는 논블로킹. 구독자마다 고정 크기 송신 버퍼를 두고, 버퍼가 넘치거나
+// STREAM_STALL_MS 동안 한 바이트도 못 보내면 그 구독자만 끊는다 (loop 는 절대 기다리지 않음).
+// loop 태스크 전용.
+
+struct StreamStats {
+  uint32_t clients;       // 현재 구독자 수
+  uint32_t accepted;      // 누적 구독
+  uint32_t rejected;      // 자리 없음 (503) / 잘못된 요청 (404)
+  uint32_t slowDrops;     // 백프레셔로 끊은 구독자
+  uint32_t disconnects;   // 클라이언트가 끊음
+  uint32_t events;        // 보낸 이벤트 (구독자 수만큼 중복 계산하지 않음)
+  uint32_t bytes;         // 소켓으로 나간 바이트
+};
+
+void streamBegin();
+// 스케줄러 net 작업마다: 새 연결 수락 / 요청 해석 / 대기 데이터 송신 / keepalive
+void streamTick();
+// statusTick() 에서 스냅샷을 반영한 뒤 호출
+void streamStatus(uint8_t zone);                 // 바뀐 필드가 있으면 status 이벤트
+void streamPidEdge(uint8_t zone, bool start);    // 냉각 전이 이벤트
+void streamFlush();                              // 방금 쌓은 이벤트를 바로 송신 (수락은 안 함)
+bool streamActive();                             // 구독자가 하나라도 있음
+StreamStats streamStats();
+
+// ===== 논블로킹 소켓 (ESP32: stream_net.cpp / native: sim/stream_sim.cpp) =====
+// 핸들 = 0 .. STREAM_MAX_CLIENTS (거절 응답용으로 하나 더)
+bool streamNetBegin();
+int  streamNetAccept();                                   // 새 연결 핸들, 없으면 -1
+int  streamNetRead(int h, char* buf, size_t cap);         // 읽은 바이트, 0 = 아직 없음, -1 = 끊김
+int  streamNetWrite(int h, const char* buf, size_t len);  // 받아들인 바이트, 0 = 가득 참, -1 = 끊김
+void streamNetClose(int h);
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+#include "state.h"
+
+// ===================== 상태 이력 =====================
+// 제어 스냅샷마다 존별 압축 샘플을 RAM 링에 쌓는다 (가득 차면 가장 오래된 것부터 덮어씀).
+// 시각은 저장하지 않는다: 샘플은 제어 주기 간격이고, 빠진 주기(seq 건너뜀)는 결측 샘플로 채운다.
+// /history 는 구간을 골라 LTTB 로 줄인 뒤 조각 단위로 싱크에 흘려보낸다 (전체 응답을 만들지 않음).
+// loop 태스크 전용.
+
+// 6바이트 샘플
+struct HistorySample {
+  int16_t temp10;     // 0.1°C, HISTORY_NULL16 = 결측
+  int16_t target10;   // 0.1°C, HISTORY_NULL16 = 목표 없음
+  uint8_t hum2;       // 0.5%,  HISTORY_NULL8 = 결측
+  uint8_t power;      // 0~100 (%) | HISTORY_COOLING
+};
+static_assert(sizeof(HistorySample) == 6, "HistorySample must stay 6 bytes");
+
+static const int16_t  HISTORY_NULL16   = INT16_MIN;
+static const uint8_t  HISTORY_NULL8    = 0xFF;
+static const uint8_t  HISTORY_COOLING  = 0x80;
+static const uint32_t HISTORY_STEP_SEC = CONTROL_PERIOD_MS / 1000;
+static const uint32_t HISTORY_SAMPLES  = HISTORY_BUDGET_BYTES / sizeof(HistorySample) / ZONE_COUNT;   // 존당
+static_assert(CONTROL_PERIOD_MS % 1000 == 0, "history timestamps assume a whole-second control period");
+
+struct HistoryStats {
+  uint32_t count;       // 저장된 샘플
+  uint32_t capacity;
+  uint32_t gapFills;    // 빠진 주기를 채운 결측 샘플 누적
+  uint32_t spanSec;     // 가장 오래된 ~ 최신 샘플
+};
+
+// 응답 조각을 받는 쪽 (ESP32: WebServer::sendContent, 벤치: 바이트 세기)
+typedef void (*HistorySink)(const char* data, size_t len, void* ctx);
+
+struct HistoryResult {
+  uint32_t samples;     // 구간 안의 원본 샘플
+  uint32_t points;      // 보낸 점
+  uint32_t bytes;
+  uint32_t chunks;
+};
+
+void historyBegin();
+// statusTick() 에서 스냅샷마다 (목표는 gZone 값)
+void historyAdd(const ControlSnapshot& s);
+// [from, to] (historyClock() 기준 초) 를 최대 points 개로 줄여 JSON 으로
+HistoryResult historyWriteJson(uint8_t zone, uint32_t from, uint32_t to, uint32_t points,
+                               HistorySink sink, void* ctx);
+// NTP 가 맞으면 unix 초, 아니면 가동 시간(초)
+uint32_t     historyClock(bool* isUnix = nullptr);
+HistoryStats historyStats(uint8_t zone);
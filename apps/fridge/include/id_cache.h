@@ -0,0 +1,91 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+// 최근 처리한 명령 id → 결과(V) 고정 크기 LRU (힙 할당 없음, 단일 태스크 전용).
+// N 이 작으므로 (수십 개) 선형 탐색. 문자열 비교 전에 32비트 해시로 먼저 거른다.
+// ID_MAX = id 버퍼 크기 (NUL 포함). 더 긴 id 는 호출자가 미리 거부해야 한다.
+template <typename V, uint32_t N, size_t ID_MAX>
+class IdLruCache {
+  static_assert(N >= 1, "IdLruCache needs at least one slot");
+
+ public:
+  // 있으면 최근 사용으로 표시하고 값 포인터 반환, 없으면 nullptr
+  V* find(const char* id) {
+    int i = indexOf(id, hashOf(id));
+    if (i < 0) return nullptr;
+    entries_[i].stamp = ++clock_;
+    return &entries_[i].value;
+  }
+
+  // id 의 값을 기록 (이미 있으면 덮어씀, 자리가 없으면 가장 오래 안 쓴 항목을 밀어냄)
+  void put(const char* id, const V& v) {
+    uint32_t h = hashOf(id);
+    int      i = indexOf(id, h);
+    if (i < 0) {
+      i = victim();
+      if (entries_[i].used) evictions_++;
+      else                  size_++;
+      Entry& e = entries_[i];
+      e.used   = true;
+      e.hash   = h;
+      size_t n = strlen(id);
+      if (n > ID_MAX - 1) n = ID_MAX - 1;
+      memcpy(e.id, id, n);
+      e.id[n] = '\0';
+    }
+    entries_[i].value = v;
+    entries_[i].stamp = ++clock_;
+  }
+
+  void clear() {
+    for (uint32_t i = 0; i < N; i++) entries_[i].used = false;
+    size_      = 0;
+    evictions_ = 0;
+    clock_     = 0;
+  }
+
+  uint32_t size() const      { return size_; }
+  uint32_t evictions() const { return evictions_; }
+  static constexpr uint32_t capacity() { return N; }
+
+ private:
+  struct Entry {
+    char     id[ID_MAX];
+    uint32_t hash  = 0;
+    uint32_t stamp = 0;   // 마지막 사용 시점 (클수록 최근)
+    bool     used  = false;
+    V        value;
+  };
+
+  // FNV-1a
+  static uint32_t hashOf(const char* s) {
+    uint32_t h = 2166136261u;
+    while (*s) h = (h ^ (uint8_t)*s++) * 16777619u;
+    return h;
+  }
+
+  int indexOf(const char* id, uint32_t h) const {
+    for (uint32_t i = 0; i < N; i++)
+      if (entries_[i].used && entries_[i].hash == h && strcmp(entries_[i].id, id) == 0) return (int)i;
+    return -1;
+  }
+
+  // 빈 칸 우선, 없으면 stamp 가 가장 오래된 항목 (clock 랩어라운드에도 차이로 비교)
+  int victim() const {
+    int      best    = 0;
+    uint32_t bestAge = 0;
+    for (uint32_t i = 0; i < N; i++) {
+      if (!entries_[i].used) return (int)i;
+      uint32_t age = clock_ - entries_[i].stamp;
+      if (age > bestAge) { bestAge = age; best = (int)i; }
+    }
+    return best;
+  }
+
+  Entry    entries_[N];
+  uint32_t size_      = 0;
+  uint32_t evictions_ = 0;
+  uint32_t clock_     = 0;
+};
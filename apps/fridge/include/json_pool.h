@@ -0,0 +1,106 @@
+#pragma once
+
+#include <ArduinoJson.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "metrics.h"
+
+// ===================== JSON 고정 풀 =====================
+// ArduinoJson 7 의 JsonDocument 는 슬롯 풀과 복사한 문자열을 할당자에서 받는다
+// (StaticJsonDocument<N> 도 이제 힙을 쓰는 JsonDocument 의 별칭일 뿐). 기본 할당자는 malloc 이라
+// 발행 / ack / 명령 / SSE 마다 힙을 잡았다 놓으며 조각낸다. JsonPool 은 호출 지점마다 고정 배열 하나를
+// 앞에서부터 잘라 준다:
+//   static JsonPool<jsonPoolBytes(1, 128)> ackPool;
+//   JsonDocument doc(ackPool.reset());   // 쓸 때마다 처음부터
+//   - deallocate 는 마지막 블록만 되돌리고, 나머지는 다음 reset() 에서 한꺼번에
+//   - reallocate 는 마지막 블록이면 제자리에서, 아니면 새 블록에 복사
+//   - 모자라면 malloc 으로 넘기고 gMetricCounters.jsonPoolOverflows 를 센다 (크기를 키워야 한다는 뜻)
+// 단일 태스크 전용. 같은 풀로 문서 두 개를 동시에 쓰지 않는다.
+
+static const size_t JSON_POOL_ALIGN = 8;   // 블록 머리 (요청 크기) + 정렬
+
+// 크기 = 슬롯 풀 수 × 풀 크기 + 복사할 문자열.
+//   - 라이브러리는 ARDUINOJSON_POOL_CAPACITY 슬롯짜리 풀 단위로 요청하고, 슬롯은 포인터 두 개 크기
+//     (ESP32: 128 × 8B = 1KB, 64비트 호스트: 256 × 16B)
+//   - 멤버 하나 = 슬롯 2개 (키 + 값), 중첩 객체 +1, 64비트 정수 / double +1
+//   - 문자열 리터럴 키는 가리키기만 하고, const char* 값과 변수로 준 키, 역직렬화한 문자열은 복사
+//     (문자열마다 머리 8B + 블록 머리 8B)
+constexpr size_t jsonPoolBytes(size_t pools, size_t stringBytes) {
+  return pools * (ARDUINOJSON_POOL_CAPACITY * 2 * sizeof(void*) + JSON_POOL_ALIGN) + stringBytes;
+}
+
+template <size_t N>
+class JsonPool : public ArduinoJson::Allocator {
+ public:
+  ArduinoJson::Allocator* reset() {
+    used_ = 0;
+    last_ = nullptr;
+    return this;
+  }
+
+  void* allocate(size_t n) override {
+    size_t need = JSON_POOL_ALIGN + roundUp(n);
+    if (need > N - used_) return overflow(n);
+    uint8_t* blk = buf_ + used_;
+    memcpy(blk, &n, sizeof(n));
+    used_ += need;
+    last_  = blk + JSON_POOL_ALIGN;
+    return last_;
+  }
+
+  void deallocate(void* p) override {
+    if (!p) return;
+    if (!inPool(p)) {
+      free(p);
+      return;
+    }
+    if (p == last_) {   // 바로 앞 블록을 되돌림 (문자열을 만들다 버린 경우 등)
+      used_ = (size_t)((uint8_t*)p - JSON_POOL_ALIGN - buf_);
+      last_ = nullptr;
+    }
+  }
+
+  void* reallocate(void* p, size_t n) override {
+    if (!p) return allocate(n);
+    if (!inPool(p)) return realloc(p, n);   // 이미 넘친 블록
+    size_t old = sizeOf(p);
+    if (p == last_) {
+      size_t start = (size_t)((uint8_t*)p - buf_);
+      if (roundUp(n) <= N - start) {
+        memcpy((uint8_t*)p - JSON_POOL_ALIGN, &n, sizeof(n));
+        used_ = start + roundUp(n);
+        return p;
+      }
+    }
+    void* q = allocate(n);
+    if (q) memcpy(q, p, old < n ? old : n);
+    return q;
+  }
+
+ private:
+  static_assert(N >= 2 * JSON_POOL_ALIGN, "JsonPool too small");
+  static_assert(sizeof(size_t) <= JSON_POOL_ALIGN, "block header holds a size_t");
+
+  static size_t roundUp(size_t n) { return (n + JSON_POOL_ALIGN - 1) & ~(JSON_POOL_ALIGN - 1); }
+
+  bool inPool(const void* p) const {
+    return (const uint8_t*)p >= buf_ && (const uint8_t*)p < buf_ + N;
+  }
+
+  static size_t sizeOf(const void* p) {
+    size_t n = 0;
+    memcpy(&n, (const uint8_t*)p - JSON_POOL_ALIGN, sizeof(n));
+    return n;
+  }
+
+  static void* overflow(size_t n) {
+    gMetricCounters.jsonPoolOverflows++;
+    return malloc(n);
+  }
+
+  alignas(JSON_POOL_ALIGN) uint8_t buf_[N];
+  size_t   used_ = 0;
+  uint8_t* last_ = nullptr;
+};
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "config.h"
+
+// ===================== 로그 =====================
+// LOG_I(PID, "%s cooling START temp=%.1f", name, t) 처럼 쓴다.
+//   - 호출 위치마다 형식 문자열 / 레벨 / 분류를 담은 LogSite 가 정적 상수로 하나씩 생긴다
+//   - 호출하면 LogSite 포인터 + 시각 + 인자 원본(정수 / float / 문자열 복사)만 레코드로 만들어
+//     호출한 태스크의 SPSC 링에 넣고 돌아온다 (포맷 없음, 잠금 없음, 시리얼 대기 없음)
+//   - log 작업(loop, LOG_DRAIN_MS)이 링을 시각 순으로 모아 기록 링(/logs)으로 옮기고,
+//     시리얼이 붙어 있으면 그때 포맷해서 TX 버퍼가 받는 만큼만 쓴다
+//   - 컴파일 필터(LOG_COMPILE_LEVEL / LOG_COMPILE_CATS) 밖의 호출은 코드에서 빠지고,
+//     실행 중 필터(logSetFilter, POST /logs)는 인자를 복사하기 전에 확인한다
+// 링은 제어 태스크용 / loop 태스크용 둘. 다른 태스크에서 부른 로그는 버리고 센다.
+// 형식 지정자의 길이 수식어(l, ll, z …)는 무시하고 저장된 인자 타입으로 포맷한다. '*' 너비는 쓰지 않는다.
+
+struct LogSite {
+  const char* fmt;
+  uint8_t     level;   // LOG_LVL_*
+  uint16_t    cat;     // LOG_CAT_* 하나
+};
+
+// 길이가 정해진 문자열 (NUL 로 끝나지 않는 페이로드 등): LOG_D(MQTT, "payload=%s", LogStr(p, n))
+struct LogStr {
+  const char* p;
+  size_t      n;
+  LogStr(const char* s, size_t len) : p(s), n(len) {}
+};
+
+struct LogStats {
+  uint32_t records;        // 기록 링에 들어간 줄
+  uint32_t ringDrops;      // 태스크 링이 가득 차 버림
+  uint32_t foreignDrops;   // 링이 없는 태스크에서 호출
+  uint32_t overwritten;    // 기록 링이 가득 차 오래된 줄을 지움
+  uint32_t serialSkipped;  // 시리얼이 느려 못 내보내고 지나간 줄
+  uint32_t seq;            // 마지막 줄 번호
+};
+
+void logBegin();                 // setup() 태스크(loop) 를 loop 링 생산자로
+void logBindControlTask();       // 제어 태스크 시작 시
+bool logDrain();                 // log 작업: 태스크 링 → 기록 링 + 시리얼. true = 할 일이 남음 (곧 다시)
+void logFlush();                 // 재시작 직전: 남은 줄을 시리얼로 모두 (기다림)
+void logSetFilter(uint8_t level, uint16_t cats);
+uint8_t  logLevel();
+uint16_t logCats();
+LogStats logStats();
+
+const char* logLevelName(uint8_t level);     // "error" …
+const char* logCatName(uint16_t cat);        // "pid" … (비트 하나)
+bool        logLevelFromName(const char* s, uint8_t& out);
+bool        logCatsFromNames(const char* s, uint16_t& out);   // "pid,sensor" / "all"
+
+// 기록 링 훑기 (loop 태스크): seq > since 이고 레벨 / 분류가 맞는 줄을 포맷해서 sink 로. 반환 = 마지막 seq
+typedef void (*LogSink)(const char* line, size_t len, void* ctx);
+uint32_t logWriteText(uint32_t since, uint8_t level, uint16_t cats, LogSink sink, void* ctx);
+
+// ---------- 호출 위치 ----------
+extern volatile uint8_t  gLogLevel;
+extern volatile uint16_t gLogCats;
+
+namespace logdetail {
+
+// 레코드 = [LogSite*][ms u32][인자: 태그 1B + 값]…
+struct Rec {
+  uint8_t buf[LOG_RECORD_MAX];
+  size_t  len;
+  bool    full;
+
+  void begin(const LogSite* site, uint32_t ms) {
+    memcpy(buf, &site, sizeof(site));
+    memcpy(buf + sizeof(site), &ms, sizeof(ms));
+    len  = sizeof(site) + sizeof(ms);
+    full = false;
+  }
+  void put(char tag, const void* v, size_t n) {
+    if (full || len + 1 + n > sizeof(buf)) {
+      full = true;   // 뒤 인자는 포맷 때 '?'
+      return;
+    }
+    buf[len++] = (uint8_t)tag;
+    memcpy(buf + len, v, n);
+    len += n;
+  }
+  void putStr(const char* s, size_t n) {
+    if (!s) s = "(null)", n = 6;
+    if (n > LOG_STR_MAX) n = LOG_STR_MAX;
+    if (full || len + 2 + n > sizeof(buf)) {
+      full = true;
+      return;
+    }
+    buf[len++] = 's';
+    buf[len++] = (uint8_t)n;
+    memcpy(buf + len, s, n);
+    len += n;
+  }
+};
+
+// 정수는 값이 32비트에 들어가면 4바이트로
+inline void putSigned(Rec& r, long long v) {
+  if (v >= INT32_MIN && v <= INT32_MAX) { int32_t x = (int32_t)v; r.put('i', &x, 4); }
+  else                                  { int64_t x = (int64_t)v; r.put('I', &x, 8); }
+}
+inline void putUnsigned(Rec& r, unsigned long long v) {
+  if (v <= UINT32_MAX) { uint32_t x = (uint32_t)v; r.put('u', &x, 4); }
+  else                 { uint64_t x = (uint64_t)v; r.put('U', &x, 8); }
+}
+
+inline void arg(Rec& r, int v)                { putSigned(r, v); }
+inline void arg(Rec& r, long v)               { putSigned(r, v); }
+inline void arg(Rec& r, long long v)          { putSigned(r, v); }
+inline void arg(Rec& r, unsigned v)           { putUnsigned(r, v); }
+inline void arg(Rec& r, unsigned long v)      { putUnsigned(r, v); }
+inline void arg(Rec& r, unsigned long long v) { putUnsigned(r, v); }
+inline void arg(Rec& r, double v)             { float f = (float)v; r.put('f', &f, 4); }
+inline void arg(Rec& r, const char* s)        { r.putStr(s, s ? strlen(s) : 0); }
+inline void arg(Rec& r, const LogStr& s)      { r.putStr(s.p, s.n); }
+
+void commit(const Rec& r);
+uint32_t nowMs();
+
+template <typename... A>
+void write(const LogSite* site, A... a) {
+  Rec r;
+  r.begin(site, nowMs());
+  int expand[] = {0, (arg(r, a), 0)...};
+  (void)expand;
+  commit(r);
+}
+
+}  // namespace logdetail
+
+#define LOG_AT(lvl, cat, fmt, ...)                                                           \
+  do {                                                                                       \
+    if ((lvl) <= LOG_COMPILE_LEVEL && (LOG_COMPILE_CATS & (cat)) && (lvl) <= gLogLevel &&    \
+        (gLogCats & (cat))) {                                                                \
+      static const LogSite logSite_ = {fmt, (uint8_t)(lvl), (uint16_t)(cat)};               \
+      logdetail::write(&logSite_, ##__VA_ARGS__);                                            \
+    }                                                                                        \
+  } while (0)
+
+#define LOG_E(cat, fmt, ...) LOG_AT(LOG_LVL_ERROR, LOG_CAT_##cat, fmt, ##__VA_ARGS__)
+#define LOG_W(cat, fmt, ...) LOG_AT(LOG_LVL_WARN, LOG_CAT_##cat, fmt, ##__VA_ARGS__)
+#define LOG_I(cat, fmt, ...) LOG_AT(LOG_LVL_INFO, LOG_CAT_##cat, fmt, ##__VA_ARGS__)
+#define LOG_D(cat, fmt, ...) LOG_AT(LOG_LVL_DEBUG, LOG_CAT_##cat, fmt, ##__VA_ARGS__)
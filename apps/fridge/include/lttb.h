@@ -0,0 +1,69 @@
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+
+// Largest-Triangle-Three-Buckets 다운샘플링 (힙 할당 없음).
+// x = 등간격 인덱스 0..n-1, y(i) = 값 (NaN = 결측: 평균과 면적 계산에서 뺀다).
+// 첫 점과 마지막 점은 항상 남기고, 나머지 m-2 개 버킷에서 (직전에 고른 점, 다음 버킷 평균)과
+// 만드는 삼각형이 가장 큰 점을 하나씩 고른다. 고른 인덱스는 오름차순으로 바로 emit(i) 에
+// 넘기므로 결과 배열이 필요 없다.
+
+// n 개 중 몇 개가 남는지 (threshold < 3 이거나 n 이하면 전부)
+inline uint32_t lttbCount(uint32_t n, uint32_t threshold) {
+  return (threshold < 3 || threshold >= n) ? n : threshold;
+}
+
+template <typename YFn, typename EmitFn>
+uint32_t lttbSelect(uint32_t n, uint32_t threshold, YFn y, EmitFn emit) {
+  uint32_t m = lttbCount(n, threshold);
+  if (m == n) {
+    for (uint32_t i = 0; i < n; i++) emit(i);
+    return n;
+  }
+  // 버킷 k (0..m-3) = [edge(k), edge(k+1)), 마지막 점은 따로
+  auto edge = [n, m](uint32_t k) -> uint32_t {
+    return 1 + (uint32_t)((uint64_t)k * (n - 2) / (m - 2));
+  };
+
+  emit(0);
+  uint32_t a  = 0;
+  float    ay = y(0);
+  for (uint32_t k = 0; k + 2 < m; k++) {
+    // 다음 버킷 평균 (마지막 버킷 다음은 끝점)
+    uint32_t nb = (k + 3 < m) ? edge(k + 1) : n - 1;
+    uint32_t ne = (k + 3 < m) ? edge(k + 2) : n;
+    float    sx = 0.0f, sy = 0.0f;
+    uint32_t cnt = 0;
+    for (uint32_t j = nb; j < ne; j++) {
+      float v = y(j);
+      if (isnan(v)) continue;
+      sx += (float)j;
+      sy += v;
+      cnt++;
+    }
+    float cx = cnt ? sx / cnt : (float)(nb + ne - 1) * 0.5f;
+    float cy = cnt ? sy / cnt : ay;
+    if (isnan(ay)) ay = cy;   // 직전 점이 결측이면 평균과 같은 높이로
+
+    // 이번 버킷에서 삼각형이 가장 큰 점 (값이 하나도 없으면 첫 점 = 결측 구간 표시)
+    uint32_t b0 = edge(k), b1 = edge(k + 1);
+    uint32_t pick = b0;
+    float    best = -1.0f;
+    for (uint32_t j = b0; j < b1; j++) {
+      float v = y(j);
+      if (isnan(v)) continue;
+      float area = fabsf(((float)a - cx) * (v - ay) - ((float)a - (float)j) * (cy - ay));
+      if (isnan(area)) area = 0.0f;
+      if (area > best) {
+        best = area;
+        pick = j;
+      }
+    }
+    emit(pick);
+    a  = pick;
+    ay = y(pick);
+  }
+  emit(n - 1);
+  return m;
+}
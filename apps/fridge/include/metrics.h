@@ -0,0 +1,110 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ===================== 구간별 지연 히스토그램 =====================
+// 사이클 카운터로 구간 시간을 재서 고정 버킷(옥타브당 4칸, 로그 스케일)에 누적한다.
+// 기록은 O(1), 힙 없음 → 운영 중에도 항상 켜둔다.
+// 히스토그램마다 기록하는 태스크는 하나뿐이고 /metrics 는 그대로 읽는다.
+// (32비트 읽기라 값이 찢어지지는 않지만 칸 사이가 한두 개 어긋날 수 있음)
+
+class LatencyHist {
+ public:
+  static const uint32_t SUB_BUCKETS = 4;                  // 옥타브당 칸 수 (오차 ≤ 25%)
+  static const uint32_t BUCKETS     = 26 * SUB_BUCKETS;   // 0us ~ 약 134초
+
+  void record(uint32_t us) {
+    uint32_t b = bucketOf(us);
+    counts_[b]++;
+    count_++;
+    sum_ += us;
+    if (us > max_) max_ = us;
+  }
+
+  uint32_t count() const { return count_; }
+  uint32_t max() const   { return max_; }
+  uint64_t sum() const   { return sum_; }
+  // q (0~1) 분위수: 해당 버킷 상한 (max 로 제한)
+  uint32_t percentile(float q) const;
+
+  static uint32_t bucketOf(uint32_t us);
+  static uint32_t bucketUpper(uint32_t b);
+
+ private:
+  uint32_t counts_[BUCKETS] = {};
+  uint32_t count_ = 0;
+  uint32_t max_   = 0;
+  uint64_t sum_   = 0;
+};
+
+// 계측 구간
+enum MetricStage : uint8_t {
+  // loop 태스크
+  STAGE_LOOP = 0,        // loop() 한 바퀴 (delay 제외)
+  STAGE_WIFI,
+  STAGE_HTTP,            // http.handleClient()
+  STAGE_OTA,             // ElegantOTA.loop()
+  STAGE_NTP,             // timeTick() (SNTP 요청 / 응답 확인)
+  STAGE_MQTT_CONNECT,    // mqttConnectNonBlocking() (재연결 시 블로킹)
+  STAGE_MQTT_LOOP,       // mqtt.loop()
+  STAGE_STATUS,          // statusTick() 전체
+  STAGE_PUBLISH,         // publishStatus()
+  STAGE_STREAM,          // SSE 구독자 수락 / 이벤트 송신
+  // 제어 태스크
+  STAGE_CONTROL,         // controlStep() 전체
+  STAGE_SENSOR,          // readSensorsDHT21()
+  STAGE_PID,             // pidCompute()
+  STAGE_COUNT
+};
+
+const char* metricStageName(MetricStage s);
+
+// 명령 종류별 지연 (commands.cpp)
+enum MetricCmd : uint8_t {
+  METRIC_CMD_SET_TARGET = 0,
+  METRIC_CMD_SET_PELTIER,
+  METRIC_CMD_RESTART,
+  METRIC_CMD_SET_REPORT,
+  METRIC_CMD_SET_SCHEDULE,
+  METRIC_CMD_INVALID,    // 파싱/검증 실패, 알 수 없는 cmd
+  METRIC_CMD_DUPLICATE,  // 캐시에서 ack 재발행
+  METRIC_CMD_COUNT
+};
+
+const char* metricCmdName(MetricCmd c);
+
+extern LatencyHist gStageHist[STAGE_COUNT];
+extern LatencyHist gControlJitter;   // |실제 제어 주기 - CONTROL_PERIOD_MS| (us)
+extern LatencyHist gCmdApplyHist[METRIC_CMD_COUNT];   // 큐에서 꺼낸 뒤 ~ 적용 완료 (ack 발행 전)
+extern LatencyHist gCmdAckHist[METRIC_CMD_COUNT];     // MQTT 수신 ~ ack 발행 큐 투입 (브로커 왕복은 mqttOutRtt)
+
+// 이벤트 카운터 (각 필드는 한 태스크에서만 증가)
+struct MetricCounters {
+  uint32_t mqttConnects       = 0;
+  uint32_t mqttConnectFails   = 0;
+  uint32_t statusPublishFails = 0;
+  uint32_t ackPublishFails    = 0;
+  uint32_t batchPublishFails  = 0;
+  uint32_t cmdReceived        = 0;   // 큐에 들어간 명령
+  uint32_t cmdDuplicates      = 0;   // 캐시 ack 로 응답 (재실행 안 함)
+  uint32_t cmdQueueDrops      = 0;   // 큐가 가득 차서 버림 (QoS1 재전송에 맡김)
+  uint32_t cmdOversize        = 0;   // CMD_PAYLOAD_MAX 초과로 버림
+  uint32_t jsonPoolOverflows  = 0;   // JsonPool 이 모자라 malloc 으로 넘긴 블록 (json_pool.h)
+};
+extern MetricCounters gMetricCounters;
+
+// 사이클 카운터 (코어별). 태스크가 코어에 고정돼 있으므로 시작/끝이 같은 코어
+uint32_t metricsCycles();
+uint32_t metricsCyclesToUs(uint32_t cycles);
+
+// 범위 계측: 생성 ~ 소멸 구간을 해당 히스토그램에 기록
+class StageTimer {
+ public:
+  explicit StageTimer(MetricStage s) : stage_(s), start_(metricsCycles()) {}
+  ~StageTimer() { gStageHist[stage_].record(metricsCyclesToUs(metricsCycles() - start_)); }
+
+ private:
+  MetricStage stage_;
+  uint32_t    start_;
+};
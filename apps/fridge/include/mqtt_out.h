@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "metrics.h"
+
+// ===================== MQTT 발행 파이프라인 =====================
+// 256dpi MQTTClient::publish() 는 QoS1/2 응답을 받을 때까지 loop 를 붙잡는다.
+// 여기서는 PUBLISH 패킷을 미리 직렬화해 고정 크기 큐에 넣고 바로 돌아온다.
+//   - 응답 대기 메시지는 MQTT_OUT_WINDOW 개까지 (나머지는 큐 순서대로 대기)
+//   - QoS1 은 PUBACK, QoS2 는 PUBREC → (라이브러리가 PUBREL) → PUBCOMP 로 완료, QoS0 은 소켓에 넘기면 완료
+//   - MQTT_OUT_RETRY_MS 안에 응답이 없거나 재연결하면 DUP 로 재전송
+//   - 완료 / 포기 시 콜백 (ok = 브로커가 받음)
+// 연결 / 구독 / keepalive / 수신은 그대로 라이브러리가 맡고, 패킷은 같은 소켓에 직접 쓴다.
+// 패킷 id 는 0x8000 이상만 써서 라이브러리의 subscribe id 와 겹치지 않는다. loop 태스크 전용.
+
+typedef void (*MqttOutDone)(uint32_t tag, bool ok);
+
+struct MqttOutStats {
+  uint32_t depth;         // 큐에 있는 메시지 (응답 대기 포함)
+  uint32_t depthMax;
+  uint32_t inflight;      // 응답 대기
+  uint32_t queued;        // 누적 발행 요청
+  uint32_t completed;     // 누적 완료
+  uint32_t retransmits;   // 시간 초과 / 재연결로 다시 보낸 패킷 (PUBREL 포함)
+  uint32_t rejected;      // 끊김 / 큐 또는 버퍼가 가득 참 / 패킷이 너무 큼
+  uint32_t expired;       // MQTT_OUT_MAX_TRIES 를 넘겨 포기
+  uint32_t bytes;         // 소켓으로 나간 바이트
+};
+
+void mqttOutBegin();
+// false = 끊김이거나 자리가 없음 (호출한 쪽의 기존 실패 경로로)
+bool mqttOutPublish(const char* topic, const void* payload, size_t len, uint8_t qos,
+                    MqttOutDone done = nullptr, uint32_t tag = 0);
+// MQTT 연결 직후: 응답 못 받은 메시지 재전송 준비 (세션이 남아 있으면 PUBREL 도 다시)
+void mqttOutOnConnect(bool sessionPresent);
+// net 작업마다 mqtt.loop() 뒤에: 재전송 타이머 + 대기 메시지 송신
+void mqttOutTick();
+bool mqttOutBusy();   // 응답 대기 중 (net 작업을 빠른 폴링으로)
+// 수신 바이트에서 찾은 응답 (type = 4 PUBACK / 5 PUBREC / 7 PUBCOMP)
+void mqttOutOnAck(uint8_t type, uint16_t id);
+// 라이브러리가 같은 소켓에 쓰기 전에: 반쯤 보낸 패킷을 마저 보낸다 (false = 실패, 연결을 끊어야 함)
+bool mqttOutFinishPartial();
+// 재시작 직전 전용 (loop 를 막는다): mqtt.loop() 로 응답을 받으며 대기 메시지를 보낸다.
+// until 이 있으면 그것이 참이 될 때까지, 없으면 큐가 빌 때까지. timeoutMs 가 지나거나 끊기면 false
+bool mqttOutDrain(uint32_t timeoutMs, bool (*until)() = nullptr);
+MqttOutStats       mqttOutStats();
+const LatencyHist& mqttOutRtt();   // 전송 ~ PUBACK / PUBCOMP (us), 재전송한 메시지는 빼고
+
+// ===== 소켓 (ESP32: mqtt_link.cpp / native: sim/mqtt_sim.cpp) =====
+bool mqttLinkReady();
+int  mqttLinkWrite(const uint8_t* buf, size_t len);   // 받아들인 바이트, 0 = 가득 참, -1 = 끊김
+#ifdef ESP32
+class Client;
+Client& mqttLinkClient();   // MQTTClient::begin() 에 넘길 소켓 (수신 바이트에서 응답 id 를 찾는다)
+#endif
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+
+// ===================== OTA (이어받기 + 압축) =====================
+// 이미지(ota_image.h)를 PUT /ota?offset=N 조각으로 받는다. 조각마다:
+//   otaChunkBegin(offset) → otaChunkWrite(…) 여러 번 (HTTP 본문이 들어오는 대로) → otaChunkEnd()
+// 받은 바이트는 바로 (압축이면 풀면서) 비활성 앱 파티션에 OTA_FLASH_PAGE 단위로 쓰고
+// SHA-256 을 누적한다. 끝까지 받으면 크기 / SHA-256 을 확인하고 나서야 부팅 파티션을 바꾼다.
+//   - 이어받기: 연결이 끊겨도 받은 곳(received)까지는 유효. GET /ota 의 received 부터 다시 보내면 된다.
+//     offset < received 인 조각은 겹친 앞부분을 건너뛰고 (재전송), offset > received 는 거절 (gap).
+//     offset 0 에 다른 헤더가 오면 새 이미지로 다시 시작.
+//   - 세션은 RAM 에만 있다 (재부팅하면 처음부터). OTA_SESSION_IDLE_MS 동안 조각이 없으면 폐기.
+//   - 받는 동안 제어 태스크는 그대로 돈다. 펠티어는 검증이 끝난 뒤 재시작 직전에만 끈다 (otaRebootDue).
+// loop 태스크 전용.
+//
+// 호스트에서 보내기 (이어받기):
+//   sz=$(stat -c%s fw.fzo); while :; do
+//     off=$(curl -s http://fridge/ota | sed 's/.*"received":\([0-9]*\).*/\1/'); [ "$off" -ge "$sz" ] && break
+//     tail -c +$((off + 1)) fw.fzo | head -c 65536 > part; curl -s -T part "http://fridge/ota?offset=$off"; done
+
+enum OtaState : uint8_t {
+  OTA_IDLE,
+  OTA_RECEIVING,
+  OTA_READY,     // 검증 끝, 다음 부팅 파티션 전환됨 (재시작 대기)
+  OTA_FAILED,
+};
+
+struct OtaStatus {
+  OtaState    state;
+  const char* error;        // OTA_FAILED 이유 (정적 문자열)
+  uint8_t     codec;
+  uint32_t    received;     // 이미지(헤더 포함)에서 이어서 받을 위치
+  uint32_t    total;        // 헤더 + 본문 (헤더를 받기 전 0)
+  uint32_t    rawSize;
+  uint32_t    written;      // 플래시에 쓴 펌웨어 바이트
+  uint32_t    chunks;
+  uint32_t    resumes;      // offset < received 로 시작한 조각 (끊긴 뒤 재전송)
+  uint32_t    duplicateBytes;
+  uint32_t    elapsedMs;    // 첫 조각 → 마지막 조각
+  // 부팅 후 누적
+  uint32_t    sessions;
+  uint32_t    completed;
+  uint32_t    failures;
+};
+
+void        otaBegin();        // 부팅 시 (받던 세션과 누적 카운터 모두 초기화)
+// 조각 하나. false = 이 조각은 받을 수 없음 (이유는 otaChunkEnd() 가 돌려줌, 세션은 그대로)
+bool        otaChunkBegin(uint32_t offset);
+void        otaChunkWrite(const uint8_t* data, size_t len);
+const char* otaChunkEnd();     // nullptr = 받음, 아니면 "gap" / "no_session" / "complete"
+void        otaAbort();        // DELETE /ota
+void        otaTick();         // 유휴 세션 폐기 (net 작업에서)
+bool        otaRebootDue();    // 검증 성공 후 OTA_REBOOT_DELAY_MS 가 지남 → 재시작
+OtaStatus   otaStatus();
+const char* otaStateName(OtaState s);
+
+// ---------- 플랫폼 (ESP32: ota_flash.cpp, 네이티브: sim/ota_sim.cpp) ----------
+bool otaFlashBegin(uint32_t rawSize);                  // 비활성 앱 파티션 열기 (false = 없음 / 이미지가 큼)
+bool otaFlashWrite(const uint8_t* data, size_t len);   // 이어서 쓰기 (섹터는 쓰는 만큼만 지운다)
+bool otaFlashEnd();                                    // 이미지 검증 + 다음 부팅 파티션으로
+void otaFlashAbort();
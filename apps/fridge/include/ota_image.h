@@ -0,0 +1,90 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+
+// ===================== OTA 이미지 형식 =====================
+// [OtaImageHeader 48B][본문 packedSize B]
+//   - codec 0 (stored): 본문 = 펌웨어 그대로
+//   - codec 1 (lzss)  : 본문 = LZSS 토큰 열. 제어 바이트 하나가 뒤따르는 토큰 8개를 (LSB 부터) 정한다
+//                       1 = 리터럴 1바이트, 0 = 일치 2바이트 [거리-1 하위 8비트][거리-1 상위 4비트 | (길이-3) << 4]
+//                       거리 1~4096 (창 = 2^OTA_LZ_WINDOW_BITS), 길이 3~18
+// sha256 은 풀어낸 펌웨어 전체 (파티션을 바꾸기 전에 확인). 정수는 리틀 엔디언.
+// 이미지는 호스트에서 만든다: 시뮬레이터 --ota-pack firmware.bin firmware.fzo
+
+static const uint32_t OTA_IMAGE_MAGIC   = 0x314F5A46;   // "FZO1"
+static const uint8_t  OTA_IMAGE_VERSION = 1;
+static const uint8_t  OTA_CODEC_STORED  = 0;
+static const uint8_t  OTA_CODEC_LZSS    = 1;
+
+struct OtaImageHeader {
+  uint32_t magic;
+  uint8_t  version;
+  uint8_t  codec;
+  uint16_t headerSize;   // sizeof(OtaImageHeader) (나중에 필드가 늘면 앞부분만 읽는다)
+  uint32_t rawSize;      // 풀어낸 펌웨어 크기
+  uint32_t packedSize;   // 헤더 뒤 본문 크기
+  uint8_t  sha256[32];
+};
+static_assert(sizeof(OtaImageHeader) == 48, "OtaImageHeader layout is part of the image format");
+
+// nullptr = 정상, 아니면 이유 ("bad_magic" …)
+const char* otaHeaderCheck(const OtaImageHeader& h);
+
+// ---------- SHA-256 (스트리밍) ----------
+class Sha256 {
+ public:
+  void begin();
+  void update(const uint8_t* data, size_t len);
+  void finish(uint8_t out[32]);
+
+ private:
+  void     block(const uint8_t* p);
+  uint32_t h_[8];
+  uint64_t bytes_;
+  uint8_t  buf_[64];
+  size_t   fill_;
+};
+
+// ---------- LZSS 풀기 (스트리밍) ----------
+// 입력은 아무 데서나 잘려 들어와도 된다 (HTTP 조각 경계). 풀어낸 바이트는 창에 쌓였다가
+// 창 경계마다 / feed() 끝에서 sink 로 나간다. 상태는 모두 객체 안 (힙 없음, ~4KB).
+class OtaLzDecoder {
+ public:
+  static const uint32_t WINDOW    = 1u << OTA_LZ_WINDOW_BITS;
+  static const uint32_t MIN_MATCH = 3;
+  static const uint32_t MAX_MATCH = 18;
+  static_assert(OTA_LZ_WINDOW_BITS == 12, "match token packs the distance into 12 bits");
+
+  // false = 쓰기 실패 (디코더도 실패로 멈춘다)
+  typedef bool (*Sink)(const uint8_t* data, size_t len, void* ctx);
+
+  void begin(uint32_t rawSize);
+  // false = 형식 오류 (창 밖 거리 / rawSize 초과 / 끝난 뒤 남는 입력) 또는 sink 실패
+  bool feed(const uint8_t* in, size_t len, Sink sink, void* ctx);
+  bool finished() const { return !failed_ && out_ == rawSize_; }
+  uint32_t produced() const { return out_; }
+
+ private:
+  enum : uint8_t { ST_CTRL, ST_TOKEN, ST_MATCH_HI };
+  bool flush(Sink sink, void* ctx);
+  bool fail() {
+    failed_ = true;
+    return false;
+  }
+  void nextToken() {
+    ctrl_ >>= 1;
+    state_ = --bitsLeft_ ? ST_TOKEN : ST_CTRL;
+  }
+
+  uint8_t  window_[WINDOW];
+  uint32_t out_      = 0;   // 지금까지 풀어낸 바이트
+  uint32_t flushed_  = 0;   // sink 로 넘긴 바이트
+  uint32_t rawSize_  = 0;
+  uint8_t  state_    = ST_CTRL;
+  uint8_t  ctrl_     = 0;
+  uint8_t  bitsLeft_ = 0;
+  uint8_t  lo_       = 0;
+  bool     failed_   = false;
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdint.h>
+
+// ===================== 펠티어 구동 =====================
+// PID 출력(LEDC 코드, 소수부 16비트) → 구동 틱마다 실제로 쓸 정수 LEDC 코드.
+//   슬루 제한  : 듀티가 틱당 slewStep 보다 크게 움직이지 않는다
+//                (꺼짐 → 켜짐 직후 softStartTicks 동안은 더 느린 softStep)
+//   시그마-델타: 소수부를 누적해 이웃한 두 코드를 오가며 평균이 목표와 같게 (1차, 누적 오차 < 1코드)
+// 목표 0 은 슬루 없이 바로 0 (정지/안전 경로는 늦어지면 안 됨).
+// Arduino 의존 없음 → 호스트에서 그대로 검증 (시뮬레이터 --bench-drive)
+struct PeltierDriveParams {
+  int32_t  maxQ;             // 출력 상한 (코드 << FRAC)
+  int32_t  slewStepQ;        // 틱당 최대 변화
+  int32_t  softStepQ;        // 소프트 스타트 동안 틱당 최대 변화
+  uint32_t softStartTicks;   // 소프트 스타트 길이 (틱)
+};
+
+class PeltierDrive {
+ public:
+  static const int FRAC = 16;
+
+  static constexpr int32_t fromCode(int32_t code) { return code << FRAC; }
+
+  void reset() {
+    target_  = 0;
+    level_   = 0;
+    acc_     = 0;
+    onTicks_ = 0;
+  }
+
+  // 제어 태스크에서만 (int32 하나라 구동 틱이 동시에 읽어도 찢어지지 않는다).
+  // 재시작 전 정지는 setTarget 을 부르지 않고 control.cpp 의 정지 래치로 한다
+  void    setTarget(int32_t q) { target_ = q; }
+  int32_t target() const { return target_; }
+  int32_t level() const { return level_; }   // 슬루를 거친 듀티 (디더링 전)
+
+  // 구동 틱 1회: 이번 틱에 쓸 LEDC 코드
+  uint32_t tick(const PeltierDriveParams& p) {
+    int32_t t = target_;
+    if (t <= 0) {
+      level_   = 0;
+      acc_     = 0;
+      onTicks_ = 0;
+      return 0;
+    }
+    if (t > p.maxQ) t = p.maxQ;
+
+    int32_t step = onTicks_ < p.softStartTicks ? p.softStepQ : p.slewStepQ;
+    if (onTicks_ < p.softStartTicks) onTicks_++;
+    int32_t d = t - level_;
+    if (d > step)  d = step;
+    if (d < -step) d = -step;
+    level_ += d;
+
+    // 출력 = floor(level + 누적 나머지), 나머지는 다음 틱으로
+    int32_t  v    = level_ + acc_;
+    uint32_t code = (uint32_t)(v >> FRAC);
+    acc_          = v - (int32_t)(code << FRAC);
+    return code;
+  }
+
+ private:
+  volatile int32_t target_  = 0;
+  int32_t          level_   = 0;
+  int32_t          acc_     = 0;   // [0, 1 << FRAC)
+  uint32_t         onTicks_ = 0;
+};
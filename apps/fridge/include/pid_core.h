@@ -0,0 +1,205 @@
+#pragma once
+
+#include <stdint.h>
+
+// ===================== PID 코어 =====================
+// 수치 타입(Q)과 한계값(L)을 템플릿으로 받는 PID 연산부 (존 N 개를 한 번에 들고 있는 뱅크).
+// 히스테리시스/전제조건 판단은 control.cpp 에 두고, 여기서는 오차 → PWM 카운트만 계산한다.
+//
+// - 게인은 setGains() 에서 한 번만 PWM 카운트 단위로 환산 (출력 상한 포함)
+//   → 매 주기 % ↔ PWM 변환 없음, 출력은 바로 정수 PWM
+// - 미분항은 온도 변화율(°C/s)을 직접 받거나 (필터 추정값), 없으면 오차 차분 / dt
+// - Q = FixedQ<FRAC>: int32 Q(31-FRAC).FRAC, 곱셈은 int64 중간값 + 반올림
+//   Q = FloatQ: 같은 코드를 float 로 (벤치마크 / 비교용)
+// - L 은 constexpr 멤버를 가진 타입: kp/ki/kd 기본값, integralMin/Max, deadband, dt, outMax
+
+// ---------- 수치 타입 ----------
+template <int FRAC>
+struct FixedQ {
+  static_assert(FRAC > 0 && FRAC < 31, "FixedQ fraction bits out of range");
+  typedef int32_t T;      // 저장 타입
+  typedef int64_t Wide;   // 곱셈/합산 중간값 (게인이 커도 넘치지 않게)
+
+  static constexpr int   FRAC_BITS = FRAC;
+  static constexpr float FROM_MAX  = 2147483648.0f / (float)(1L << FRAC);   // 2^31 / 2^FRAC, 여기부터 포화
+
+  // 범위 밖은 int32 끝값으로 포화, NaN 은 0 (그대로 캐스트하면 정의되지 않은 동작)
+  static constexpr T from(float v) {
+    return v != v           ? T(0)
+           : v >= FROM_MAX  ? T(INT32_MAX)
+           : v <= -FROM_MAX ? T(INT32_MIN)
+           : (T)(v * (float)(1L << FRAC) + (v >= 0.0f ? 0.5f : -0.5f));
+  }
+  static constexpr float toFloat(T v) { return (float)v / (float)(1L << FRAC); }
+  static constexpr Wide widen(T v) { return (Wide)v; }
+  static Wide mul(T a, T b) { return ((Wide)a * (Wide)b + ((Wide)1 << (FRAC - 1))) >> FRAC; }
+  static T narrow(Wide v) { return (T)v; }   // 호출자가 범위를 먼저 clamp
+  static int32_t toInt(T v) { return (int32_t)(v >> FRAC); }   // 내림 (양수는 버림과 같음)
+};
+
+struct FloatQ {
+  typedef float T;
+  typedef float Wide;
+
+  static constexpr T from(float v) { return v; }
+  static constexpr float toFloat(T v) { return v; }
+  static constexpr Wide widen(T v) { return v; }
+  static Wide mul(T a, T b) { return a * b; }
+  static T narrow(Wide v) { return v; }
+  static int32_t toInt(T v) { return (int32_t)v; }
+};
+
+// ---------- PID 뱅크 ----------
+// 채널(존) N 개의 PID 를 필드별 배열(SoA)로 들고 있다. 제어 루프가 모든 존을 차례로 훑을 때
+// 같은 필드(게인, 적분, 직전 오차 …)가 연속으로 놓여 존 수가 늘어도 캐시 라인을 덜 건드린다.
+template <typename Q, typename L, uint32_t N>
+class PidBank {
+  static_assert(N >= 1, "PidBank needs at least one channel");
+
+ public:
+  typedef typename Q::T    Num;
+  typedef typename Q::Wide Wide;
+
+  struct Gains {
+    Num kp;   // PWM 카운트 / °C
+    Num ki;   // PWM 카운트 / (°C·s)
+    Num kd;   // PWM 카운트 / (°C/s)
+  };
+
+  // 사람 단위 게인 (%/°C 등, /pid 와 같은 단위) → 내부 단위
+  static constexpr Gains scaleGains(float kp, float ki, float kd) {
+    return Gains{Q::from(kp * (float)L::outMax / 100.0f),
+                 Q::from(ki * (float)L::outMax / 100.0f),
+                 Q::from(kd * (float)L::outMax / 100.0f)};
+  }
+  static constexpr Gains defaultGains() { return scaleGains(L::kp, L::ki, L::kd); }
+
+  PidBank() {
+    Gains g = defaultGains();
+    for (uint32_t i = 0; i < N; i++) {
+      kp_[i]     = g.kp;
+      ki_[i]     = g.ki;
+      kd_[i]     = g.kd;
+      output_[i] = 0;
+      reset(i);
+    }
+  }
+
+  void setGains(uint32_t i, float kp, float ki, float kd) {
+    Gains g = scaleGains(kp, ki, kd);
+    kp_[i]  = g.kp;
+    ki_[i]  = g.ki;
+    kd_[i]  = g.kd;
+  }
+  Gains gains(uint32_t i) const { return Gains{kp_[i], ki_[i], kd_[i]}; }
+
+  // 적분/미분 이력 초기화 (냉각 시작, 목표/게인 변경 시)
+  void reset(uint32_t i) {
+    integral_[i]  = 0;
+    prevError_[i] = 0;
+    firstRun_[i]  = true;
+  }
+
+  // error = temp - target (°C, 양수 = 냉각 필요). 반환 = PWM 카운트 0 ~ L::outMax
+  // 미분: 오차 차분 / dt (kick 방지를 위해 목표 변경 후 첫 주기는 생략)
+  int32_t update(uint32_t i, Num error) {
+    Num  rate    = firstRun_[i] ? Num(0) : Q::narrow(Q::mul(error - prevError_[i], INV_DT));
+    bool useRate = !firstRun_[i];
+    prevError_[i] = error;
+    firstRun_[i]  = false;
+    return step(i, error, rate, useRate);
+  }
+
+  // rate = 측정값 변화율 (°C/s, 필터 추정). 목표와 무관하므로 목표 변경 시에도 kick 없음
+  int32_t update(uint32_t i, Num error, Num rate) {
+    prevError_[i] = error;
+    firstRun_[i]  = false;
+    return step(i, error, rate, true);
+  }
+
+  Num integral(uint32_t i) const { return integral_[i]; }     // °C·s
+  Num prevError(uint32_t i) const { return prevError_[i]; }   // °C
+  Num output(uint32_t i) const { return output_[i]; }         // PWM 카운트 (소수부 포함)
+
+  // 재부팅 직전 상태 복원 (웜 부팅). 범위는 step() 과 같은 한계로 다시 자른다
+  void restore(uint32_t i, Num integral, Num prevError, Num output) {
+    if (integral > INTEGRAL_MAX) integral = INTEGRAL_MAX;
+    if (integral < INTEGRAL_MIN) integral = INTEGRAL_MIN;
+    if (output < Num(0))         output   = Num(0);
+    if (output > OUT_MAX)        output   = OUT_MAX;
+    integral_[i]  = integral;
+    prevError_[i] = prevError;
+    output_[i]    = output;
+    firstRun_[i]  = false;
+  }
+
+ private:
+  int32_t step(uint32_t i, Num error, Num rate, bool useRate) {
+    // 적분 (데드밴드 밖에서만) + 와인드업 클램프
+    Num absErr = error < 0 ? -error : error;
+    Num integ  = integral_[i];
+    if (absErr > DEADBAND) integ += Q::narrow(Q::mul(error, DT));
+    if (integ > INTEGRAL_MAX) integ = INTEGRAL_MAX;
+    if (integ < INTEGRAL_MIN) integ = INTEGRAL_MIN;
+    integral_[i] = integ;
+
+    Wide out = Q::mul(kp_[i], error) + Q::mul(ki_[i], integ);
+    if (useRate) out += Q::mul(kd_[i], rate);
+
+    if (out < Q::widen(0))       out = Q::widen(0);
+    if (out > Q::widen(OUT_MAX)) out = Q::widen(OUT_MAX);
+    output_[i] = Q::narrow(out);
+    return Q::toInt(output_[i]);
+  }
+
+  static constexpr Num DT           = Q::from(L::dt);
+  static constexpr Num INV_DT       = Q::from(1.0f / L::dt);
+  static constexpr Num DEADBAND     = Q::from(L::deadband);
+  static constexpr Num INTEGRAL_MAX = Q::from(L::integralMax);
+  static constexpr Num INTEGRAL_MIN = Q::from(L::integralMin);
+  static constexpr Num OUT_MAX      = Q::from((float)L::outMax);
+
+  Num  kp_[N];
+  Num  ki_[N];
+  Num  kd_[N];
+  Num  integral_[N];
+  Num  prevError_[N];
+  Num  output_[N];
+  bool firstRun_[N];
+};
+
+// C++11: constexpr 정적 멤버가 참조로 쓰일 때를 위한 정의
+template <typename Q, typename L, uint32_t N> constexpr typename PidBank<Q, L, N>::Num PidBank<Q, L, N>::DT;
+template <typename Q, typename L, uint32_t N> constexpr typename PidBank<Q, L, N>::Num PidBank<Q, L, N>::INV_DT;
+template <typename Q, typename L, uint32_t N> constexpr typename PidBank<Q, L, N>::Num PidBank<Q, L, N>::DEADBAND;
+template <typename Q, typename L, uint32_t N> constexpr typename PidBank<Q, L, N>::Num PidBank<Q, L, N>::INTEGRAL_MAX;
+template <typename Q, typename L, uint32_t N> constexpr typename PidBank<Q, L, N>::Num PidBank<Q, L, N>::INTEGRAL_MIN;
+template <typename Q, typename L, uint32_t N> constexpr typename PidBank<Q, L, N>::Num PidBank<Q, L, N>::OUT_MAX;
+
+// ---------- PID (단일 채널) ----------
+// 뱅크 한 칸짜리. 벤치마크 / 비교용
+template <typename Q, typename L>
+class PidCore {
+  typedef PidBank<Q, L, 1> Bank;
+
+ public:
+  typedef typename Bank::Num   Num;
+  typedef typename Bank::Wide  Wide;
+  typedef typename Bank::Gains Gains;
+
+  static constexpr Gains scaleGains(float kp, float ki, float kd) { return Bank::scaleGains(kp, ki, kd); }
+  static constexpr Gains defaultGains() { return Bank::defaultGains(); }
+
+  void  setGains(float kp, float ki, float kd) { bank_.setGains(0, kp, ki, kd); }
+  Gains gains() const { return bank_.gains(0); }
+  void  reset() { bank_.reset(0); }
+
+  int32_t update(Num error) { return bank_.update(0, error); }
+  int32_t update(Num error, Num rate) { return bank_.update(0, error, rate); }
+
+  Num integral() const { return bank_.integral(0); }
+  Num output() const { return bank_.output(0); }
+
+ private:
+  Bank bank_;
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdint.h>
+
+// 고정 크기 링 버퍼 (힙 할당 없음, 단일 태스크 전용).
+// 가득 찬 상태에서 push 하면 가장 오래된 기록을 덮어쓴다.
+template <typename T, uint32_t N>
+class RecordRing {
+  static_assert(N >= 1, "RecordRing needs at least one slot");
+
+ public:
+  // false = 가득 차서 가장 오래된 기록을 덮어씀
+  bool push(const T& v) {
+    bool overwrote = (count_ == N);
+    buf_[(head_ + count_) % N] = v;
+    if (overwrote) head_ = (head_ + 1) % N;
+    else           count_++;
+    return !overwrote;
+  }
+
+  // i = 0 이 가장 오래된 기록
+  const T& peek(uint32_t i) const { return buf_[(head_ + i) % N]; }
+  const T& oldest() const         { return buf_[head_]; }
+
+  // 오래된 순으로 n 개 제거
+  void drop(uint32_t n) {
+    if (n > count_) n = count_;
+    head_   = (head_ + n) % N;
+    count_ -= n;
+  }
+
+  void     clear()       { head_ = 0; count_ = 0; }
+  bool     empty() const { return count_ == 0; }
+  bool     full() const  { return count_ == N; }
+  uint32_t size() const  { return count_; }
+  static constexpr uint32_t capacity() { return N; }
+
+ private:
+  T        buf_[N];
+  uint32_t head_  = 0;
+  uint32_t count_ = 0;
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stdint.h>
+#include "config.h"
+#include "state.h"
+
+// ===================== 상태 보고 정책 =====================
+// JSON 상태 토픽을 언제 보낼지 정한다. 마지막으로 보낸 값과 비교해서
+//   이벤트   : 냉각 START/STOP, 목표/펠티어 사용 변경, 센서 이상/복구, 출력 계단 → 바로
+//   dead-band: 온도/습도가 밴드를 넘으면 → REPORT_MIN_GAP_MS 안에서 한 번
+//   heartbeat: 아무 일도 없으면 heartbeatSec 마다
+// 정책은 존마다 set_report 명령으로 바꿀 수 있다 (RAM, 재부팅하면 config.h 기본값).
+// loop 태스크 전용.
+
+enum ReportReason : uint8_t {
+  REPORT_NONE = 0,
+  REPORT_FIRST,           // 연결 직후 / 첫 보고
+  REPORT_SENSOR_FAULT,    // 온도 값 → null
+  REPORT_SENSOR_OK,       // null → 값
+  REPORT_COOLING_START,
+  REPORT_COOLING_STOP,
+  REPORT_TARGET,
+  REPORT_PELTIER,
+  REPORT_POWER,           // 출력이 powerBand 이상 바뀜
+  REPORT_TEMP,
+  REPORT_HUMIDITY,
+  REPORT_HEARTBEAT,
+  REPORT_REASON_COUNT
+};
+
+struct ReportPolicy {
+  uint16_t heartbeatSec;
+  float    tempBand;      // °C
+  float    humBand;       // %
+  uint8_t  powerBand;     // %p
+};
+
+void reportBegin();
+// 지금 보내야 하면 사유, 아니면 REPORT_NONE (gZone / gControl 기준)
+ReportReason reportCheck(uint8_t zone, uint32_t nowMs);
+// 발행 직후: 비교 기준을 지금 값으로
+void reportMark(uint8_t zone, ReportReason reason, uint32_t nowMs);
+// MQTT 재연결: 다음 확인에서 REPORT_FIRST
+void reportReset(uint8_t zone);
+
+const ReportPolicy& reportPolicy(uint8_t zone);
+void        setReportPolicy(uint8_t zone, const ReportPolicy& p);
+const char* reportReasonName(ReportReason r);
+uint32_t    reportCount(ReportReason r);   // 사유별 발행 수 (전 존 합계)
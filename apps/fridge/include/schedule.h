@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdint.h>
+#include "config.h"
+#include "state.h"
+
+// ===================== 발효 스케줄 =====================
+// 존마다 구간(ramp / hold) 최대 SCHEDULE_SEGMENTS_MAX 개를 set_schedule 명령으로 한 번 받아 NVS 에 두고,
+// NTP 시각 기준으로 기기가 직접 진행한다 (네트워크가 끊겨도, 재부팅 후에도 같은 위치에서 이어감).
+//   ramp : 직전 구간 끝 값(첫 구간은 업로드 당시 목표)에서 target 까지 minutes 동안 직선
+//   hold : target 을 minutes 동안 유지
+// 구간에 들어갈 때 제어 태스크에 램프(시작값, 끝값, 남은 시간)를 넘기고, 제어 태스크가 PID 주기마다 보간한다.
+// 마지막 구간이 끝나면 마지막 목표를 일반 목표로 남긴다. set_target 은 스케줄을 취소한다.
+// loop 태스크 전용.
+
+enum ScheduleKind : uint8_t {
+  SCHED_HOLD = 0,
+  SCHED_RAMP = 1,
+};
+
+struct __attribute__((packed)) ScheduleSegment {
+  uint8_t  kind;       // ScheduleKind
+  int16_t  target10;   // 0.1°C
+  uint16_t minutes;    // 최대 ~45일
+};
+
+// NVS blob 그대로 (storage.cpp 가 존 네임스페이스의 별도 키로 기록)
+static const uint8_t SCHEDULE_VERSION = 1;
+struct __attribute__((packed)) FermSchedule {
+  uint8_t         version;
+  uint8_t         count;           // 0 = 스케줄 없음
+  int16_t         startTarget10;   // 첫 ramp 의 시작값
+  uint32_t        startUnix;       // 첫 구간 시작 (unix 초)
+  ScheduleSegment seg[SCHEDULE_SEGMENTS_MAX];
+};
+
+enum ScheduleState : uint8_t {
+  SCHED_STATE_NONE = 0,
+  SCHED_STATE_WAITING,   // 시작 전이거나 NTP 미동기 (저장된 목표 유지)
+  SCHED_STATE_RUNNING,
+  SCHED_STATE_DONE,
+};
+
+struct ScheduleProgress {
+  ScheduleState state;
+  uint8_t       step;       // 진행 중 구간 (0부터)
+  uint8_t       steps;
+  uint32_t      elapsedSec; // 스케줄 시작부터
+  uint32_t      totalSec;
+  float         setpoint;   // 지금 목표 (RUNNING)
+};
+
+void scheduleBegin();   // loadFromNVS 이후: 저장된 스케줄 복원 (구간 진입은 첫 scheduleTick 에서)
+// statusTick() 에서 제어 주기마다: 구간 전환 → 제어 태스크 램프, gZone[].target 갱신
+void scheduleTick();
+// 검증 후 시작. false = 구간 값이 잘못됨
+bool scheduleSet(uint8_t zone, const FermSchedule& s);
+void scheduleCancel(uint8_t zone);
+bool scheduleActive(uint8_t zone);   // WAITING / RUNNING
+ScheduleProgress scheduleProgress(uint8_t zone);
+const char*      scheduleStateName(ScheduleState s);
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <stdint.h>
+
+// ===================== 타이머 휠 스케줄러 =====================
+// 주기 작업(재연결, NTP, 네트워크 폴링, 재전송 등)을 마감 시각과 함께 등록하고,
+// loop 는 다음 마감까지 잠들었다가 runDue() 로 도래한 작업만 실행한다.
+//
+// - 해시 타이머 휠: SLOTS 칸 × tickMs. 칸마다 작업 인덱스 연결 리스트
+//   (한 바퀴보다 먼 마감은 같은 칸에서 다음 바퀴까지 대기)
+// - 시계는 호출자가 넘겨주므로 millis() 와 무관 → 가상 시계로 호스트에서 돌릴 수 있다
+// - 힙 할당 없음, 단일 태스크 전용
+//
+// 작업 함수 안에서 schedule() 로 자기 자신의 다음 실행 시각을 바꿀 수 있다 (백오프 등).
+// 그렇지 않으면 주기 작업은 원래 위상을 유지한 채 다음 주기로 다시 걸린다.
+
+typedef void (*SchedFn)(void* arg);
+
+template <uint32_t SLOTS, uint32_t MAX_JOBS>
+class TimerWheel {
+  static_assert(SLOTS >= 2, "TimerWheel needs at least two slots");
+  static_assert(MAX_JOBS >= 1 && MAX_JOBS < 127, "TimerWheel job index must fit int8_t");
+
+ public:
+  struct JobStats {
+    const char* name;
+    uint32_t    runs;
+    uint32_t    lateMaxMs;   // 마감 대비 실제 실행 지연 최대값
+  };
+
+  explicit TimerWheel(uint32_t tickMs) : tickMs_(tickMs ? tickMs : 1) {
+    for (uint32_t i = 0; i < SLOTS; i++) head_[i] = -1;
+  }
+
+  void begin(uint32_t nowMs) {
+    lastNowMs_ = nowMs;
+    remMs_     = 0;
+    curTick_   = 0;
+    scanTick_  = 0;
+  }
+
+  // 반환 = 작업 id (-1 = 자리 없음). periodMs = 0 이면 한 번만 실행
+  int add(const char* name, SchedFn fn, void* arg, uint32_t periodMs, uint32_t delayMs) {
+    for (uint32_t i = 0; i < MAX_JOBS; i++) {
+      if (jobs_[i].fn) continue;
+      Job& j     = jobs_[i];
+      j.name     = name;
+      j.fn       = fn;
+      j.arg      = arg;
+      j.periodMs = periodMs;
+      j.runs     = 0;
+      j.lateMax  = 0;
+      arm((int)i, delayMs);
+      return (int)i;
+    }
+    return -1;
+  }
+
+  // 다음 실행을 delayMs 뒤로 (이미 걸려 있으면 옮긴다). 기준 시각 = 마지막 runDue()
+  void schedule(int id, uint32_t delayMs) {
+    if (!valid(id)) return;
+    if (jobs_[id].armed) unlink(id);
+    arm(id, delayMs);
+    jobs_[id].rearmed = true;
+  }
+
+  void setPeriod(int id, uint32_t periodMs) {
+    if (valid(id)) jobs_[id].periodMs = periodMs;
+  }
+
+  // 등록은 유지하고 실행만 멈춘다 (schedule() 로 다시 건다)
+  void cancel(int id) {
+    if (!valid(id)) return;
+    if (jobs_[id].armed) unlink(id);
+    jobs_[id].rearmed = true;
+  }
+
+  // nowMs 까지 도래한 작업 실행. 반환 = 실행한 작업 수
+  uint32_t runDue(uint32_t nowMs) {
+    advanceTo(nowMs);
+    uint32_t ran   = 0;
+    uint32_t steps = curTick_ - scanTick_;
+    if (steps > SLOTS) steps = SLOTS;   // 한 바퀴 이상 밀렸으면 전 칸을 한 번씩만 보면 된다
+    for (uint32_t s = 1; s <= steps; s++) {
+      uint32_t slot = (scanTick_ + s) % SLOTS;
+      int      i    = head_[slot];
+      while (i >= 0) {
+        if ((int32_t)(jobs_[i].dueTick - curTick_) <= 0) {
+          fire(i);
+          ran++;
+          i = head_[slot];   // 작업이 다른 작업을 옮겼을 수 있으므로 처음부터 다시
+        } else {
+          i = jobs_[i].next;
+        }
+      }
+    }
+    scanTick_ = curTick_;
+    return ran;
+  }
+
+  // 가장 가까운 마감까지 남은 시간 (0 = 이미 도래, UINT32_MAX = 걸린 작업 없음)
+  uint32_t msUntilNext(uint32_t nowMs) const {
+    uint32_t elapsed = (nowMs - lastNowMs_) + remMs_;   // 마지막 advance 이후 흐른 시간
+    uint32_t best    = UINT32_MAX;
+    for (uint32_t i = 0; i < MAX_JOBS; i++) {
+      if (!jobs_[i].fn || !jobs_[i].armed) continue;
+      int32_t  ticks = (int32_t)(jobs_[i].dueTick - curTick_);
+      uint32_t ms    = ticks <= 0 ? 0 : (uint32_t)ticks * tickMs_;
+      ms             = ms > elapsed ? ms - elapsed : 0;
+      if (ms < best) best = ms;
+    }
+    return best;
+  }
+
+  bool stats(int id, JobStats& out) const {
+    if (!valid(id)) return false;
+    out.name      = jobs_[id].name;
+    out.runs      = jobs_[id].runs;
+    out.lateMaxMs = jobs_[id].lateMax;
+    return true;
+  }
+
+  static constexpr uint32_t capacity() { return MAX_JOBS; }
+
+ private:
+  struct Job {
+    const char* name     = nullptr;
+    SchedFn     fn       = nullptr;
+    void*       arg      = nullptr;
+    uint32_t    periodMs = 0;
+    uint32_t    dueTick  = 0;
+    uint32_t    runs     = 0;
+    uint32_t    lateMax  = 0;
+    int8_t      next     = -1;
+    int8_t      prev     = -1;
+    bool        armed    = false;
+    bool        rearmed  = false;   // 실행 중 schedule()/cancel() 호출 여부
+  };
+
+  bool valid(int id) const { return id >= 0 && (uint32_t)id < MAX_JOBS && jobs_[id].fn; }
+
+  // 경과 시간을 틱으로 환산 (millis 랩어라운드에 안전하도록 차이만 누적)
+  void advanceTo(uint32_t nowMs) {
+    uint32_t delta = (nowMs - lastNowMs_) + remMs_;
+    lastNowMs_     = nowMs;
+    curTick_      += delta / tickMs_;
+    remMs_         = delta % tickMs_;
+  }
+
+  void arm(int id, uint32_t delayMs) {
+    Job& j = jobs_[id];
+    // 올림: 마감보다 일찍 실행되지 않게
+    uint32_t ticks = (delayMs + remMs_ + tickMs_ - 1) / tickMs_;
+    if (ticks == 0) ticks = 1;
+    j.dueTick = curTick_ + ticks;
+    link(id);
+  }
+
+  void link(int id) {
+    Job&     j    = jobs_[id];
+    uint32_t slot = j.dueTick % SLOTS;
+    j.prev        = -1;
+    j.next        = head_[slot];
+    if (j.next >= 0) jobs_[j.next].prev = (int8_t)id;
+    head_[slot] = (int8_t)id;
+    j.armed     = true;
+  }
+
+  void unlink(int id) {
+    Job&     j    = jobs_[id];
+    uint32_t slot = j.dueTick % SLOTS;
+    if (j.prev >= 0) jobs_[j.prev].next = j.next;
+    else             head_[slot]        = j.next;
+    if (j.next >= 0) jobs_[j.next].prev = j.prev;
+    j.next  = -1;
+    j.prev  = -1;
+    j.armed = false;
+  }
+
+  void fire(int id) {
+    Job&     j        = jobs_[id];
+    uint32_t lateTick = curTick_ - j.dueTick;
+    uint32_t lateMs   = lateTick * tickMs_;
+    if (lateMs > j.lateMax) j.lateMax = lateMs;
+    uint32_t due = j.dueTick;
+    unlink(id);
+    j.rearmed = false;
+    j.runs++;
+    j.fn(j.arg);
+    if (j.rearmed || j.periodMs == 0) return;
+
+    // 주기 작업: 위상 유지. 여러 주기를 놓쳤으면 건너뛰고 다음 위상으로
+    uint32_t periodTicks = (j.periodMs + tickMs_ - 1) / tickMs_;
+    if (periodTicks == 0) periodTicks = 1;
+    uint32_t next = due + periodTicks;
+    if ((int32_t)(next - curTick_) <= 0)
+      next = curTick_ + periodTicks - ((curTick_ - due) % periodTicks);
+    j.dueTick = next;
+    link(id);
+  }
+
+  uint32_t tickMs_;
+  uint32_t lastNowMs_ = 0;
+  uint32_t remMs_     = 0;
+  uint32_t curTick_   = 0;
+  uint32_t scanTick_  = 0;
+  int8_t   head_[SLOTS];
+  Job      jobs_[MAX_JOBS];
+};
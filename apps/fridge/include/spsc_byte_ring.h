@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+
+// 단일 생산자 / 단일 소비자 가변 길이 레코드 링 (lock-free, 힙 할당 없음).
+// 레코드 = [길이 u16][본문], 4바이트 정렬. 끝에 자리가 모자라면 건너뛰기 표시를 남기고 처음부터 쓴다
+// → 레코드는 항상 연속된 바이트라 소비자가 복사 없이 front() 로 바로 읽는다.
+// N 은 2의 거듭제곱. head/tail 은 SpscQueue 처럼 단조 증가하는 32비트 바이트 카운터.
+// 생산자와 소비자가 같은 태스크면 가득 찼을 때 pop() 으로 오래된 것을 버리고 다시 쓸 수 있다.
+template <uint32_t N>
+class SpscByteRing {
+  static_assert(N >= 64 && (N & (N - 1)) == 0, "SpscByteRing size must be a power of two");
+
+ public:
+  static constexpr uint32_t MAX_RECORD = N / 4;   // 본문 최대 길이
+
+  // 생산자: false = 자리가 없음 (아무것도 쓰지 않음)
+  bool push(const void* data, uint16_t len) {
+    if (len == 0 || len > MAX_RECORD) return false;
+    uint32_t need = align(HDR + len);
+    uint32_t head = head_.load(std::memory_order_relaxed);
+    uint32_t pos  = head & (N - 1);
+    uint32_t room = N - pos;                       // 끝까지 남은 연속 공간 (4의 배수)
+    uint32_t skip = need > room ? room : 0;
+    if (head + skip + need - tail_.load(std::memory_order_acquire) > N) return false;
+    if (skip) {
+      putLen(pos, SKIP);
+      pos = 0;
+    }
+    putLen(pos, len);
+    memcpy(buf_ + pos + HDR, data, len);
+    head_.store(head + skip + need, std::memory_order_release);
+    return true;
+  }
+
+  // 소비자: 가장 오래된 레코드 (없으면 nullptr). pop() 전까지 유효
+  const uint8_t* front(uint16_t& len) {
+    uint32_t tail = tail_.load(std::memory_order_relaxed);
+    uint32_t head = head_.load(std::memory_order_acquire);
+    if (tail == head) return nullptr;
+    uint32_t pos = tail & (N - 1);
+    uint16_t l   = getLen(pos);
+    if (l == SKIP) {
+      tail += N - pos;
+      tail_.store(tail, std::memory_order_release);
+      if (tail == head) return nullptr;
+      pos = 0;
+      l   = getLen(0);
+    }
+    len = l;
+    return buf_ + pos + HDR;
+  }
+
+  void pop() {
+    uint16_t len;
+    if (!front(len)) return;
+    uint32_t tail = tail_.load(std::memory_order_relaxed);
+    tail_.store(tail + align(HDR + len), std::memory_order_release);
+  }
+
+  // 소비자: 지우지 않고 훑기. cursor = begin() 부터, 레코드를 돌려줄 때마다 다음 위치로 (끝이면 nullptr)
+  uint32_t begin() const { return tail_.load(std::memory_order_relaxed); }
+  const uint8_t* next(uint32_t& cursor, uint16_t& len) const {
+    uint32_t head = head_.load(std::memory_order_acquire);
+    if (cursor == head) return nullptr;
+    uint32_t pos = cursor & (N - 1);
+    uint16_t l   = getLen(pos);
+    if (l == SKIP) {
+      cursor += N - pos;
+      if (cursor == head) return nullptr;
+      pos = 0;
+      l   = getLen(0);
+    }
+    len     = l;
+    cursor += align(HDR + l);
+    return buf_ + pos + HDR;
+  }
+
+  bool     empty() const { return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire); }
+  uint32_t used() const  { return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire); }
+  static constexpr uint32_t capacity() { return N; }
+
+ private:
+  static constexpr uint32_t HDR  = 2;
+  static constexpr uint16_t SKIP = 0xFFFF;
+
+  static constexpr uint32_t align(uint32_t n) { return (n + 3u) & ~3u; }
+  void     putLen(uint32_t pos, uint16_t len) { memcpy(buf_ + pos, &len, HDR); }
+  uint16_t getLen(uint32_t pos) const { uint16_t l; memcpy(&l, buf_ + pos, HDR); return l; }
+
+  alignas(4) uint8_t    buf_[N];
+  std::atomic<uint32_t> head_{0};
+  std::atomic<uint32_t> tail_{0};
+};
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <Arduino.h>
+#include <MQTTClient.h>
+#include <Preferences.h>
+#include "config.h"
+#include "pid_core.h"
+
+// ===== PID State (제어 태스크 소유) =====
+// 한계값은 config.h 의 constexpr 값으로 컴파일 시 고정
+struct PeltierPidLimits {
+  static constexpr float kp          = PID_KP_DEFAULT;
+  static constexpr float ki          = PID_KI_DEFAULT;
+  static constexpr float kd          = PID_KD_DEFAULT;
+  static constexpr float integralMin = PID_INTEGRAL_MIN;
+  static constexpr float integralMax = PID_INTEGRAL_MAX;
+  static constexpr float deadband    = PID_DEADBAND;
+  static constexpr float dt          = PID_COMPUTE_SEC;
+  static constexpr int   outMax      = PELTIER_ABS_MAX_PWM;
+};
+typedef FixedQ<PID_Q_FRAC_BITS>                      PidQ;
+typedef PidCore<PidQ, PeltierPidLimits>             PeltierPid;
+typedef PidBank<PidQ, PeltierPidLimits, ZONE_COUNT> PeltierPidBank;
+static_assert(PID_GAIN_MAX * PELTIER_ABS_MAX_PWM / 100.0f < (float)(INT32_MAX >> PID_Q_FRAC_BITS),
+              "PID_GAIN_MAX does not fit the fixed-point gains");
+
+// /pid 와 NVS 에서 읽은 게인 검사: 유한값, 0 이상 (음수면 제어 방향이 뒤집힌다), PID_GAIN_MAX 이하
+inline bool pidGainValid(float g) { return isfinite(g) && g >= 0.0f && g <= PID_GAIN_MAX; }
+
+// 존별 배열 (SoA): 제어 루프가 존을 차례로 훑을 때 같은 필드끼리 연속으로 놓인다
+struct PIDState {
+  float kp[ZONE_COUNT];              // /pid 로 조회/변경하는 게인 (%/°C 단위)
+  float ki[ZONE_COUNT];
+  float kd[ZONE_COUNT];
+  PeltierPidBank core;               // 적분/미분 이력 + PWM 단위로 환산된 게인
+  float outputPct[ZONE_COUNT];       // 0~100 (%) 보고용
+  int   outputPWM[ZONE_COUNT];       // 0~PELTIER_ABS_MAX_PWM 목표 듀티 (LEDC 는 구동 틱이 슬루/디더링해서 씀)
+  bool  coolingActive[ZONE_COUNT];   // 냉각 중 여부 (히스테리시스용)
+
+  PIDState() {
+    for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+      kp[z]            = PID_KP_DEFAULT;
+      ki[z]            = PID_KI_DEFAULT;
+      kd[z]            = PID_KD_DEFAULT;
+      outputPct[z]     = 0.0f;
+      outputPWM[z]     = 0;
+      coolingActive[z] = false;
+    }
+  }
+};
+extern PIDState pid;
+
+// ===== State =====
+// 존별 최신 상태 (loop 태스크 소유, 제어 스냅샷으로 갱신)
+struct ZoneStatus {
+  float    temp           = NAN;
+  float    humidity       = NAN;
+  float    tempRaw        = NAN;     // 필터 전 측정값
+  float    tempRate       = 0.0f;    // 추정 변화율 (°C/s)
+  int      power          = 0;       // 0~100 (%) PID 출력
+  bool     hasTarget      = false;
+  float    target         = 0.0f;
+  bool     peltierEnabled = true;
+};
+extern ZoneStatus gZone[ZONE_COUNT];
+
+// 장치 공통
+struct StatusState {
+  uint32_t uptimeSec      = 0;
+  int      wifiRssi       = 0;
+  bool     mqttConnected  = false;
+  uint64_t tsMs           = 0;       // unix ms (0 = 시각 모름, timesync.h)
+  // 힙 상태 (소크 테스트에서 평평하게 유지되는지 확인용)
+  uint32_t heapFree       = 0;
+  uint32_t heapMaxBlock   = 0;       // 가장 큰 연속 블록 (단편화 지표)
+  uint32_t heapMinFree    = 0;       // 부팅 이후 최저 여유 힙
+};
+extern StatusState gStatus;
+
+// ===== 제어 태스크 → 네트워크 태스크 스냅샷 =====
+struct ControlSnapshot {
+  uint8_t  zone           = 0;
+  uint32_t seq            = 0;
+  uint32_t ms             = 0;       // 스냅샷 생성 시각 (millis)
+  float    temp           = NAN;     // 필터 추정값
+  float    humidity       = NAN;
+  float    tempRaw        = NAN;     // 마지막 측정값 (범위 체크 통과분)
+  float    humidityRaw    = NAN;
+  float    tempRate       = 0.0f;    // 추정 온도 변화율 (°C/s)
+  bool     sensorOk       = false;   // 이번 주기 센서 읽기 성공 여부
+  int      power          = 0;       // 0~100 (%)
+  float    kp             = PID_KP_DEFAULT;
+  float    ki             = PID_KI_DEFAULT;
+  float    kd             = PID_KD_DEFAULT;
+  float    integral       = 0.0f;
+  float    outputPct      = 0.0f;
+  int      outputPWM      = 0;
+  bool     coolingActive  = false;
+  // 제어 주기 지터 (us): 실제 주기 - CONTROL_PERIOD_MS (제어 태스크 공통, 모든 존에 같은 값)
+  uint32_t jitterMaxUs    = 0;
+  uint32_t jitterAvgUs    = 0;
+  uint32_t execMaxUs      = 0;       // 한 주기 실행 시간 최대값
+  uint32_t overruns       = 0;       // 주기를 놓친 횟수
+  uint32_t snapDrops      = 0;       // 스냅샷 큐가 가득 차 버린 횟수
+  uint32_t pidStarts      = 0;       // 냉각 START 전이 누적
+  uint32_t pidStops       = 0;       // 냉각 STOP 전이 누적
+  // 센서 실패/거부 사유별 누적 (존별)
+  uint32_t sensorNoResponse   = 0;
+  uint32_t sensorTimingErrs   = 0;
+  uint32_t sensorChecksumErrs = 0;   // 통신은 됐지만 체크섬 불일치
+  uint32_t sensorRangeRejects = 0;   // 디코드는 됐지만 물리 범위 밖
+  uint32_t sensorOutliers     = 0;   // 필터 혁신 게이트에서 거부
+  uint32_t sensorRecoveries   = 0;   // 계단 변화로 판단해 필터 재초기화
+};
+extern ControlSnapshot gControl[ZONE_COUNT];   // 네트워크 태스크 쪽 존별 최신 사본
+
+extern char lastRestartCmdId[CMD_ID_MAX];
+
+// ===== Objects (main.cpp / sim_main.cpp 에서 정의) =====
+extern Preferences prefs;
+extern MQTTClient  mqtt;
+
+// unix 초 (0 = 시각 모름). timesync.cpp
+uint32_t nowUnix();
+
+// ===== 플랫폼 훅 (main.cpp / sim_main.cpp 에서 정의) =====
+void updateRuntimeFields();
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "telemetry_buffer.h"
+
+// ===================== 바이너리 상태 배치 (v1) =====================
+// 하드웨어와 무관한 순수 인코더/디코더. 스키마 정의는 packages/protocol 의
+// decodeStatusBatch() 와 짝을 이룬다. 바이트 순서는 리틀 엔디언.
+//
+//   헤더 14바이트
+//     0  u8   version (= STATUS_BATCH_VERSION)
+//     1  u8   count (샘플 수, 1 이상)
+//     2  u8   flags (bit0 = peltier_enabled)
+//     3  u8   reserved (0)
+//     4  u32  첫 샘플 ts (unix 초, 0 = NTP 미동기)
+//     8  i16  첫 샘플 temp  (0.1°C, INT16_MIN = null)
+//     10 i16  첫 샘플 humidity (0.1%, INT16_MIN = null)
+//     12 i16  target (0.1°C, INT16_MIN = null, 배치 내 고정)
+//   샘플 4바이트 × count (첫 샘플은 dt/델타 0)
+//     u8 dt (직전 샘플과의 간격, 초)
+//     i8 temp 델타 (0.1°C, 직전 샘플 기준)
+//     i8 humidity 델타 (0.1%, 직전 샘플 기준)
+//     u8 power (bit0~6 = 0~100%, bit7 = 냉각 중)
+//
+// target / peltier_enabled / null 여부가 바뀌거나, 간격·델타가 필드 범위를 넘으면
+// 그 샘플부터 새 배치를 시작한다.
+
+static const uint8_t  STATUS_BATCH_VERSION     = 1;
+static const size_t   STATUS_BATCH_HEADER_SIZE = 14;
+static const size_t   STATUS_BATCH_SAMPLE_SIZE = 4;
+static const uint32_t STATUS_BATCH_MAX_SAMPLES = 255;
+
+class StatusBatch {
+ public:
+  void clear() { n_ = 0; }
+
+  // false = 가득 찼거나 배치 규칙상 이 샘플은 새 배치에서 시작해야 함
+  bool tryAdd(const StatusRecord& r, uint32_t ms, uint32_t maxSamples);
+
+  // 직렬화된 길이 반환 (cap 부족 시 0)
+  size_t encode(uint8_t* out, size_t cap) const;
+
+  uint32_t count() const      { return n_; }
+  bool     empty() const      { return n_ == 0; }
+  uint32_t firstMs() const    { return firstMs_; }
+  static constexpr size_t encodedSize(uint32_t n) { return STATUS_BATCH_HEADER_SIZE + n * STATUS_BATCH_SAMPLE_SIZE; }
+
+ private:
+  StatusRecord first_;
+  StatusRecord prev_;
+  uint32_t     firstMs_ = 0;
+  uint32_t     prevMs_  = 0;    // 초 단위로 반올림해 누적한 시각 (누적 오차 방지)
+  uint32_t     n_       = 0;
+  uint8_t      samples_[STATUS_BATCH_MAX_SAMPLES][STATUS_BATCH_SAMPLE_SIZE];
+};
+
+// 검증/도구용 디코더. out 에 최대 max 개, 반환 = 디코드한 샘플 수 (형식 오류 시 -1)
+int statusBatchDecode(const uint8_t* buf, size_t len, StatusRecord* out, size_t max);
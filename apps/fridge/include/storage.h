@@ -0,0 +1,33 @@
+#pragma once
+
+#include "state.h"
+#include "schedule.h"
+
+// ===== NVS 영속화 (write-behind) =====
+// store*() 는 RAM 의 사본만 바꾸고 dirty 표시만 한다 (명령 응답 경로에서 플래시 접근 없음).
+// storageTick() 이 변경이 NVS_COALESCE_MS 동안 잠잠해지면 (늦어도 NVS_MAX_DELAY_MS 안에)
+// 존마다 전체 상태를 blob 하나로 한 번에 기록한다. NVS 는 항목 단위로 원자적이므로
+// 목표/펠티어/게인/재시작 id 가 섞인 중간 상태로 남지 않는다.
+
+struct StorageStats {
+  uint32_t requests;        // store*() 호출 수 (부팅 이후)
+  uint32_t commits;         // 실제 플래시 기록 수 (부팅 이후)
+  uint32_t skipped;         // 기록 시점에 값이 이전 기록과 같아 건너뛴 횟수
+  uint32_t failures;        // 기록 실패
+  uint32_t lifetimeWrites;  // 누적 기록 수, 전 존 합계 (blob 안에 함께 저장, 마모 추정용)
+  bool     pending;         // 아직 기록되지 않은 변경 있음
+};
+
+void loadFromNVS();   // 존별 gZone / pid 게인 + lastRestartCmdId 복원 (제어 태스크 시작 전)
+
+void storeTarget(uint8_t zone, bool hasTarget, float target);
+void storePeltierEnabled(uint8_t zone, bool en);
+void storePidGains(uint8_t zone, float kp, float ki, float kd);
+void storeRestartCmdId(const char* id);   // 장치 공통 (존 0 blob)
+// 발효 스케줄은 같은 네임스페이스의 별도 키 (업로드/취소 때만 바뀌므로 상태 blob 과 따로 기록)
+void storeSchedule(uint8_t zone, const FermSchedule& s);
+bool storedSchedule(uint8_t zone, FermSchedule& out);   // loadFromNVS 로 읽은 값 (없으면 false)
+
+void         storageTick();    // 스케줄러가 NVS_TICK_MS 마다 호출
+void         storageFlush();   // 재시작 / OTA 직전: 대기 중인 변경을 즉시 기록
+StorageStats storageStats();
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "state.h"
+#include "mqtt_out.h"
+#include "report_policy.h"
+#include "text_writer.h"
+
+enum AckValueMode : uint8_t {
+  ACK_VALUE_NONE  = 0,
+  ACK_VALUE_FLOAT = 1,
+  ACK_VALUE_NULL  = 2,
+  ACK_VALUE_BOOL  = 3
+};
+
+// 호출자가 준 고정 버퍼에 직렬화 (힙 할당 없음). 반환 = 길이 (NUL 제외)
+static const size_t STATUS_JSON_MAX = 1536;   // extras 포함 /status 응답 최대 길이 (4존 ~1320B)
+// reason = 주기 발행 사유 (report_policy.h), /status 응답에는 없음
+size_t buildStatusJson(uint8_t zone, char* out, size_t cap, bool includeExtras, const char* reason = nullptr);
+size_t buildHealthJson(char* out, size_t cap, bool ok, const char* errCodeOrNull);
+
+void publishAck(uint8_t zone, const char* id, const char* cmd, bool success,
+                const char* errorOrNull,
+                AckValueMode valueMode = ACK_VALUE_NONE,
+                float fvalue = 0.0f, bool bvalue = false,
+                MqttOutDone done = nullptr);   // 브로커가 받음 / 포기 (재시작 ack 용)
+bool publishStatus(uint8_t zone, ReportReason reason);
+// 명령 적용 직후처럼 다음 스냅샷을 기다리지 않고 보고 정책을 확인할 때 (연결돼 있을 때만)
+void statusReportNow(uint8_t zone);
+
+// /metrics 응답 (Prometheus 텍스트 형식) = buildMetricsText + buildSchedMetrics. 버퍼가 모자라면 넣을 수 있는 데까지.
+// 크기는 모든 값이 최대 자릿수일 때 (정수 11자리, _sum 20자리, 명령 종류별 요약 전부) 기준이다:
+//   존 하나일 때 ~15.7KB + 존이 늘 때마다 ~570B + 스케줄러 작업당 ~110B, 각각 여유 ~1/8.
+// 시뮬레이터가 실행 끝마다 최악 크기를 계산해 넘으면 실패로 끝난다 ([SIM] metrics worst)
+static const size_t METRICS_SCHED_JOBS_MAX = 12;   // 보고하는 스케줄러 작업 수 상한 (펌웨어 7, 시뮬레이터 9)
+static const size_t METRICS_TEXT_MAX = 17920 + (ZONE_COUNT - 1) * 640 + METRICS_SCHED_JOBS_MAX * 128;
+size_t buildMetricsText(char* out, size_t cap);
+
+// /metrics 뒤에 붙는 작업별 실행 횟수 / 최대 지연. Wheel = TimerWheel (scheduler.h)
+template <class Wheel>
+size_t buildSchedMetrics(const Wheel& sched, char* out, size_t cap) {
+  TextWriter tw(out, cap);
+  typename Wheel::JobStats js;
+  for (uint32_t i = 0; i < sched.capacity(); i++) {
+    if (!sched.stats((int)i, js)) continue;
+    tw.put("fridge_sched_runs_total{job=\"%s\"} %lu\n", js.name, (unsigned long)js.runs);
+    tw.put("fridge_sched_late_max_ms{job=\"%s\"} %lu\n", js.name, (unsigned long)js.lateMaxMs);
+  }
+  return tw.ok ? tw.w : 0;
+}
+
+// 바이너리 상태 배치 토픽 (존별 status/batch) 사용 여부. 기본값 STATUS_BATCH_ENABLED
+void setStatusBatchEnabled(bool on);
+bool statusBatchEnabled();
+
+// loop() 가 깨어날 때마다 호출 (제어 태스크 알림 포함): 스냅샷 수신 → gZone 갱신 → 존별 상태 발행
+void statusTick();
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+#include "state.h"
+
+// ===================== 분 단위 집계 =====================
+// 제어 스냅샷(2초)을 하나도 버리지 않고 존별 STATUS_AGG_WINDOW_SEC 창으로 묶는다.
+// 창이 닫히면 대기 링에 넣고, MQTT 가 연결돼 있으면 오래된 것부터 status/agg 로 발행
+// (끊긴 동안은 STATUS_AGG_BACKLOG 개까지 보관, 넘치면 가장 오래된 것을 버림).
+// loop 태스크 전용.
+
+// 닫힌 창 하나 (대기 링에 보관하는 형태, 0.1 단위 정수)
+struct StatusAggregate {
+  uint32_t ts;            // 창 시작 (unix 초, 닫힐 때까지도 시각을 모르면 0)
+  uint16_t samples;       // 창 안의 스냅샷 수
+  uint16_t coolSec;       // 냉각 ON 누적 (초)
+  int16_t  tMin10, tMax10, tMean10;   // 0.1°C, STATUS_AGG_NULL16 = 유효 샘플 없음
+  int16_t  hMin10, hMax10, hMean10;   // 0.1%
+  int16_t  target10;      // 창이 닫힐 때 목표 (STATUS_AGG_NULL16 = 없음)
+  uint16_t outMean10;     // pid outputPct 평균 (0.1%)
+  uint16_t outMax10;
+  uint16_t rejects;       // 센서 실패/거부 (무응답, 타이밍, 체크섬, 범위, 필터 이상치)
+  uint32_t energyMwh;     // PWM 듀티 × PELTIER_RATED_W 적산 (mWh)
+};
+
+static const int16_t STATUS_AGG_NULL16 = INT16_MIN;
+
+struct AggStats {
+  uint32_t windows;       // 닫힌 창
+  uint32_t published;
+  uint32_t pending;       // 발행 대기
+  uint32_t dropped;       // 대기 링이 넘쳐 버림
+  uint32_t publishFails;
+};
+
+void aggBegin();
+// statusTick() 에서 스냅샷마다. 창 경계를 넘으면 이전 창을 닫는다
+void aggAdd(const ControlSnapshot& s);
+// 연결돼 있으면 밀린 집계를 STATUS_AGG_PUBLISH_MAX 개까지 발행
+void aggFlush();
+size_t   buildAggregateJson(const StatusAggregate& a, char* out, size_t cap);
+void     setStatusAggEnabled(bool on);
+bool     statusAggEnabled();
+AggStats aggStats();
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+
+// ===================== 상태 기록 저장 후 전달 =====================
+// MQTT 가 끊긴 동안의 상태를 고정 크기 RAM 링에 쌓아두고(가득 차면 플래시로 넘김),
+// 재연결 후 오래된 순서대로 배치 메시지로 속도를 제한해 다시 보낸다.
+// 시각을 모를 때 만든 기록은 단조 시각(초)을 넣고 STATUS_REC_FLAG_MONO 로 표시해 두었다가,
+// 보낼 때 timeAt() 으로 unix 초를 붙인다. 스필 색인은 RAM 에만 있어 기록이 재부팅을 넘지 않으므로
+// 단조 시각은 늘 이번 부팅 기준이다. 시각을 알기 전에는 보내지 않는다.
+
+// 압축 상태 기록 (12바이트)
+struct StatusRecord {
+  uint32_t ts;         // unix 초 (STATUS_REC_FLAG_MONO 면 단조 시각(초), 보낼 때 변환)
+  int16_t  temp10;     // 0.1°C, STATUS_REC_NULL16 = null
+  int16_t  hum10;      // 0.1%,  STATUS_REC_NULL16 = null
+  int16_t  target10;   // 0.1°C, STATUS_REC_NULL16 = null
+  uint8_t  power;      // 0~100 (%)
+  uint8_t  flags;      // STATUS_REC_FLAG_* + 존 번호 (STATUS_REC_ZONE_SHIFT)
+};
+static_assert(sizeof(StatusRecord) == 12, "StatusRecord must stay 12 bytes");
+
+static const int16_t STATUS_REC_NULL16         = INT16_MIN;
+static const uint8_t STATUS_REC_FLAG_PELTIER   = 0x01;   // peltier_enabled
+static const uint8_t STATUS_REC_FLAG_COOLING   = 0x02;   // 냉각 중
+static const uint8_t STATUS_REC_FLAG_MONO      = 0x08;   // ts = 단조 시각 (기기 안에서만, 발행 안 함)
+static const uint8_t STATUS_REC_FLAG_MASK      = 0x07;   // 발행하는 플래그 (존 / MONO 비트 제외)
+static const uint8_t STATUS_REC_ZONE_SHIFT     = 4;      // bit4~5 = 존 번호 (토픽으로 구분하므로 발행 안 함)
+static const uint8_t STATUS_REC_ZONE_MASK      = 0x30;
+static_assert(ZONE_MAX <= 4, "StatusRecord zone bits hold at most 4 zones");
+
+struct BufferStats {
+  uint32_t ramCount;
+  uint32_t ramCapacity;
+  uint32_t spillCount;
+  uint32_t spillCapacity;
+  uint32_t highWater;      // RAM + 플래시 최대 적재량
+  uint32_t buffered;       // 누적 저장
+  uint32_t replayed;       // 누적 재전송
+  uint32_t dropped;        // 공간 부족으로 버린 기록
+  uint32_t batches;        // 발행한 배치 메시지 수
+  uint32_t publishFails;   // 배치 발행 실패
+  uint32_t backstamped;    // 시각을 모를 때 만들어 보낼 때 시각을 붙인 기록
+};
+
+// 현재 gStatus/gZone[zone]/gControl[zone] 으로 기록 생성 (시각을 모르면 단조 시각 + STATUS_REC_FLAG_MONO)
+StatusRecord makeStatusRecord(uint8_t zone);
+inline uint8_t statusRecordZone(const StatusRecord& r) {
+  return (uint8_t)((r.flags & STATUS_REC_ZONE_MASK) >> STATUS_REC_ZONE_SHIFT);
+}
+
+void bufferBegin();
+// MQTT 끊김 중 (또는 시각을 기다리는 동안) statusTick() 에서 호출. 존마다 TELEMETRY_RECORD_MS 간격으로만 저장
+void bufferStore(const StatusRecord& r);
+// MQTT 연결 중 스케줄러가 TELEMETRY_DRAIN_MS 마다 호출.
+// 호출당 가장 오래된 기록 묶음 하나를 존별 backlog 토픽으로 나눠 발행하고, 모두 PUBACK 을 받으면 지운다
+// (그 전까지는 다음 묶음을 보내지 않음). 시각을 모르는 동안은 보내지 않는다
+bool bufferDrain();
+bool bufferEmpty();
+BufferStats bufferStats();
+
+// ===== 플래시 스필 저장소 (ESP32: telemetry_spill.cpp / native: sim/spill_sim.cpp) =====
+bool     spillBegin();
+bool     spillAppend(const StatusRecord& r);             // false = 가득 참 / 미사용
+size_t   spillPeek(StatusRecord* out, size_t max);      // 오래된 순으로 복사 (제거 안 함)
+void     spillConsume(size_t n);
+uint32_t spillCount();
+uint32_t spillCapacity();
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+
+// 고정 버퍼에 printf 로 이어 쓰기 (힙 할당 없음).
+// 넘치면 이후 쓰기는 무시되고 ok=false
+struct TextWriter {
+  char*  p;
+  size_t cap;
+  size_t w;
+  bool   ok;
+
+  TextWriter(char* buf, size_t n) : p(buf), cap(n), w(0), ok(n > 0) {
+    if (n) buf[0] = '\0';
+  }
+
+  void put(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+    if (!ok) return;
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(p + w, cap - w, fmt, ap);
+    va_end(ap);
+    if (n < 0 || (size_t)n >= cap - w) {
+      ok     = false;
+      p[w]   = '\0';   // 잘린 줄은 남기지 않음
+      return;
+    }
+    w += (size_t)n;
+  }
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+
+// ===================== 시각 (SNTP) =====================
+// 단조 시계(부팅 후 ms, 뒤로 가지 않음) 위에 unix ms 모델을 얹는다:
+//   unix(m) = anchorUnix + (m - anchorMono) × (1 - drift) + slew
+//   - SNTP: loop 의 ntp 작업이 요청을 보내고 SCHED_TICK_MS 마다 응답을 확인한다 (기다리며 막지 않음).
+//     응답은 mode / stratum / LI / originate(쿠키) 를 확인하고, 왕복이 NTP_RTT_MAX_MS 를 넘으면 버린다.
+//   - 위상: 오차가 TIME_STEP_MS 보다 크면 한 번에 맞추고(step), 작으면 TIME_SLEW_MS_PER_S 속도로 천천히.
+//     SNTP 로 맞춘 뒤에는 nowUnixMs() 가 뒤로 가지 않는다.
+//   - 주파수: 기준 샘플과의 (서버 경과 - 단조 경과) 로 기기 시계 드리프트를 추정해 모델에 반영.
+//     오차가 작으면 폴링 간격을 NTP_POLL_MIN_MS 부터 NTP_REFRESH_MS 까지 두 배씩 늘린다.
+//   - 동기 전에는 웜 부팅 기록(warmEpochMs)으로, 그것도 없으면 0 (= 모름).
+//     부팅 직후 TIME_SYNC_WAIT_MS 동안 시각을 모르면 timeHolding() 이 참: 상태는 단조 시각으로 버퍼에
+//     두었다가 동기 후 timeAt() 으로 시각을 붙여 보낸다.
+// loop 태스크 전용.
+
+enum TimeSource : uint8_t {
+  TIME_NONE,   // 모름 (nowUnixMs() = 0)
+  TIME_WARM,   // 재부팅 전 SNTP 기준 + RTC 타이머
+  TIME_SNTP,
+};
+
+struct TimeStats {
+  TimeSource source;
+  int32_t    offsetMs;      // 마지막 샘플의 오차 (서버 - 기기, 반영 전)
+  int32_t    driftPpb;      // 추정 드리프트 (+ = 기기 시계가 빠름)
+  uint32_t   rttMs;         // 마지막 샘플 왕복
+  uint32_t   pollMs;        // 현재 폴링 간격
+  uint32_t   lastSyncMs;    // 마지막 샘플 반영 시각 (단조, 0 = 아직)
+  uint32_t   firstSyncMs;   // 부팅 → 첫 SNTP 동기 (0 = 아직)
+  uint32_t   requests;
+  uint32_t   syncs;         // 반영한 샘플
+  uint32_t   timeouts;
+  uint32_t   rejects;       // 형식 / 쿠키 / stratum / 왕복 초과로 버린 응답
+  uint32_t   steps;         // 한 번에 맞춘 횟수 (첫 동기 포함)
+};
+
+void        timeBegin();        // 부팅 시 (웜 부팅 기록이 있으면 그 시각에서 시작)
+uint32_t    timeTick();         // ntp 작업: 할 일을 하고 다음 호출까지 ms 를 돌려준다
+uint64_t    timeMonoMs();       // 부팅 후 ms (단조)
+uint64_t    nowUnixMs();        // 0 = 모름
+uint64_t    timeAt(uint64_t monoMs);   // 단조 시각 → unix ms (지나간 시각에 붙이기, 0 = 모름)
+bool        timeSynced();       // 이번 부팅에 SNTP 로 맞춤
+bool        timeHolding();      // 시각을 몰라 발행을 미루는 중
+TimeStats   timeStats();
+const char* timeSourceName(TimeSource s);
+
+// ---------- 플랫폼 (ESP32: sntp_net.cpp, 네이티브: sim/sntp_sim.cpp) ----------
+// 요청 하나 보냄: 1 = 보냄, 0 = 아직 못 보냄 (DNS 조회 중), -1 = 실패
+int sntpNetSend(const uint8_t* pkt, size_t len);
+// 받은 데이터그램 하나 (논블로킹): 바이트 수, 0 = 없음
+int sntpNetRecv(uint8_t* buf, size_t cap);
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stdint.h>
+
+// ===================== 1차원 칼만 필터 (값 + 변화율) =====================
+// 등속 모델: x = [값, 변화율/s], 가속도를 백색 잡음으로 보는 과정 잡음.
+// 하드웨어와 무관한 순수 코드 (제어 태스크 / 시뮬레이터 / 벤치에서 그대로 사용).
+//
+// 이상치 판정은 혁신(측정 - 예측)이 gateSigma × sqrt(S) 를 넘는지로 한다.
+// 고정 임계값과 달리 판정 기준이 예측 불확실성을 따라가므로,
+// 측정이 빠지거나 거부될수록 P 가 커져 게이트가 자연히 넓어진다.
+//
+// 복구: 연속 recoverN 회 거부됐고 그 값들이 서로 recoverBand 이내로 모여 있으면
+// 진짜 계단 변화(문 열림, 센서 재연결)로 보고 마지막 측정값으로 재초기화한다.
+
+struct TrackFilterParams {
+  float   measNoise;     // 측정 잡음 표준편차
+  float   accelNoise;    // 가속도(변화율의 변화) 표준편차 /s²
+  float   gateSigma;     // 혁신 게이트 (표준편차 배수)
+  uint8_t recoverN;      // 이 횟수 연속 거부되면 복구 검사
+  float   recoverBand;   // 연속 거부값들이 이 범위 안에 모여 있어야 복구
+};
+
+enum TrackResult : uint8_t {
+  TRACK_INIT      = 0,   // 첫 측정 → 초기화
+  TRACK_ACCEPTED  = 1,
+  TRACK_OUTLIER   = 2,   // 거부 (예측값 유지)
+  TRACK_RECOVERED = 3    // 계단 변화로 판단, 재초기화
+};
+
+class TrackFilter {
+ public:
+  explicit TrackFilter(const TrackFilterParams& p) : p_(p) {}
+
+  void reset();
+  // dtSec = 직전 update 이후 경과 시간 (읽기 실패로 건너뛴 주기 포함)
+  TrackResult update(float z, float dtSec);
+
+  bool  ready() const { return ready_; }
+  float value() const { return x_; }
+  float rate() const { return v_; }                // 단위/s
+  float innovation() const { return lastInnov_; }  // 마지막 혁신 (측정 - 예측)
+
+ private:
+  void init(float z);
+
+  TrackFilterParams p_;
+  bool    ready_     = false;
+  float   x_         = 0.0f;
+  float   v_         = 0.0f;
+  float   p00_       = 0.0f;   // 공분산 (대칭: p01 = p10)
+  float   p01_       = 0.0f;
+  float   p11_       = 0.0f;
+  float   lastInnov_ = 0.0f;
+  uint8_t outlierRun_ = 0;
+  float   outlierMin_ = 0.0f;
+  float   outlierMax_ = 0.0f;
+};
+
+const char* trackResultName(TrackResult r);
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdint.h>
+#include "state.h"
+
+// ===================== 웜 부팅 =====================
+// 리셋해도 지워지지 않는 메모리(ESP32 RTC_NOINIT_ATTR, 네이티브는 재부팅을 넘어 남는 정적 변수)에
+// 다음 부팅을 빠르게 할 정보를 남긴다.
+//   - 네트워크 (loop 태스크): 마지막 AP 의 채널/BSSID, DHCP 로 받은 주소, SNTP 시각 기준
+//     → 스캔 없이 바로 결합, (WARM_REUSE_IP 면) DHCP 생략, SNTP 응답 전에도 ts 를 채움
+//   - 제어 (제어 태스크): 존별 PID 적분/직전 오차/출력, 냉각 여부, 그때의 목표
+//     → 첫 센서 읽기를 기다리지 않고 재시작 전 듀티로 다시 켜고, 히스테리시스도 이어서
+// 영역마다 쓰는 태스크가 하나뿐이라 CRC 도 따로. 쓰는 도중 리셋되면 그 영역만 콜드 부팅.
+// 전원 투입(POWERON) 리셋이거나 제어 기록이 WARM_MAX_AGE_MS 보다 오래됐으면 쓰지 않는다.
+
+struct WarmWifi {
+  uint8_t  bssid[6];
+  uint8_t  channel;
+  uint32_t ip;        // 마지막 DHCP 결과 (IPAddress 의 uint32_t 값 그대로)
+  uint32_t gateway;
+  uint32_t subnet;
+  uint32_t dns;
+};
+
+struct WarmZone {
+  PidQ::T integral;
+  PidQ::T prevError;
+  PidQ::T output;
+  float   target;          // 기록 당시 목표 (NVS 목표와 다르면 복원하지 않음)
+  bool    coolingActive;
+};
+
+// 부팅 시각(0) 기준 ms. 0 = 아직
+struct BootInfo {
+  const char* reason;          // 리셋 사유 (poweron / sw / panic / wdt / brownout / ...)
+  bool        wifiCached;      // 채널/BSSID 캐시로 결합 시도
+  uint8_t     zonesRestored;   // 제어 상태를 복원한 존 수 (0 = 콜드)
+  uint32_t    wifiMs;          // 부팅 → WiFi 연결
+  uint32_t    firstPwmMs;      // 부팅 → 첫 펠티어 출력
+  uint32_t    firstPublishMs;  // 부팅 → 첫 상태 발행
+};
+
+// setup() 맨 앞에서 (리셋 사유 확인 + 기록 검증 + 부팅 시각 기준)
+void     warmBegin();
+BootInfo bootInfo();
+
+// ---- loop 태스크 ----
+bool     warmWifi(WarmWifi& out);
+void     warmSaveWifi(const WarmWifi& w);
+void     warmForgetWifi();                  // 캐시로 결합 실패 (AP 가 채널을 바꿨거나 사라짐)
+void     warmSaveEpoch(uint64_t unixMs);    // SNTP 샘플 반영 직후 (timesync.cpp)
+uint64_t warmEpochMs();                     // SNTP 전 시각 추정 (unix ms, 0 = 모름)
+void     bootMarkWifi();
+void     bootMarkPublish();
+
+// ---- 제어 태스크 ----
+bool warmZone(uint8_t z, WarmZone& out);          // 이번 부팅에 쓸 수 있는 기록 (controlBegin 에서)
+void warmSaveControl(const WarmZone* zones);      // ZONE_COUNT 개, 제어 주기마다
+void warmNoteRestored();                          // warmZone() 으로 복원한 존마다 한 번
+void bootMarkPwm();
+
+// 네이티브: 시뮬레이터 --cold-boot (재부팅마다 기록을 버려서 비교)
+void warmSetEnabled(bool on);
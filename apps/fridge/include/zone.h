@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdint.h>
+#include "config.h"
+
+// ===================== 존 =====================
+// 존별 MQTT 토픽과 이름 조회. 토픽 문자열은 처음 쓸 때 한 번만 만든다 (이후 힙/포맷 없음).
+
+enum ZoneTopic : uint8_t {
+  ZONE_TOPIC_STATUS = 0,
+  ZONE_TOPIC_CMD,
+  ZONE_TOPIC_ACK,
+  ZONE_TOPIC_STATUS_BACKLOG,
+  ZONE_TOPIC_STATUS_BATCH,
+  ZONE_TOPIC_STATUS_AGG,
+  ZONE_TOPIC_COUNT
+};
+
+inline const ZoneConfig& zoneConfig(uint8_t zone) { return ZONE_TABLE[zone]; }
+
+// 존이 하나면 /homebrew/status, 여럿이면 /homebrew/<name>/status
+const char* zoneTopic(uint8_t zone, ZoneTopic t);
+
+int zoneFromCmdTopic(const char* topic);   // 명령 토픽 → 존 번호 (-1 = 해당 없음)
+int zoneFromArg(const char* arg);          // 이름("fridge2") 또는 번호("1") → 존 번호 (-1 = 없음)
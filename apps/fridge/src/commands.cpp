@@ -0,0 +1,354 @@
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "commands.h"
+#include "control.h"
+#include "storage.h"
+#include "telemetry.h"
+#include "metrics.h"
+#include "spsc_queue.h"
+#include "id_cache.h"
+#include "json_pool.h"
+#include "report_policy.h"
+#include "schedule.h"
+#include "zone.h"
+#include "log.h"
+
+// ---------- Command pipeline ----------
+// MQTT 콜백(mqtt.loop() 안)은 페이로드를 큐에 복사만 하고, 실행은 loop 태스크의 commandsTick() 에서.
+// 처리한 명령 id 는 결과(ack)와 함께 LRU 캐시에 남겨서, QoS1 재전송 / 영속 세션 재전달로
+// 같은 id 가 다시 오면 재실행(NVS 기록, PID 적분 리셋) 없이 캐시된 ack 만 다시 보낸다.
+// 명령은 수신 토픽의 존에만 적용되고, 캐시와 ack 토픽도 존마다 따로 (restart 만 장치 전체).
+
+// ack 한 건을 다시 만들 수 있는 정보 (error 는 정적 문자열)
+struct CommandAck {
+  char         cmd[CMD_NAME_MAX] = "";
+  bool         success           = false;
+  const char*  error             = nullptr;
+  AckValueMode valueMode         = ACK_VALUE_NONE;
+  float        fvalue            = 0.0f;
+  bool         bvalue            = false;
+};
+
+struct QueuedCommand {
+  uint32_t rxCycles;                  // 수신 시각 (ack 지연 계측용)
+  uint8_t  zone;
+  uint16_t len;
+  char     payload[CMD_PAYLOAD_MAX];
+};
+
+enum ExecResult : uint8_t {
+  EXEC_DONE = 0,
+  EXEC_BUSY,      // 일시적 거부: 캐시하지 않음 (같은 id 재시도 시 다시 실행)
+  EXEC_RESTART,   // ack 발행 후 재시작
+};
+
+static SpscQueue<QueuedCommand, CMD_QUEUE_DEPTH>          cmdQueue;
+static IdLruCache<CommandAck, CMD_CACHE_SIZE, CMD_ID_MAX> ackCache[ZONE_COUNT];
+static uint32_t executedCount = 0;
+
+static ExecResult setAck(CommandAck& a, bool success, const char* error,
+                         AckValueMode mode = ACK_VALUE_NONE, float fvalue = 0.0f, bool bvalue = false) {
+  a.success   = success;
+  a.error     = error;
+  a.valueMode = mode;
+  a.fvalue    = fvalue;
+  a.bvalue    = bvalue;
+  return EXEC_DONE;
+}
+
+// 제어 상태 변경은 제어 태스크 명령 큐로 넘긴다. 큐가 가득 차면 busy 로 거부.
+static bool postToControl(const ControlCommand& c) {
+  if (controlPost(c)) return true;
+  LOG_W(CMD, "rejected: control queue full (busy)");
+  return false;
+}
+
+static ExecResult execute(uint8_t z, JsonDocument& doc, const char* id, const char* cmd,
+                          CommandAck& ack, MetricCmd& kind) {
+  ZoneStatus& zs = gZone[z];
+  // ---- set_peltier (value: true/false) ----
+  if (strcmp(cmd, "set_peltier") == 0) {
+    kind = METRIC_CMD_SET_PELTIER;
+    if (!doc.containsKey("value") || (!doc["value"].is<bool>() && !doc["value"].is<int>()))
+      return setAck(ack, false, "invalid_value");
+    bool en = doc["value"].as<bool>();
+    if (!postToControl({CTL_CMD_SET_ENABLED, en, 0.0f, 0.0f, 0.0f, z})) {
+      setAck(ack, false, "busy");
+      return EXEC_BUSY;
+    }
+    zs.peltierEnabled = en;
+    storePeltierEnabled(z, en);
+    LOG_I(CMD, "%s set_peltier -> %s", zoneConfig(z).name, en ? "true" : "false");
+    if (!en) zs.power = 0;
+    return setAck(ack, true, nullptr, ACK_VALUE_BOOL, 0.0f, en);
+  }
+
+  // ---- set_report (value: {heartbeat, temp, humidity, power}, 빠진 필드는 그대로) ----
+  // 보고 방식만 바꾸므로 펠티어가 꺼져 있어도 받는다
+  if (strcmp(cmd, "set_report") == 0) {
+    kind = METRIC_CMD_SET_REPORT;
+    JsonObject v = doc["value"].as<JsonObject>();
+    if (v.isNull()) return setAck(ack, false, "invalid_value");
+    ReportPolicy p = reportPolicy(z);
+    if (!v["heartbeat"].isNull()) {
+      int hb = v["heartbeat"] | -1;
+      if (hb < REPORT_HEARTBEAT_MIN_SEC || hb > REPORT_HEARTBEAT_MAX_SEC) return setAck(ack, false, "invalid_value");
+      p.heartbeatSec = (uint16_t)hb;
+    }
+    if (!v["temp"].isNull()) {
+      float b = v["temp"] | -1.0f;
+      if (b < 0.1f || b > 5.0f) return setAck(ack, false, "invalid_value");
+      p.tempBand = b;
+    }
+    if (!v["humidity"].isNull()) {
+      float b = v["humidity"] | -1.0f;
+      if (b < 0.5f || b > 50.0f) return setAck(ack, false, "invalid_value");
+      p.humBand = b;
+    }
+    if (!v["power"].isNull()) {
+      int b = v["power"] | -1;
+      if (b < 1 || b > 100) return setAck(ack, false, "invalid_value");
+      p.powerBand = (uint8_t)b;
+    }
+    setReportPolicy(z, p);
+    LOG_I(CMD, "%s set_report -> heartbeat=%us temp=%.2f humidity=%.1f power=%u",
+          zoneConfig(z).name, (unsigned)p.heartbeatSec, p.tempBand, p.humBand, (unsigned)p.powerBand);
+    return setAck(ack, true, nullptr);
+  }
+
+  kind = strcmp(cmd, "set_target") == 0   ? METRIC_CMD_SET_TARGET
+       : strcmp(cmd, "set_schedule") == 0 ? METRIC_CMD_SET_SCHEDULE
+       : strcmp(cmd, "restart") == 0      ? METRIC_CMD_RESTART
+                                          : METRIC_CMD_INVALID;
+
+  // 펠티어 비활성 상태에서 다른 제어 명령 거부
+  if (!zs.peltierEnabled) {
+    LOG_W(CMD, "rejected: peltier disabled (not_ready)");
+    return setAck(ack, false, "not_ready");
+  }
+
+  // ---- set_target (진행 중인 스케줄은 취소) ----
+  if (kind == METRIC_CMD_SET_TARGET) {
+    if (doc["value"].isNull()) {
+      if (!postToControl({CTL_CMD_SET_TARGET, false, 0.0f, 0.0f, 0.0f, z})) {
+        setAck(ack, false, "busy");
+        return EXEC_BUSY;
+      }
+      scheduleCancel(z);
+      zs.hasTarget = false;
+      zs.target    = 0.0f;
+      storeTarget(z, false, 0.0f);
+      zs.power = 0;
+      LOG_I(CMD, "%s set_target null -> target cleared, peltier off", zoneConfig(z).name);
+      return setAck(ack, true, nullptr, ACK_VALUE_NULL);
+    }
+    if (!doc["value"].is<float>() && !doc["value"].is<int>() && !doc["value"].is<double>())
+      return setAck(ack, false, "invalid_value");
+    float v = doc["value"].as<float>();
+    if (v < TARGET_MIN || v > TARGET_MAX) return setAck(ack, false, "invalid_value");
+    // 목표 변경 + PID 적분 리셋은 제어 태스크에서
+    if (!postToControl({CTL_CMD_SET_TARGET, true, v, 0.0f, 0.0f, z})) {
+      setAck(ack, false, "busy");
+      return EXEC_BUSY;
+    }
+    scheduleCancel(z);
+    zs.hasTarget = true;
+    zs.target    = v;
+    storeTarget(z, true, v);
+    LOG_I(CMD, "%s set_target -> %.2f", zoneConfig(z).name, v);
+    return setAck(ack, true, nullptr, ACK_VALUE_FLOAT, v);
+  }
+
+  // ---- set_schedule (value: {start?, segments: [["ramp"|"hold", 목표, 분], ...]}, null = 취소) ----
+  if (kind == METRIC_CMD_SET_SCHEDULE) {
+    if (doc["value"].isNull()) {
+      // 지금 목표에서 멈춘다 (램프 중이면 그 값으로)
+      if (scheduleActive(z)) {
+        if (!postToControl({CTL_CMD_SET_TARGET, zs.hasTarget, zs.target, 0.0f, 0.0f, z})) {
+          setAck(ack, false, "busy");
+          return EXEC_BUSY;
+        }
+        storeTarget(z, zs.hasTarget, zs.target);
+      }
+      scheduleCancel(z);
+      LOG_I(CMD, "%s set_schedule null -> cancelled", zoneConfig(z).name);
+      return setAck(ack, true, nullptr, ACK_VALUE_NULL);
+    }
+    JsonArray segs = doc["value"]["segments"].as<JsonArray>();
+    if (segs.isNull() || segs.size() == 0 || segs.size() > SCHEDULE_SEGMENTS_MAX)
+      return setAck(ack, false, "invalid_value");
+    FermSchedule fs = {};
+    fs.count = (uint8_t)segs.size();
+    uint8_t i = 0;
+    for (JsonArray g : segs) {
+      const char* k = g[0] | "";
+      float       t = g[1] | NAN;
+      long        m = g[2] | 0L;
+      if (strcmp(k, "ramp") != 0 && strcmp(k, "hold") != 0) return setAck(ack, false, "invalid_value");
+      if (!isfinite(t) || m <= 0 || m > 65535) return setAck(ack, false, "invalid_value");
+      fs.seg[i].kind     = strcmp(k, "ramp") == 0 ? SCHED_RAMP : SCHED_HOLD;
+      fs.seg[i].target10 = (int16_t)lroundf(t * 10.0f);
+      fs.seg[i].minutes  = (uint16_t)m;
+      i++;
+    }
+    // 시작 시각이 없으면 지금부터 (시각을 모르면 진행 위치를 잡을 수 없다)
+    uint32_t now   = nowUnix();
+    uint32_t start = doc["value"]["start"] | 0UL;
+    if (start == 0) start = now;
+    if (start == 0) return setAck(ack, false, "not_ready");
+    fs.startUnix = start;
+    // 첫 ramp 는 지금 목표에서 (목표가 없으면 지금 온도, 그것도 없으면 첫 구간 목표 = 계단)
+    float from = zs.hasTarget ? zs.target : isfinite(zs.temp) ? zs.temp : (float)fs.seg[0].target10 / 10.0f;
+    fs.startTarget10 = (int16_t)lroundf(from * 10.0f);
+    if (!scheduleSet(z, fs)) return setAck(ack, false, "invalid_value");
+    LOG_I(CMD, "%s set_schedule -> %u segments from %lu", zoneConfig(z).name,
+          (unsigned)fs.count, (unsigned long)start);
+    return setAck(ack, true, nullptr);
+  }
+
+  // ---- restart ----
+  if (kind == METRIC_CMD_RESTART) {
+    LOG_I(CMD, "restart requested");
+    // 재부팅 후 같은 id 가 재전달돼도 다시 재시작하지 않도록 id 를 영구 저장 (commandsBegin 이 캐시에 복원)
+    strncpy(lastRestartCmdId, id, sizeof(lastRestartCmdId) - 1);
+    lastRestartCmdId[sizeof(lastRestartCmdId) - 1] = '\0';
+    storeRestartCmdId(id);
+    storageFlush();     // 재시작 전에 대기 중인 변경까지 모두 기록
+    controlForceOff();  // 안전: 재시작 전 모든 존 펠티어 OFF
+    setAck(ack, true, nullptr);
+    return EXEC_RESTART;
+  }
+
+  return setAck(ack, false, "invalid_cmd");
+}
+
+// 재시작 ack: 브로커가 받았거나 (PUBCOMP) mqtt_out 이 포기하면 재시작해도 된다
+static bool restartAckDone = false;
+
+static void onRestartAck(uint32_t, bool ok) {
+  restartAckDone = true;
+  if (!ok) LOG_W(CMD, "restart ack not delivered");
+}
+
+static bool restartAcked() { return restartAckDone; }
+
+// 명령 역직렬화: 키와 문자열 값을 모두 복사한다 (같은 키는 한 번). set_schedule 8구간 ≈ 70 슬롯
+static JsonPool<jsonPoolBytes(1, CMD_PAYLOAD_MAX + 256)> cmdPool;
+
+static void processCommand(const QueuedCommand& q) {
+  uint32_t start = metricsCycles();
+  uint8_t  z     = q.zone;
+  LOG_D(CMD, "payload=%s", LogStr(q.payload, q.len));
+  JsonDocument doc(cmdPool.reset());
+  if (deserializeJson(doc, q.payload, q.len)) {
+    LOG_W(CMD, "JSON parse failed");
+    return;
+  }
+  const char* cmd = doc["cmd"] | "";
+  const char* id  = doc["id"]  | "";
+  if (strlen(cmd) == 0 || strlen(id) == 0) {
+    LOG_W(CMD, "missing cmd/id");
+    return;
+  }
+  // 중복 판별용 id 는 고정 크기 버퍼에 보관하므로 길이 제한
+  if (strlen(id) >= CMD_ID_MAX) {
+    LOG_W(CMD, "id too long");
+    publishAck(z, id, cmd, false, "invalid_id");
+    gCmdAckHist[METRIC_CMD_INVALID].record(metricsCyclesToUs(metricsCycles() - q.rxCycles));
+    return;
+  }
+
+  // ---- 이미 처리한 id: 캐시된 결과로 ack 만 다시 ----
+  const CommandAck* hit = ackCache[z].find(id);
+  if (hit) {
+    gMetricCounters.cmdDuplicates++;
+    LOG_I(CMD, "duplicate id=%s -> cached ack", id);
+    publishAck(z, id, hit->cmd, hit->success, hit->error, hit->valueMode, hit->fvalue, hit->bvalue);
+    gCmdAckHist[METRIC_CMD_DUPLICATE].record(metricsCyclesToUs(metricsCycles() - q.rxCycles));
+    return;
+  }
+
+  CommandAck ack;
+  MetricCmd  kind = METRIC_CMD_INVALID;
+  strncpy(ack.cmd, cmd, sizeof(ack.cmd) - 1);
+  ExecResult r = execute(z, doc, id, cmd, ack, kind);
+  executedCount++;
+  gCmdApplyHist[kind].record(metricsCyclesToUs(metricsCycles() - start));
+
+  if (r != EXEC_BUSY) ackCache[z].put(id, ack);
+  restartAckDone = false;
+  publishAck(z, id, cmd, ack.success, ack.error, ack.valueMode, ack.fvalue, ack.bvalue,
+             r == EXEC_RESTART ? onRestartAck : nullptr);
+  gCmdAckHist[kind].record(metricsCyclesToUs(metricsCycles() - q.rxCycles));
+  // 목표 / 펠티어 / 스케줄 변경은 다음 스냅샷을 기다리지 않고 바로 상태에 반영
+  if (ack.success && (kind == METRIC_CMD_SET_TARGET || kind == METRIC_CMD_SET_PELTIER ||
+                      kind == METRIC_CMD_SET_SCHEDULE)) statusReportNow(z);
+
+  if (r == EXEC_RESTART) {
+    // 발행은 큐에 넣기만 하므로, 재시작 전에 ack 의 QoS2 교환이 끝나도록 직접 돌린다.
+    // ack 가 끝나면 남은 시간 동안 같이 대기 중이던 상태 / 집계 메시지도
+    uint32_t drainStart = millis();
+    if (mqttOutDrain(MQTT_OUT_RETRY_MS, restartAcked)) {
+      uint32_t spent = millis() - drainStart;
+      if (spent < MQTT_OUT_RETRY_MS) mqttOutDrain(MQTT_OUT_RETRY_MS - spent);
+    }
+    logFlush();   // 대기 중인 로그를 시리얼로 (재시작하면 링이 사라진다)
+    ESP.restart();
+  }
+}
+
+void handleCommandMessage(uint8_t zone, const char* payload, size_t len) {
+  if (zone >= ZONE_COUNT) return;
+  if (len > CMD_PAYLOAD_MAX) {
+    gMetricCounters.cmdOversize++;
+    LOG_W(CMD, "dropped: %u bytes > %u", (unsigned)len, (unsigned)CMD_PAYLOAD_MAX);
+    return;
+  }
+  QueuedCommand q;
+  q.rxCycles = metricsCycles();
+  q.zone     = zone;
+  q.len      = (uint16_t)len;
+  memcpy(q.payload, payload, len);
+  if (!cmdQueue.push(q)) {
+    // ack 를 보내지 않으면 QoS1 재전송으로 다시 온다
+    gMetricCounters.cmdQueueDrops++;
+    LOG_W(CMD, "dropped: command queue full");
+    return;
+  }
+  gMetricCounters.cmdReceived++;
+}
+
+void commandsBegin() {
+  QueuedCommand q;
+  while (cmdQueue.pop(q)) {}
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) ackCache[z].clear();
+  // 마지막 restart 는 재부팅 전에 이미 ack 했으므로 재전달되면 같은 ack 만.
+  // 어느 존 토픽으로 왔는지는 저장하지 않으므로 모든 존 캐시에 등록
+  if (lastRestartCmdId[0] != '\0') {
+    CommandAck ack;
+    strncpy(ack.cmd, "restart", sizeof(ack.cmd) - 1);
+    setAck(ack, true, nullptr);
+    for (uint8_t z = 0; z < ZONE_COUNT; z++) ackCache[z].put(lastRestartCmdId, ack);
+  }
+}
+
+void commandsTick() {
+  QueuedCommand q;
+  while (cmdQueue.pop(q)) processCommand(q);
+}
+
+CommandStats commandStats() {
+  CommandStats s;
+  s.received   = gMetricCounters.cmdReceived;
+  s.executed   = executedCount;
+  s.duplicates = gMetricCounters.cmdDuplicates;
+  s.queueDrops = gMetricCounters.cmdQueueDrops;
+  s.oversize   = gMetricCounters.cmdOversize;
+  s.cached     = 0;
+  s.evictions  = 0;
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    s.cached    += ackCache[z].size();
+    s.evictions += ackCache[z].evictions();
+  }
+  return s;
+}
@@ -0,0 +1,616 @@
+#include <Arduino.h>
+#include <math.h>
+#include <atomic>
+#include "control.h"
+#include "dht_sensor.h"
+#include "metrics.h"
+#include "peltier_drive.h"
+#include "spsc_queue.h"
+#include "track_filter.h"
+#include "warm_boot.h"
+#include "zone.h"
+#include "log.h"
+#if defined(ESP32) && CONFIG_PM_ENABLE
+#include <esp_pm.h>
+#endif
+#ifdef ESP32
+#include <esp_timer.h>
+#endif
+
+PIDState pid;
+
+// ===== 제어 태스크 소유 상태 =====
+// 네트워크 태스크는 직접 접근하지 않고 명령 큐 / 스냅샷 큐로만 주고받는다.
+// 존별 배열 (SoA): PID 루프가 존을 차례로 훑으며 같은 필드만 읽는다.
+struct ControlState {
+  float         temp[ZONE_COUNT];             // 필터 추정값 (PID/히스테리시스 입력)
+  float         humidity[ZONE_COUNT];
+  float         tempRate[ZONE_COUNT];         // 필터 추정 변화율 (°C/s)
+  float         tempRaw[ZONE_COUNT];          // 마지막 측정값 (범위 체크 통과분)
+  float         humidityRaw[ZONE_COUNT];
+  unsigned long filterMs[ZONE_COUNT];         // 마지막 필터 갱신 시각
+  int           power[ZONE_COUNT];
+  bool          hasTarget[ZONE_COUNT];
+  float         target[ZONE_COUNT];
+  bool          peltierEnabled[ZONE_COUNT];
+  bool          sensorOk[ZONE_COUNT];         // 이번 주기 센서 읽기 성공 여부
+  float         rampFrom[ZONE_COUNT];         // 스케줄 램프 (rampMs = 0 이면 없음)
+  float         rampTo[ZONE_COUNT];
+  unsigned long rampStartMs[ZONE_COUNT];
+  unsigned long rampMs[ZONE_COUNT];
+
+  void reset() {
+    for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+      temp[z]           = NAN;
+      humidity[z]       = NAN;
+      tempRate[z]       = 0.0f;
+      tempRaw[z]        = NAN;
+      humidityRaw[z]    = NAN;
+      filterMs[z]       = 0;
+      power[z]          = 0;
+      hasTarget[z]      = false;
+      target[z]         = 0.0f;
+      peltierEnabled[z] = true;
+      sensorOk[z]       = false;
+      rampMs[z]         = 0;
+    }
+  }
+};
+static ControlState ctl;
+
+// 존별 센서 실패/거부 사유 + 냉각 전이 누적 카운터 (제어 태스크 쪽에서만 갱신)
+struct ZoneCounters {
+  uint32_t noResponse   = 0;
+  uint32_t timingErrs   = 0;
+  uint32_t checksumErrs = 0;
+  uint32_t rangeRejects = 0;
+  uint32_t outliers     = 0;   // 필터 혁신 게이트에서 거부
+  uint32_t recoveries   = 0;   // 계단 변화로 판단해 재초기화
+  uint32_t pidStarts    = 0;
+  uint32_t pidStops     = 0;
+};
+static ZoneCounters zoneCnt[ZONE_COUNT];
+
+static const TrackFilterParams TEMP_FILTER = {SENSOR_TEMP_NOISE, SENSOR_TEMP_ACCEL, SENSOR_GATE_SIGMA,
+                                              SENSOR_RECOVER_N, SENSOR_TEMP_RECOVER_BAND};
+static const TrackFilterParams HUM_FILTER  = {SENSOR_HUM_NOISE, SENSOR_HUM_ACCEL, SENSOR_GATE_SIGMA,
+                                              SENSOR_RECOVER_N, SENSOR_HUM_RECOVER_BAND};
+struct ZoneFilters {
+  TrackFilter temp{TEMP_FILTER};
+  TrackFilter hum{HUM_FILTER};
+};
+static ZoneFilters filters[ZONE_COUNT];
+
+static SpscQueue<ControlCommand, CONTROL_CMD_QUEUE>   cmdQueue;    // loop → 제어
+static SpscQueue<ControlSnapshot, CONTROL_SNAP_QUEUE> snapQueue;   // 제어 → loop
+static uint32_t cmdDrops = 0;                                      // loop 쪽에서만 증가
+
+// 지터 측정 (제어 태스크 쪽에서만 갱신, 모든 존 공통)
+struct ControlTiming {
+  uint32_t seq         = 0;
+  uint32_t lastStartUs = 0;
+  uint32_t jitterMaxUs = 0;
+  uint32_t jitterAvgUs = 0;
+  uint32_t execMaxUs   = 0;
+  uint32_t overruns    = 0;
+  uint32_t snapDrops   = 0;
+};
+static ControlTiming timing;
+
+#ifdef ESP32
+static TaskHandle_t snapNotifyTask = nullptr;   // 스냅샷을 넣을 때 깨울 loop 태스크
+#endif
+
+#if defined(ESP32) && CONFIG_PM_ENABLE
+// LEDC 는 light sleep 중 멈추므로 펠티어가 하나라도 켜져 있는 동안은 잠들지 않게 잡아둔다
+static esp_pm_lock_handle_t pwmAwakeLock = nullptr;
+static bool                 pwmAwakeHeld = false;
+
+static void pwmHoldAwake(bool on) {
+  if (!pwmAwakeLock || on == pwmAwakeHeld) return;
+  if (on) esp_pm_lock_acquire(pwmAwakeLock);
+  else    esp_pm_lock_release(pwmAwakeLock);
+  pwmAwakeHeld = on;
+}
+#else
+static void pwmHoldAwake(bool) {}
+#endif
+
+static uint32_t pwmOnMask = 0;   // 출력이 0 이 아닌 존 (bit = 존 번호)
+
+// controlForceOff 이후 WARM_FREEZE_MS 동안은 웜 부팅 기록을 덮어쓰지 않는다 (loop 태스크가 씀)
+static volatile uint32_t warmFreezeUntilMs = 0;
+static volatile bool     warmFrozen        = false;
+
+// controlForceOff 이후 재부팅까지 풀리지 않는 정지 래치. 제어 태스크는 이 동안 냉각을 다시 시작하지 않는다
+// (restart / OTA 는 꺼 둔 뒤 발행 큐를 비우느라 수 초를 기다린다)
+static std::atomic<bool> forcedOff{false};
+static std::atomic<bool> forcedDark{false};   // 구동 틱이 래치를 보고 모든 채널에 0 을 썼다
+
+// ---------- 구동 레이어 ----------
+// 제어 태스크는 목표 듀티만 넘기고, 구동 틱(PELTIER_DRIVE_TICK_MS)이 슬루 제한 + 디더링해 LEDC 에 쓴다
+static constexpr int32_t driveStepQ(float pctPerSec) {
+  return (int32_t)((float)PELTIER_PWM_MAX * pctPerSec / 100.0f * (float)PELTIER_DRIVE_TICK_MS / 1000.0f *
+                   (float)(1L << PeltierDrive::FRAC));
+}
+static const PeltierDriveParams DRIVE_PARAMS = {
+  PeltierDrive::fromCode(PELTIER_ABS_MAX_PWM),
+  driveStepQ(PELTIER_SLEW_PCT_PER_SEC),
+  driveStepQ(PELTIER_SOFT_START_PCT_PER_SEC),
+  PELTIER_SOFT_START_MS / PELTIER_DRIVE_TICK_MS,
+};
+static_assert(PID_Q_FRAC_BITS >= PeltierDrive::FRAC, "PID output needs at least drive fraction bits");
+
+static PeltierDrive drive[ZONE_COUNT];
+
+#ifdef ESP32
+// 출력이 있는 동안만 도는 주기 타이머 (esp_timer 태스크). 모두 꺼지면 스스로 멈춰 light sleep 을 막지 않는다
+static esp_timer_handle_t driveTimer = nullptr;
+
+static void driveTimerCb(void*) {
+  peltierDriveTick();
+}
+#endif
+
+// ==================== Peltier PWM ====================
+static void peltierSetup(uint8_t z) {
+#if defined(ESP32) && CONFIG_PM_ENABLE
+  if (!pwmAwakeLock) esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "peltier", &pwmAwakeLock);
+#endif
+  const ZoneConfig& zc = zoneConfig(z);
+  ledcSetup(zc.pwmChannel, PELTIER_PWM_FREQ, PELTIER_PWM_RES);
+  ledcAttachPin(zc.pwmPin, zc.pwmChannel);
+  ledcWrite(zc.pwmChannel, 0);  // 초기: OFF
+  drive[z].reset();
+#ifdef ESP32
+  if (!driveTimer) {
+    esp_timer_create_args_t args = {};
+    args.callback = driveTimerCb;
+    args.name     = "peltier_drive";
+    esp_timer_create(&args, &driveTimer);
+  }
+#endif
+  LOG_I(PID, "%s PWM init pin=%d ch=%d freq=%dHz res=%dbit", zc.name, zc.pwmPin, zc.pwmChannel,
+        PELTIER_PWM_FREQ, PELTIER_PWM_RES);
+}
+
+// dutyQ = LEDC 코드 (소수부 PeltierDrive::FRAC 비트). 0 이면 구동 틱을 기다리지 않고 바로 끈다
+static void peltierWrite(uint8_t z, int32_t dutyQ) {
+  if (dutyQ < 0 || forcedOff.load()) dutyQ = 0;
+  if (dutyQ > DRIVE_PARAMS.maxQ) dutyQ = DRIVE_PARAMS.maxQ;
+  if (dutyQ > 0) {
+    pwmOnMask |= 1UL << z;
+    pwmHoldAwake(true);   // 켜기 전에 잠금
+    bootMarkPwm();
+  }
+  drive[z].setTarget(dutyQ);
+  if (dutyQ == 0) {
+    ledcWrite(zoneConfig(z).pwmChannel, 0);
+    pwmOnMask &= ~(1UL << z);
+    if (!pwmOnMask) pwmHoldAwake(false);
+  }
+#ifdef ESP32
+  // 타이머가 막 스스로 멈춘 직후라 시작이 빗나가도 다음 제어 주기에 다시 시도된다 (출력은 꺼진 쪽으로만 늦음)
+  else if (driveTimer && !esp_timer_is_active(driveTimer)) {
+    esp_timer_start_periodic(driveTimer, (uint64_t)PELTIER_DRIVE_TICK_MS * 1000ULL);
+  }
+#endif
+}
+
+void peltierDriveTick() {
+  if (forcedOff.load()) {
+    // 정지 래치: 구동 상태는 제어 태스크가 FORCE_OFF 로 정리하고, 여기서는 출력만 0 으로 잡는다
+    for (uint8_t z = 0; z < ZONE_COUNT; z++) ledcWrite(zoneConfig(z).pwmChannel, 0);
+    forcedDark.store(true);
+#ifdef ESP32
+    if (driveTimer) esp_timer_stop(driveTimer);
+#endif
+    return;
+  }
+  bool active = false;
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    uint32_t code = drive[z].tick(DRIVE_PARAMS);
+    ledcWrite(zoneConfig(z).pwmChannel, code);
+    if (code || drive[z].target() > 0) active = true;
+  }
+#ifdef ESP32
+  if (!active && driveTimer) esp_timer_stop(driveTimer);
+#else
+  (void)active;
+#endif
+}
+
+static void peltierOff(uint8_t z) {
+  peltierWrite(z, 0);
+  pid.outputPct[z]     = 0.0f;
+  pid.outputPWM[z]     = 0;
+  pid.core.reset(z);
+  pid.coolingActive[z] = false;
+  ctl.power[z]         = 0;
+}
+
+// ==================== PID 연산 ====================
+// 존 하나의 히스테리시스 판단 + PID. 상태는 모두 [z] 칸만 건드린다 (다른 존과 독립)
+static void pidCompute(uint8_t z) {
+  const char* name = zoneConfig(z).name;
+  if (forcedOff.load()) {   // 재부팅 대기: FORCE_OFF 가 이미 껐고, 히스테리시스가 다시 켜지 않게
+    if (pid.outputPWM[z] != 0 || pid.coolingActive[z]) peltierOff(z);
+    return;
+  }
+  // 전제조건 확인
+  if (!ctl.peltierEnabled[z] || !ctl.hasTarget[z] || !isfinite(ctl.temp[z])) {
+    if (pid.outputPWM[z] != 0) {
+      peltierOff(z);
+      LOG_I(PID, "%s OFF (precondition not met)", name);
+    }
+    return;
+  }
+
+  float error = ctl.temp[z] - ctl.target[z];  // 양수 = 현재 온도가 높음 = 냉각 필요
+
+  // --- 히스테리시스: 냉각 시작/정지 판단 ---
+  if (!pid.coolingActive[z]) {
+    // 냉각 OFF 상태: target + COOL_START_OFFSET 이상이면 냉각 시작
+    if (error > COOL_START_OFFSET) {
+      pid.coolingActive[z] = true;
+      zoneCnt[z].pidStarts++;
+      pid.core.reset(z);
+      LOG_I(PID, "%s cooling START (temp=%.1f target=%.1f err=%.2f)",
+            name, ctl.temp[z], ctl.target[z], error);
+    } else {
+      // 냉각 불필요 -> 출력 0 유지
+      if (pid.outputPWM[z] != 0) {
+        peltierOff(z);
+        LOG_I(PID, "%s OFF (below start threshold)", name);
+      }
+      return;
+    }
+  } else {
+    // 냉각 ON 상태: target + COOL_STOP_OFFSET 이하면 냉각 정지
+    if (error < COOL_STOP_OFFSET) {
+      pid.coolingActive[z] = false;
+      zoneCnt[z].pidStops++;
+      peltierOff(z);
+      LOG_I(PID, "%s cooling STOP (temp=%.1f target=%.1f err=%.2f)",
+            name, ctl.temp[z], ctl.target[z], error);
+      return;
+    }
+  }
+
+  // --- PID: 고정소수점 코어가 오차 → PWM 카운트를 바로 계산 (데드밴드/와인드업 포함) ---
+  // 정수 카운트는 보고용, 구동 레이어에는 소수부까지 넘겨 디더링으로 표현
+  int pwm = pid.core.update(z, PidQ::from(error), PidQ::from(ctl.tempRate[z]));
+
+  pid.outputPWM[z] = pwm;
+  pid.outputPct[z] = (float)pwm * (100.0f / (float)PELTIER_ABS_MAX_PWM);
+  ctl.power[z]     = (pwm * 100 + PELTIER_ABS_MAX_PWM / 2) / PELTIER_ABS_MAX_PWM;   // 반올림하여 0~100%
+
+  peltierWrite(z, pid.core.output(z) >> (PID_Q_FRAC_BITS - PeltierDrive::FRAC));
+
+  LOG_D(PID, "%s temp=%.1f target=%.1f err=%.2f | int=%.1f | out=%.1f%% pwm=%d/%d", name, ctl.temp[z],
+        ctl.target[z], error, PidQ::toFloat(pid.core.integral(z)), pid.outputPct[z], pwm, PELTIER_ABS_MAX_PWM);
+}
+
+// ---------- Sensor ----------
+static bool readSensorsDHT21(uint8_t z) {
+  const char*   name = zoneConfig(z).name;
+  ZoneCounters& cnt  = zoneCnt[z];
+  ZoneFilters&  f    = filters[z];
+  DhtReading r;
+  DhtStatus  st = dhtSensorRead(z, r);
+
+  // 1) 통신 실패 (응답 없음 / 펄스 폭 이상 / 체크섬)
+  if (st != DHT_OK) {
+    if      (st == DHT_ERR_NO_RESPONSE) cnt.noResponse++;
+    else if (st == DHT_ERR_TIMING)      cnt.timingErrs++;
+    else                                cnt.checksumErrs++;
+    LOG_W(SENSOR, "%s DHT read failed (%s)", name, dhtStatusName(st));
+    return false;
+  }
+  float t = r.temp;
+  float h = r.humidity;
+
+  // 2) 물리적 범위 체크 (829.9°C, -11.4°C 같은 비정상값 차단)
+  if (t < SENSOR_TEMP_MIN || t > SENSOR_TEMP_MAX ||
+      h < SENSOR_HUM_MIN  || h > SENSOR_HUM_MAX) {
+    cnt.rangeRejects++;
+    LOG_W(SENSOR, "%s out of range rejected: t=%.1f h=%.1f", name, t, h);
+    return false;
+  }
+
+  // 3) 추정 필터: 예측 대비 혁신으로 이상치 판정, 계단 변화는 복구 경로로 따라감
+  unsigned long now = millis();
+  float dt = f.temp.ready() ? (float)(now - ctl.filterMs[z]) / 1000.0f : 0.0f;
+  ctl.filterMs[z]    = now;
+  ctl.tempRaw[z]     = t;
+  ctl.humidityRaw[z] = h;
+  TrackResult tr     = f.temp.update(t, dt);
+  TrackResult hr     = f.hum.update(h, dt);
+  if (tr == TRACK_OUTLIER || hr == TRACK_OUTLIER) cnt.outliers++;
+  if (tr == TRACK_RECOVERED || hr == TRACK_RECOVERED) {
+    cnt.recoveries++;
+    LOG_I(SENSOR, "%s step change accepted: t=%.1f h=%.1f", name, t, h);
+  }
+  if (tr == TRACK_OUTLIER || hr == TRACK_OUTLIER)
+    LOG_W(SENSOR, "%s outlier: t=%.1f(%s, innov=%.2f) h=%.1f(%s, innov=%.1f)", name, t, trackResultName(tr),
+          f.temp.innovation(), h, trackResultName(hr), f.hum.innovation());
+  // 온도가 거부된 주기는 PID 를 돌리지 않는다 (예측값으로 출력을 바꾸지 않음)
+  if (tr == TRACK_OUTLIER) return false;
+
+  ctl.temp[z]     = f.temp.value();
+  ctl.tempRate[z] = f.temp.rate();
+  ctl.humidity[z] = f.hum.value();
+  LOG_D(SENSOR, "%s temp=%.2fC (raw %.1f, %+.3fC/min) hum=%.1f%% (raw %.1f)", name, ctl.temp[z], t,
+        ctl.tempRate[z] * 60.0f, ctl.humidity[z], h);
+  return true;
+}
+
+// ==================== 제어 태스크 ====================
+// 명령 하나는 존 하나에만 적용된다 (FORCE_OFF 는 전체)
+static void applyCommand(const ControlCommand& c) {
+  if (c.type == CTL_CMD_FORCE_OFF) {
+    for (uint8_t z = 0; z < ZONE_COUNT; z++) peltierOff(z);
+    return;
+  }
+  if (c.zone >= ZONE_COUNT) return;
+  uint8_t z = c.zone;
+  switch (c.type) {
+    case CTL_CMD_SET_TARGET:
+      ctl.rampMs[z]    = 0;
+      ctl.hasTarget[z] = c.flag;
+      ctl.target[z]    = c.flag ? c.a : 0.0f;
+      if (!c.flag) {
+        peltierOff(z);
+      } else {
+        // 목표 변경 시 PID 적분 리셋
+        pid.core.reset(z);
+      }
+      break;
+    case CTL_CMD_SET_ENABLED:
+      ctl.peltierEnabled[z] = c.flag;
+      if (!c.flag) peltierOff(z);
+      break;
+    case CTL_CMD_SET_GAINS:
+      pid.kp[z] = c.a;
+      pid.ki[z] = c.b;
+      pid.kd[z] = c.c;
+      pid.core.setGains(z, c.a, c.b, c.c);
+      // 적분 리셋 (게인 변경 시)
+      pid.core.reset(z);
+      LOG_I(PID, "%s tuning updated kp=%.2f ki=%.2f kd=%.2f",
+            zoneConfig(z).name, pid.kp[z], pid.ki[z], pid.kd[z]);
+      break;
+    case CTL_CMD_SET_RAMP:
+      // 스케줄 구간 진입: 목표만 움직이고 적분은 그대로 (램프를 따라가는 중 리셋하면 출력이 꺼진다)
+      ctl.hasTarget[z]   = true;
+      ctl.target[z]      = c.a;
+      ctl.rampFrom[z]    = c.a;
+      ctl.rampTo[z]      = c.b;
+      ctl.rampStartMs[z] = millis();
+      ctl.rampMs[z]      = c.c > 0.0f ? (unsigned long)(c.c * 1000.0f) : 0;
+      if (!ctl.rampMs[z]) ctl.target[z] = c.b;
+      break;
+    case CTL_CMD_FORCE_OFF:
+      break;
+  }
+}
+
+// PID 주기마다 램프 목표 보간
+static void updateRamps() {
+  unsigned long now = millis();
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    if (!ctl.rampMs[z]) continue;
+    unsigned long el = now - ctl.rampStartMs[z];
+    if (el >= ctl.rampMs[z]) {
+      ctl.target[z] = ctl.rampTo[z];
+      ctl.rampMs[z] = 0;
+    } else {
+      ctl.target[z] = ctl.rampFrom[z] + (ctl.rampTo[z] - ctl.rampFrom[z]) * ((float)el / (float)ctl.rampMs[z]);
+    }
+  }
+}
+
+static void publishSnapshot(uint8_t z) {
+  const ZoneCounters& cnt = zoneCnt[z];
+  ControlSnapshot s;
+  s.zone          = z;
+  s.seq           = timing.seq;
+  s.ms            = millis();
+  s.temp          = ctl.temp[z];
+  s.humidity      = ctl.humidity[z];
+  s.tempRaw       = ctl.tempRaw[z];
+  s.humidityRaw   = ctl.humidityRaw[z];
+  s.tempRate      = ctl.tempRate[z];
+  s.sensorOk      = ctl.sensorOk[z];
+  s.power         = ctl.power[z];
+  s.kp            = pid.kp[z];
+  s.ki            = pid.ki[z];
+  s.kd            = pid.kd[z];
+  s.integral      = PidQ::toFloat(pid.core.integral(z));
+  s.outputPct     = pid.outputPct[z];
+  s.outputPWM     = pid.outputPWM[z];
+  s.coolingActive = pid.coolingActive[z];
+  s.jitterMaxUs   = timing.jitterMaxUs;
+  s.jitterAvgUs   = timing.jitterAvgUs;
+  s.execMaxUs     = timing.execMaxUs;
+  s.overruns      = timing.overruns;
+  s.snapDrops     = timing.snapDrops;
+  s.pidStarts     = cnt.pidStarts;
+  s.pidStops      = cnt.pidStops;
+  s.sensorNoResponse   = cnt.noResponse;
+  s.sensorTimingErrs   = cnt.timingErrs;
+  s.sensorChecksumErrs = cnt.checksumErrs;
+  s.sensorRangeRejects = cnt.rangeRejects;
+  s.sensorOutliers     = cnt.outliers;
+  s.sensorRecoveries   = cnt.recoveries;
+  // 네트워크가 밀려 큐가 가득 차면 이번 스냅샷은 버린다 (제어 주기는 절대 막지 않음)
+  if (!snapQueue.push(s)) timing.snapDrops++;
+}
+
+// ---------- 웜 부팅 ----------
+// 매 주기 RTC 메모리에 PID 상태를 남긴다 (restart / OTA / 브라운아웃 / 패닉 뒤 복원용)
+static void saveWarmState() {
+  if (warmFrozen) {
+    if ((int32_t)(millis() - warmFreezeUntilMs) < 0) return;
+    warmFrozen = false;
+  }
+  WarmZone wz[ZONE_COUNT];
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    wz[z].integral      = pid.core.integral(z);
+    wz[z].prevError     = pid.core.prevError(z);
+    wz[z].output        = pid.coolingActive[z] ? pid.core.output(z) : 0;
+    wz[z].target        = ctl.target[z];
+    wz[z].coolingActive = pid.coolingActive[z];
+  }
+  warmSaveControl(wz);
+}
+
+// 재부팅 직전 기록이 있고 목표가 같으면 적분/냉각 여부를 이어받고 그 듀티로 바로 켠다.
+// 첫 센서 읽기(다음 주기)부터는 평소처럼 PID 가 이어서 계산한다 (구동 레이어의 소프트 스타트는 그대로)
+static void restoreWarmState(uint8_t z) {
+  WarmZone wz;
+  if (!warmZone(z, wz) || !ctl.hasTarget[z] || !ctl.peltierEnabled[z]) return;
+  if (fabsf(wz.target - ctl.target[z]) > WARM_TARGET_TOL) return;
+  pid.core.restore(z, wz.integral, wz.prevError, wz.output);
+  pid.coolingActive[z] = wz.coolingActive;
+  warmNoteRestored();
+  if (!wz.coolingActive) return;
+  int pwm = PidQ::toInt(pid.core.output(z));
+  pid.outputPWM[z] = pwm;
+  pid.outputPct[z] = (float)pwm * (100.0f / (float)PELTIER_ABS_MAX_PWM);
+  ctl.power[z]     = (pwm * 100 + PELTIER_ABS_MAX_PWM / 2) / PELTIER_ABS_MAX_PWM;
+  peltierWrite(z, pid.core.output(z) >> (PID_Q_FRAC_BITS - PeltierDrive::FRAC));
+  LOG_I(PID, "%s warm restore int=%.1f pwm=%d cooling=%d", zoneConfig(z).name,
+        PidQ::toFloat(pid.core.integral(z)), pwm, (int)wz.coolingActive);
+}
+
+void controlStep() {
+  StageTimer stage(STAGE_CONTROL);
+  uint32_t startUs = micros();
+  if (timing.seq > 0) {
+    int32_t  periodUs = (int32_t)(startUs - timing.lastStartUs);
+    int32_t  errUs    = periodUs - (int32_t)(CONTROL_PERIOD_MS * 1000UL);
+    uint32_t absErr   = (uint32_t)(errUs < 0 ? -errUs : errUs);
+    if (absErr > timing.jitterMaxUs) timing.jitterMaxUs = absErr;
+    gControlJitter.record(absErr);
+    timing.jitterAvgUs += ((int32_t)absErr - (int32_t)timing.jitterAvgUs) / 16;   // EWMA 1/16
+    if (periodUs > (int32_t)(CONTROL_PERIOD_MS * 1500UL)) timing.overruns++;
+  }
+  timing.lastStartUs = startUs;
+  timing.seq++;
+
+  ControlCommand c;
+  while (cmdQueue.pop(c)) applyCommand(c);
+  updateRamps();
+
+  // 센서: 존마다 캡처를 기다리며 잠든다 (존당 ~6ms, 무응답이면 DHT_CAPTURE_TIMEOUT_MS).
+  // 한 존의 실패는 그 존의 카운터/상태에만 남는다
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    StageTimer t(STAGE_SENSOR);
+    ctl.sensorOk[z] = readSensorsDHT21(z);
+  }
+
+  // PID 연산: 센서 읽기 성공한 존만
+  {
+    StageTimer t(STAGE_PID);
+    for (uint8_t z = 0; z < ZONE_COUNT; z++)
+      if (ctl.sensorOk[z]) pidCompute(z);
+  }
+
+  saveWarmState();
+
+  uint32_t execUs = micros() - startUs;
+  if (execUs > timing.execMaxUs) timing.execMaxUs = execUs;
+
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) publishSnapshot(z);
+#ifdef ESP32
+  if (snapNotifyTask) xTaskNotifyGive(snapNotifyTask);   // loop() 를 다음 마감 전에 깨운다
+#endif
+}
+
+#ifdef ESP32
+// loop() 가 도는 코어의 반대편에 고정
+static const BaseType_t CONTROL_TASK_CORE = (ARDUINO_RUNNING_CORE == 0) ? 1 : 0;
+
+static void controlTask(void*) {
+  logBindControlTask();
+  TickType_t lastWake = xTaskGetTickCount();
+  for (;;) {
+    // 이전 깨어남 기준으로 다음 주기를 잡아 누적 드리프트 없이 고정 주기 유지
+    vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(CONTROL_PERIOD_MS));
+    controlStep();
+  }
+}
+#endif
+
+void controlBegin() {
+  ctl.reset();
+  pwmOnMask = 0;
+  forcedOff.store(false);
+  forcedDark.store(false);
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    const ZoneConfig& zc = zoneConfig(z);
+    filters[z].temp.reset();
+    filters[z].hum.reset();
+    ctl.hasTarget[z]      = gZone[z].hasTarget;
+    ctl.target[z]         = gZone[z].target;
+    ctl.peltierEnabled[z] = gZone[z].peltierEnabled;
+
+    // 펠티어 PWM / 센서 초기화
+    peltierSetup(z);
+    restoreWarmState(z);
+    if (!dhtSensorBegin(z, zc.dhtPin, zc.dhtRmtChannel)) {
+      LOG_E(SENSOR, "%s DHT capture init failed", zc.name);
+    }
+  }
+
+#ifdef ESP32
+  xTaskCreatePinnedToCore(controlTask, "control", CONTROL_TASK_STACK, nullptr,
+                          CONTROL_TASK_PRIO, nullptr, CONTROL_TASK_CORE);
+  LOG_I(PID, "control task started core=%d prio=%u period=%ums zones=%u",
+        (int)CONTROL_TASK_CORE, (unsigned)CONTROL_TASK_PRIO,
+        (unsigned)CONTROL_PERIOD_MS, (unsigned)ZONE_COUNT);
+#endif
+}
+
+// ==================== 네트워크 태스크 인터페이스 ====================
+bool controlPost(const ControlCommand& cmd) {
+  if (cmdQueue.push(cmd)) return true;
+  cmdDrops++;
+  return false;
+}
+
+bool controlPoll(ControlSnapshot& out) {
+  return snapQueue.pop(out);
+}
+
+void controlForceOff() {
+  // 출력단은 제어 태스크 (peltierWrite) 와 구동 틱만 건드린다. 여기서는 래치를 세우고 명령을 보낸 뒤
+  // 구동 틱이 래치를 보고 LEDC 를 0 으로 쓸 때까지만 기다린다. PID 상태 리셋은 제어 태스크가 명령을 받아 처리.
+  // 재시작 직전이면 꺼진 상태 대신 직전 PID 상태가 RTC 메모리에 남아야 한다
+  warmFreezeUntilMs = millis() + WARM_FREEZE_MS;
+  warmFrozen        = true;
+  forcedOff.store(true);
+  ControlCommand c = {CTL_CMD_FORCE_OFF, false, 0.0f, 0.0f, 0.0f, 0};
+  controlPost(c);
+#ifdef ESP32
+  // 타이머가 멈춰 있으면 이미 모든 출력이 0 이다 (래치 이후 peltierWrite 는 다시 켜지 않음)
+  uint32_t start = millis();
+  while (driveTimer && esp_timer_is_active(driveTimer) && !forcedDark.load() &&
+         millis() - start < 3 * PELTIER_DRIVE_TICK_MS) {
+    delay(1);
+  }
+#else
+  peltierDriveTick();   // 시뮬레이터는 단일 스레드: 구동 틱을 바로 한 번
+#endif
+}
+
+#ifdef ESP32
+void controlNotifyOnSnapshot(TaskHandle_t task) {
+  snapNotifyTask = task;
+}
+#endif
+
+uint32_t controlCmdDrops() {
+  return cmdDrops;
+}
@@ -0,0 +1,70 @@
+#include "dht_decode.h"
+
+// 같은 레벨이 연속으로 들어오면(캡처 분할 등) 하나로 합쳐 읽는다
+struct PulseCursor {
+  const DhtPulse* p;
+  size_t          n;
+  size_t          i;
+
+  bool next(uint8_t& level, uint32_t& us) {
+    if (i >= n) return false;
+    level = p[i].level;
+    us    = p[i].us;
+    i++;
+    while (i < n && p[i].level == level) us += p[i++].us;
+    return true;
+  }
+};
+
+static bool inRange(uint32_t v, uint16_t lo, uint16_t hi) {
+  return v >= lo && v <= hi;
+}
+
+DhtStatus dhtDecode(const DhtPulse* pulses, size_t n, DhtReading& out) {
+  PulseCursor c = {pulses, n, 0};
+  uint8_t  level;
+  uint32_t us;
+
+  // 1) 응답 찾기: LOW 80us 다음 HIGH 80us (앞쪽 HIGH 는 호스트 해제 구간)
+  bool found = false;
+  while (c.next(level, us)) {
+    if (level != 0 || !inRange(us, DHT_RESP_MIN_US, DHT_RESP_MAX_US)) continue;
+    uint8_t  l2;
+    uint32_t us2;
+    if (!c.next(l2, us2)) break;
+    if (l2 == 1 && inRange(us2, DHT_RESP_MIN_US, DHT_RESP_MAX_US)) {
+      found = true;
+      break;
+    }
+  }
+  if (!found) return DHT_ERR_NO_RESPONSE;
+
+  // 2) 40비트
+  uint8_t b[5] = {0, 0, 0, 0, 0};
+  for (int bit = 0; bit < 40; bit++) {
+    if (!c.next(level, us) || level != 0 || !inRange(us, DHT_BIT_LOW_MIN_US, DHT_BIT_LOW_MAX_US))
+      return DHT_ERR_TIMING;
+    if (!c.next(level, us) || level != 1 || !inRange(us, DHT_BIT_HIGH_MIN_US, DHT_BIT_HIGH_MAX_US))
+      return DHT_ERR_TIMING;
+    b[bit / 8] = (uint8_t)((b[bit / 8] << 1) | (us >= DHT_BIT_ONE_US ? 1 : 0));
+  }
+
+  // 3) 체크섬
+  if ((uint8_t)(b[0] + b[1] + b[2] + b[3]) != b[4]) return DHT_ERR_CHECKSUM;
+
+  for (int i = 0; i < 5; i++) out.raw[i] = b[i];
+  out.humidity = (float)(((uint16_t)b[0] << 8) | b[1]) * 0.1f;
+  float t = (float)(((uint16_t)(b[2] & 0x7F) << 8) | b[3]) * 0.1f;
+  out.temp = (b[2] & 0x80) ? -t : t;
+  return DHT_OK;
+}
+
+const char* dhtStatusName(DhtStatus s) {
+  switch (s) {
+    case DHT_OK:              return "ok";
+    case DHT_ERR_NO_RESPONSE: return "no_response";
+    case DHT_ERR_TIMING:      return "timing";
+    case DHT_ERR_CHECKSUM:    return "checksum";
+  }
+  return "unknown";
+}
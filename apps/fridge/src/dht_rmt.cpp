@@ -0,0 +1,91 @@
+#ifdef ESP32
+
+#include <Arduino.h>
+#include <driver/gpio.h>
+#include <driver/rmt.h>
+#include <esp_timer.h>
+#include "config.h"
+#include "dht_sensor.h"
+
+// ==================== DHT21 RMT 캡처 ====================
+// 시작 신호(LOW 1.1ms)는 esp_timer 로 해제하고, 이후 펄스열은 RMT 수신기가
+// 1us 분해능으로 링버퍼에 기록한다. 비트뱅잉(Adafruit DHT)과 달리
+// 측정 중에 인터럽트를 막지 않으며, 호출 태스크는 링버퍼를 기다리며 잠든다.
+
+static const size_t DHT_MAX_PULSES = 100;   // 응답 2 + 비트 80 + 여유
+
+// 존별 센서: 핀 / RMT 채널 / 수신 링버퍼 / 시작 신호 타이머
+struct DhtChannel {
+  gpio_num_t         pin          = GPIO_NUM_NC;
+  rmt_channel_t      rmtCh        = RMT_CHANNEL_0;
+  RingbufHandle_t    ring         = nullptr;
+  esp_timer_handle_t releaseTimer = nullptr;
+};
+static DhtChannel channels[ZONE_COUNT];
+
+// esp_timer 태스크 컨텍스트: 시작 신호를 끝내고 캡처 시작
+static void releaseLine(void* arg) {
+  DhtChannel& c = *(DhtChannel*)arg;
+  gpio_set_level(c.pin, 1);   // 오픈드레인 해제 → 풀업으로 HIGH
+  rmt_rx_start(c.rmtCh, true);
+}
+
+bool dhtSensorBegin(uint8_t zone, int pin, int rmtChannel) {
+  if (zone >= ZONE_COUNT) return false;
+  DhtChannel& c = channels[zone];
+  c.pin   = (gpio_num_t)pin;
+  c.rmtCh = (rmt_channel_t)rmtChannel;
+
+  rmt_config_t cfg = RMT_DEFAULT_CONFIG_RX(c.pin, c.rmtCh);
+  cfg.clk_div                       = 80;                   // 80MHz / 80 = 1 tick/us
+  cfg.rx_config.filter_en           = true;
+  cfg.rx_config.filter_ticks_thresh = 100;                  // APB 클럭 기준 ~1.25us 이하 글리치 무시
+  cfg.rx_config.idle_threshold      = DHT_RMT_IDLE_US;      // 이만큼 변화 없으면 프레임 종료
+  if (rmt_config(&cfg) != ESP_OK) return false;
+  if (rmt_driver_install(c.rmtCh, 1024, 0) != ESP_OK) return false;
+  rmt_get_ringbuf_handle(c.rmtCh, &c.ring);
+
+  // RMT 입력 연결은 유지한 채 오픈드레인으로 라인을 직접 내릴 수 있게 설정
+  gpio_set_direction(c.pin, GPIO_MODE_INPUT_OUTPUT_OD);
+  gpio_set_pull_mode(c.pin, GPIO_PULLUP_ONLY);
+  gpio_set_level(c.pin, 1);
+
+  esp_timer_create_args_t args = {};
+  args.callback = releaseLine;
+  args.arg      = &c;
+  args.name     = "dht_start";
+  return esp_timer_create(&args, &c.releaseTimer) == ESP_OK;
+}
+
+DhtStatus dhtSensorRead(uint8_t zone, DhtReading& out) {
+  if (zone >= ZONE_COUNT || !channels[zone].ring) return DHT_ERR_NO_RESPONSE;
+  DhtChannel& c = channels[zone];
+
+  // 이전 측정 잔여물 비우기
+  size_t len = 0;
+  void*  stale;
+  while ((stale = xRingbufferReceive(c.ring, &len, 0)) != nullptr) vRingbufferReturnItem(c.ring, stale);
+
+  // 시작 신호: LOW 유지 후 타이머 콜백에서 해제 + 캡처 시작
+  gpio_set_level(c.pin, 0);
+  esp_timer_start_once(c.releaseTimer, DHT_START_LOW_US);
+
+  rmt_item32_t* items = (rmt_item32_t*)xRingbufferReceive(c.ring, &len, pdMS_TO_TICKS(DHT_CAPTURE_TIMEOUT_MS));
+  rmt_rx_stop(c.rmtCh);
+  if (!items) return DHT_ERR_NO_RESPONSE;
+
+  DhtPulse pulses[DHT_MAX_PULSES];
+  size_t   n      = 0;
+  size_t   nItems = len / sizeof(rmt_item32_t);
+  for (size_t i = 0; i < nItems && n + 2 <= DHT_MAX_PULSES; i++) {
+    if (items[i].duration0 == 0) break;
+    pulses[n++] = {(uint8_t)items[i].level0, (uint16_t)items[i].duration0};
+    if (items[i].duration1 == 0) break;   // 유휴 감지로 끝난 마지막 항목
+    pulses[n++] = {(uint8_t)items[i].level1, (uint16_t)items[i].duration1};
+  }
+  vRingbufferReturnItem(c.ring, items);
+
+  return dhtDecode(pulses, n, out);
+}
+
+#endif  // ESP32
@@ -0,0 +1,300 @@
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <string.h>
+#include "event_stream.h"
+#include "json_pool.h"
+#include "metrics.h"
+#include "record_ring.h"
+#include "state.h"
+#include "telemetry.h"
+#include "telemetry_buffer.h"
+#include "zone.h"
+#include "log.h"
+
+// ---------- 구독자 ----------
+struct StreamClient {
+  int           handle  = -1;      // 전송 계층 핸들 (-1 = 빈 칸)
+  bool          open    = false;   // 응답 헤더를 보냄 (이벤트 수신 중)
+  uint8_t       zoneMask = 0;      // 받을 존 (bit = 존 번호)
+  unsigned long sinceMs = 0;       // 접속 시각 / 대기 데이터가 마지막으로 나간 시각
+  uint16_t      reqLen  = 0;
+  char          req[STREAM_REQ_MAX];
+  RecordRing<char, STREAM_CLIENT_BUF> out;
+};
+
+static StreamClient  clients[STREAM_MAX_CLIENTS];
+static StreamStats   stats       = {};
+static bool          netReady    = false;
+static unsigned long lastEventMs = 0;
+
+// 존별로 마지막에 모든 구독자에게 보낸 상태 (델타 기준). 새 구독자에게 전체 상태를 보내도
+// 기존 구독자와 어긋나지 않도록 여기는 브로드캐스트할 때만 바꾼다.
+static StatusRecord streamed[ZONE_COUNT];
+static bool         streamedValid[ZONE_COUNT] = {};
+
+static char eventBuf[384];   // "event: x\ndata: {...}\n\n" 한 건
+// 이벤트 JsonDocument 고정 풀 (putTenths 키와 존 이름은 복사)
+static JsonPool<jsonPoolBytes(1, 160)> statusEventPool;
+static JsonPool<jsonPoolBytes(1, 96)>  pidEventPool;
+
+static const char RESP_OK[] =
+  "HTTP/1.1 200 OK\r\n"
+  "Content-Type: text/event-stream\r\n"
+  "Cache-Control: no-cache\r\n"
+  "Connection: keep-alive\r\n"
+  "Access-Control-Allow-Origin: *\r\n"
+  "\r\n"
+  "retry: 5000\n\n";
+static const char RESP_BUSY[]      = "HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+static const char RESP_NOT_FOUND[] = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+
+static uint8_t allZonesMask() { return (uint8_t)((1u << ZONE_COUNT) - 1); }
+
+static void closeClient(StreamClient& c) {
+  if (c.handle >= 0) streamNetClose(c.handle);
+  c.handle = -1;
+  c.open   = false;
+  c.reqLen = 0;
+  c.out.clear();
+}
+
+// 이벤트를 송신 버퍼에 넣는다. 자리가 없으면 느린 구독자로 보고 끊는다 (일부만 넣지 않음)
+static void enqueue(StreamClient& c, const char* data, size_t len) {
+  if (c.out.capacity() - c.out.size() < len) {
+    stats.slowDrops++;
+    LOG_W(HTTP, "client %d dropped: send buffer full (%u pending)",
+          c.handle, (unsigned)c.out.size());
+    closeClient(c);
+    return;
+  }
+  if (c.out.empty()) c.sinceMs = millis();
+  for (size_t i = 0; i < len; i++) c.out.push(data[i]);
+}
+
+// 소켓이 받아주는 만큼만 보낸다
+static void pump(StreamClient& c) {
+  char chunk[256];
+  while (!c.out.empty()) {
+    uint32_t n = c.out.size() < sizeof(chunk) ? c.out.size() : (uint32_t)sizeof(chunk);
+    for (uint32_t i = 0; i < n; i++) chunk[i] = c.out.peek(i);
+    int w = streamNetWrite(c.handle, chunk, n);
+    if (w < 0) {
+      stats.disconnects++;
+      closeClient(c);
+      return;
+    }
+    if (w == 0) break;
+    c.out.drop((uint32_t)w);
+    c.sinceMs    = millis();
+    stats.bytes += (uint32_t)w;
+  }
+  if (!c.out.empty() && millis() - c.sinceMs >= STREAM_STALL_MS) {
+    stats.slowDrops++;
+    LOG_W(HTTP, "client %d dropped: stalled %ums", c.handle, (unsigned)STREAM_STALL_MS);
+    closeClient(c);
+  }
+}
+
+static size_t formatEvent(const char* event, const char* json, size_t jsonLen) {
+  int n = snprintf(eventBuf, sizeof(eventBuf), "event: %s\ndata: %.*s\n\n", event, (int)jsonLen, json);
+  return (n > 0 && (size_t)n < sizeof(eventBuf)) ? (size_t)n : 0;
+}
+
+// 존 z 를 구독하는 모든 구독자에게
+static void broadcast(uint8_t zone, size_t len) {
+  if (len == 0) return;
+  for (StreamClient& c : clients)
+    if (c.open && (c.zoneMask & (1u << zone))) enqueue(c, eventBuf, len);
+  stats.events++;
+  lastEventMs = millis();
+}
+
+// ---------- 요청 해석 ----------
+// "GET /stream?zone=fridge2 HTTP/1.1" → 존 마스크 (0 = 잘못된 요청)
+static uint8_t parseRequest(char* req) {
+  if (strncmp(req, "GET /stream", 11) != 0) return 0;
+  char* path = req + 4;
+  char* end  = strpbrk(path, " \r\n");
+  if (end) *end = '\0';
+  if (path[7] != '\0' && path[7] != '?') return 0;   // /streamx 같은 경로
+  char* arg = strstr(path, "zone=");
+  if (!arg) return allZonesMask();
+  arg += 5;
+  char* amp = strchr(arg, '&');
+  if (amp) *amp = '\0';
+  int z = zoneFromArg(arg);
+  return z < 0 ? 0 : (uint8_t)(1u << z);
+}
+
+// 응답 헤더 + 구독한 존의 현재 전체 상태
+static void openClient(StreamClient& c, uint8_t mask) {
+  c.open     = true;
+  c.zoneMask = mask;
+  enqueue(c, RESP_OK, sizeof(RESP_OK) - 1);
+  char json[384];   // extras 없는 상태 JSON (발행 경로의 statusBuf 와 같은 크기)
+  for (uint8_t z = 0; c.open && z < ZONE_COUNT; z++) {
+    if (!(mask & (1u << z))) continue;
+    size_t len = formatEvent("status", json, buildStatusJson(z, json, sizeof(json), false));
+    if (len) enqueue(c, eventBuf, len);
+  }
+  stats.accepted++;
+  LOG_I(HTTP, "client %d subscribed zones=0x%02x", c.handle, (unsigned)mask);
+}
+
+static void rejectHandle(int h, const char* resp, size_t len) {
+  streamNetWrite(h, resp, len);   // 최선 노력: 못 보내도 그냥 닫는다
+  streamNetClose(h);
+  stats.rejected++;
+}
+
+static void readRequest(StreamClient& c) {
+  int n = streamNetRead(c.handle, c.req + c.reqLen, sizeof(c.req) - 1 - c.reqLen);
+  if (n < 0) {
+    closeClient(c);
+    return;
+  }
+  c.reqLen += (uint16_t)n;
+  c.req[c.reqLen] = '\0';
+  if (strstr(c.req, "\r\n\r\n") || strstr(c.req, "\n\n")) {
+    uint8_t mask = parseRequest(c.req);
+    if (mask) {
+      openClient(c, mask);
+    } else {
+      int h = c.handle;
+      c.handle = -1;
+      closeClient(c);
+      rejectHandle(h, RESP_NOT_FOUND, sizeof(RESP_NOT_FOUND) - 1);
+    }
+    return;
+  }
+  // 헤더가 버퍼보다 길거나 너무 오래 걸리면 포기
+  if (c.reqLen >= sizeof(c.req) - 1 || millis() - c.sinceMs >= STREAM_HANDSHAKE_MS) {
+    int h = c.handle;
+    c.handle = -1;
+    closeClient(c);
+    rejectHandle(h, RESP_NOT_FOUND, sizeof(RESP_NOT_FOUND) - 1);
+  }
+}
+
+// ---------- API ----------
+void streamBegin() {
+  for (StreamClient& c : clients) closeClient(c);
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) streamedValid[z] = false;
+  stats    = {};
+  netReady = streamNetBegin();
+  LOG_I(HTTP, "%s port=%u max_clients=%u", netReady ? "listening" : "unavailable",
+        (unsigned)STREAM_PORT, (unsigned)STREAM_MAX_CLIENTS);
+}
+
+void streamTick() {
+  if (!netReady) return;
+  StageTimer stage(STAGE_STREAM);
+  // 새 연결: 빈 칸이 없으면 바로 503
+  int h;
+  while ((h = streamNetAccept()) >= 0) {
+    StreamClient* slot = nullptr;
+    for (StreamClient& c : clients)
+      if (c.handle < 0) { slot = &c; break; }
+    if (!slot) {
+      rejectHandle(h, RESP_BUSY, sizeof(RESP_BUSY) - 1);
+      continue;
+    }
+    slot->handle  = h;
+    slot->open    = false;
+    slot->reqLen  = 0;
+    slot->sinceMs = millis();
+    slot->out.clear();
+  }
+
+  for (StreamClient& c : clients) {
+    if (c.handle < 0) continue;
+    if (!c.open) readRequest(c);
+    if (c.handle >= 0) pump(c);
+  }
+
+  // 이벤트가 뜸하면 주석 줄로 연결 유지 (프록시 / 브라우저 타임아웃 방지)
+  if (streamActive() && millis() - lastEventMs >= STREAM_KEEPALIVE_MS) {
+    static const char PING[] = ": ping\n\n";
+    for (StreamClient& c : clients)
+      if (c.open) enqueue(c, PING, sizeof(PING) - 1);
+    lastEventMs = millis();
+  }
+}
+
+void streamFlush() {
+  if (!streamActive()) return;
+  StageTimer stage(STAGE_STREAM);
+  for (StreamClient& c : clients)
+    if (c.open) pump(c);
+}
+
+bool streamActive() {
+  for (const StreamClient& c : clients)
+    if (c.open) return true;
+  return false;
+}
+
+static void putTenths(JsonDocument& doc, const char* key, int16_t v) {
+  if (v == STATUS_REC_NULL16) doc[key] = nullptr;
+  else                        doc[key] = (float)v / 10.0f;
+}
+
+void streamStatus(uint8_t zone) {
+  if (zone >= ZONE_COUNT) return;
+  // 구독자가 없는 동안은 기준이 낡으므로 다음 구독자가 생기면 전체 필드부터
+  if (!streamActive()) {
+    streamedValid[zone] = false;
+    return;
+  }
+  StatusRecord  r    = makeStatusRecord(zone);
+  StatusRecord& prev = streamed[zone];
+  bool          all  = !streamedValid[zone];
+
+  JsonDocument doc(statusEventPool.reset());
+  if (ZONE_COUNT > 1) doc["zone"] = zoneConfig(zone).name;
+  size_t fields = 0;
+  if (all || r.temp10 != prev.temp10)     { putTenths(doc, "temp", r.temp10); fields++; }
+  if (all || r.hum10 != prev.hum10)       { putTenths(doc, "humidity", r.hum10); fields++; }
+  if (all || r.target10 != prev.target10) { putTenths(doc, "target", r.target10); fields++; }
+  if (all || r.power != prev.power)       { doc["power"] = r.power; fields++; }
+  if (all || ((r.flags ^ prev.flags) & STATUS_REC_FLAG_PELTIER)) {
+    doc["peltier_enabled"] = (r.flags & STATUS_REC_FLAG_PELTIER) != 0;
+    fields++;
+  }
+  if (all || ((r.flags ^ prev.flags) & STATUS_REC_FLAG_COOLING)) {
+    doc["cooling"] = (r.flags & STATUS_REC_FLAG_COOLING) != 0;
+    fields++;
+  }
+  if (fields == 0) return;
+  doc["ts"] = gStatus.tsMs;   // unix ms (0 = 시각 모름)
+
+  prev                = r;
+  streamedValid[zone] = true;
+  char   json[256];
+  size_t n = serializeJson(doc, json, sizeof(json));
+  broadcast(zone, formatEvent("status", json, n));
+}
+
+void streamPidEdge(uint8_t zone, bool start) {
+  if (zone >= ZONE_COUNT || !streamActive()) return;
+  const ZoneStatus& zs = gZone[zone];
+  JsonDocument doc(pidEventPool.reset());
+  if (ZONE_COUNT > 1) doc["zone"] = zoneConfig(zone).name;
+  doc["edge"] = start ? "start" : "stop";
+  if (isfinite(zs.temp)) doc["temp"] = (float)(roundf(zs.temp * 10.0f) / 10.0f);
+  else                   doc["temp"] = nullptr;
+  if (zs.hasTarget) doc["target"] = zs.target;
+  else              doc["target"] = nullptr;
+  doc["ts"] = gStatus.tsMs;
+  char   json[160];
+  size_t n = serializeJson(doc, json, sizeof(json));
+  broadcast(zone, formatEvent("pid", json, n));
+}
+
+StreamStats streamStats() {
+  StreamStats s = stats;
+  s.clients     = 0;
+  for (const StreamClient& c : clients)
+    if (c.open) s.clients++;
+  return s;
+}
@@ -0,0 +1,184 @@
+#include <Arduino.h>
+#include <math.h>
+#include <stdarg.h>
+#include "history.h"
+#include "lttb.h"
+#include "record_ring.h"
+#include "zone.h"
+
+// 존별 링 + 최신 샘플 시각 (millis). 샘플 i 의 시각 = 최신 - (count-1-i) × 주기
+struct ZoneHistory {
+  RecordRing<HistorySample, HISTORY_SAMPLES> ring;
+  uint32_t newestMs = 0;
+  uint32_t gapFills = 0;
+};
+
+static ZoneHistory hist[ZONE_COUNT];
+
+static int16_t quantize10(float v) {
+  if (!isfinite(v)) return HISTORY_NULL16;
+  float q = roundf(v * 10.0f);
+  if (q < -32767.0f) q = -32767.0f;
+  if (q > 32767.0f)  q = 32767.0f;
+  return (int16_t)q;
+}
+
+static HistorySample nullSample() {
+  HistorySample h;
+  h.temp10   = HISTORY_NULL16;
+  h.target10 = HISTORY_NULL16;
+  h.hum2     = HISTORY_NULL8;
+  h.power    = 0;
+  return h;
+}
+
+void historyBegin() {
+  for (ZoneHistory& h : hist) {
+    h.ring.clear();
+    h.newestMs = 0;
+    h.gapFills = 0;
+  }
+}
+
+void historyAdd(const ControlSnapshot& s) {
+  if (s.zone >= ZONE_COUNT) return;
+  ZoneHistory&      h  = hist[s.zone];
+  const ZoneStatus& zs = gZone[s.zone];
+  // 스냅샷이 버려졌거나 제어 주기가 밀려 빈 주기는 결측으로 채워 시각 간격을 유지
+  if (!h.ring.empty()) {
+    uint32_t periods = (s.ms - h.newestMs + CONTROL_PERIOD_MS / 2) / CONTROL_PERIOD_MS;
+    if (periods == 0) return;   // 같은 주기 (시각만 조금 앞당겨진 스냅샷)
+    if (periods > HISTORY_SAMPLES) periods = HISTORY_SAMPLES;
+    for (uint32_t i = 1; i < periods; i++) h.ring.push(nullSample());
+    h.gapFills += periods - 1;
+  }
+  HistorySample r;
+  r.temp10   = quantize10(s.temp);
+  r.target10 = zs.hasTarget ? quantize10(zs.target) : HISTORY_NULL16;
+  r.hum2     = HISTORY_NULL8;
+  if (isfinite(s.humidity)) {
+    long hum2 = lroundf(s.humidity * 2.0f);
+    r.hum2    = (uint8_t)(hum2 < 0 ? 0 : hum2 > 200 ? 200 : hum2);
+  }
+  int power = s.power < 0 ? 0 : s.power > 100 ? 100 : s.power;
+  r.power   = (uint8_t)power | (s.coolingActive ? HISTORY_COOLING : 0);
+  h.ring.push(r);
+  h.newestMs = s.ms;
+}
+
+uint32_t historyClock(bool* isUnix) {
+  uint32_t t = nowUnix();
+  if (isUnix) *isUnix = t != 0;
+  return t ? t : millis() / 1000;
+}
+
+// 최신 샘플의 시각 (historyClock 기준)
+static uint32_t newestTs(const ZoneHistory& h) {
+  return historyClock() - (millis() - h.newestMs) / 1000;
+}
+
+HistoryStats historyStats(uint8_t zone) {
+  const ZoneHistory& h = hist[zone];
+  HistoryStats s;
+  s.count    = h.ring.size();
+  s.capacity = h.ring.capacity();
+  s.gapFills = h.gapFills;
+  s.spanSec  = s.count ? (s.count - 1) * HISTORY_STEP_SEC : 0;
+  return s;
+}
+
+// ---------- 조각 단위 JSON ----------
+// 고정 버퍼에 이어 쓰다가 다음 줄이 안 들어가면 싱크로 내보내고 처음부터
+struct ChunkWriter {
+  char          buf[HISTORY_CHUNK_BYTES];
+  size_t        w = 0;
+  HistorySink   sink;
+  void*         ctx;
+  HistoryResult res = {};
+
+  void flush() {
+    if (w == 0) return;
+    sink(buf, w, ctx);
+    res.bytes += (uint32_t)w;
+    res.chunks++;
+    w = 0;
+  }
+
+  void put(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+    for (int attempt = 0; attempt < 2; attempt++) {
+      va_list ap;
+      va_start(ap, fmt);
+      int n = vsnprintf(buf + w, sizeof(buf) - w, fmt, ap);
+      va_end(ap);
+      if (n >= 0 && (size_t)n < sizeof(buf) - w) {
+        w += (size_t)n;
+        return;
+      }
+      flush();   // 한 줄은 항상 한 조각보다 짧다
+    }
+  }
+};
+
+// 0.1 단위 정수 → "12.3" / "-0.5" / "null" (float 출력 없이)
+static const char* tenths(char* out, size_t cap, int16_t v) {
+  if (v == HISTORY_NULL16) return "null";
+  int a = v < 0 ? -v : v;
+  snprintf(out, cap, "%s%d.%d", v < 0 ? "-" : "", a / 10, a % 10);
+  return out;
+}
+
+HistoryResult historyWriteJson(uint8_t zone, uint32_t from, uint32_t to, uint32_t points,
+                               HistorySink sink, void* ctx) {
+  const ZoneHistory& h = hist[zone];
+  static ChunkWriter cw;   // loop 태스크 전용 (조각 버퍼를 스택에 두지 않음)
+  cw.w    = 0;
+  cw.sink = sink;
+  cw.ctx  = ctx;
+  cw.res  = {};
+
+  // 요청 구간 → 인덱스 [i0, i1]
+  uint32_t n  = h.ring.size();
+  uint32_t i0 = 0, i1 = 0, count = 0;
+  uint32_t tNew = 0, tOld = 0;
+  bool     isUnix = false;
+  historyClock(&isUnix);
+  if (n > 0) {
+    tNew = newestTs(h);
+    tOld = tNew - (n - 1) * HISTORY_STEP_SEC;
+    if (from <= tNew && to >= tOld && from <= to) {
+      i0    = from <= tOld ? 0 : (from - tOld + HISTORY_STEP_SEC - 1) / HISTORY_STEP_SEC;
+      i1    = to >= tNew ? n - 1 : (to - tOld) / HISTORY_STEP_SEC;
+      count = i1 >= i0 ? i1 - i0 + 1 : 0;
+    }
+  }
+  uint32_t m = lttbCount(count, points);
+
+  cw.put("{\"zone\":\"%s\",\"clock\":\"%s\",\"step\":%u,\"from\":%lu,\"to\":%lu,\"samples\":%u,\"points\":%u,"
+         "\"fields\":[\"ts\",\"temp\",\"humidity\",\"power\",\"target\",\"cooling\"],\"data\":[",
+         zoneConfig(zone).name, isUnix ? "unix" : "uptime", (unsigned)HISTORY_STEP_SEC,
+         (unsigned long)(count ? tOld + i0 * HISTORY_STEP_SEC : 0),
+         (unsigned long)(count ? tOld + i1 * HISTORY_STEP_SEC : 0), (unsigned)count, (unsigned)m);
+
+  // 온도 곡선 모양을 기준으로 고르고, 고른 샘플은 모든 필드를 그대로
+  bool first = true;
+  lttbSelect(count, points,
+    [&](uint32_t i) -> float {
+      int16_t t = h.ring.peek(i0 + i).temp10;
+      return t == HISTORY_NULL16 ? NAN : (float)t;
+    },
+    [&](uint32_t i) {
+      const HistorySample& r = h.ring.peek(i0 + i);
+      char t[12], g[12], hum[8] = "null";
+      if (r.hum2 != HISTORY_NULL8) snprintf(hum, sizeof(hum), "%u.%u", r.hum2 / 2u, (r.hum2 % 2u) * 5u);
+      cw.put("%s[%lu,%s,%s,%u,%s,%u]", first ? "" : ",",
+             (unsigned long)(tOld + (i0 + i) * HISTORY_STEP_SEC),
+             tenths(t, sizeof(t), r.temp10), hum, (unsigned)(r.power & ~HISTORY_COOLING),
+             tenths(g, sizeof(g), r.target10), (r.power & HISTORY_COOLING) ? 1u : 0u);
+      first = false;
+      cw.res.points++;
+    });
+  cw.put("]}");
+  cw.flush();
+  cw.res.samples = count;
+  return cw.res;
+}
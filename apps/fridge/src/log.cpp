@@ -0,0 +1,351 @@
+#include <Arduino.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "log.h"
+#include "spsc_byte_ring.h"
+
+volatile uint8_t  gLogLevel = LOG_RUNTIME_LEVEL;
+volatile uint16_t gLogCats  = LOG_RUNTIME_CATS;
+
+// ===== 링 =====
+enum LogRingId : uint8_t { LOG_RING_LOOP = 0, LOG_RING_CONTROL = 1, LOG_RING_COUNT };
+
+static SpscByteRing<LOG_TASK_RING_BYTES> taskRing[LOG_RING_COUNT];   // 태스크 → log 작업
+static SpscByteRing<LOG_HISTORY_BYTES>   history;                    // [seq u32] + 레코드 (loop 전용)
+static_assert(LOG_RECORD_MAX + 4 <= SpscByteRing<LOG_TASK_RING_BYTES>::MAX_RECORD, "log record exceeds task ring");
+
+static volatile uint32_t ringDrops[LOG_RING_COUNT] = {};   // 링마다 생산자 태스크만 증가
+static volatile uint32_t foreignDrops = 0;
+static uint32_t          seqNext      = 1;
+static LogStats          stats        = {};
+
+#ifdef ESP32
+static TaskHandle_t ringTask[LOG_RING_COUNT] = {};
+#endif
+
+// 시리얼 싱크: 기록 링 안의 다음 줄 위치 + 반쯤 보낸 줄
+static uint32_t serialCursor = 0;
+static uint32_t serialSeq    = 0;      // 마지막으로 내보낸 seq
+static char     serialLine[LOG_LINE_MAX];
+static size_t   serialLen    = 0;
+static size_t   serialOff    = 0;
+
+static const char* const LEVEL_NAMES[] = {"error", "warn", "info", "debug"};
+static const char        LEVEL_CHARS[] = {'E', 'W', 'I', 'D'};
+static const char* const CAT_NAMES[]   = {"sys", "wifi", "mqtt", "http", "sensor", "pid",
+                                          "cmd", "status", "nvs", "sched", "ota", "time"};
+static const uint8_t     CAT_COUNT     = sizeof(CAT_NAMES) / sizeof(CAT_NAMES[0]);
+static_assert(LOG_CAT_ALL == (1u << (sizeof(CAT_NAMES) / sizeof(CAT_NAMES[0]))) - 1, "log category names out of sync");
+
+// ==================== 호출 위치 ====================
+uint32_t logdetail::nowMs() {
+  return (uint32_t)millis();
+}
+
+void logdetail::commit(const Rec& r) {
+#ifdef ESP32
+  TaskHandle_t self = xTaskGetCurrentTaskHandle();
+  uint8_t      id   = self == ringTask[LOG_RING_CONTROL] ? LOG_RING_CONTROL
+                    : self == ringTask[LOG_RING_LOOP]    ? LOG_RING_LOOP
+                                                         : LOG_RING_COUNT;
+  if (id == LOG_RING_COUNT) {
+    foreignDrops = foreignDrops + 1;   // 생산자가 여럿이라 근사값
+    return;
+  }
+#else
+  uint8_t id = LOG_RING_LOOP;   // 네이티브는 한 스레드
+#endif
+  if (!taskRing[id].push(r.buf, (uint16_t)r.len)) ringDrops[id] = ringDrops[id] + 1;
+}
+
+// ==================== 포맷 ====================
+static const LogSite* recSite(const uint8_t* rec) {
+  const LogSite* s;
+  memcpy(&s, rec, sizeof(s));
+  return s;
+}
+
+static uint32_t recMs(const uint8_t* rec) {
+  uint32_t ms;
+  memcpy(&ms, rec + sizeof(const LogSite*), sizeof(ms));
+  return ms;
+}
+
+// 인자 하나 읽기 (형식 지정자 하나에 대응)
+struct ArgReader {
+  const uint8_t* p;
+  const uint8_t* end;
+
+  // tag = 0 이면 인자가 모자람
+  char next(int64_t& i, uint64_t& u, double& f, const char*& s, uint8_t& slen) {
+    if (p >= end) return 0;
+    char tag = (char)*p++;
+    switch (tag) {
+      case 'i': { int32_t v;  memcpy(&v, p, 4); p += 4; i = v; u = (uint64_t)(int64_t)v; f = v; break; }
+      case 'u': { uint32_t v; memcpy(&v, p, 4); p += 4; u = v; i = v; f = v; break; }
+      case 'I': { int64_t v;  memcpy(&v, p, 8); p += 8; i = v; u = (uint64_t)v; f = (double)v; break; }
+      case 'U': { uint64_t v; memcpy(&v, p, 8); p += 8; u = v; i = (int64_t)v; f = (double)v; break; }
+      case 'f': { float v;    memcpy(&v, p, 4); p += 4; f = v; i = (int64_t)v; u = (uint64_t)i; break; }
+      case 's': slen = *p++; s = (const char*)p; p += slen; break;
+      default:  p = end; return 0;
+    }
+    return tag;
+  }
+};
+
+// 형식 문자열을 따라가며 지정자마다 저장된 인자 하나를 snprintf 로
+static size_t formatMessage(const LogSite* site, const uint8_t* args, const uint8_t* end, char* out, size_t cap) {
+  size_t    n = 0;
+  ArgReader rd = {args, end};
+  auto emit = [&](int w) {
+    if (w > 0) n += (size_t)w;
+    if (n >= cap) n = cap - 1;
+  };
+  for (const char* f = site->fmt; *f && n + 1 < cap; f++) {
+    if (*f != '%') {
+      out[n++] = *f;
+      continue;
+    }
+    if (f[1] == '%') {
+      out[n++] = '%';
+      f++;
+      continue;
+    }
+    // % [플래그][너비][.정밀도][길이] 변환
+    char spec[32];
+    size_t k = 0;
+    spec[k++] = '%';
+    const char* q = f + 1;
+    int prec = -1;
+    while (*q && strchr("-+ #0123456789", *q) && k < sizeof(spec) - 5) spec[k++] = *q++;
+    if (*q == '.') {
+      prec = atoi(++q);
+      while (*q >= '0' && *q <= '9') q++;
+    }
+    while (*q && strchr("hlzjtL", *q)) q++;
+    char conv = *q;
+    if (!conv) break;
+    f = q;
+    if (prec >= 0 && conv != 's') k += (size_t)snprintf(spec + k, sizeof(spec) - k - 3, ".%d", prec > 99 ? 99 : prec);
+
+    int64_t  iv = 0;
+    uint64_t uv = 0;
+    double   fv = 0.0;
+    const char* sv = nullptr;
+    uint8_t  sl = 0;
+    char tag = rd.next(iv, uv, fv, sv, sl);
+    if (!tag) {
+      out[n++] = '?';
+      continue;
+    }
+    switch (conv) {
+      case 'd': case 'i':
+        spec[k++] = 'l'; spec[k++] = 'l'; spec[k++] = conv; spec[k] = '\0';
+        emit(snprintf(out + n, cap - n, spec, (long long)iv));
+        break;
+      case 'u': case 'x': case 'X': case 'o':
+        spec[k++] = 'l'; spec[k++] = 'l'; spec[k++] = conv; spec[k] = '\0';
+        emit(snprintf(out + n, cap - n, spec, (unsigned long long)uv));
+        break;
+      case 'c':
+        spec[k++] = 'c'; spec[k] = '\0';
+        emit(snprintf(out + n, cap - n, spec, (int)iv));
+        break;
+      case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+        spec[k++] = conv; spec[k] = '\0';
+        emit(snprintf(out + n, cap - n, spec, fv));
+        break;
+      case 's':
+        if (tag != 's') {
+          out[n++] = '?';
+          break;
+        }
+        // 저장된 문자열은 NUL 로 끝나지 않는다 → 정밀도 = min(지정값, 길이)
+        spec[k++] = '.'; spec[k++] = '*'; spec[k++] = 's'; spec[k] = '\0';
+        emit(snprintf(out + n, cap - n, spec, prec >= 0 && prec < sl ? prec : (int)sl, sv));
+        break;
+      default:
+        out[n++] = '?';
+        break;
+    }
+  }
+  out[n] = '\0';
+  return n;
+}
+
+// "[    12.345] I pid 메시지" (/logs 는 앞에 seq)
+static size_t formatLine(uint32_t seq, const uint8_t* rec, size_t len, char* out, size_t cap, bool withSeq) {
+  const LogSite* site = recSite(rec);
+  uint32_t       ms   = recMs(rec);
+  uint8_t        cat  = 0;
+  while (cat < CAT_COUNT && !(site->cat & (1u << cat))) cat++;
+  int n = withSeq ? snprintf(out, cap, "%lu [%6lu.%03lu] %c %s ", (unsigned long)seq, (unsigned long)(ms / 1000),
+                             (unsigned long)(ms % 1000), LEVEL_CHARS[site->level & 3],
+                             cat < CAT_COUNT ? CAT_NAMES[cat] : "?")
+                  : snprintf(out, cap, "[%6lu.%03lu] %c %s ", (unsigned long)(ms / 1000), (unsigned long)(ms % 1000),
+                             LEVEL_CHARS[site->level & 3], cat < CAT_COUNT ? CAT_NAMES[cat] : "?");
+  if (n < 0 || (size_t)n >= cap - 2) return 0;
+  size_t m = (size_t)n;
+  m += formatMessage(site, rec + sizeof(const LogSite*) + 4, rec + len, out + m, cap - m - 1);
+  out[m++] = '\n';
+  out[m]   = '\0';
+  return m;
+}
+
+// ==================== log 작업 ====================
+void logBegin() {
+#ifdef ESP32
+  ringTask[LOG_RING_LOOP] = xTaskGetCurrentTaskHandle();
+#endif
+  // 시리얼로 보는 중이면 기존처럼 주기 줄(DEBUG)까지
+  if (isDEBUG && LOG_RUNTIME_LEVEL < LOG_LVL_DEBUG) gLogLevel = LOG_LVL_DEBUG;
+}
+
+void logBindControlTask() {
+#ifdef ESP32
+  ringTask[LOG_RING_CONTROL] = xTaskGetCurrentTaskHandle();
+#endif
+}
+
+static void historyPush(const uint8_t* rec, uint16_t len) {
+  uint8_t buf[LOG_RECORD_MAX + 4];
+  uint32_t seq = seqNext++;
+  memcpy(buf, &seq, 4);
+  memcpy(buf + 4, rec, len);
+  while (!history.push(buf, (uint16_t)(len + 4))) {
+    history.pop();
+    stats.overwritten++;
+  }
+  stats.records++;
+  stats.seq = seq;
+}
+
+// 시리얼: TX 버퍼에 빈 만큼만 (loop 가 UART 를 기다리지 않게). 밀려서 기록 링에서 지워진 줄은 건너뜀
+static bool serialPump(bool wait) {
+  for (;;) {
+    if (serialOff < serialLen) {
+      size_t room = wait ? serialLen - serialOff : (size_t)Serial.availableForWrite();
+      if (!room) return true;   // TX 버퍼가 빌 때까지 다음 주기로
+      if (room > serialLen - serialOff) room = serialLen - serialOff;
+      serialOff += Serial.write((const uint8_t*)serialLine + serialOff, room);
+      if (serialOff < serialLen) continue;
+    }
+    uint32_t oldest = history.begin();
+    if ((int32_t)(serialCursor - oldest) < 0) serialCursor = oldest;
+    uint16_t       len;
+    const uint8_t* rec = history.next(serialCursor, len);
+    if (!rec) return false;
+    uint32_t seq;
+    memcpy(&seq, rec, 4);
+    if (serialSeq && seq > serialSeq + 1) stats.serialSkipped += seq - serialSeq - 1;
+    serialSeq = seq;
+    serialLen = formatLine(seq, rec + 4, len - 4, serialLine, sizeof(serialLine), false);
+    serialOff = 0;
+  }
+}
+
+bool logDrain() {
+  // 두 태스크 링의 앞 줄 중 이른 것부터 (링 안에서는 이미 시각 순)
+  bool moved = false;
+  for (;;) {
+    uint16_t       len[LOG_RING_COUNT];
+    const uint8_t* rec[LOG_RING_COUNT];
+    int            pick = -1;
+    for (uint8_t i = 0; i < LOG_RING_COUNT; i++) {
+      rec[i] = taskRing[i].front(len[i]);
+      if (rec[i] && (pick < 0 || (int32_t)(recMs(rec[i]) - recMs(rec[pick])) < 0)) pick = i;
+    }
+    if (pick < 0) break;
+    historyPush(rec[pick], len[pick]);
+    taskRing[pick].pop();
+    moved = true;
+  }
+  if (isDEBUG) return serialPump(false) || moved;
+  serialCursor = history.begin() + history.used();   // 나중에 붙어도 지난 줄을 쏟지 않게
+  return moved;
+}
+
+void logFlush() {
+  logDrain();
+  if (!isDEBUG) return;
+  serialPump(true);
+  Serial.flush();
+}
+
+// ==================== 필터 / 조회 ====================
+void logSetFilter(uint8_t level, uint16_t cats) {
+  gLogLevel = level > LOG_LVL_DEBUG ? LOG_LVL_DEBUG : level;
+  gLogCats  = cats & LOG_CAT_ALL;
+}
+
+uint8_t  logLevel() { return gLogLevel; }
+uint16_t logCats()  { return gLogCats; }
+
+LogStats logStats() {
+  LogStats s     = stats;
+  s.ringDrops    = ringDrops[LOG_RING_LOOP] + ringDrops[LOG_RING_CONTROL];
+  s.foreignDrops = foreignDrops;
+  return s;
+}
+
+const char* logLevelName(uint8_t level) {
+  return level <= LOG_LVL_DEBUG ? LEVEL_NAMES[level] : "?";
+}
+
+const char* logCatName(uint16_t cat) {
+  for (uint8_t i = 0; i < CAT_COUNT; i++)
+    if (cat == (1u << i)) return CAT_NAMES[i];
+  return "?";
+}
+
+bool logLevelFromName(const char* s, uint8_t& out) {
+  for (uint8_t i = 0; i <= LOG_LVL_DEBUG; i++) {
+    if (strcmp(s, LEVEL_NAMES[i]) == 0) {
+      out = i;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool logCatsFromNames(const char* s, uint16_t& out) {
+  uint16_t mask = 0;
+  while (*s) {
+    const char* e = strchr(s, ',');
+    size_t      n = e ? (size_t)(e - s) : strlen(s);
+    bool        found = false;
+    if (n == 3 && strncmp(s, "all", 3) == 0) {
+      mask |= LOG_CAT_ALL;
+      found = true;
+    }
+    for (uint8_t i = 0; !found && i < CAT_COUNT; i++) {
+      if (strlen(CAT_NAMES[i]) == n && strncmp(s, CAT_NAMES[i], n) == 0) {
+        mask |= 1u << i;
+        found = true;
+      }
+    }
+    if (!found) return false;
+    s += n;
+    if (*s == ',') s++;
+  }
+  out = mask;
+  return true;
+}
+
+uint32_t logWriteText(uint32_t since, uint8_t level, uint16_t cats, LogSink sink, void* ctx) {
+  char     line[LOG_LINE_MAX];
+  uint32_t last   = since;
+  uint32_t cursor = history.begin();
+  uint16_t len;
+  for (const uint8_t* rec = history.next(cursor, len); rec; rec = history.next(cursor, len)) {
+    uint32_t seq;
+    memcpy(&seq, rec, 4);
+    if (seq <= since) continue;
+    last = seq;
+    const LogSite* site = recSite(rec + 4);
+    if (site->level > level || !(site->cat & cats)) continue;
+    size_t n = formatLine(seq, rec + 4, len - 4, line, sizeof(line), true);
+    if (n) sink(line, n, ctx);
+  }
+  return last;
+}
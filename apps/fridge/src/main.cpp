@@ -3,11 +3,32 @@
 #include <Preferences.h>
 #include <ArduinoJson.h>
 #include <MQTTClient.h>
-#include <NTPClient.h>
-#include <WiFiUdp.h>
 #include <ElegantOTA.h>
-#include <DHT.h>
 #include <math.h>
+#include "config.h"
+#include "state.h"
+#include "control.h"
+#include "storage.h"
+#include "telemetry.h"
+#include "telemetry_buffer.h"
+#include "telemetry_agg.h"
+#include "report_policy.h"
+#include "schedule.h"
+#include "commands.h"
+#include "event_stream.h"
+#include "mqtt_out.h"
+#include "history.h"
+#include "json_pool.h"
+#include "metrics.h"
+#include "scheduler.h"
+#include "timesync.h"
+#include "warm_boot.h"
+#include "log.h"
+#include "ota.h"
+#include "ota_image.h"
+#if CONFIG_PM_ENABLE
+#include <esp_pm.h>
+#endif
 
 // ===================== USER CONFIG =====================
 static const char* WIFI_SSID         = CONFIG_WIFI_SSID;
@@ -21,448 +42,374 @@ static const char* MQTT_CLIENT_ID    = CONFIG_MQTT_CLIENT_ID;
 static const uint16_t MQTT_KEEPALIVE_SEC = CONFIG_MQTT_KEEPALIVE_SEC;
 static const bool MQTT_CLEAN_SESSION = CONFIG_MQTT_CLEAN_SESSION;
 
-static const char* TOPIC_STATUS      = "/homebrew/status";   // publish QoS1
-static const char* TOPIC_CMD         = "/homebrew/cmd";      // subscribe QoS1
-static const char* TOPIC_ACK         = "/homebrew/ack";      // publish QoS2
-
 static const uint16_t HTTP_PORT          = 80;
-static const int       REPORT_INTERVAL_SEC = 1;
-static const float     TEMP_RAPID_DELTA    = 1.0f;
-static const float     TARGET_MIN          = 2.0f;
-static const float     TARGET_MAX          = 30.0f;
-
-// Sensor sanity check
-static const float SENSOR_TEMP_MIN       = -10.0f;   // 물리적으로 가능한 최저 온도
-static const float SENSOR_TEMP_MAX       = 50.0f;    // 물리적으로 가능한 최고 온도
-static const float SENSOR_HUM_MIN        = 5.0f;     // 최소 습도
-static const float SENSOR_HUM_MAX        = 99.0f;    // 최대 습도
-static const float SENSOR_TEMP_MAX_DELTA = 3.0f;     // 연속 읽기 간 최대 허용 온도 변화 (°C)
-static const float SENSOR_HUM_MAX_DELTA  = 10.0f;    // 연속 읽기 간 최대 허용 습도 변화 (%)
-
-// DHT21 (AM2301)
-static const int DHT_PIN = 4;           // 노란선(DATA)
-#define DHTTYPE DHT21
-
-// ===================== PELTIER CONFIG =====================
-static const int   PELTIER_PIN       = 18;          // MOSFET gate PWM 핀
-static const int   PELTIER_PWM_CH    = 0;           // LEDC 채널
-static const int   PELTIER_PWM_FREQ  = 25000;       // 25kHz PWM (MOSFET 스위칭에 적합)
-static const int   PELTIER_PWM_RES   = 8;           // 8비트 해상도 (0~255)
-static const int   PELTIER_PWM_MAX   = 255;
-static const int   PELTIER_PWM_MIN   = 0;
-
-// ===================== PID CONFIG =========================
-// 냉각 전용: error = temp - target (양수 = 냉각 필요)
-static const float PID_KP_DEFAULT    = 30.0f;   // 비례 게인
-static const float PID_KI_DEFAULT    = 0.5f;    // 적분 게인
-static const float PID_KD_DEFAULT    = 10.0f;   // 미분 게인
-static const float PID_INTEGRAL_MAX  = 200.0f;  // 적분 와인드업 방지 상한
-static const float PID_INTEGRAL_MIN  = -50.0f;  // 적분 와인드업 방지 하한 (역방향 제한)
-static const float PID_DEADBAND      = 0.2f;    // ±0.2°C 이내면 현재 출력 유지
-static const float PID_COMPUTE_SEC   = 1.0f;    // PID 연산 주기 (초)
-
-// 냉각 시작/정지 히스테리시스
-static const float COOL_START_OFFSET = 0.3f;    // target + 0.3°C 이상이면 냉각 시작
-static const float COOL_STOP_OFFSET  = -0.1f;   // target - 0.1°C 이하면 냉각 정지
-
-// 안전 제한
-static const float PELTIER_MAX_DUTY_PCT = 85.0f;   // 최대 듀티 85% (과열 방지)
-static const int   PELTIER_ABS_MAX_PWM  = (int)(PELTIER_PWM_MAX * PELTIER_MAX_DUTY_PCT / 100.0f);
-
-// =========================================================
 
 // ===================== DEBUG CONFIG =====================
 bool isDEBUG = true;
-#define LOG_WIFI    1
-#define LOG_MQTT    1
-#define LOG_HTTP    1
-#define LOG_SENSOR  1
-#define LOG_STATUS  1
-#define LOG_CMD     1
-#define LOG_PID     1
 // =======================================================
 
 // ===== Objects =====
 WebServer    http(HTTP_PORT);
 Preferences  prefs;
-WiFiClient   net;
-MQTTClient   mqtt(1024);
-WiFiUDP      ntpUDP;
-NTPClient    ntp(ntpUDP, "pool.ntp.org", 0, 10 * 60 * 1000);
-DHT          dht(DHT_PIN, DHTTYPE);
-
-// ===== PID State =====
-struct PIDState {
-  float kp           = PID_KP_DEFAULT;
-  float ki           = PID_KI_DEFAULT;
-  float kd           = PID_KD_DEFAULT;
-  float integral     = 0.0f;
-  float prevError    = 0.0f;
-  bool  firstRun     = true;
-  float outputPct    = 0.0f;     // 0~100 (%)
-  int   outputPWM    = 0;        // 0~255 실제 출력
-  bool  coolingActive = false;   // 냉각 중 여부 (히스테리시스용)
-  unsigned long lastComputeMs = 0;
-};
-PIDState pid;
-
-// ===== State =====
-struct StatusState {
-  float    temp           = NAN;
-  float    humidity       = NAN;
-  int      power          = 0;       // 0~100 (%) PID 출력
-  bool     hasTarget      = false;
-  float    target         = 0.0f;
-  bool     peltierEnabled = true;
-  uint32_t uptimeSec      = 0;
-  int      wifiRssi       = 0;
-  bool     mqttConnected  = false;
-  uint32_t ts             = 0;
-};
-StatusState gStatus;
-
-unsigned long lastStatusPublishMs  = 0;
-float         lastPublishedTemp    = NAN;
-unsigned long wifiLastAttemptMs    = 0;
-unsigned long mqttLastAttemptMs    = 0;
-uint32_t      mqttRetryCount       = 0;
+MQTTClient   mqtt(1024);   // 연결 / 구독 / 수신만. 발행은 mqtt_out
 
-static uint32_t nowUnix() {
-  if (ntp.isTimeSet()) return (uint32_t)ntp.getEpochTime();
-  return 0;
-}
-
-static String lastRestartCmdId = "";
-
-// ==================== Peltier PWM ====================
-static void peltierSetup() {
-  ledcSetup(PELTIER_PWM_CH, PELTIER_PWM_FREQ, PELTIER_PWM_RES);
-  ledcAttachPin(PELTIER_PIN, PELTIER_PWM_CH);
-  ledcWrite(PELTIER_PWM_CH, 0);  // 초기: OFF
-#if LOG_PID
-  if (isDEBUG) {
-    Serial.printf("[PELTIER] PWM init pin=%d ch=%d freq=%dHz res=%dbit\n",
-                  PELTIER_PIN, PELTIER_PWM_CH, PELTIER_PWM_FREQ, PELTIER_PWM_RES);
-  }
-#endif
-}
+uint32_t      mqttRetryCount       = 0;
 
-static void peltierWrite(int pwmVal) {
-  if (pwmVal < PELTIER_PWM_MIN) pwmVal = PELTIER_PWM_MIN;
-  if (pwmVal > PELTIER_ABS_MAX_PWM) pwmVal = PELTIER_ABS_MAX_PWM;
-  ledcWrite(PELTIER_PWM_CH, pwmVal);
+// ===== Scheduler =====
+// loop() 의 모든 주기 작업은 여기 등록된 작업으로만 돈다 (millis() 비교 없음)
+static TimerWheel<64, 8> sched(SCHED_TICK_MS);
+static int jobWifi  = -1;
+static int jobMqtt  = -1;
+static int jobNtp   = -1;
+static int jobNet   = -1;
+static int jobDrain = -1;
+static int jobNvs   = -1;
+static int jobLog   = -1;
+
+static TaskHandle_t  loopTaskHandle   = nullptr;
+static volatile bool wifiEventPending = false;   // WiFi 이벤트 태스크 → loop
+static unsigned long netActiveMs      = 0;       // 마지막 HTTP/MQTT 요청 시각
+
+// HTTP 요청 / MQTT 수신 / OTA 진행 중에는 네트워크 폴링을 빠르게 유지
+static void markNetActive() {
+  netActiveMs = millis();
 }
 
-static void peltierOff() {
-  peltierWrite(0);
-  pid.outputPct    = 0.0f;
-  pid.outputPWM    = 0;
-  pid.integral     = 0.0f;
-  pid.prevError    = 0.0f;
-  pid.firstRun     = true;
-  pid.coolingActive = false;
-}
+// ---------- WiFi ----------
+static bool wifiFastPending = false;   // 부팅 때 캐시된 채널/BSSID 로 결합 시도 중
 
-// ==================== PID 연산 ====================
-static void pidCompute() {
-  // 전제조건 확인
-  if (!gStatus.peltierEnabled || !gStatus.hasTarget || !isfinite(gStatus.temp)) {
-    if (pid.outputPWM != 0) {
-      peltierOff();
-      gStatus.power = 0;
-#if LOG_PID
-      if (isDEBUG) Serial.println("[PID] OFF (precondition not met)");
-#endif
-    }
+// 웜 부팅: 마지막 AP 의 채널/BSSID 로 스캔 없이 결합 (WARM_REUSE_IP 면 DHCP 도 생략).
+// 캐시가 없거나 첫 wifi 작업(WIFI_RETRY_MS)까지 붙지 못하면 평소처럼 전체 스캔
+static void wifiBeginBoot() {
+  WiFi.mode(WIFI_STA);
+  WarmWifi w;
+  if (!warmWifi(w)) {
+    WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
     return;
   }
-
-  unsigned long now = millis();
-  if (now - pid.lastComputeMs < (unsigned long)(PID_COMPUTE_SEC * 1000.0f)) return;
-  pid.lastComputeMs = now;
-
-  float error = gStatus.temp - gStatus.target;  // 양수 = 현재 온도가 높음 = 냉각 필요
-
-  // --- 히스테리시스: 냉각 시작/정지 판단 ---
-  if (!pid.coolingActive) {
-    // 냉각 OFF 상태: target + COOL_START_OFFSET 이상이면 냉각 시작
-    if (error > COOL_START_OFFSET) {
-      pid.coolingActive = true;
-      pid.integral  = 0.0f;
-      pid.firstRun  = true;
-#if LOG_PID
-      if (isDEBUG) Serial.printf("[PID] cooling START (temp=%.1f target=%.1f err=%.2f)\n",
-                                  gStatus.temp, gStatus.target, error);
-#endif
-    } else {
-      // 냉각 불필요 -> 출력 0 유지
-      if (pid.outputPWM != 0) {
-        peltierOff();
-        gStatus.power = 0;
-#if LOG_PID
-        if (isDEBUG) Serial.println("[PID] OFF (below start threshold)");
-#endif
-      }
-      return;
-    }
-  } else {
-    // 냉각 ON 상태: target + COOL_STOP_OFFSET 이하면 냉각 정지
-    if (error < COOL_STOP_OFFSET) {
-      pid.coolingActive = false;
-      peltierOff();
-      gStatus.power = 0;
-#if LOG_PID
-      if (isDEBUG) Serial.printf("[PID] cooling STOP (temp=%.1f target=%.1f err=%.2f)\n",
-                                  gStatus.temp, gStatus.target, error);
-#endif
-      return;
-    }
-  }
-
-  // --- 데드밴드: 목표 근처에서 미세 진동 방지 ---
-  float dt = PID_COMPUTE_SEC;
-
-  // Proportional
-  float P = pid.kp * error;
-
-  // Integral (데드밴드 밖에서만 적분)
-  if (fabsf(error) > PID_DEADBAND) {
-    pid.integral += error * dt;
-  }
-  // 와인드업 클램프
-  if (pid.integral > PID_INTEGRAL_MAX)  pid.integral = PID_INTEGRAL_MAX;
-  if (pid.integral < PID_INTEGRAL_MIN)  pid.integral = PID_INTEGRAL_MIN;
-  float I = pid.ki * pid.integral;
-
-  // Derivative (kick 방지: 에러 미분 대신 에러 변화 사용)
-  float D = 0.0f;
-  if (!pid.firstRun) {
-    float dError = (error - pid.prevError) / dt;
-    D = pid.kd * dError;
-  }
-  pid.prevError = error;
-  pid.firstRun  = false;
-
-  // PID 출력 (0~100%)
-  float output = P + I + D;
-  if (output < 0.0f)   output = 0.0f;
-  if (output > 100.0f) output = 100.0f;
-
-  // % → PWM 변환
-  int pwm = (int)((output / 100.0f) * (float)PELTIER_ABS_MAX_PWM);
-  if (pwm < 0)                  pwm = 0;
-  if (pwm > PELTIER_ABS_MAX_PWM) pwm = PELTIER_ABS_MAX_PWM;
-
-  pid.outputPct = output;
-  pid.outputPWM = pwm;
-  gStatus.power = (int)(output + 0.5f);  // 반올림하여 0~100%
-
-  peltierWrite(pwm);
-
-#if LOG_PID
-  if (isDEBUG) {
-    Serial.printf("[PID] temp=%.1f target=%.1f err=%.2f | P=%.1f I=%.1f(int=%.1f) D=%.1f | out=%.1f%% pwm=%d/%d\n",
-                  gStatus.temp, gStatus.target, error,
-                  P, I, pid.integral, D,
-                  output, pwm, PELTIER_ABS_MAX_PWM);
-  }
-#endif
-}
-
-// ---------- NVS ----------
-static void loadFromNVS() {
-  prefs.begin("homebrew", true);
-  gStatus.hasTarget      = prefs.getBool("has_target", false);
-  gStatus.target         = prefs.getFloat("target", 0.0f);
-  gStatus.peltierEnabled = prefs.getBool("peltier_en", true);
-  lastRestartCmdId       = prefs.getString("restart_id", "");
-  prefs.end();
-#if LOG_CMD
-  if (isDEBUG) {
-    Serial.print("[NVS] hasTarget="); Serial.print(gStatus.hasTarget ? "true" : "false");
-    Serial.print(" target=");         Serial.print(gStatus.target, 2);
-    Serial.print(" peltierEnabled="); Serial.println(gStatus.peltierEnabled ? "true" : "false");
-    Serial.print("[NVS] lastRestartCmdId="); Serial.println(lastRestartCmdId);
-  }
-#endif
+  if (WARM_REUSE_IP && w.ip)
+    WiFi.config(IPAddress(w.ip), IPAddress(w.gateway), IPAddress(w.subnet), IPAddress(w.dns));
+  WiFi.begin(WIFI_SSID, WIFI_PASSWORD, w.channel, w.bssid);
+  wifiFastPending = true;
+  LOG_I(WIFI, "fast connect ch=%u bssid=%02x:%02x:%02x:%02x:%02x:%02x%s",
+        (unsigned)w.channel, w.bssid[0], w.bssid[1], w.bssid[2], w.bssid[3],
+        w.bssid[4], w.bssid[5], WARM_REUSE_IP && w.ip ? " static-ip" : "");
 }
 
-static void saveTargetToNVS(bool hasTarget, float target) {
-  prefs.begin("homebrew", false);
-  prefs.putBool("has_target", hasTarget);
-  prefs.putFloat("target", target);
-  prefs.end();
-#if LOG_CMD
-  if (isDEBUG) {
-    Serial.print("[NVS] save target hasTarget="); Serial.print(hasTarget ? "true" : "false");
-    Serial.print(" target="); Serial.println(target, 2);
-  }
-#endif
+// 붙은 AP / 주소를 다음 부팅용으로
+static void wifiRemember() {
+  WarmWifi w;
+  memcpy(w.bssid, WiFi.BSSID(), sizeof(w.bssid));
+  w.channel = (uint8_t)WiFi.channel();
+  w.ip      = (uint32_t)WiFi.localIP();
+  w.gateway = (uint32_t)WiFi.gatewayIP();
+  w.subnet  = (uint32_t)WiFi.subnetMask();
+  w.dns     = (uint32_t)WiFi.dnsIP();
+  warmSaveWifi(w);
 }
 
-static void savePeltierEnabledToNVS(bool en) {
-  prefs.begin("homebrew", false);
-  prefs.putBool("peltier_en", en);
-  prefs.end();
-#if LOG_CMD
-  if (isDEBUG) {
-    Serial.print("[NVS] save peltierEnabled="); Serial.println(en ? "true" : "false");
+// 연결/끊김 엣지 처리. WiFi 이벤트로 깨어났을 때와 wifi 작업에서 호출
+static void wifiCheckEdge() {
+  static bool wifiWasConnected = false;
+  bool wifiNow = (WiFi.status() == WL_CONNECTED);
+  if (wifiNow && !wifiWasConnected) {
+    wifiFastPending = false;
+    bootMarkWifi();
+    wifiRemember();
+    LOG_I(WIFI, "connected IP=%s ch=%u", WiFi.localIP().toString().c_str(), (unsigned)WiFi.channel());
+    // 연결되자마자 MQTT / NTP 를 시도
+    sched.schedule(jobMqtt, 0);
+    sched.schedule(jobNtp, 0);
   }
-#endif
-}
-
-static void saveRestartCmdIdToNVS(const char* id) {
-  prefs.begin("homebrew", false);
-  prefs.putString("restart_id", id);
-  prefs.end();
-#if LOG_CMD
-  if (isDEBUG) {
-    Serial.print("[NVS] save restart_id="); Serial.println(id);
+  if (!wifiNow && wifiWasConnected) {
+    LOG_I(WIFI, "disconnected");
   }
-#endif
+  wifiWasConnected = wifiNow;
 }
 
-// ---------- WiFi ----------
-static void wifiConnectNonBlocking() {
+static void wifiJob(void*) {
+  StageTimer t(STAGE_WIFI);
+  wifiCheckEdge();
   if (WiFi.status() == WL_CONNECTED) return;
-  unsigned long now = millis();
-  if (now - wifiLastAttemptMs < 3000) return;
-  wifiLastAttemptMs = now;
-#if LOG_WIFI
-  if (isDEBUG) { Serial.print("[WIFI] connecting to "); Serial.println(WIFI_SSID); }
-#endif
+  if (wifiFastPending) {
+    // 캐시가 맞지 않음 (AP 가 채널을 바꿨거나 다른 AP): 버리고 DHCP + 전체 스캔으로
+    wifiFastPending = false;
+    warmForgetWifi();
+    if (WARM_REUSE_IP) WiFi.config(IPAddress((uint32_t)0), IPAddress((uint32_t)0), IPAddress((uint32_t)0));
+    LOG_W(WIFI, "fast connect failed, full scan");
+  }
+  LOG_I(WIFI, "connecting to %s", WIFI_SSID);
   WiFi.mode(WIFI_STA);
   WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
 }
 
 // ---------- HTTP ----------
-static String buildStatusJson(bool includeExtras) {
-  StaticJsonDocument<512> doc;
-  if (isfinite(gStatus.temp))
-    doc["temp"] = (float)(roundf(gStatus.temp * 10.0f) / 10.0f);
-  else
-    doc["temp"] = nullptr;
-  if (isfinite(gStatus.humidity))
-    doc["humidity"] = (float)(roundf(gStatus.humidity * 10.0f) / 10.0f);
-  else
-    doc["humidity"] = nullptr;
-
-  doc["power"]           = gStatus.power;
-  doc["peltier_enabled"] = gStatus.peltierEnabled;
-
-  if (gStatus.hasTarget)
-    doc["target"] = (float)gStatus.target;
-  else
-    doc["target"] = nullptr;
-
-  doc["ts"] = gStatus.ts;
-
-  if (includeExtras) {
-    doc["uptime"]         = gStatus.uptimeSec;
-    doc["wifi_rssi"]      = gStatus.wifiRssi;
-    doc["mqtt_connected"] = gStatus.mqttConnected;
-    // PID 디버그 정보
-    JsonObject pidInfo    = doc.createNestedObject("pid");
-    pidInfo["kp"]         = pid.kp;
-    pidInfo["ki"]         = pid.ki;
-    pidInfo["kd"]         = pid.kd;
-    pidInfo["integral"]   = (float)(roundf(pid.integral * 10.0f) / 10.0f);
-    pidInfo["output_pct"] = (float)(roundf(pid.outputPct * 10.0f) / 10.0f);
-    pidInfo["pwm"]        = pid.outputPWM;
-    pidInfo["cooling"]    = pid.coolingActive;
+// 응답 본문은 고정 버퍼에 직렬화해 send_P 로 보낸다 (String 복사 없음)
+static char httpBuf[STATUS_JSON_MAX];
+// HTTP 핸들러 JsonDocument 고정 풀: 요청 본문 / 응답 (POST 는 둘이 동시에 산다)
+static JsonPool<jsonPoolBytes(1, 192)> httpReqPool;
+static JsonPool<jsonPoolBytes(1, 320)> httpRespPool;   // /logs 분류 이름 복사
+
+static void sendJson(int code, size_t len) {
+  markNetActive();
+  http.send_P(code, "application/json", httpBuf, len);
+}
+
+// ?zone=<이름|번호> (없으면 존 0). 모르는 존이면 404 를 보내고 -1
+static int httpZoneArg() {
+  if (!http.hasArg("zone")) return 0;
+  int z = zoneFromArg(http.arg("zone").c_str());
+  if (z < 0) {
+    markNetActive();
+    http.send(404, "application/json", "{\"error\":\"unknown_zone\"}");
   }
+  return z;
+}
 
-  String out;
-  serializeJson(doc, out);
-  return out;
+// GET/PUT/DELETE /ota 응답. reject = 이번 조각을 받지 않은 이유 (otaChunkEnd)
+static size_t otaStatusJson(const char* reject) {
+  OtaStatus s = otaStatus();
+  JsonDocument doc(httpRespPool.reset());
+  doc["state"] = otaStateName(s.state);
+  if (s.error) doc["error"] = s.error;
+  if (reject)  doc["reject"] = reject;
+  doc["codec"]           = s.codec == OTA_CODEC_LZSS ? "lzss" : "stored";
+  doc["received"]        = s.received;
+  doc["total"]           = s.total;
+  doc["raw"]             = s.rawSize;
+  doc["written"]         = s.written;
+  doc["chunks"]          = s.chunks;
+  doc["resumes"]         = s.resumes;
+  doc["duplicate_bytes"] = s.duplicateBytes;
+  doc["elapsed_ms"]      = s.elapsedMs;
+  return serializeJson(doc, httpBuf, sizeof(httpBuf));
 }
 
-static String buildHealthJson(bool ok, const char* errCodeOrNull) {
-  StaticJsonDocument<160> doc;
-  doc["status"] = ok ? "ok" : "error";
-  if (!ok) doc["error"] = errCodeOrNull;
-  doc["uptime"] = gStatus.uptimeSec;
-  String out;
-  serializeJson(doc, out);
-  return out;
+static bool zoneSensorOk(uint8_t z) {
+  return isfinite(gZone[z].temp) && isfinite(gZone[z].humidity);
 }
 
 static void setupHttpRoutes() {
   http.on("/status", HTTP_GET, []() {
-#if LOG_HTTP
-    if (isDEBUG) Serial.println("[HTTP] GET /status");
-#endif
-    http.send(200, "application/json", buildStatusJson(true));
+    LOG_D(HTTP, "GET /status");
+    int z = httpZoneArg();
+    if (z < 0) return;
+    sendJson(200, buildStatusJson((uint8_t)z, httpBuf, sizeof(httpBuf), true));
   });
 
   http.on("/health", HTTP_GET, []() {
-#if LOG_HTTP
-    if (isDEBUG) Serial.println("[HTTP] GET /health");
-#endif
-    bool sensorOk = isfinite(gStatus.temp) && isfinite(gStatus.humidity);
+    LOG_D(HTTP, "GET /health");
+    // ?zone= 가 있으면 그 존만, 없으면 모든 존 센서가 살아 있어야 ok
+    bool sensorOk = true;
+    if (http.hasArg("zone")) {
+      int z = httpZoneArg();
+      if (z < 0) return;
+      sensorOk = zoneSensorOk((uint8_t)z);
+    } else {
+      for (uint8_t z = 0; z < ZONE_COUNT; z++) sensorOk = sensorOk && zoneSensorOk(z);
+    }
     if (sensorOk)
-      http.send(200, "application/json", buildHealthJson(true, nullptr));
+      sendJson(200, buildHealthJson(httpBuf, sizeof(httpBuf), true, nullptr));
     else
-      http.send(503, "application/json", buildHealthJson(false, "sensor_failure"));
+      sendJson(503, buildHealthJson(httpBuf, sizeof(httpBuf), false, "sensor_failure"));
   });
 
   // PID 튜닝 엔드포인트 (GET으로 조회, POST로 변경)
   http.on("/pid", HTTP_GET, []() {
-#if LOG_HTTP
-    if (isDEBUG) Serial.println("[HTTP] GET /pid");
-#endif
-    StaticJsonDocument<128> doc;
-    doc["kp"] = pid.kp;
-    doc["ki"] = pid.ki;
-    doc["kd"] = pid.kd;
-    String out;
-    serializeJson(doc, out);
-    http.send(200, "application/json", out);
+    LOG_D(HTTP, "GET /pid");
+    int z = httpZoneArg();
+    if (z < 0) return;
+    JsonDocument doc(httpRespPool.reset());
+    doc["kp"] = gControl[z].kp;
+    doc["ki"] = gControl[z].ki;
+    doc["kd"] = gControl[z].kd;
+    sendJson(200, serializeJson(doc, httpBuf, sizeof(httpBuf)));
   });
 
   http.on("/pid", HTTP_POST, []() {
-#if LOG_HTTP
-    if (isDEBUG) Serial.println("[HTTP] POST /pid");
-#endif
-    StaticJsonDocument<128> doc;
+    LOG_D(HTTP, "POST /pid");
+    int z = httpZoneArg();
+    if (z < 0) return;
+    JsonDocument doc(httpReqPool.reset());
     if (deserializeJson(doc, http.arg("plain"))) {
+      markNetActive();
       http.send(400, "application/json", "{\"error\":\"invalid_json\"}");
       return;
     }
-    if (doc.containsKey("kp")) pid.kp = doc["kp"].as<float>();
-    if (doc.containsKey("ki")) pid.ki = doc["ki"].as<float>();
-    if (doc.containsKey("kd")) pid.kd = doc["kd"].as<float>();
-    // 적분 리셋 (게인 변경 시)
-    pid.integral = 0.0f;
-    pid.firstRun = true;
-#if LOG_PID
-    if (isDEBUG) Serial.printf("[PID] tuning updated kp=%.2f ki=%.2f kd=%.2f\n", pid.kp, pid.ki, pid.kd);
-#endif
-    StaticJsonDocument<128> resp;
-    resp["kp"] = pid.kp;
-    resp["ki"] = pid.ki;
-    resp["kd"] = pid.kd;
-    String out;
-    serializeJson(resp, out);
-    http.send(200, "application/json", out);
+    // 게인 변경 + 적분 리셋은 제어 태스크에서 다음 주기에 반영
+    ControlSnapshot& g = gControl[z];
+    ControlCommand   c = {CTL_CMD_SET_GAINS, false, g.kp, g.ki, g.kd, (uint8_t)z};
+    if (doc.containsKey("kp")) c.a = doc["kp"].as<float>();
+    if (doc.containsKey("ki")) c.b = doc["ki"].as<float>();
+    if (doc.containsKey("kd")) c.c = doc["kd"].as<float>();
+    if (!pidGainValid(c.a) || !pidGainValid(c.b) || !pidGainValid(c.c)) {
+      markNetActive();
+      http.send(400, "application/json", "{\"error\":\"invalid_gain\"}");
+      return;
+    }
+    if (!controlPost(c)) {
+      markNetActive();
+      http.send(503, "application/json", "{\"error\":\"busy\"}");
+      return;
+    }
+    g.kp = c.a;
+    g.ki = c.b;
+    g.kd = c.c;
+    storePidGains((uint8_t)z, c.a, c.b, c.c);
+    JsonDocument resp(httpRespPool.reset());
+    resp["kp"] = c.a;
+    resp["ki"] = c.b;
+    resp["kd"] = c.c;
+    sendJson(200, serializeJson(resp, httpBuf, sizeof(httpBuf)));
+  });
+
+  // 구간별 지연 히스토그램 + 카운터 (Prometheus 텍스트)
+  http.on("/metrics", HTTP_GET, []() {
+    LOG_D(HTTP, "GET /metrics");
+    markNetActive();
+    static char metricsBuf[METRICS_TEXT_MAX];
+    size_t len = buildMetricsText(metricsBuf, sizeof(metricsBuf));
+    len += buildSchedMetrics(sched, metricsBuf + len, sizeof(metricsBuf) - len);
+    http.send_P(200, "text/plain; version=0.0.4", metricsBuf, len);
+  });
+
+  // 이력: ?from=&to= (historyClock 초) ?points= (LTTB 로 줄일 점 수). 조각 단위로 바로 보낸다
+  http.on("/history", HTTP_GET, []() {
+    LOG_D(HTTP, "GET /history");
+    int z = httpZoneArg();
+    if (z < 0) return;
+    uint32_t from   = http.hasArg("from") ? strtoul(http.arg("from").c_str(), nullptr, 10) : 0;
+    uint32_t to     = http.hasArg("to") ? strtoul(http.arg("to").c_str(), nullptr, 10) : UINT32_MAX;
+    uint32_t points = http.hasArg("points") ? strtoul(http.arg("points").c_str(), nullptr, 10) : HISTORY_POINTS_DEFAULT;
+    if (points > HISTORY_POINTS_MAX) points = HISTORY_POINTS_MAX;
+    markNetActive();
+    http.setContentLength(CONTENT_LENGTH_UNKNOWN);   // HTTP/1.1 이면 chunked
+    http.send(200, "application/json", "");
+    HistoryResult r = historyWriteJson((uint8_t)z, from, to, points,
+                                       [](const char* data, size_t len, void*) { http.sendContent(data, len); },
+                                       nullptr);
+    http.sendContent("");   // 마지막 빈 조각
+    LOG_D(HTTP, "/history samples=%u points=%u bytes=%u chunks=%u",
+          (unsigned)r.samples, (unsigned)r.points, (unsigned)r.bytes, (unsigned)r.chunks);
+  });
+
+  // 로그 기록 링: ?since=<seq> (그 뒤 줄만) ?level=error|warn|info|debug ?cats=pid,sensor|all
+  // 응답 끝의 "# next=<seq>" 를 다음 요청의 since 로 쓰면 이어서 받는다
+  http.on("/logs", HTTP_GET, []() {
+    uint32_t since = http.hasArg("since") ? strtoul(http.arg("since").c_str(), nullptr, 10) : 0;
+    uint8_t  level = LOG_LVL_DEBUG;
+    uint16_t cats  = LOG_CAT_ALL;
+    if ((http.hasArg("level") && !logLevelFromName(http.arg("level").c_str(), level)) ||
+        (http.hasArg("cats") && !logCatsFromNames(http.arg("cats").c_str(), cats))) {
+      markNetActive();
+      http.send(400, "application/json", "{\"error\":\"invalid_filter\"}");
+      return;
+    }
+    markNetActive();
+    http.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    http.send(200, "text/plain", "");
+    // 줄을 httpBuf 에 모아 조각 단위로
+    size_t fill = 0;
+    uint32_t next = logWriteText(since, level, cats, [](const char* line, size_t len, void* ctx) {
+      size_t& n = *(size_t*)ctx;
+      if (n + len > sizeof(httpBuf)) {
+        http.sendContent(httpBuf, n);
+        n = 0;
+      }
+      memcpy(httpBuf + n, line, len);
+      n += len;
+    }, &fill);
+    if (fill + 24 > sizeof(httpBuf)) {
+      http.sendContent(httpBuf, fill);
+      fill = 0;
+    }
+    fill += snprintf(httpBuf + fill, sizeof(httpBuf) - fill, "# next=%lu\n", (unsigned long)next);
+    http.sendContent(httpBuf, fill);
+    http.sendContent("");
+  });
+
+  // 실행 중 필터 변경: {"level":"debug","cats":"pid,sensor"} (빠진 항목은 그대로)
+  http.on("/logs", HTTP_POST, []() {
+    JsonDocument doc(httpReqPool.reset());
+    uint8_t  level = logLevel();
+    uint16_t cats  = logCats();
+    bool     ok    = !deserializeJson(doc, http.arg("plain"));
+    if (ok && doc["level"].is<const char*>()) ok = logLevelFromName(doc["level"].as<const char*>(), level);
+    if (ok && doc["cats"].is<const char*>())  ok = logCatsFromNames(doc["cats"].as<const char*>(), cats);
+    if (!ok) {
+      markNetActive();
+      http.send(400, "application/json", "{\"error\":\"invalid_filter\"}");
+      return;
+    }
+    logSetFilter(level, cats);
+    LOG_I(SYS, "log filter level=%s cats=0x%03x", logLevelName(level), (unsigned)cats);
+    JsonDocument resp(httpRespPool.reset());
+    resp["level"]  = logLevelName(logLevel());
+    JsonArray list = resp.createNestedArray("cats");
+    for (uint16_t bit = 1; bit & LOG_CAT_ALL; bit <<= 1)
+      if (logCats() & bit) list.add(logCatName(bit));
+    sendJson(200, serializeJson(resp, httpBuf, sizeof(httpBuf)));
+  });
+
+  // SSE 는 연결을 붙잡아야 해서 동기식 WebServer 대신 STREAM_PORT 의 논블로킹 서버가 맡는다
+  http.on("/stream", HTTP_GET, []() {
+    LOG_D(HTTP, "GET /stream -> redirect");
+    markNetActive();
+    String host = WiFi.localIP().toString();
+    if (http.hasArg("zone"))
+      snprintf(httpBuf, sizeof(httpBuf), "http://%s:%u/stream?zone=%s", host.c_str(), (unsigned)STREAM_PORT,
+               http.arg("zone").c_str());
+    else
+      snprintf(httpBuf, sizeof(httpBuf), "http://%s:%u/stream", host.c_str(), (unsigned)STREAM_PORT);
+    http.sendHeader("Location", httpBuf);
+    http.send(307, "text/plain", "");
+  });
+
+  // 이어받기 OTA (ota.h): 본문은 raw 핸들러가 들어오는 대로 받아 바로 풀어서 쓴다 (버퍼링 없음).
+  // 200 = 받음, 409 = 이 조각은 안 받음 (reject: gap → received 부터 다시), 422 = 이미지 검증 실패
+  http.on("/ota", HTTP_GET, []() {
+    sendJson(200, otaStatusJson(nullptr));
+  });
+  http.on("/ota", HTTP_PUT, []() {
+    const char* reject = otaChunkEnd();
+    int         code   = reject ? 409 : otaStatus().state == OTA_FAILED ? 422 : 200;
+    sendJson(code, otaStatusJson(reject));
+  }, []() {
+    HTTPRaw& raw = http.raw();
+    markNetActive();
+    if (raw.status == RAW_START)
+      otaChunkBegin(http.hasArg("offset") ? strtoul(http.arg("offset").c_str(), nullptr, 10) : 0);
+    else if (raw.status == RAW_WRITE)
+      otaChunkWrite(raw.buf, raw.currentSize);
+    else if (raw.status == RAW_ABORTED)
+      otaChunkEnd();   // 연결 끊김: 받은 데까지는 유효
+  });
+  http.on("/ota", HTTP_DELETE, []() {
+    otaAbort();
+    sendJson(200, otaStatusJson(nullptr));
   });
 
   http.on("/", HTTP_GET, []() {
+    markNetActive();
     http.send(200, "text/html",
       "<html><body style='font-family:monospace;padding:20px'>"
       "<h2>Homebrew MCU</h2>"
       "<ul>"
-      "<li><a href='/status'>/status</a></li>"
+      "<li><a href='/status'>/status</a> (?zone=이름|번호)</li>"
       "<li><a href='/health'>/health</a></li>"
-      "<li><a href='/pid'>/pid</a> (GET=조회, POST=튜닝)</li>"
+      "<li><a href='/pid'>/pid</a> (GET=조회, POST=튜닝, ?zone=)</li>"
+      "<li><a href='/metrics'>/metrics</a> (구간별 지연)</li>"
+      "<li><a href='/stream'>/stream</a> (SSE 실시간 상태, ?zone=)</li>"
+      "<li><a href='/history'>/history</a> (?from=&amp;to=&amp;points=&amp;zone=)</li>"
+      "<li><a href='/logs'>/logs</a> (?since=&amp;level=&amp;cats=, POST=실행 중 필터)</li>"
+      "<li><a href='/ota'>/ota</a> (이어받기 + 압축 OTA, PUT ?offset=)</li>"
       "<li><a href='/update'>/update</a> (OTA)</li>"
       "</ul></body></html>");
   });
 
   http.onNotFound([]() {
-#if LOG_HTTP
-    if (isDEBUG) { Serial.print("[HTTP] 404 "); Serial.println(http.uri()); }
-#endif
+    LOG_D(HTTP, "404 %s", http.uri().c_str());
+    markNetActive();
     http.send(404, "text/plain", "Not Found");
   });
 }
@@ -476,283 +423,141 @@ static unsigned long mqttBackoffMs(uint32_t attempt) {
   return 60000;
 }
 
-// ---------- MQTT publish helpers ----------
-enum AckValueMode : uint8_t {
-  ACK_VALUE_NONE  = 0,
-  ACK_VALUE_FLOAT = 1,
-  ACK_VALUE_NULL  = 2,
-  ACK_VALUE_BOOL  = 3
-};
-
-static void publishAck(const char* id, const char* cmd, bool success,
-                        const char* errorOrNull,
-                        AckValueMode valueMode = ACK_VALUE_NONE,
-                        float fvalue = 0.0f, bool bvalue = false) {
-  StaticJsonDocument<320> doc;
-  doc["id"]      = id;
-  doc["cmd"]     = cmd;
-  doc["success"] = success;
-  doc["error"]   = success ? nullptr : errorOrNull;
-  if      (valueMode == ACK_VALUE_FLOAT) doc["value"] = fvalue;
-  else if (valueMode == ACK_VALUE_NULL)  doc["value"] = nullptr;
-  else if (valueMode == ACK_VALUE_BOOL)  doc["value"] = bvalue;
-  doc["ts"] = nowUnix();
-
-  String out;
-  serializeJson(doc, out);
-#if LOG_CMD
-  if (isDEBUG) { Serial.print("[MQTT] ACK(QoS2) -> "); Serial.print(TOPIC_ACK); Serial.print(" payload="); Serial.println(out); }
-#endif
-  mqtt.publish(TOPIC_ACK, out.c_str(), false, 2);
-}
-
-static void publishStatus() {
-  String body = buildStatusJson(false);
-#if LOG_STATUS
-  if (isDEBUG) { Serial.print("[MQTT] STATUS(QoS1) -> "); Serial.print(TOPIC_STATUS); Serial.print(" payload="); Serial.println(body); }
-#endif
-  mqtt.publish(TOPIC_STATUS, body.c_str(), false, 1);
-  lastStatusPublishMs = millis();
-  if (isfinite(gStatus.temp)) lastPublishedTemp = gStatus.temp;
-}
-
-static bool shouldPublishStatus() {
-  unsigned long now = millis();
-  if (now - lastStatusPublishMs >= (unsigned long)REPORT_INTERVAL_SEC * 1000UL)
-    return true;
-  if (isfinite(gStatus.temp) && isfinite(lastPublishedTemp)) {
-    if (fabsf(gStatus.temp - lastPublishedTemp) >= TEMP_RAPID_DELTA)
-      return true;
-  }
-  if (!isfinite(lastPublishedTemp) && isfinite(gStatus.temp))
-    return true;
-  return false;
-}
-
-// ---------- Commands ----------
-static void handleCommandMessage(const String& payload) {
-#if LOG_CMD
-  if (isDEBUG) { Serial.print("[MQTT] CMD payload="); Serial.println(payload); }
-#endif
-  StaticJsonDocument<512> doc;
-  if (deserializeJson(doc, payload)) {
-#if LOG_CMD
-    if (isDEBUG) Serial.println("[MQTT] CMD JSON parse failed");
-#endif
-    return;
-  }
-  const char* cmd = doc["cmd"] | "";
-  const char* id  = doc["id"]  | "";
-  if (strlen(cmd) == 0 || strlen(id) == 0) {
-#if LOG_CMD
-    if (isDEBUG) Serial.println("[MQTT] CMD missing cmd/id");
-#endif
-    return;
-  }
-
-  // ---- set_peltier (value: true/false) ----
-  if (strcmp(cmd, "set_peltier") == 0) {
-    if (!doc.containsKey("value") || (!doc["value"].is<bool>() && !doc["value"].is<int>())) {
-      publishAck(id, cmd, false, "invalid_value");
-      return;
-    }
-    bool en = doc["value"].as<bool>();
-    gStatus.peltierEnabled = en;
-    savePeltierEnabledToNVS(en);
-#if LOG_CMD
-    if (isDEBUG) { Serial.print("[CMD] set_peltier -> "); Serial.println(en ? "true" : "false"); }
-#endif
-    if (!en) {
-      peltierOff();
-      gStatus.power = 0;
-    }
-    publishAck(id, cmd, true, nullptr, ACK_VALUE_BOOL, 0.0f, en);
-    return;
-  }
-
-  // 펠티어 비활성 상태에서 다른 제어 명령 거부
-  if (!gStatus.peltierEnabled) {
-#if LOG_CMD
-    if (isDEBUG) Serial.println("[CMD] rejected: peltier disabled (not_ready)");
-#endif
-    publishAck(id, cmd, false, "not_ready");
-    return;
-  }
-
-  // ---- set_target ----
-  if (strcmp(cmd, "set_target") == 0) {
-    if (doc["value"].isNull()) {
-      gStatus.hasTarget = false;
-      gStatus.target    = 0.0f;
-      saveTargetToNVS(false, 0.0f);
-      peltierOff();
-      gStatus.power = 0;
-#if LOG_CMD
-      if (isDEBUG) Serial.println("[CMD] set_target null -> target cleared, peltier off");
-#endif
-      publishAck(id, cmd, true, nullptr, ACK_VALUE_NULL);
-      return;
-    }
-    if (!doc["value"].is<float>() && !doc["value"].is<int>() && !doc["value"].is<double>()) {
-      publishAck(id, cmd, false, "invalid_value");
-      return;
-    }
-    float v = doc["value"].as<float>();
-    if (v < TARGET_MIN || v > TARGET_MAX) {
-      publishAck(id, cmd, false, "invalid_value");
-      return;
-    }
-    gStatus.hasTarget = true;
-    gStatus.target    = v;
-    saveTargetToNVS(true, v);
-    // 목표 변경 시 PID 적분 리셋
-    pid.integral = 0.0f;
-    pid.firstRun = true;
-#if LOG_CMD
-    if (isDEBUG) { Serial.print("[CMD] set_target -> "); Serial.println(v, 2); }
-#endif
-    publishAck(id, cmd, true, nullptr, ACK_VALUE_FLOAT, v);
-    return;
-  }
-
-  // ---- restart ----
-  if (strcmp(cmd, "restart") == 0) {
-#if LOG_CMD
-    if (isDEBUG) Serial.println("[CMD] restart requested");
-#endif
-    if (lastRestartCmdId.length() > 0 && lastRestartCmdId == String(id)) {
-#if LOG_CMD
-      if (isDEBUG) Serial.println("[CMD] restart ignored: duplicate cmd id");
-#endif
-      return;
-    }
-    lastRestartCmdId = String(id);
-    saveRestartCmdIdToNVS(id);
-    peltierOff();  // 안전: 재시작 전 펠티어 OFF
-    publishAck(id, cmd, true, nullptr);
-    delay(200);
-    ESP.restart();
-    return;
-  }
-
-  publishAck(id, cmd, false, "invalid_cmd");
-}
-
-static void onMqttMessage(String& topic, String& payload) {
-#if LOG_MQTT
-  if (isDEBUG) { Serial.print("[MQTT] RX topic="); Serial.print(topic); Serial.print(" payload="); Serial.println(payload); }
-#endif
-  if (topic == TOPIC_CMD) handleCommandMessage(payload);
+// advanced 콜백: 라이브러리 수신 버퍼를 그대로 받는다 (String 생성 없음)
+static void onMqttMessage(MQTTClient* client, char topic[], char bytes[], int length) {
+  (void)client;
+  markNetActive();
+  LOG_D(MQTT, "RX topic=%s payload=%s", topic, LogStr(bytes, (size_t)length));
+  int z = zoneFromCmdTopic(topic);
+  if (z >= 0) handleCommandMessage((uint8_t)z, bytes, (size_t)length);
 }
 
 static void mqttConfigure() {
-  mqtt.begin(MQTT_HOST, MQTT_PORT, net);
-  mqtt.onMessage(onMqttMessage);
+  mqtt.begin(MQTT_HOST, MQTT_PORT, mqttLinkClient());
+  mqtt.onMessageAdvanced(onMqttMessage);
   mqtt.setKeepAlive(MQTT_KEEPALIVE_SEC);
   mqtt.setCleanSession(MQTT_CLEAN_SESSION);
 
-  StaticJsonDocument<160> willDoc;
+  JsonDocument willDoc(httpRespPool.reset());   // setup() 에서 한 번 (HTTP 핸들러는 loop 에서만)
   willDoc["temp"]     = nullptr;
   willDoc["humidity"] = nullptr;
   willDoc["power"]    = 0;
   willDoc["target"]   = nullptr;
   willDoc["ts"]       = 0;
-  String willMsg;
-  serializeJson(willDoc, willMsg);
-  mqtt.setWill(TOPIC_STATUS, willMsg.c_str(), true, 1);
+  char willMsg[96];
+  serializeJson(willDoc, willMsg, sizeof(willMsg));
+  // will 은 연결당 하나뿐이라 존 0 상태 토픽에만 건다 (장치 전체 오프라인 표시)
+  mqtt.setWill(zoneTopic(0, ZONE_TOPIC_STATUS), willMsg, true, 1);
 }
 
-static void mqttConnectNonBlocking() {
+// 주기 mqttBackoffMs(1) 로 연결 상태를 확인하고, 실패하면 백오프만큼 다음 시도를 미룬다
+static void mqttJob(void*) {
   if (mqtt.connected()) return;
   if (WiFi.status() != WL_CONNECTED) return;
-  unsigned long now = millis();
-  unsigned long waitMs = mqttBackoffMs(mqttRetryCount == 0 ? 1 : mqttRetryCount);
-  if (now - mqttLastAttemptMs < waitMs) return;
-  mqttLastAttemptMs = now;
-#if LOG_MQTT
-  if (isDEBUG) {
-    Serial.print("[MQTT] connecting to "); Serial.print(MQTT_HOST);
-    Serial.print(":"); Serial.print(MQTT_PORT);
-    Serial.print(" attempt="); Serial.println(mqttRetryCount + 1);
-  }
-#endif
+  StageTimer t(STAGE_MQTT_CONNECT);
+  LOG_I(MQTT, "connecting to %s:%u attempt=%u", MQTT_HOST, (unsigned)MQTT_PORT, (unsigned)(mqttRetryCount + 1));
   bool ok = mqtt.connect(MQTT_CLIENT_ID, MQTT_USER, MQTT_PASS);
   if (ok) {
     mqttRetryCount = 0;
-#if LOG_MQTT
-    if (isDEBUG) Serial.println("[MQTT] connected OK");
-#endif
-    mqtt.subscribe(TOPIC_CMD, 1);
-#if LOG_MQTT
-    if (isDEBUG) { Serial.print("[MQTT] subscribed QoS1: "); Serial.println(TOPIC_CMD); }
-#endif
-    lastStatusPublishMs = 0;
+    gMetricCounters.mqttConnects++;
+    LOG_I(MQTT, "connected OK");
+    for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+      mqtt.subscribe(zoneTopic(z, ZONE_TOPIC_CMD), 1);
+      LOG_D(MQTT, "subscribed QoS1: %s", zoneTopic(z, ZONE_TOPIC_CMD));
+      reportReset(z);
+    }
+    mqttOutOnConnect(mqtt.sessionPresent());
   } else {
     mqttRetryCount++;
-#if LOG_MQTT
-    if (isDEBUG) Serial.println("[MQTT] connect failed");
-#endif
+    gMetricCounters.mqttConnectFails++;
+    LOG_W(MQTT, "connect failed");
+    sched.schedule(jobMqtt, mqttBackoffMs(mqttRetryCount));
   }
 }
 
-// ---------- Sensor ----------
-static bool readSensorsDHT21() {
-  float h = dht.readHumidity();
-  float t = dht.readTemperature();
+// ---------- Scheduler jobs ----------
+// SNTP 요청 / 응답 확인. 응답을 기다리는 동안은 SCHED_TICK_MS 마다, 맞춘 뒤에는 폴링 간격마다.
+// WiFi 가 끊기면 멈췄다가 연결 엣지에서 다시 건다
+static void ntpJob(void*) {
+  if (WiFi.status() != WL_CONNECTED) return;
+  StageTimer t(STAGE_NTP);
+  sched.schedule(jobNtp, timeTick());
+}
 
-  // 1) NaN 체크 (DHT 라이브러리 통신 실패)
-  if (isnan(t) || isnan(h)) {
-#if LOG_SENSOR
-    if (isDEBUG) Serial.println("[SENSOR] DHT read skipped (NaN)");
-#endif
-    return false;
+// HTTP / OTA / MQTT 수신 처리. 최근 요청이 있으면 빠르게, 없으면 느리게 다시 건다
+static void netJob(void*) {
+  {
+    StageTimer t(STAGE_HTTP);
+    http.handleClient();
   }
-
-  // 2) 물리적 범위 체크 (829.9°C, -11.4°C 같은 비정상값 차단)
-  if (t < SENSOR_TEMP_MIN || t > SENSOR_TEMP_MAX ||
-      h < SENSOR_HUM_MIN  || h > SENSOR_HUM_MAX) {
-#if LOG_SENSOR
-    if (isDEBUG) Serial.printf("[SENSOR] out of range rejected: t=%.1f h=%.1f\n", t, h);
-#endif
-    return false;
+  {
+    StageTimer t(STAGE_OTA);
+    ElegantOTA.loop();
+    otaTick();
   }
-
-  // 3) 급격한 변화 체크 (직전 유효값 대비 스파이크 차단)
-  //    첫 읽기(gStatus.temp == NAN)일 때는 건너뜀
-  if (isfinite(gStatus.temp)) {
-    float dT = fabsf(t - gStatus.temp);
-    float dH = fabsf(h - gStatus.humidity);
-    if (dT > SENSOR_TEMP_MAX_DELTA || dH > SENSOR_HUM_MAX_DELTA) {
-#if LOG_SENSOR
-      if (isDEBUG) Serial.printf("[SENSOR] spike rejected: t=%.1f(Δ%.1f) h=%.1f(Δ%.1f)\n",
-                                  t, dT, h, dH);
-#endif
-      return false;
-    }
+  // 새 이미지 검증 끝: 설정 기록 → 펠티어 OFF → 재시작. 받는 동안은 제어가 그대로 돈다
+  if (otaRebootDue()) {
+    LOG_I(OTA, "rebooting into new image");
+    storageFlush();
+    controlForceOff();
+    mqttOutDrain(MQTT_OUT_RETRY_MS);   // 큐에 남은 상태 / 집계 메시지를 보내고 (최대 MQTT_OUT_RETRY_MS)
+    logFlush();
+    ESP.restart();
   }
-
-  // 모든 검증 통과 → 전역 상태 업데이트
-  gStatus.temp     = t;
-  gStatus.humidity = h;
-#if LOG_SENSOR
-  if (isDEBUG) {
-    Serial.print("[SENSOR] temp="); Serial.print(gStatus.temp, 1);
-    Serial.print("C hum="); Serial.print(gStatus.humidity, 1); Serial.println("%");
+  {
+    StageTimer t(STAGE_MQTT_LOOP);
+    mqtt.loop();
   }
-#endif
-  return true;
+  commandsTick();   // 콜백에서 큐에 넣은 명령 실행 + ack
+  mqttOutTick();    // 발행 재전송 / 대기 메시지 송신 (논블로킹)
+  streamTick();     // SSE 수락 / 송신 (논블로킹)
+  // 응답을 기다리는 발행이 있으면 빠르게 (PUBACK 처리 지연 = 창이 비는 지연)
+  bool active = millis() - netActiveMs < NET_ACTIVE_HOLD_MS || mqttOutBusy();
+  sched.schedule(jobNet, active ? NET_POLL_ACTIVE_MS : NET_POLL_IDLE_MS);
+}
+
+// 끊김 동안 쌓인 기록은 연결 중에 속도를 제한해 배치로 재전송
+static void drainJob(void*) {
+  if (!mqtt.connected()) return;
+  StageTimer t(STAGE_STATUS);
+  bufferDrain();
+}
+
+// 모아둔 설정 변경을 NVS 에 기록 (명령 응답 경로 밖에서)
+static void nvsJob(void*) {
+  storageTick();
+}
+
+// 태스크 링의 로그를 기록 링으로 옮기고 시리얼로 포맷. 할 일이 없으면 드물게
+static void logJob(void*) {
+  sched.schedule(jobLog, logDrain() ? LOG_DRAIN_MS : LOG_IDLE_MS);
+}
+
+static void schedBegin() {
+  sched.begin(millis());
+  jobWifi  = sched.add("wifi",  wifiJob,  nullptr, WIFI_RETRY_MS,      WIFI_RETRY_MS);
+  jobMqtt  = sched.add("mqtt",  mqttJob,  nullptr, mqttBackoffMs(1),   0);
+  jobNtp   = sched.add("ntp",   ntpJob,   nullptr, NTP_RETRY_MS,       0);
+  jobNet   = sched.add("net",   netJob,   nullptr, 0,                  0);
+  jobDrain = sched.add("drain", drainJob, nullptr, TELEMETRY_DRAIN_MS, TELEMETRY_DRAIN_MS);
+  jobNvs   = sched.add("nvs",   nvsJob,   nullptr, NVS_TICK_MS,        NVS_TICK_MS);
+  jobLog   = sched.add("log",   logJob,   nullptr, 0,                  0);
 }
 
-static void updateRuntimeFields() {
+void updateRuntimeFields() {
   gStatus.uptimeSec     = millis() / 1000;
   gStatus.wifiRssi      = (WiFi.status() == WL_CONNECTED) ? WiFi.RSSI() : 0;
   gStatus.mqttConnected = mqtt.connected();
-  gStatus.ts            = nowUnix();
+  gStatus.tsMs          = nowUnixMs();
+  gStatus.heapFree      = ESP.getFreeHeap();
+  gStatus.heapMaxBlock  = ESP.getMaxAllocHeap();
+  gStatus.heapMinFree   = ESP.getMinFreeHeap();
 }
 
 // ==================== SETUP ====================
 void setup() {
   if (isDEBUG) {
+    Serial.setTxBufferSize(LOG_SERIAL_TX_BUF);   // log 작업이 availableForWrite() 만큼만 쓴다
     Serial.begin(115200);
     delay(200);
     if (!Serial) {
@@ -768,84 +573,89 @@ void setup() {
     Serial.println("==================================");
   }
 
+  logBegin();    // 이 태스크(loop)를 로그 생산자로
+  warmBegin();   // RTC 메모리 기록 확인 (WiFi 캐시 / SNTP 기준 / PID 상태)
+  timeBegin();   // 웜 부팅이면 재부팅 전 SNTP 기준으로 바로 시각을 안다
   loadFromNVS();
-
-  // 펠티어 PWM 초기화
-  peltierSetup();
-
-  WiFi.mode(WIFI_STA);
-  WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+  scheduleBegin();
+  otaBegin();
+  commandsBegin();
+  bufferBegin();
+  aggBegin();
+  reportBegin();
+  historyBegin();
+  mqttOutBegin();
+
+  // 펠티어 PWM + 센서 초기화, 제어 태스크 시작 (스냅샷마다 loop 를 깨움)
+  loopTaskHandle = xTaskGetCurrentTaskHandle();
+  controlNotifyOnSnapshot(loopTaskHandle);
+  controlBegin();
+
+  // WiFi 연결/끊김은 다음 wifi 작업을 기다리지 않고 바로 loop 를 깨운다
+  auto onWifiEvent = [](WiFiEvent_t) {
+    wifiEventPending = true;
+    if (loopTaskHandle) xTaskNotifyGive(loopTaskHandle);
+  };
+  WiFi.onEvent(onWifiEvent, ARDUINO_EVENT_WIFI_STA_GOT_IP);
+  WiFi.onEvent(onWifiEvent, ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+  wifiBeginBoot();
 
   setupHttpRoutes();
 
   ElegantOTA.begin(&http);
+  // 받는 동안은 제어를 멈추지 않는다. 펠티어는 성공해서 재부팅하기 직전에만 끈다
   ElegantOTA.onStart([]() {
-    peltierOff();  // OTA 중 안전을 위해 펠티어 OFF
-    if (isDEBUG) Serial.println("[OTA] Start - peltier OFF for safety");
+    markNetActive();
+    LOG_I(OTA, "start");
   });
   ElegantOTA.onEnd([](bool success) {
-    if (isDEBUG) Serial.printf("[OTA] End success=%s\n", success ? "true" : "false");
+    storageFlush();     // 새 펌웨어로 재부팅되기 전에 설정 기록
+    if (success) controlForceOff();
+    LOG_I(OTA, "end success=%s", success ? "true" : "false");
+    logFlush();
   });
   ElegantOTA.onProgress([](size_t current, size_t final) {
-    if (isDEBUG) Serial.printf("[OTA] Progress: %u%%\r", (unsigned)((current * 100) / final));
+    markNetActive();
+    LOG_D(OTA, "progress %u%%", (unsigned)((current * 100) / final));
   });
 
   http.begin();
-  dht.begin();
-  ntp.begin();
+  streamBegin();
   mqttConfigure();
-}
 
-// ==================== LOOP ====================
-void loop() {
-  // WiFi
-  wifiConnectNonBlocking();
-  static bool wifiWasConnected = false;
-  bool wifiNow = (WiFi.status() == WL_CONNECTED);
-  if (wifiNow && !wifiWasConnected) {
-#if LOG_WIFI
-    if (isDEBUG) {
-      Serial.print("[WIFI] connected! IP="); Serial.println(WiFi.localIP());
-      Serial.println("[OTA] Open http://<ip>/update");
-    }
+#if CONFIG_PM_ENABLE
+  // 다음 마감까지 idle 이면 light sleep (sdkconfig 에 PM + tickless idle 이 켜진 빌드에서만).
+  // 펠티어 PWM 이 켜져 있는 동안은 제어 쪽에서 잠금을 잡아 막는다.
+  esp_pm_config_esp32_t pm = {};
+  pm.max_freq_mhz       = 240;
+  pm.min_freq_mhz       = 80;
+  pm.light_sleep_enable = true;
+  esp_err_t pmErr = esp_pm_configure(&pm);
+  LOG_I(SYS, "light sleep %s", pmErr == ESP_OK ? "enabled" : "unavailable");
+  (void)pmErr;
 #endif
-  }
-  if (!wifiNow && wifiWasConnected) {
-#if LOG_WIFI
-    if (isDEBUG) Serial.println("[WIFI] disconnected");
-#endif
-  }
-  wifiWasConnected = wifiNow;
 
-  // HTTP + OTA
-  http.handleClient();
-  ElegantOTA.loop();
-
-  // NTP
-  if (wifiNow) ntp.update();
+  schedBegin();
+}
 
-  // MQTT
-  mqttConnectNonBlocking();
-  mqtt.loop();
+// ==================== LOOP ====================
+void loop() {
+  uint32_t loopStart = metricsCycles();
 
-  // 1초 주기 작업: 센서 읽기 + PID + 상태 발행
-  static unsigned long lastScanMs = 0;
-  unsigned long now = millis();
-  if (now - lastScanMs >= 2000) {  // DHT21 최소 샘플링 간격 2초
-    lastScanMs = now;
+  if (wifiEventPending) {
+    wifiEventPending = false;
+    wifiCheckEdge();
+  }
 
-    bool sensorOk = readSensorsDHT21();
-    updateRuntimeFields();
+  // 마감이 지난 작업 (WiFi / MQTT 재연결, NTP, 네트워크 폴링, 재전송)
+  sched.runDue(millis());
 
-    // PID 연산: 센서 읽기 성공 시에만 수행
-    if (sensorOk) {
-      pidCompute();
-    }
+  // 제어 태스크 스냅샷 수신 + 상태 발행
+  statusTick();
 
-    if (mqtt.connected() && shouldPublishStatus()) {
-      publishStatus();
-    }
-  }
+  gStageHist[STAGE_LOOP].record(metricsCyclesToUs(metricsCycles() - loopStart));
 
-  delay(10);
-}
\ No newline at end of file
+  // 다음 마감까지 잠든다. 제어 태스크 스냅샷 / WiFi 이벤트 알림이 오면 일찍 깨어남
+  uint32_t waitMs = sched.msUntilNext(millis());
+  if (waitMs > 0) ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(waitMs));
+}
@@ -0,0 +1,71 @@
+#include <Arduino.h>
+#include "metrics.h"
+
+LatencyHist    gStageHist[STAGE_COUNT];
+LatencyHist    gControlJitter;
+LatencyHist    gCmdApplyHist[METRIC_CMD_COUNT];
+LatencyHist    gCmdAckHist[METRIC_CMD_COUNT];
+MetricCounters gMetricCounters;
+
+static const char* const STAGE_NAMES[STAGE_COUNT] = {
+  "loop", "wifi", "http", "ota", "ntp", "mqtt_connect", "mqtt_loop", "status", "publish",
+  "stream", "control", "sensor", "pid",
+};
+
+const char* metricStageName(MetricStage s) {
+  return s < STAGE_COUNT ? STAGE_NAMES[s] : "unknown";
+}
+
+static const char* const CMD_NAMES[METRIC_CMD_COUNT] = {
+  "set_target", "set_peltier", "restart", "set_report", "set_schedule", "invalid", "duplicate",
+};
+
+const char* metricCmdName(MetricCmd c) {
+  return c < METRIC_CMD_COUNT ? CMD_NAMES[c] : "unknown";
+}
+
+// ---------- 버킷 ----------
+// 0~3us 는 1us 단위, 그 위로는 2^e ~ 2^(e+1) 구간을 4칸으로 나눈다
+uint32_t LatencyHist::bucketOf(uint32_t us) {
+  if (us < SUB_BUCKETS) return us;
+  uint32_t e   = 31 - __builtin_clz(us);              // floor(log2(us)) ≥ 2
+  uint32_t sub = (us >> (e - 2)) & (SUB_BUCKETS - 1);
+  uint32_t b   = SUB_BUCKETS * (e - 1) + sub;
+  return b < BUCKETS ? b : BUCKETS - 1;
+}
+
+uint32_t LatencyHist::bucketUpper(uint32_t b) {
+  if (b < SUB_BUCKETS) return b;
+  uint32_t e   = b / SUB_BUCKETS + 1;
+  uint32_t sub = b % SUB_BUCKETS;
+  return ((SUB_BUCKETS + sub + 1) << (e - 2)) - 1;
+}
+
+uint32_t LatencyHist::percentile(float q) const {
+  uint32_t n = count_;
+  if (n == 0) return 0;
+  uint32_t rank = (uint32_t)(q * (float)n + 0.5f);
+  if (rank < 1) rank = 1;
+  if (rank > n) rank = n;
+  uint32_t seen = 0;
+  for (uint32_t b = 0; b < BUCKETS; b++) {
+    seen += counts_[b];
+    if (seen >= rank) {
+      uint32_t up = bucketUpper(b);
+      return up < max_ ? up : max_;
+    }
+  }
+  return max_;
+}
+
+// ---------- 사이클 카운터 ----------
+static uint32_t cpuMHz = 0;
+
+uint32_t metricsCycles() {
+  return ESP.getCycleCount();
+}
+
+uint32_t metricsCyclesToUs(uint32_t cycles) {
+  if (cpuMHz == 0) cpuMHz = ESP.getCpuFreqMHz();
+  return cycles / cpuMHz;
+}
@@ -0,0 +1,109 @@
+#ifdef ESP32
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <errno.h>
+#include <lwip/sockets.h>
+#include "mqtt_out.h"
+#include "state.h"
+
+// ==================== MQTT 소켓 ====================
+// MQTTClient 에는 WiFiClient 대신 이 Client 를 넘긴다.
+//   수신: 라이브러리가 읽는 바이트를 그대로 넘기면서 패킷 경계를 따라가 PUBACK / PUBREC / PUBCOMP 의
+//         id 를 mqtt_out 에 알린다 (라이브러리는 PUBREC 에 PUBREL 로 답하고 PUBACK / PUBCOMP 는 버린다)
+//   송신: mqtt_out 의 PUBLISH 는 lwip send(MSG_DONTWAIT) 로 직접. 라이브러리의 쓰기(CONNECT, 구독,
+//         PINGREQ, 수신 명령의 PUBACK)는 반쯤 보낸 PUBLISH 를 마저 보낸 뒤에 (패킷이 섞이지 않게)
+
+// 고정 헤더 → 남은 길이(가변 길이) → 본문. 응답 패킷은 본문 첫 2바이트가 id
+class AckTap {
+ public:
+  void reset() { phase_ = HDR; }
+
+  void feed(uint8_t b) {
+    switch (phase_) {
+      case HDR:
+        type_   = b >> 4;
+        remain_ = 0;
+        shift_  = 0;
+        phase_  = LEN;
+        break;
+      case LEN:
+        remain_ |= (uint32_t)(b & 0x7F) << shift_;
+        shift_  += 7;
+        if (b & 0x80) break;
+        idBytes_ = 0;
+        id_      = 0;
+        phase_   = remain_ ? BODY : HDR;
+        break;
+      case BODY:
+        if (idBytes_ < 2) {
+          id_ = (uint16_t)(id_ << 8 | b);
+          if (++idBytes_ == 2 && (type_ == 4 || type_ == 5 || type_ == 7)) mqttOutOnAck(type_, id_);
+        }
+        if (--remain_ == 0) phase_ = HDR;
+        break;
+    }
+  }
+
+ private:
+  enum Phase : uint8_t { HDR, LEN, BODY };
+  Phase    phase_   = HDR;
+  uint8_t  type_    = 0;
+  uint8_t  shift_   = 0;
+  uint8_t  idBytes_ = 0;
+  uint16_t id_      = 0;
+  uint32_t remain_  = 0;
+};
+
+class TapClient : public Client {
+ public:
+  explicit TapClient(WiFiClient& c) : c_(c) {}
+
+  int connect(IPAddress ip, uint16_t port) { tap_.reset(); return c_.connect(ip, port); }
+  int connect(const char* host, uint16_t port) { tap_.reset(); return c_.connect(host, port); }
+  int connect(IPAddress ip, uint16_t port, int32_t timeout) { tap_.reset(); return c_.connect(ip, port, timeout); }
+  int connect(const char* host, uint16_t port, int32_t timeout) { tap_.reset(); return c_.connect(host, port, timeout); }
+
+  size_t write(uint8_t b) { return write(&b, 1); }
+  size_t write(const uint8_t* buf, size_t size) {
+    if (!mqttOutFinishPartial()) return 0;
+    return c_.write(buf, size);
+  }
+
+  int available() { return c_.available(); }
+  int read() {
+    int b = c_.read();
+    if (b >= 0) tap_.feed((uint8_t)b);
+    return b;
+  }
+  int read(uint8_t* buf, size_t size) {
+    int n = c_.read(buf, size);
+    for (int i = 0; i < n; i++) tap_.feed(buf[i]);
+    return n;
+  }
+  int     peek() { return c_.peek(); }
+  void    flush() { c_.flush(); }
+  void    stop() { c_.stop(); }
+  uint8_t connected() { return c_.connected(); }
+  operator bool() { return (bool)c_; }
+
+ private:
+  WiFiClient& c_;
+  AckTap      tap_;
+};
+
+static WiFiClient sock;
+static TapClient  tap(sock);
+
+Client& mqttLinkClient() { return tap; }
+
+bool mqttLinkReady() { return mqtt.connected(); }
+
+int mqttLinkWrite(const uint8_t* buf, size_t len) {
+  if (!sock.connected()) return -1;
+  int n = send(sock.fd(), buf, len, MSG_DONTWAIT);
+  if (n >= 0) return n;
+  return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+}
+
+#endif  // ESP32
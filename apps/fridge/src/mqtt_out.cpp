@@ -0,0 +1,358 @@
+#include <Arduino.h>
+#include <string.h>
+#include "config.h"
+#include "mqtt_out.h"
+#include "state.h"
+#include "log.h"
+
+// 메시지 상태: QUEUED → (QoS0 이면 바로 DONE) SENT → (QoS2) RELEASED → DONE
+enum OutState : uint8_t { OUT_QUEUED, OUT_SENT, OUT_RELEASED, OUT_DONE };
+
+struct OutMsg {
+  uint16_t    off;       // arena 안 패킷 위치
+  uint16_t    len;
+  uint16_t    id;        // QoS0 = 0
+  uint8_t     qos;
+  uint8_t     state;
+  uint8_t     tries;     // 이번 단계(PUBLISH / PUBREL) 전송 횟수
+  bool        resent;    // 한 번이라도 재전송 (RTT 표본에서 뺀다: 어느 전송의 응답인지 모름)
+  uint32_t    firstMs;   // 첫 전송 (RTT 기준)
+  uint32_t    sentMs;    // 마지막 전송 (재전송 타이머)
+  MqttOutDone done;
+  uint32_t    tag;
+};
+
+static const uint16_t ID_MIN = 0x8000;
+
+static OutMsg       msgs[MQTT_OUT_SLOTS];   // 발행 순서대로 (oldest 부터 count 개)
+static uint32_t     oldest    = 0;
+static uint32_t     count     = 0;
+static uint8_t      arena[MQTT_OUT_BUF];    // 패킷 바이트 링. 메시지 순서대로 잡고 순서대로 푼다
+static uint32_t     arenaHead = 0;
+static uint16_t     nextId    = ID_MIN;
+static bool         linked    = false;      // mqttOutOnConnect ~ 끊김
+static uint32_t     inflight  = 0;          // SENT + RELEASED
+static MqttOutStats stats     = {};
+static LatencyHist  rtt;
+
+// 소켓에 다 못 넘긴 패킷: 다른 패킷보다 먼저 마저 보내야 스트림이 안 깨진다
+static const uint8_t* partialBuf  = nullptr;
+static size_t         partialLeft = 0;
+static int            partialSlot = -1;     // -1 = PUBREL
+static uint8_t        pubrel[4];
+
+static uint32_t slotAt(uint32_t i) { return (oldest + i) % MQTT_OUT_SLOTS; }
+
+// 메시지가 순서대로 풀리므로 빈 곳은 head 뒤 ~ 가장 오래된 패킷 앞
+static int32_t arenaAlloc(size_t n) {
+  if (count == 0) {
+    arenaHead = 0;
+    return n <= MQTT_OUT_BUF ? 0 : -1;
+  }
+  uint32_t tail = msgs[oldest].off;
+  if (arenaHead == tail) return -1;   // 가득 참
+  if (arenaHead > tail) {
+    if (MQTT_OUT_BUF - arenaHead >= n) return (int32_t)arenaHead;
+    return tail >= n ? 0 : -1;        // 끝 자투리는 비워 두고 앞에서
+  }
+  return tail - arenaHead >= n ? (int32_t)arenaHead : -1;
+}
+
+static uint16_t allocId() {
+  for (;;) {
+    uint16_t id = nextId;
+    nextId = nextId == 0xFFFF ? ID_MIN : (uint16_t)(nextId + 1);
+    bool used = false;
+    for (uint32_t i = 0; i < count && !used; i++) {
+      const OutMsg& m = msgs[slotAt(i)];
+      used = m.qos && m.state != OUT_DONE && m.id == id;
+    }
+    if (!used) return id;
+  }
+}
+
+// 콜백 안에서 발행하면 안 된다 (큐를 훑는 도중일 수 있음)
+static void finish(uint32_t s, bool ok) {
+  OutMsg& m = msgs[s];
+  if (m.state == OUT_SENT || m.state == OUT_RELEASED) inflight--;
+  m.state = OUT_DONE;
+  if (ok) stats.completed++;
+  else    stats.expired++;
+  if (m.done) m.done(m.tag, ok);
+}
+
+static void reclaim() {
+  while (count && msgs[oldest].state == OUT_DONE) {
+    oldest = (oldest + 1) % MQTT_OUT_SLOTS;
+    count--;
+  }
+}
+
+// 연결이 끊기면 응답 못 받은 PUBLISH 는 재연결 후 다시 (RELEASED 는 세션 여부를 보고 mqttOutOnConnect 에서)
+static void linkDown() {
+  linked      = false;
+  partialLeft = 0;
+  partialSlot = -1;
+  for (uint32_t i = 0; i < count; i++) {
+    OutMsg& m = msgs[slotAt(i)];
+    if (m.state != OUT_SENT) continue;
+    m.state = OUT_QUEUED;
+    inflight--;
+  }
+}
+
+// false = 다 못 넘김 (나머지는 partial 로) 또는 끊김
+static bool transmit(int slot, const uint8_t* buf, size_t len) {
+  int n = mqttLinkWrite(buf, len);
+  if (n < 0) {
+    linkDown();
+    return false;
+  }
+  stats.bytes += (uint32_t)n;
+  if ((size_t)n < len) {
+    partialBuf  = buf + n;
+    partialLeft = len - (size_t)n;
+    partialSlot = slot;
+    return false;
+  }
+  return true;
+}
+
+static bool flushPartial() {
+  if (!partialLeft) return true;
+  int n = mqttLinkWrite(partialBuf, partialLeft);
+  if (n < 0) {
+    linkDown();
+    return false;
+  }
+  stats.bytes += (uint32_t)n;
+  partialBuf  += n;
+  partialLeft -= (size_t)n;
+  if (partialLeft) return false;
+  int s = partialSlot;
+  partialSlot = -1;
+  if (s >= 0 && msgs[s].qos == 0 && msgs[s].state == OUT_QUEUED) finish((uint32_t)s, true);
+  return true;
+}
+
+static bool sendPublish(uint32_t s) {
+  OutMsg&  m   = msgs[s];
+  uint32_t now = millis();
+  if (m.tries == 0) {
+    m.firstMs = now;
+  } else {
+    if (m.qos) arena[m.off] |= 0x08;   // DUP
+    m.resent = true;
+    stats.retransmits++;
+  }
+  m.tries++;
+  m.sentMs = now;
+  if (m.qos && m.state == OUT_QUEUED) {
+    m.state = OUT_SENT;
+    inflight++;
+  }
+  bool whole = transmit((int)s, arena + m.off, m.len);
+  if (whole && m.qos == 0) finish(s, true);
+  return whole;
+}
+
+static bool sendPubrel(uint32_t s) {
+  OutMsg& m = msgs[s];
+  pubrel[0] = 0x62;   // PUBREL, flags 0010
+  pubrel[1] = 0x02;
+  pubrel[2] = (uint8_t)(m.id >> 8);
+  pubrel[3] = (uint8_t)m.id;
+  m.tries++;
+  m.sentMs = millis();
+  m.resent = true;
+  stats.retransmits++;
+  return transmit(-1, pubrel, sizeof(pubrel));
+}
+
+// 큐 순서대로 보낸다. 창이 차면 뒤 메시지도 기다린다 (같은 토픽 순서 유지)
+static void pump() {
+  if (!linked || !flushPartial()) return;
+  for (uint32_t i = 0; i < count && linked; i++) {
+    uint32_t s = slotAt(i);
+    OutMsg&  m = msgs[s];
+    if (m.state != OUT_QUEUED) continue;
+    if (m.qos && inflight >= MQTT_OUT_WINDOW) return;
+    if (!sendPublish(s)) return;
+  }
+}
+
+void mqttOutBegin() {
+  oldest      = 0;
+  count       = 0;
+  arenaHead   = 0;
+  linked      = false;
+  inflight    = 0;
+  partialLeft = 0;
+  partialSlot = -1;
+  stats       = {};
+  rtt         = LatencyHist();
+}
+
+bool mqttOutPublish(const char* topic, const void* payload, size_t len, uint8_t qos,
+                    MqttOutDone done, uint32_t tag) {
+  if (qos > 2) qos = 2;
+  size_t tlen = strlen(topic);
+  size_t rem  = 2 + tlen + (qos ? 2 : 0) + len;
+  size_t n    = 1 + (rem < 128 ? 1 : rem < 16384 ? 2 : 3) + rem;
+  int32_t off = -1;
+  if (linked && count < MQTT_OUT_SLOTS && n <= 0xFFFF) off = arenaAlloc(n);
+  if (off < 0) {
+    stats.rejected++;
+    return false;
+  }
+
+  uint8_t* p = arena + off;
+  *p++ = (uint8_t)(0x30 | (qos << 1));   // PUBLISH, retain 없음
+  size_t r = rem;
+  do {
+    uint8_t b = r & 0x7F;
+    r >>= 7;
+    *p++ = r ? (uint8_t)(b | 0x80) : b;
+  } while (r);
+  *p++ = (uint8_t)(tlen >> 8);
+  *p++ = (uint8_t)tlen;
+  memcpy(p, topic, tlen);
+  p += tlen;
+  uint16_t id = 0;
+  if (qos) {
+    id   = allocId();
+    *p++ = (uint8_t)(id >> 8);
+    *p++ = (uint8_t)id;
+  }
+  memcpy(p, payload, len);
+  arenaHead = (uint32_t)off + (uint32_t)n;
+
+  OutMsg& m = msgs[slotAt(count++)];
+  m.off     = (uint16_t)off;
+  m.len     = (uint16_t)n;
+  m.id      = id;
+  m.qos     = qos;
+  m.state   = OUT_QUEUED;
+  m.tries   = 0;
+  m.resent  = false;
+  m.firstMs = 0;
+  m.sentMs  = 0;
+  m.done    = done;
+  m.tag     = tag;
+  stats.queued++;
+  if (count > stats.depthMax) stats.depthMax = count;
+
+  pump();
+  reclaim();
+  return true;
+}
+
+void mqttOutOnConnect(bool sessionPresent) {
+  if (linked) linkDown();
+  linked = true;
+  uint32_t now = millis();
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t s = slotAt(i);
+    OutMsg&  m = msgs[s];
+    if (m.state != OUT_RELEASED) continue;
+    // 새 세션이면 브로커가 PUBREC 까지 보낸 메시지는 이미 받은 것. 세션이 남아 있으면 PUBREL 을 다음 틱에 다시
+    if (sessionPresent) m.sentMs = now - MQTT_OUT_RETRY_MS;
+    else                finish(s, true);
+  }
+  pump();
+  reclaim();
+}
+
+void mqttOutTick() {
+  if (!mqttLinkReady()) {
+    if (linked) linkDown();
+    return;
+  }
+  if (!linked) return;   // mqttOutOnConnect 전까지
+  // 반쯤 보낸 패킷이 있으면 재전송도 다음 틱에
+  if (flushPartial()) {
+    uint32_t now = millis();
+    for (uint32_t i = 0; i < count && linked; i++) {
+      uint32_t s = slotAt(i);
+      OutMsg&  m = msgs[s];
+      if (m.state != OUT_SENT && m.state != OUT_RELEASED) continue;
+      if (now - m.sentMs < MQTT_OUT_RETRY_MS) continue;
+      if (m.tries >= MQTT_OUT_MAX_TRIES) {
+        LOG_W(MQTT, "OUT id=%u gave up after %u tries", (unsigned)m.id, (unsigned)m.tries);
+        finish(s, false);
+        continue;
+      }
+      bool whole = m.state == OUT_SENT ? sendPublish(s) : sendPubrel(s);
+      if (!whole) break;
+    }
+    pump();
+  }
+  reclaim();
+}
+
+bool mqttOutBusy() {
+  return inflight > 0 || partialLeft > 0;
+}
+
+void mqttOutOnAck(uint8_t type, uint16_t id) {
+  if (id < ID_MIN) return;   // 라이브러리 자신의 subscribe 등
+  uint32_t now = millis();
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t s = slotAt(i);
+    OutMsg&  m = msgs[s];
+    if (!m.qos || m.id != id || m.state == OUT_DONE) continue;
+    if (type == 4 && m.qos == 1 && m.state == OUT_SENT) {
+      if (!m.resent) rtt.record((now - m.firstMs) * 1000UL);
+      finish(s, true);
+    } else if (type == 5 && m.qos == 2 && m.state == OUT_SENT) {
+      // 라이브러리가 PUBREL 을 이미 보냈다. 여기서부터 PUBREL 재전송 타이머
+      m.state  = OUT_RELEASED;
+      m.tries  = 1;
+      m.sentMs = now;
+    } else if (type == 7 && m.state == OUT_RELEASED) {
+      if (!m.resent) rtt.record((now - m.firstMs) * 1000UL);
+      finish(s, true);
+    }
+    break;
+  }
+  reclaim();
+}
+
+bool mqttOutFinishPartial() {
+  uint32_t start = millis();
+  while (partialLeft) {
+    if (flushPartial()) break;
+    if (!linked) return false;   // 쓰다가 끊김
+    if (millis() - start >= MQTT_OUT_FLUSH_MS) {
+      linkDown();
+      return false;
+    }
+    delay(1);
+  }
+  return true;
+}
+
+// 재시작하면 큐가 사라지므로 평소의 net 작업 순서(mqtt.loop() → mqttOutTick())를 여기서 직접 돌린다.
+// QoS2 는 PUBREC → PUBREL → PUBCOMP 까지 mqtt.loop() 가 있어야 끝난다
+bool mqttOutDrain(uint32_t timeoutMs, bool (*until)()) {
+  uint32_t start = millis();
+  for (;;) {
+    if (until ? until() : count == 0) return true;
+    if (!linked || millis() - start >= timeoutMs) break;
+    if (!mqttOutFinishPartial()) break;
+    mqtt.loop();
+    mqttOutTick();
+    delay(NET_POLL_ACTIVE_MS);
+  }
+  LOG_W(MQTT, "OUT drain gave up: depth=%u inflight=%u", (unsigned)count, (unsigned)inflight);
+  return false;
+}
+
+MqttOutStats mqttOutStats() {
+  MqttOutStats s = stats;
+  s.depth    = count;
+  s.inflight = inflight;
+  return s;
+}
+
+const LatencyHist& mqttOutRtt() { return rtt; }
@@ -0,0 +1,207 @@
+#include <Arduino.h>
+#include <string.h>
+#include "ota.h"
+#include "ota_image.h"
+#include "log.h"
+
+// ===== 세션 =====
+static OtaStatus      st = {};
+static OtaImageHeader hdr;
+static uint8_t        hdrBuf[sizeof(OtaImageHeader)];
+static OtaLzDecoder   lz;
+static Sha256         sha;
+static uint8_t        page[OTA_FLASH_PAGE];   // 풀어낸 펌웨어를 섹터 단위로 모아 쓴다
+static size_t         pageFill    = 0;
+static uint32_t       startMs     = 0;
+static uint32_t       lastMs      = 0;
+static uint32_t       readyMs     = 0;
+static const char*    sinkErr     = nullptr;   // emit() 가 거절한 이유
+
+// ===== 조각 =====
+static bool        chunkOpen   = false;
+static uint32_t    chunkCursor = 0;      // 이번 조각의 다음 바이트가 이미지에서 차지하는 위치
+static const char* chunkErr    = nullptr;
+
+const char* otaStateName(OtaState s) {
+  switch (s) {
+    case OTA_IDLE:      return "idle";
+    case OTA_RECEIVING: return "receiving";
+    case OTA_READY:     return "ready";
+    case OTA_FAILED:    return "failed";
+  }
+  return "?";
+}
+
+void otaBegin() {
+  st        = OtaStatus();
+  chunkOpen = false;
+}
+
+static void fail(const char* why) {
+  if (st.state == OTA_RECEIVING) otaFlashAbort();
+  st.state = OTA_FAILED;
+  st.error = why;
+  st.failures++;
+  chunkOpen = false;
+  LOG_W(OTA, "failed: %s at %u/%u bytes", why, (unsigned)st.received, (unsigned)st.total);
+}
+
+static void start() {
+  if (st.state == OTA_RECEIVING) otaFlashAbort();
+  uint32_t sessions = st.sessions, completed = st.completed, failures = st.failures;
+  st           = OtaStatus();
+  st.state     = OTA_RECEIVING;
+  st.sessions  = sessions + 1;
+  st.completed = completed;
+  st.failures  = failures;
+  pageFill     = 0;
+  startMs      = millis();
+  LOG_I(OTA, "session start");
+}
+
+static bool writePage() {
+  if (!pageFill) return true;
+  bool ok  = otaFlashWrite(page, pageFill);
+  pageFill = 0;
+  return ok;
+}
+
+// 풀어낸 펌웨어 → SHA-256 + 페이지 버퍼 (가득 차면 플래시)
+static bool emit(const uint8_t* data, size_t len, void*) {
+  if (len > st.rawSize - st.written) {
+    sinkErr = "too_long";
+    return false;
+  }
+  sha.update(data, len);
+  st.written += len;
+  while (len) {
+    size_t n = OTA_FLASH_PAGE - pageFill < len ? OTA_FLASH_PAGE - pageFill : len;
+    memcpy(page + pageFill, data, n);
+    pageFill += n;
+    data     += n;
+    len      -= n;
+    if (pageFill == OTA_FLASH_PAGE && !writePage()) {
+      sinkErr = "flash_write";
+      return false;
+    }
+  }
+  return true;
+}
+
+static void parseHeader() {
+  memcpy(&hdr, hdrBuf, sizeof(hdr));
+  const char* bad = otaHeaderCheck(hdr);
+  if (bad) return fail(bad);
+  if (!otaFlashBegin(hdr.rawSize)) return fail("no_partition");
+  st.codec   = hdr.codec;
+  st.rawSize = hdr.rawSize;
+  st.total   = (uint32_t)sizeof(hdr) + hdr.packedSize;
+  sha.begin();
+  lz.begin(hdr.rawSize);
+  LOG_I(OTA, "image %s raw=%u packed=%u", hdr.codec == OTA_CODEC_LZSS ? "lzss" : "stored",
+        (unsigned)hdr.rawSize, (unsigned)hdr.packedSize);
+}
+
+// 끝까지 받음: 크기 / SHA-256 확인 후에만 파티션 전환
+static void finish() {
+  if (!writePage()) return fail("flash_write");
+  if (st.written != st.rawSize || (hdr.codec == OTA_CODEC_LZSS && !lz.finished())) return fail("truncated");
+  uint8_t digest[32];
+  sha.finish(digest);
+  if (memcmp(digest, hdr.sha256, sizeof(digest)) != 0) return fail("sha256_mismatch");
+  if (!otaFlashEnd()) return fail("image_invalid");
+  st.state = OTA_READY;
+  st.completed++;
+  readyMs = millis();
+  LOG_I(OTA, "verified %u bytes in %ums (%u resumes), reboot in %ums", (unsigned)st.rawSize,
+        (unsigned)st.elapsedMs, (unsigned)st.resumes, (unsigned)OTA_REBOOT_DELAY_MS);
+}
+
+// 새 바이트 (received 위치부터)
+static void consume(const uint8_t* data, size_t len) {
+  if (st.received < sizeof(hdrBuf)) {
+    size_t n = sizeof(hdrBuf) - st.received < len ? sizeof(hdrBuf) - st.received : len;
+    memcpy(hdrBuf + st.received, data, n);
+    st.received += n;
+    data += n;
+    len  -= n;
+    if (st.received < sizeof(hdrBuf)) return;
+    parseHeader();
+    if (st.state != OTA_RECEIVING) return;
+  }
+  if (len > st.total - st.received) return fail("too_long");
+  sinkErr = nullptr;
+  bool ok = hdr.codec == OTA_CODEC_LZSS ? lz.feed(data, len, emit, nullptr) : emit(data, len, nullptr);
+  if (!ok) return fail(sinkErr ? sinkErr : "corrupt");
+  st.received += len;
+  if (st.received == st.total) finish();
+}
+
+bool otaChunkBegin(uint32_t offset) {
+  chunkErr  = nullptr;
+  chunkOpen = false;
+  // 검증을 마친 이미지(READY)는 재시작 전까지 건드리지 않는다
+  if (offset == 0 && (st.state == OTA_IDLE || st.state == OTA_FAILED)) start();
+  if (st.state == OTA_READY)     chunkErr = "complete";
+  else if (st.state != OTA_RECEIVING) chunkErr = "no_session";
+  else if (offset > st.received) chunkErr = "gap";
+  if (chunkErr) return false;
+  if (offset < st.received) st.resumes++;
+  st.chunks++;
+  chunkOpen   = true;
+  chunkCursor = offset;
+  lastMs      = millis();
+  return true;
+}
+
+void otaChunkWrite(const uint8_t* data, size_t len) {
+  if (!chunkOpen) return;
+  lastMs = millis();
+  // 이미 받은 앞부분: 헤더 구간은 비교해서 다르면 새 이미지, 본문은 건너뜀
+  if (chunkCursor < st.received) {
+    size_t n = st.received - chunkCursor < len ? st.received - chunkCursor : len;
+    if (chunkCursor < sizeof(hdrBuf)) {
+      size_t h = sizeof(hdrBuf) - chunkCursor < n ? sizeof(hdrBuf) - chunkCursor : n;
+      if (memcmp(hdrBuf + chunkCursor, data, h) != 0) {
+        if (chunkCursor != 0) return fail("header_changed");
+        start();
+        chunkCursor = 0;
+        return otaChunkWrite(data, len);
+      }
+    }
+    st.duplicateBytes += n;
+    chunkCursor       += n;
+    data              += n;
+    len               -= n;
+  }
+  if (!len || st.state != OTA_RECEIVING) return;
+  consume(data, len);
+  chunkCursor += len;
+  st.elapsedMs = millis() - startMs;
+}
+
+const char* otaChunkEnd() {
+  chunkOpen = false;
+  return chunkErr;
+}
+
+void otaAbort() {
+  if (st.state == OTA_RECEIVING) {
+    otaFlashAbort();
+    LOG_I(OTA, "aborted at %u/%u bytes", (unsigned)st.received, (unsigned)st.total);
+  }
+  if (st.state != OTA_READY) st.state = OTA_IDLE;
+  chunkOpen = false;
+}
+
+void otaTick() {
+  if (st.state == OTA_RECEIVING && millis() - lastMs > OTA_SESSION_IDLE_MS) fail("timeout");
+}
+
+bool otaRebootDue() {
+  return st.state == OTA_READY && millis() - readyMs >= OTA_REBOOT_DELAY_MS;
+}
+
+OtaStatus otaStatus() {
+  return st;
+}
@@ -0,0 +1,55 @@
+#ifdef ESP32
+
+#include <Arduino.h>
+#include <esp_ota_ops.h>
+#include "ota.h"
+#include "log.h"
+
+// ==================== OTA 파티션 쓰기 ====================
+// esp_ota_begin(OTA_WITH_SEQUENTIAL_WRITES) 은 파티션 전체를 미리 지우지 않고 쓰는 섹터만
+// 그때그때 지운다. 한꺼번에 지우면 캐시가 꺼진 채로 수 초 동안 loop 가 멈춘다.
+
+static const esp_partition_t* part   = nullptr;
+static esp_ota_handle_t       handle = 0;
+
+bool otaFlashBegin(uint32_t rawSize) {
+  otaFlashAbort();
+  part = esp_ota_get_next_update_partition(nullptr);
+  if (!part || rawSize > part->size) {
+    LOG_W(OTA, "no partition for %u bytes", (unsigned)rawSize);
+    part = nullptr;
+    return false;
+  }
+  esp_err_t err = esp_ota_begin(part, OTA_WITH_SEQUENTIAL_WRITES, &handle);
+  if (err != ESP_OK) {
+    LOG_W(OTA, "esp_ota_begin err=0x%x", (unsigned)err);
+    handle = 0;
+    return false;
+  }
+  LOG_I(OTA, "writing %s @0x%x", part->label, (unsigned)part->address);
+  return true;
+}
+
+bool otaFlashWrite(const uint8_t* data, size_t len) {
+  if (!handle) return false;
+  esp_err_t err = esp_ota_write(handle, data, len);
+  if (err != ESP_OK) LOG_W(OTA, "esp_ota_write err=0x%x", (unsigned)err);
+  return err == ESP_OK;
+}
+
+// esp_ota_end 는 앱 이미지 형식(세그먼트 / 체크섬)을 한 번 더 검사한다. 성공/실패와 관계없이 핸들은 닫힌다
+bool otaFlashEnd() {
+  if (!handle) return false;
+  esp_err_t err = esp_ota_end(handle);
+  handle = 0;
+  if (err == ESP_OK) err = esp_ota_set_boot_partition(part);
+  if (err != ESP_OK) LOG_W(OTA, "finalize err=0x%x", (unsigned)err);
+  return err == ESP_OK;
+}
+
+void otaFlashAbort() {
+  if (handle) esp_ota_abort(handle);
+  handle = 0;
+}
+
+#endif
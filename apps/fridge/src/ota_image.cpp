@@ -0,0 +1,156 @@
+#include <string.h>
+#include "ota_image.h"
+
+const char* otaHeaderCheck(const OtaImageHeader& h) {
+  if (h.magic != OTA_IMAGE_MAGIC)                                   return "bad_magic";
+  if (h.version != OTA_IMAGE_VERSION)                               return "bad_version";
+  if (h.headerSize != sizeof(OtaImageHeader))                       return "bad_header";
+  if (h.codec != OTA_CODEC_STORED && h.codec != OTA_CODEC_LZSS)     return "bad_codec";
+  if (h.rawSize == 0 || h.packedSize == 0)                          return "bad_size";
+  if (h.codec == OTA_CODEC_STORED && h.packedSize != h.rawSize)     return "bad_size";
+  // LZSS 최악 = 리터럴만 (8바이트마다 제어 바이트 하나)
+  if (h.codec == OTA_CODEC_LZSS && h.packedSize > h.rawSize + h.rawSize / 8 + 1) return "bad_size";
+  return nullptr;
+}
+
+// ==================== SHA-256 ====================
+static const uint32_t SHA_K[64] = {
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static inline uint32_t rotr(uint32_t x, uint32_t n) { return (x >> n) | (x << (32 - n)); }
+
+void Sha256::begin() {
+  static const uint32_t H0[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+  memcpy(h_, H0, sizeof(h_));
+  bytes_ = 0;
+  fill_  = 0;
+}
+
+void Sha256::block(const uint8_t* p) {
+  uint32_t w[64];
+  for (int i = 0; i < 16; i++)
+    w[i] = (uint32_t)p[i * 4] << 24 | (uint32_t)p[i * 4 + 1] << 16 | (uint32_t)p[i * 4 + 2] << 8 | p[i * 4 + 3];
+  for (int i = 16; i < 64; i++) {
+    uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+    uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+  }
+  uint32_t a = h_[0], b = h_[1], c = h_[2], d = h_[3], e = h_[4], f = h_[5], g = h_[6], h = h_[7];
+  for (int i = 0; i < 64; i++) {
+    uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + SHA_K[i] + w[i];
+    uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+    h = g;
+    g = f;
+    f = e;
+    e = d + t1;
+    d = c;
+    c = b;
+    b = a;
+    a = t1 + t2;
+  }
+  h_[0] += a; h_[1] += b; h_[2] += c; h_[3] += d;
+  h_[4] += e; h_[5] += f; h_[6] += g; h_[7] += h;
+}
+
+void Sha256::update(const uint8_t* data, size_t len) {
+  bytes_ += len;
+  if (fill_) {
+    size_t n = 64 - fill_ < len ? 64 - fill_ : len;
+    memcpy(buf_ + fill_, data, n);
+    fill_ += n;
+    data  += n;
+    len   -= n;
+    if (fill_ < 64) return;
+    block(buf_);
+    fill_ = 0;
+  }
+  for (; len >= 64; data += 64, len -= 64) block(data);
+  memcpy(buf_, data, len);
+  fill_ = len;
+}
+
+void Sha256::finish(uint8_t out[32]) {
+  uint64_t bits = bytes_ * 8;
+  uint8_t  pad  = 0x80;
+  update(&pad, 1);
+  pad = 0;
+  while (fill_ != 56) update(&pad, 1);
+  uint8_t len[8];
+  for (int i = 0; i < 8; i++) len[i] = (uint8_t)(bits >> (56 - 8 * i));
+  update(len, 8);
+  for (int i = 0; i < 8; i++) {
+    out[i * 4]     = (uint8_t)(h_[i] >> 24);
+    out[i * 4 + 1] = (uint8_t)(h_[i] >> 16);
+    out[i * 4 + 2] = (uint8_t)(h_[i] >> 8);
+    out[i * 4 + 3] = (uint8_t)h_[i];
+  }
+}
+
+// ==================== LZSS ====================
+void OtaLzDecoder::begin(uint32_t rawSize) {
+  out_      = 0;
+  flushed_  = 0;
+  rawSize_  = rawSize;
+  state_    = ST_CTRL;
+  ctrl_     = 0;
+  bitsLeft_ = 0;
+  failed_   = false;
+}
+
+// 창 경계를 넘기 전에 부르므로 [flushed_, out_) 는 창 안에서 연속
+bool OtaLzDecoder::flush(Sink sink, void* ctx) {
+  if (out_ == flushed_) return true;
+  bool ok  = sink(window_ + (flushed_ & (WINDOW - 1)), out_ - flushed_, ctx);
+  flushed_ = out_;
+  return ok;
+}
+
+bool OtaLzDecoder::feed(const uint8_t* in, size_t len, Sink sink, void* ctx) {
+  if (failed_) return false;
+  const uint32_t mask = WINDOW - 1;
+  for (size_t i = 0; i < len;) {
+    if (out_ == rawSize_) return fail();   // 끝난 뒤 남는 입력
+    switch (state_) {
+      case ST_CTRL:
+        ctrl_     = in[i++];
+        bitsLeft_ = 8;
+        state_    = ST_TOKEN;
+        break;
+      case ST_TOKEN:
+        if (ctrl_ & 1) {
+          window_[out_++ & mask] = in[i++];
+          if (!(out_ & mask) && !flush(sink, ctx)) return fail();
+          nextToken();
+        } else {
+          lo_    = in[i++];
+          state_ = ST_MATCH_HI;
+        }
+        break;
+      case ST_MATCH_HI: {
+        uint8_t  hi   = in[i++];
+        uint32_t dist = ((uint32_t)lo_ | (uint32_t)(hi & 0x0F) << 8) + 1;
+        uint32_t n    = (uint32_t)(hi >> 4) + MIN_MATCH;
+        if (dist > out_ || n > rawSize_ - out_) return fail();
+        // 겹치는 복사 (거리 < 길이) 는 바이트 단위라야 반복 패턴이 된다
+        while (n--) {
+          window_[out_ & mask] = window_[(out_ - dist) & mask];
+          out_++;
+          if (!(out_ & mask) && !flush(sink, ctx)) return fail();
+        }
+        nextToken();
+        break;
+      }
+    }
+  }
+  if (!flush(sink, ctx)) return fail();
+  return true;
+}
@@ -0,0 +1,102 @@
+#include <Arduino.h>
+#include <math.h>
+#include "report_policy.h"
+
+// 마지막으로 보낸 값 (존별)
+struct Reported {
+  bool     valid     = false;
+  uint32_t ms        = 0;
+  float    temp      = NAN;
+  float    humidity  = NAN;
+  int      power     = 0;
+  bool     cooling   = false;
+  bool     hasTarget = false;
+  float    target    = 0.0f;
+  bool     peltier   = true;
+};
+
+static const ReportPolicy DEFAULT_POLICY = {
+  REPORT_HEARTBEAT_SEC, REPORT_TEMP_BAND, REPORT_HUM_BAND, REPORT_POWER_BAND,
+};
+
+static Reported     last[ZONE_COUNT];
+static ReportPolicy policy[ZONE_COUNT];
+static uint32_t     counts[REPORT_REASON_COUNT] = {};
+
+static const char* const REASON_NAMES[REPORT_REASON_COUNT] = {
+  "none", "first", "sensor_fault", "sensor_ok", "cooling_start", "cooling_stop",
+  "target", "peltier", "power", "temp", "humidity", "heartbeat",
+};
+
+// 둘 다 값이 있으면 차이가 band 이상, 한쪽만 있으면 변화로 본다
+static bool beyond(float now, float prev, float band) {
+  if (isfinite(now) != isfinite(prev)) return true;
+  return isfinite(now) && fabsf(now - prev) >= band;
+}
+
+void reportBegin() {
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    last[z]   = Reported();
+    policy[z] = DEFAULT_POLICY;
+  }
+  memset(counts, 0, sizeof(counts));
+}
+
+ReportReason reportCheck(uint8_t zone, uint32_t nowMs) {
+  const Reported&     r  = last[zone];
+  const ReportPolicy& p  = policy[zone];
+  const ZoneStatus&   zs = gZone[zone];
+  if (!r.valid) return REPORT_FIRST;
+
+  // ---- 이벤트: 간격 제한 없이 ----
+  if (isfinite(r.temp) && !isfinite(zs.temp)) return REPORT_SENSOR_FAULT;
+  if (!isfinite(r.temp) && isfinite(zs.temp)) return REPORT_SENSOR_OK;
+  bool cooling = gControl[zone].coolingActive;
+  if (cooling != r.cooling) return cooling ? REPORT_COOLING_START : REPORT_COOLING_STOP;
+  // 스케줄 램프 중에는 목표가 주기마다 조금씩 움직이므로 0.05°C 이상일 때만
+  if (zs.hasTarget != r.hasTarget || (zs.hasTarget && fabsf(zs.target - r.target) >= 0.05f)) return REPORT_TARGET;
+  if (zs.peltierEnabled != r.peltier) return REPORT_PELTIER;
+  if (abs(zs.power - r.power) >= p.powerBand) return REPORT_POWER;
+
+  // ---- dead-band: 흔들리는 값이 밴드 경계를 오가도 REPORT_MIN_GAP_MS 에 한 번 ----
+  uint32_t since = nowMs - r.ms;
+  if (since >= REPORT_MIN_GAP_MS) {
+    if (beyond(zs.temp, r.temp, p.tempBand))        return REPORT_TEMP;
+    if (beyond(zs.humidity, r.humidity, p.humBand)) return REPORT_HUMIDITY;
+  }
+  if (since >= (uint32_t)p.heartbeatSec * 1000UL) return REPORT_HEARTBEAT;
+  return REPORT_NONE;
+}
+
+void reportMark(uint8_t zone, ReportReason reason, uint32_t nowMs) {
+  Reported&         r  = last[zone];
+  const ZoneStatus& zs = gZone[zone];
+  r.valid     = true;
+  r.ms        = nowMs;
+  r.temp      = zs.temp;
+  r.humidity  = zs.humidity;
+  r.power     = zs.power;
+  r.cooling   = gControl[zone].coolingActive;
+  r.hasTarget = zs.hasTarget;
+  r.target    = zs.target;
+  r.peltier   = zs.peltierEnabled;
+  if (reason < REPORT_REASON_COUNT) counts[reason]++;
+}
+
+void reportReset(uint8_t zone) {
+  last[zone].valid = false;
+}
+
+const ReportPolicy& reportPolicy(uint8_t zone) { return policy[zone]; }
+
+void setReportPolicy(uint8_t zone, const ReportPolicy& p) {
+  policy[zone] = p;
+}
+
+const char* reportReasonName(ReportReason r) {
+  return r < REPORT_REASON_COUNT ? REASON_NAMES[r] : "unknown";
+}
+
+uint32_t reportCount(ReportReason r) {
+  return r < REPORT_REASON_COUNT ? counts[r] : 0;
+}
@@ -0,0 +1,164 @@
+#include <Arduino.h>
+#include <string.h>
+#include "control.h"
+#include "schedule.h"
+#include "storage.h"
+#include "zone.h"
+#include "log.h"
+
+// 존별 진행 상태 (스케줄 자체는 NVS blob 과 같은 형태로 보관)
+struct ZoneRun {
+  FermSchedule sched    = {};
+  int8_t       seg      = -1;      // 제어 태스크에 램프를 넘긴 구간 (-1 = 아직)
+  bool         done     = false;
+  bool         waiting  = false;
+  float        setpoint = NAN;
+};
+
+static ZoneRun run[ZONE_COUNT];
+
+static float fromTenths(int16_t v) { return (float)v / 10.0f; }
+
+static uint32_t segSec(const ScheduleSegment& s) { return (uint32_t)s.minutes * 60UL; }
+
+static uint32_t totalSec(const FermSchedule& s) {
+  uint32_t t = 0;
+  for (uint8_t i = 0; i < s.count; i++) t += segSec(s.seg[i]);
+  return t;
+}
+
+// 구간 i 에서 offset 초 지난 시점의 목표
+static float valueAt(const FermSchedule& s, uint8_t i, uint32_t offset) {
+  const ScheduleSegment& g  = s.seg[i];
+  float                  to = fromTenths(g.target10);
+  if (g.kind != SCHED_RAMP) return to;
+  float from = fromTenths(i == 0 ? s.startTarget10 : s.seg[i - 1].target10);
+  return from + (to - from) * (float)offset / (float)segSec(g);
+}
+
+// 시작부터 elapsed 초 → 구간 번호와 구간 안 경과 (끝났으면 count)
+static uint8_t locate(const FermSchedule& s, uint32_t elapsed, uint32_t& offset) {
+  for (uint8_t i = 0; i < s.count; i++) {
+    uint32_t d = segSec(s.seg[i]);
+    if (elapsed < d) {
+      offset = elapsed;
+      return i;
+    }
+    elapsed -= d;
+  }
+  offset = 0;
+  return s.count;
+}
+
+static void advance(uint8_t z) {
+  ZoneRun&      r = run[z];
+  FermSchedule& s = r.sched;
+  if (s.count == 0 || r.done) return;
+  uint32_t now = nowUnix();
+  // 시각을 모르면 어디까지 왔는지 알 수 없으므로 저장된 목표(마지막 구간 진입 값)를 유지
+  r.waiting = now == 0 || now < s.startUnix;
+  if (r.waiting) return;
+
+  uint32_t offset = 0;
+  uint8_t  i      = locate(s, now - s.startUnix, offset);
+  ZoneStatus& zs  = gZone[z];
+
+  if (i >= s.count) {
+    float last = fromTenths(s.seg[s.count - 1].target10);
+    if (!controlPost({CTL_CMD_SET_TARGET, true, last, 0.0f, 0.0f, z})) return;   // 큐가 차면 다음 주기에
+    zs.hasTarget = true;
+    zs.target    = last;
+    storeTarget(z, true, last);
+    r.done     = true;
+    r.setpoint = last;
+    LOG_I(SCHED, "%s done -> hold %.1f", zoneConfig(z).name, last);
+    return;
+  }
+
+  float sp = valueAt(s, i, offset);
+  if ((int8_t)i != r.seg) {
+    // 램프 (시작값, 끝값, 남은 시간). hold 는 시작값 = 끝값
+    const ScheduleSegment& g = s.seg[i];
+    float remaining = (float)(segSec(g) - offset);
+    if (!controlPost({CTL_CMD_SET_RAMP, true, sp, fromTenths(g.target10), remaining, z})) return;
+    r.seg = (int8_t)i;
+    // NTP 없이 재부팅해도 이 값에서 버티도록
+    storeTarget(z, true, sp);
+    LOG_I(SCHED, "%s step %u/%u %s %.2f -> %.1f over %.0fs", zoneConfig(z).name,
+          (unsigned)i + 1, (unsigned)s.count, g.kind == SCHED_RAMP ? "ramp" : "hold",
+          sp, fromTenths(g.target10), remaining);
+  }
+  r.setpoint   = sp;
+  zs.hasTarget = true;
+  zs.target    = sp;
+}
+
+void scheduleBegin() {
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    run[z] = ZoneRun();
+    if (!storedSchedule(z, run[z].sched)) run[z].sched.count = 0;
+  }
+}
+
+void scheduleTick() {
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) advance(z);
+}
+
+bool scheduleSet(uint8_t zone, const FermSchedule& s) {
+  if (zone >= ZONE_COUNT || s.count == 0 || s.count > SCHEDULE_SEGMENTS_MAX) return false;
+  for (uint8_t i = 0; i < s.count; i++) {
+    const ScheduleSegment& g = s.seg[i];
+    if (g.kind > SCHED_RAMP || g.minutes == 0) return false;
+    if (g.target10 < TARGET_MIN * 10 || g.target10 > TARGET_MAX * 10) return false;
+  }
+  ZoneRun& r = run[zone];
+  r         = ZoneRun();
+  r.sched   = s;
+  r.sched.version = SCHEDULE_VERSION;
+  storeSchedule(zone, r.sched);
+  advance(zone);
+  return true;
+}
+
+void scheduleCancel(uint8_t zone) {
+  if (zone >= ZONE_COUNT || run[zone].sched.count == 0) return;
+  run[zone] = ZoneRun();
+  storeSchedule(zone, run[zone].sched);
+}
+
+bool scheduleActive(uint8_t zone) {
+  const ZoneRun& r = run[zone];
+  return r.sched.count > 0 && !r.done;
+}
+
+ScheduleProgress scheduleProgress(uint8_t zone) {
+  const ZoneRun&      r = run[zone];
+  const FermSchedule& s = r.sched;
+  ScheduleProgress    p = {};
+  if (s.count == 0) return p;
+  p.steps    = s.count;
+  p.totalSec = totalSec(s);
+  p.setpoint = r.setpoint;
+  uint32_t now = nowUnix();
+  if (r.done) {
+    p.state      = SCHED_STATE_DONE;
+    p.step       = s.count - 1;
+    p.elapsedSec = p.totalSec;
+  } else if (r.waiting || r.seg < 0) {
+    p.state = SCHED_STATE_WAITING;
+  } else {
+    p.state      = SCHED_STATE_RUNNING;
+    p.step       = (uint8_t)r.seg;
+    p.elapsedSec = now - s.startUnix;
+  }
+  return p;
+}
+
+const char* scheduleStateName(ScheduleState s) {
+  switch (s) {
+    case SCHED_STATE_WAITING: return "waiting";
+    case SCHED_STATE_RUNNING: return "running";
+    case SCHED_STATE_DONE:    return "done";
+    default:                  return "none";
+  }
+}
@@ -0,0 +1,585 @@
+#include "control_bench.h"
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include "config.h"
+#include "control.h"
+#include "dht_wire.h"
+#include "plant.h"
+#include "sim.h"
+#include "state.h"
+#include "zone.h"
+
+typedef std::chrono::steady_clock BenchClock;
+
+static double nsSince(BenchClock::time_point t0) {
+  return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(BenchClock::now() - t0).count();
+}
+
+// ==================== 판정 기준 ====================
+static const float  SETTLE_BAND      = 0.5f;            // |air - target| 이 안에 들어오면 정착으로 본다
+static const double SETTLE_HOLD_SEC  = 10.0 * 60.0;     // 그 상태로 이만큼 유지돼야 정착
+static const double STEADY_AFTER_SEC = 30.0 * 60.0;     // 사건 후 30분부터 정상 상태 RMS 에 넣는다
+static const float  ELEC_W           = PlantParams().peltierElecW;   // 트레이스 에너지 추정 (듀티 100% 소비전력)
+static const double TRACE_GAP_SEC    = 10.0 * 60.0;     // 기록이 이만큼 비면 센서 무응답으로 재생
+
+// 회귀: now > base + max(abs, rel * |base|). 연산 시간은 호스트마다 달라서 3배까지 허용
+struct Gate {
+  const char* key;
+  double      absTol;
+  double      relTol;
+};
+static const Gate GATES[] = {
+  {"overshoot_c",   0.10, 0.00},
+  {"peak_err_c",    0.20, 0.00},
+  {"settling_sec",  120.0, 0.10},
+  {"rms_c",         0.02, 0.10},
+  {"energy_wh",     0.5,  0.05},
+  {"power_mae_pct", 2.0,  0.00},
+  {"tick_ns",       0.0,  2.00},
+};
+
+// ==================== 시나리오 ====================
+enum BenchEventKind : uint8_t {
+  EV_TARGET  = 0,   // value = 목표
+  EV_DOOR    = 1,   // value = 외기로 바뀌는 내부 공기 비율
+  EV_AMBIENT = 2,   // value = 외기, rampH 동안 직선으로
+  EV_DROPOUT = 3    // value = 센서 무응답 확률 (1 = 완전 끊김, 0 = 복구)
+};
+
+struct BenchEvent {
+  double         hour;
+  BenchEventKind kind;
+  float          value;
+  float          rampH;
+};
+
+struct Scenario {
+  const char*             name;
+  double                  hours;
+  float                   initialC;
+  std::vector<BenchEvent> events;
+};
+
+static std::vector<Scenario> builtinScenarios() {
+  return {
+    // 발효 시작 (24 → 18), 라거 온도로 내렸다가 복귀
+    {"target_step", 14.0, 24.0f, {{0.0, EV_TARGET, 18.0f, 0.0f}, {6.0, EV_TARGET, 14.0f, 0.0f},
+                                  {10.0, EV_TARGET, 18.0f, 0.0f}}},
+    // 정착 후 문 열림 두 번
+    {"door", 10.0, 18.0f, {{0.0, EV_TARGET, 18.0f, 0.0f}, {4.0, EV_DOOR, 0.8f, 0.0f},
+                           {6.0, EV_DOOR, 0.8f, 0.0f}}},
+    // 외기 24 → 32°C (2시간에 걸쳐), 4시간 뒤 복귀
+    {"heat_wave", 14.0, 18.0f, {{0.0, EV_TARGET, 18.0f, 0.0f}, {4.0, EV_AMBIENT, 32.0f, 2.0f},
+                                {10.0, EV_AMBIENT, 24.0f, 2.0f}}},
+    // 30% 무응답 2시간 → 15분 완전 끊김 → 복구
+    {"sensor_dropout", 10.0, 18.0f, {{0.0, EV_TARGET, 18.0f, 0.0f}, {4.0, EV_DROPOUT, 0.3f, 0.0f},
+                                     {6.0, EV_DROPOUT, 1.0f, 0.0f}, {6.25, EV_DROPOUT, 0.0f, 0.0f}}},
+  };
+}
+
+// ==================== 기록 트레이스 ====================
+// 헤더로 열을 찾는다: fridge_logs (recorded_at, temperature, humidity, peltier_power, target_temp)
+// 또는 시뮬레이터 --csv (t_sec, target, sensor, ..., power). 목표가 빈 칸이면 목표 없음.
+struct TraceRow {
+  double sec;
+  float  temp;
+  float  humidity;
+  int    power;
+  bool   hasTarget;
+  float  target;
+};
+
+// 1970-01-01 부터 일 수 (그레고리력)
+static long daysFromCivil(int y, int m, int d) {
+  y -= m <= 2;
+  long era = (y >= 0 ? y : y - 399) / 400;
+  long yoe = y - era * 400;
+  long doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+// "2026-01-05 12:34:56[.sss][Z]" 또는 초 단위 숫자
+static double parseTime(const char* s) {
+  int    y, mo, d, h, mi;
+  double sec;
+  if (strchr(s, '-') && sscanf(s, "%d-%d-%d%*c%d:%d:%lf", &y, &mo, &d, &h, &mi, &sec) == 6)
+    return (double)daysFromCivil(y, mo, d) * 86400.0 + h * 3600.0 + mi * 60.0 + sec;
+  return atof(s);
+}
+
+static int splitCsv(char* line, char** cols, int max) {
+  int n = 0;
+  for (char* p = line; n < max;) {
+    cols[n++] = p;
+    char* c = strchr(p, ',');
+    if (!c) break;
+    *c = '\0';
+    p  = c + 1;
+  }
+  char* last = cols[n - 1];
+  last[strcspn(last, "\r\n")] = '\0';
+  return n;
+}
+
+static int findCol(char** cols, int n, const char* a, const char* b) {
+  for (int i = 0; i < n; i++)
+    if (!strcmp(cols[i], a) || (b && !strcmp(cols[i], b))) return i;
+  return -1;
+}
+
+static bool loadTrace(const char* path, std::vector<TraceRow>& out) {
+  FILE* f = fopen(path, "r");
+  if (!f) return false;
+  char  line[512];
+  char* cols[16];
+  int   cTime = -1, cTemp = -1, cHum = -1, cPower = -1, cTarget = -1, cZone = -1;
+  std::string zone;
+  double t0 = NAN;
+  while (fgets(line, sizeof(line), f)) {
+    if (line[0] == '#' || line[0] == '\n') continue;
+    int n = splitCsv(line, cols, 16);
+    if (cTime < 0) {
+      cTime   = findCol(cols, n, "recorded_at", "t_sec");
+      cTemp   = findCol(cols, n, "temperature", "sensor");
+      cHum    = findCol(cols, n, "humidity", nullptr);
+      cPower  = findCol(cols, n, "peltier_power", "power");
+      cTarget = findCol(cols, n, "target_temp", "target");
+      cZone   = findCol(cols, n, "zone", nullptr);
+      if (cTime < 0 || cTemp < 0 || cPower < 0 || cTarget < 0) break;
+      continue;
+    }
+    if (cTime >= n || cTemp >= n || cPower >= n || cTarget >= n) continue;
+    // 여러 존 기록이면 첫 존만
+    if (cZone >= 0 && cZone < n) {
+      if (zone.empty()) zone = cols[cZone];
+      if (zone != cols[cZone]) continue;
+    }
+    TraceRow r;
+    r.sec       = parseTime(cols[cTime]);
+    r.temp      = cols[cTemp][0] && strcmp(cols[cTemp], "nan") ? (float)atof(cols[cTemp]) : NAN;
+    r.humidity  = cHum >= 0 && cHum < n && cols[cHum][0] ? (float)atof(cols[cHum]) : 60.0f;
+    r.power     = atoi(cols[cPower]);
+    r.hasTarget = cols[cTarget][0] != '\0';
+    r.target    = r.hasTarget ? (float)atof(cols[cTarget]) : 0.0f;
+    if (isnan(t0)) t0 = r.sec;
+    r.sec -= t0;
+    if (!out.empty() && r.sec < out.back().sec) continue;   // 순서가 뒤바뀐 행은 버림
+    out.push_back(r);
+  }
+  fclose(f);
+  return out.size() >= 2;
+}
+
+// ==================== 실행 상태 (훅이 함수 포인터라 파일 범위) ====================
+struct BenchRun {
+  ThermalPlant* plant[ZONE_COUNT];
+  bool          hasTarget;
+  float         target;
+  float         dropout;
+  uint32_t      rng;
+  double        hookNs;        // 제어 주기 안에서 플랜트 적분/측정에 쓴 시간 (연산 시간에서 뺀다)
+  bool          prevCooling;
+
+  // 존 0 측정
+  double   eventSec;
+  bool     reached;            // 목표 변경 후 밴드에 한 번 들어왔는지 (그 전의 접근 구간은 오버슈트가 아님)
+  bool     settled;
+  double   inBandSince;
+  double   settleMax;
+  uint32_t unsettled;
+  float    overshoot;          // target - air 최대 (냉각 전용이라 아래로 넘침)
+  float    peakErr;            // air - target 최대 (정착 후 문 열림/폭염/센서 끊김에 밀린 정도)
+  double   sqErrSum;
+  double   steadySec;
+  double   dutySum;
+  double   elecWh;
+  uint32_t starts;
+
+  // 트레이스 재생
+  const std::vector<TraceRow>* trace;
+  size_t                       sensorRow;
+};
+
+static BenchRun run;
+
+static float benchRandom() {
+  run.rng ^= run.rng << 13;
+  run.rng ^= run.rng >> 17;
+  run.rng ^= run.rng << 5;
+  return (float)(run.rng >> 8) / 16777216.0f;
+}
+
+static double benchSec() { return run.plant[0] ? run.plant[0]->elapsedSec() : sim::nowMs() / 1000.0; }
+
+static void closeSettle(double now) {
+  if (run.settled) return;
+  double s = (run.inBandSince >= 0.0 ? run.inBandSince : now) - run.eventSec;
+  if (run.inBandSince < 0.0 || now - run.inBandSince < SETTLE_HOLD_SEC) run.unsettled++;
+  if (s > run.settleMax) run.settleMax = s;
+  run.settled = true;
+}
+
+static void markEvent(bool targetChange) {
+  double now = benchSec();
+  closeSettle(now);
+  run.eventSec    = now;
+  run.settled     = false;
+  run.inBandSince = -1.0;
+  if (targetChange) run.reached = false;
+}
+
+static void benchStep(uint32_t dtMs) {
+  BenchClock::time_point t0 = BenchClock::now();
+  float dt   = dtMs / 1000.0f;
+  float duty = sim::pwmDuty(zoneConfig(0).pwmChannel);
+  for (uint8_t z = 0; z < ZONE_COUNT && run.plant[z]; z++) {
+    run.plant[z]->setDuty(sim::pwmDuty(zoneConfig(z).pwmChannel));
+    run.plant[z]->step(dt);
+  }
+  run.dutySum += duty * dt;
+  run.elecWh  += duty * ELEC_W * dt / 3600.0;
+  if (pid.coolingActive[0] && !run.prevCooling) run.starts++;
+  run.prevCooling = pid.coolingActive[0];
+
+  if (run.plant[0] && run.hasTarget) {
+    double now = benchSec();
+    float  err = run.plant[0]->airC() - run.target;
+    bool   in  = fabsf(err) <= SETTLE_BAND;
+    if (in) run.reached = true;
+    if (run.reached) {
+      if (-err > run.overshoot) run.overshoot = -err;
+      if (err > run.peakErr)    run.peakErr   = err;
+    }
+    if (!run.settled) {
+      if (!in)                          run.inBandSince = -1.0;
+      else if (run.inBandSince < 0.0)   run.inBandSince = now;
+      else if (now - run.inBandSince >= SETTLE_HOLD_SEC) {
+        double s = run.inBandSince - run.eventSec;
+        if (s > run.settleMax) run.settleMax = s;
+        run.settled = true;
+      }
+    }
+    if (now - run.eventSec >= STEADY_AFTER_SEC) {
+      run.sqErrSum  += (double)err * err * dt;
+      run.steadySec += dt;
+    }
+  }
+  run.hookNs += nsSince(t0);
+}
+
+// 플랜트 공기 온도 → DHT21 펄스열 (무응답 주입)
+static size_t benchPlantFrame(uint8_t zone, DhtPulse* out, size_t max) {
+  ThermalPlant& p = *run.plant[zone];
+  float t = p.sampleTemperature();
+  float h = p.sampleHumidity();
+  if (isnan(t) || run.dropout >= 1.0f || (run.dropout > 0.0f && benchRandom() < run.dropout)) return 0;
+  return dhtEncodeFrame(t, h, out, max);
+}
+
+// 기록 온도를 센서로: 기록 간격(보통 1분) 사이는 직선 보간 (0.1°C 양자화는 DHT21 프레임이 한다).
+// 기록은 존 하나 분량이라 존이 여럿이면 모든 존이 같은 기록을 읽는다
+static size_t benchTraceFrame(uint8_t, DhtPulse* out, size_t max) {
+  const std::vector<TraceRow>& tr = *run.trace;
+  double now = sim::nowMs() / 1000.0;
+  while (run.sensorRow + 1 < tr.size() && tr[run.sensorRow + 1].sec <= now) run.sensorRow++;
+  const TraceRow& r = tr[run.sensorRow];
+  if (isnan(r.temp) || now - r.sec > TRACE_GAP_SEC) return 0;
+  float t = r.temp;
+  if (run.sensorRow + 1 < tr.size()) {
+    const TraceRow& n = tr[run.sensorRow + 1];
+    if (isfinite(n.temp) && n.sec - r.sec <= TRACE_GAP_SEC)
+      t += (n.temp - r.temp) * (float)((now - r.sec) / (n.sec - r.sec));
+  }
+  return dhtEncodeFrame(t, r.humidity, out, max);
+}
+
+// ==================== 결과 ====================
+struct BenchResult {
+  std::string                                name;
+  std::vector<std::pair<std::string, double>> fields;
+  void add(const char* key, double v) { fields.push_back({key, v}); }
+};
+
+static void resetFirmware() {
+  pid = PIDState();
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    gZone[z]    = ZoneStatus();
+    gControl[z] = ControlSnapshot();
+  }
+  controlBegin();
+  ControlSnapshot s;
+  while (controlPoll(s)) {}
+}
+
+static void postTarget(bool hasTarget, float target) {
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    controlPost({CTL_CMD_SET_TARGET, hasTarget, target, 0.0f, 0.0f, z});
+    gZone[z].hasTarget = hasTarget;
+    gZone[z].target    = target;
+  }
+  run.hasTarget = hasTarget;
+  run.target    = target;
+}
+
+// 제어 주기 1회 (호스트 연산 시간 측정) + 스냅샷 반영, 다음 주기까지 구동 틱을 돌리며 가상 시계 진행
+struct TickStats {
+  double   nsSum = 0.0;
+  double   nsMax = 0.0;
+  uint32_t n     = 0;
+};
+
+static void tick(uint64_t& nextMs, TickStats& ts) {
+  run.hookNs = 0.0;
+  BenchClock::time_point t0 = BenchClock::now();
+  controlStep();
+  double ns = nsSince(t0) - run.hookNs;
+  ts.nsSum += ns;
+  if (ns > ts.nsMax) ts.nsMax = ns;
+  ts.n++;
+  ControlSnapshot s;
+  while (controlPoll(s)) gControl[s.zone] = s;
+  // 다음 주기까지 펠티어 구동 틱 (펌웨어의 esp_timer)
+  nextMs += CONTROL_PERIOD_MS;
+  while (sim::nowMs() < nextMs) {
+    peltierDriveTick();
+    uint64_t left = nextMs - sim::nowMs();
+    delay((unsigned long)(left < PELTIER_DRIVE_TICK_MS ? left : PELTIER_DRIVE_TICK_MS));
+  }
+}
+
+static BenchResult runScenario(const Scenario& sc) {
+  std::vector<ThermalPlant> plants;
+  plants.reserve(ZONE_COUNT);
+  run = BenchRun();
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    PlantParams p;
+    p.initialC = sc.initialC;
+    p.seed     = 1 + z * 7919u;
+    plants.emplace_back(p);
+    run.plant[z] = &plants[z];
+  }
+  run.rng         = 0x9E3779B9u;
+  run.inBandSince = -1.0;
+  run.settled     = true;
+  sim::setStepHook(benchStep);
+  sim::setDhtFrameSource(benchPlantFrame);
+  resetFirmware();
+
+  const uint64_t startMs = sim::nowMs();
+  const uint64_t endMs   = startMs + (uint64_t)(sc.hours * 3600.0 * 1000.0);
+  uint64_t  nextMs    = startMs;
+  size_t    nextEv    = 0;
+  float     ambFrom   = 0.0f, ambTo = 0.0f;
+  double    ambStartH = 0.0, ambRampH = 0.0;
+  TickStats ts;
+  while (sim::nowMs() < endMs) {
+    double h = (sim::nowMs() - startMs) / 3600000.0;
+    for (; nextEv < sc.events.size() && h >= sc.events[nextEv].hour; nextEv++) {
+      const BenchEvent& e = sc.events[nextEv];
+      switch (e.kind) {
+        case EV_TARGET:  postTarget(true, e.value); break;
+        case EV_DOOR:    for (ThermalPlant& p : plants) p.openDoor(e.value); break;
+        case EV_DROPOUT: run.dropout = e.value; break;
+        case EV_AMBIENT:
+          ambFrom   = plants[0].params().ambientC;
+          ambTo     = e.value;
+          ambStartH = h;
+          ambRampH  = e.rampH;
+          break;
+      }
+      markEvent(e.kind == EV_TARGET);
+    }
+    if (ambRampH > 0.0) {
+      double k = (h - ambStartH) / ambRampH;
+      if (k >= 1.0) { k = 1.0; ambRampH = 0.0; }
+      for (ThermalPlant& p : plants) p.params().ambientC = ambFrom + (ambTo - ambFrom) * (float)k;
+    }
+    tick(nextMs, ts);
+  }
+  closeSettle(benchSec());
+  sim::setStepHook(nullptr);
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) run.plant[z] = nullptr;
+
+  double simSec = sc.hours * 3600.0;
+  BenchResult r;
+  r.name = sc.name;
+  r.add("hours", sc.hours);
+  r.add("overshoot_c", run.overshoot);
+  r.add("peak_err_c", run.peakErr);
+  r.add("settling_sec", run.settleMax);
+  r.add("unsettled", run.unsettled);
+  r.add("rms_c", run.steadySec > 0.0 ? sqrt(run.sqErrSum / run.steadySec) : 0.0);
+  r.add("duty_pct", 100.0 * run.dutySum / simSec);
+  r.add("energy_wh", plants[0].energyWh());
+  r.add("starts", run.starts);
+  r.add("tick_ns", ts.n ? ts.nsSum / ts.n : 0.0);
+  r.add("tick_max_ns", ts.nsMax);
+  return r;
+}
+
+// 기록 온도를 센서로 넣고 같은 시각의 펌웨어 출력과 기록된 출력 비교 (개루프).
+// 기록 온도는 이미 필터를 거친 값이라 필터를 한 번 더 지나면서 늦어지므로, 절대값보다 baseline 대비 변화를 본다.
+static bool runTrace(const char* path, BenchResult& r) {
+  std::vector<TraceRow> tr;
+  if (!loadTrace(path, tr)) return false;
+  run = BenchRun();
+  run.trace       = &tr;
+  run.inBandSince = -1.0;
+  run.settled     = true;
+  sim::setStepHook(benchStep);
+  sim::setDhtFrameSource(benchTraceFrame);
+  resetFirmware();
+
+  // 트레이스 시각은 0부터이므로 지금 가상 시각만큼 민다
+  const uint64_t startMs = sim::nowMs();
+  const double base = startMs / 1000.0;
+  for (TraceRow& row : tr) row.sec += base;
+
+  uint64_t  nextMs = startMs;
+  size_t    row    = 0;
+  double    absSum = 0.0, biasSum = 0.0;
+  uint32_t  compared = 0;
+  TickStats ts;
+  const double endSec = tr.back().sec;
+  while (sim::nowMs() / 1000.0 < endSec) {
+    double now = sim::nowMs() / 1000.0;
+    for (; row < tr.size() && tr[row].sec <= now; row++) {
+      const TraceRow& tRow = tr[row];
+      // 첫 주기 이후 (필터가 값을 잡은 뒤) 같은 시각의 출력끼리
+      if (row > 0 && gControl[0].seq > 0) {
+        int d = gControl[0].power - tRow.power;
+        absSum  += abs(d);
+        biasSum += d;
+        compared++;
+      }
+      if (tRow.hasTarget != run.hasTarget || (tRow.hasTarget && tRow.target != run.target))
+        postTarget(tRow.hasTarget, tRow.target);
+    }
+    tick(nextMs, ts);
+  }
+  sim::setStepHook(nullptr);
+
+  uint32_t rejects = gControl[0].sensorOutliers + gControl[0].sensorRangeRejects;
+  double   simSec  = endSec - base;
+  const char* slash = strrchr(path, '/');
+  r.name = std::string("trace:") + (slash ? slash + 1 : path);
+  r.add("hours", simSec / 3600.0);
+  r.add("rows", (double)tr.size());
+  r.add("power_mae_pct", compared ? absSum / compared : 0.0);
+  r.add("power_bias_pct", compared ? biasSum / compared : 0.0);
+  r.add("duty_pct", simSec > 0.0 ? 100.0 * run.dutySum / simSec : 0.0);
+  r.add("energy_wh", run.elecWh);
+  r.add("starts", run.starts);
+  r.add("sensor_rejects", rejects);
+  r.add("tick_ns", ts.n ? ts.nsSum / ts.n : 0.0);
+  r.add("tick_max_ns", ts.nsMax);
+  return true;
+}
+
+// ==================== 보고서 / baseline ====================
+// 시나리오 하나가 한 줄 (baseline 을 줄 단위로 다시 읽는다)
+static void writeReport(FILE* f, const std::vector<BenchResult>& results) {
+  fprintf(f, "{\"bench\":\"control\",\"zones\":%u,\"control_period_ms\":%u,\"scenarios\":[\n",
+          (unsigned)ZONE_COUNT, (unsigned)CONTROL_PERIOD_MS);
+  for (size_t i = 0; i < results.size(); i++) {
+    const BenchResult& r = results[i];
+    fprintf(f, "  {\"name\":\"%s\"", r.name.c_str());
+    for (const auto& kv : r.fields) fprintf(f, ",\"%s\":%.4g", kv.first.c_str(), kv.second);
+    fprintf(f, "}%s\n", i + 1 < results.size() ? "," : "");
+  }
+  fprintf(f, "]}\n");
+}
+
+static bool loadBaseline(const char* path, std::vector<BenchResult>& out) {
+  FILE* f = fopen(path, "r");
+  if (!f) return false;
+  char line[1024];
+  while (fgets(line, sizeof(line), f)) {
+    char* open  = strchr(line, '{');
+    char* close = strrchr(line, '}');
+    if (!open || !close || !strstr(line, "\"name\"")) continue;
+    JsonDocument doc;
+    if (deserializeJson(doc, open, (size_t)(close - open + 1))) continue;
+    BenchResult r;
+    r.name = doc["name"] | "";
+    for (const Gate& g : GATES)
+      if (!doc[g.key].isNull()) r.add(g.key, doc[g.key].as<double>());
+    out.push_back(r);
+  }
+  fclose(f);
+  return true;
+}
+
+static const double* field(const BenchResult& r, const char* key) {
+  for (const auto& kv : r.fields)
+    if (kv.first == key) return &kv.second;
+  return nullptr;
+}
+
+static uint32_t compareBaseline(const std::vector<BenchResult>& results, const std::vector<BenchResult>& base) {
+  uint32_t regressions = 0;
+  for (const BenchResult& r : results) {
+    const BenchResult* b = nullptr;
+    for (const BenchResult& x : base)
+      if (x.name == r.name) b = &x;
+    if (!b) {
+      fprintf(stderr, "[BENCH] %-22s not in baseline\n", r.name.c_str());
+      continue;
+    }
+    for (const Gate& g : GATES) {
+      const double* now = field(r, g.key);
+      const double* was = field(*b, g.key);
+      if (!now || !was) continue;
+      double tol = g.absTol > g.relTol * fabs(*was) ? g.absTol : g.relTol * fabs(*was);
+      if (*now <= *was + tol) continue;
+      fprintf(stderr, "[BENCH] REGRESSION %-22s %-14s %.4g -> %.4g (tolerance +%.4g)\n",
+              r.name.c_str(), g.key, *was, *now, tol);
+      regressions++;
+    }
+  }
+  return regressions;
+}
+
+int runControlBench(const ControlBenchOptions& opt) {
+  std::vector<BenchResult> results;
+  bool all = !strcmp(opt.scenarios, "all");
+  for (const Scenario& sc : builtinScenarios()) {
+    if (!all && !strstr(opt.scenarios, sc.name)) continue;
+    BenchClock::time_point t0 = BenchClock::now();
+    results.push_back(runScenario(sc));
+    fprintf(stderr, "[BENCH] %-22s %.1f h simulated in %.2f s\n", sc.name, sc.hours, nsSince(t0) / 1e9);
+  }
+  for (const char* path : opt.traces) {
+    BenchResult r;
+    if (!runTrace(path, r)) {
+      fprintf(stderr, "cannot read trace (needs time/temperature/power/target columns): %s\n", path);
+      return 2;
+    }
+    results.push_back(r);
+  }
+
+  FILE* out = opt.outPath ? fopen(opt.outPath, "w") : stdout;
+  if (!out) {
+    fprintf(stderr, "cannot open bench output: %s\n", opt.outPath);
+    return 2;
+  }
+  writeReport(out, results);
+  if (out != stdout) fclose(out);
+
+  if (!opt.baselinePath) return 0;
+  std::vector<BenchResult> base;
+  if (!loadBaseline(opt.baselinePath, base)) {
+    fprintf(stderr, "cannot read baseline: %s\n", opt.baselinePath);
+    return 2;
+  }
+  uint32_t n = compareBaseline(results, base);
+  fprintf(stderr, "[BENCH] %u regression(s) against %s\n", (unsigned)n, opt.baselinePath);
+  return n ? 1 : 0;
+}
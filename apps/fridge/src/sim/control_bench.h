@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+// 제어 회귀 벤치마크 (호스트 전용).
+// 합성 시나리오(목표 계단 / 문 열림 / 외기 폭염 / 센서 끊김)를 열 모델 위에서, 기록된 트레이스
+// (fridge_logs CSV 또는 시뮬레이터 --csv)는 기록 온도를 센서로 넣어 펌웨어 제어 경로
+// (controlStep: 센서 디코드 → 필터 → PID/히스테리시스 → 펠티어)로 돌리고
+// 오버슈트, 정착 시간, 정상 상태 RMS, 듀티/에너지, 주기당 연산 시간을 JSON 으로 낸다.
+// baseline 을 주면 허용치를 넘은 항목을 출력하고 1 을 반환한다 (빌드 실패용).
+struct ControlBenchOptions {
+  const char*              scenarios = "all";    // "all" 또는 쉼표로 구분한 이름, "none" = 트레이스만
+  std::vector<const char*> traces;
+  const char*              outPath      = nullptr;   // 없으면 stdout
+  const char*              baselinePath = nullptr;
+};
+
+int runControlBench(const ControlBenchOptions& opt);
@@ -0,0 +1,26 @@
+#include <Arduino.h>
+#include "config.h"
+#include "dht_sensor.h"
+#include "sim.h"
+
+// 네이티브 빌드용 DHT21 드라이버: 시뮬레이터가 만든 펄스열을 공용 디코더로 해석.
+// ESP32 의 RMT 캡처(dht_rmt.cpp)와 같은 경로를 밟는다.
+// 캡처 동안 호출자가 기다리는 시간(시작 신호 + 프레임, 무응답이면 타임아웃)만큼 가상 시계를 진행해
+// 존 수에 따른 제어 주기 실행 시간이 펌웨어와 같게 잡히도록 한다.
+
+static const size_t DHT_MAX_PULSES = 100;
+
+bool dhtSensorBegin(uint8_t zone, int pin, int rmtChannel) {
+  (void)pin;
+  (void)rmtChannel;
+  return zone < ZONE_COUNT;
+}
+
+DhtStatus dhtSensorRead(uint8_t zone, DhtReading& out) {
+  DhtPulse pulses[DHT_MAX_PULSES];
+  size_t   n = sim::dhtCaptureFrame(zone, pulses, DHT_MAX_PULSES);
+  uint32_t us = DHT_START_LOW_US;
+  for (size_t i = 0; i < n; i++) us += pulses[i].us;
+  delay(n ? (us + 999) / 1000 : DHT_CAPTURE_TIMEOUT_MS);
+  return dhtDecode(pulses, n, out);
+}
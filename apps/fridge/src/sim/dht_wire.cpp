@@ -0,0 +1,60 @@
+#include "dht_wire.h"
+
+#include <math.h>
+
+static const size_t DHT_FIRST_BIT = 3;   // [해제 HIGH, 응답 LOW, 응답 HIGH] 다음부터 비트
+
+static bool put(DhtPulse* out, size_t max, size_t& n, uint8_t level, uint16_t us) {
+  if (n >= max) return false;
+  out[n++] = {level, us};
+  return true;
+}
+
+size_t dhtEncodeFrame(float temp, float humidity, DhtPulse* out, size_t max) {
+  uint16_t h  = (uint16_t)lroundf(humidity * 10.0f);
+  uint16_t ta = (uint16_t)lroundf(fabsf(temp) * 10.0f);
+  uint8_t  b[5];
+  b[0] = (uint8_t)(h >> 8);
+  b[1] = (uint8_t)(h & 0xFF);
+  b[2] = (uint8_t)(((ta >> 8) & 0x7F) | (temp < 0.0f ? 0x80 : 0x00));
+  b[3] = (uint8_t)(ta & 0xFF);
+  b[4] = (uint8_t)(b[0] + b[1] + b[2] + b[3]);
+
+  size_t n = 0;
+  put(out, max, n, 1, 30);   // 호스트 해제 후 풀업 구간
+  put(out, max, n, 0, 80);   // 응답
+  put(out, max, n, 1, 80);
+  for (int bit = 0; bit < 40; bit++) {
+    bool one = (b[bit / 8] >> (7 - (bit % 8))) & 1;
+    put(out, max, n, 0, 50);
+    put(out, max, n, 1, one ? 70 : 27);
+  }
+  put(out, max, n, 0, 50);   // 종료
+  return n;
+}
+
+void dhtInjectFault(DhtFault fault, float rnd, DhtPulse* pulses, size_t& n) {
+  if (n <= DHT_FIRST_BIT + 1) return;
+  size_t bits = (n - DHT_FIRST_BIT - 1) / 2;
+  size_t bit  = (size_t)(rnd * bits);
+  if (bit >= bits) bit = bits - 1;
+  size_t low  = DHT_FIRST_BIT + bit * 2;
+  size_t high = low + 1;
+
+  switch (fault) {
+    case DHT_FAULT_NONE:
+      break;
+    case DHT_FAULT_BITFLIP:
+      pulses[high].us = pulses[high].us >= DHT_BIT_ONE_US ? 27 : 70;
+      break;
+    case DHT_FAULT_STRETCH:
+      pulses[low].us = 140;
+      break;
+    case DHT_FAULT_TRUNCATE:
+      n = high;
+      break;
+    case DHT_FAULT_SILENT:
+      n = 1;   // 해제 HIGH 만 남음
+      break;
+  }
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "dht_decode.h"
+
+// 시뮬레이터용 DHT21 펄스열 생성기와 손상 주입기.
+// 생성된 펄스열은 실제 센서 타이밍(응답 80/80us, 비트 50us + 27/70us)을 따른다.
+
+enum DhtFault : uint8_t {
+  DHT_FAULT_NONE     = 0,
+  DHT_FAULT_BITFLIP  = 1,   // 데이터 비트 하나 반전 → 체크섬 오류
+  DHT_FAULT_STRETCH  = 2,   // 펄스 하나를 허용 범위 밖으로 늘림 → 타이밍 오류
+  DHT_FAULT_TRUNCATE = 3,   // 프레임 중간에서 끊김 → 타이밍 오류
+  DHT_FAULT_SILENT   = 4    // 응답 없음
+};
+
+// 온도/습도를 DHT21 5바이트 프레임으로 인코딩한 펄스열. 반환값 = 펄스 개수
+size_t dhtEncodeFrame(float temp, float humidity, DhtPulse* out, size_t max);
+
+// 펄스열을 fault 종류대로 손상. rnd 는 [0, 1) 난수 (위치 선택용)
+void dhtInjectFault(DhtFault fault, float rnd, DhtPulse* pulses, size_t& n);
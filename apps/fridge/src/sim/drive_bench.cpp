@@ -0,0 +1,95 @@
+#include "drive_bench.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <chrono>
+#include "config.h"
+#include "peltier_drive.h"
+
+// control.cpp 와 같은 환산 (전체 듀티 %/s → 틱당 Q 코드)
+static int32_t stepQ(float pctPerSec) {
+  return (int32_t)((float)PELTIER_PWM_MAX * pctPerSec / 100.0f * (float)PELTIER_DRIVE_TICK_MS / 1000.0f *
+                   (float)(1L << PeltierDrive::FRAC));
+}
+
+static const uint32_t DITHER_WINDOW = 256;   // 평균을 볼 틱 수 (~5초)
+
+struct DriveCheck {
+  uint32_t ditherFails = 0;
+  uint32_t slewFails   = 0;
+  uint32_t offFails    = 0;
+  uint32_t maxFails    = 0;
+  double   ditherErrMax = 0.0;   // 코드 단위
+};
+
+int runDriveBench(uint32_t steps) {
+  if (steps < 16) steps = 16;
+  const PeltierDriveParams p = {
+    PeltierDrive::fromCode(PELTIER_ABS_MAX_PWM),
+    stepQ(PELTIER_SLEW_PCT_PER_SEC),
+    stepQ(PELTIER_SOFT_START_PCT_PER_SEC),
+    PELTIER_SOFT_START_MS / PELTIER_DRIVE_TICK_MS,
+  };
+  const double q = (double)(1L << PeltierDrive::FRAC);
+  printf("[BENCH] drive: res=%dbit max=%d codes (8bit: %d) tick=%ums slew=%.2f soft=%.2f codes/tick soft_start=%u ticks\n",
+         PELTIER_PWM_RES, PELTIER_ABS_MAX_PWM, (int)(255 * PELTIER_MAX_DUTY_PCT / 100.0f),
+         (unsigned)PELTIER_DRIVE_TICK_MS, p.slewStepQ / q, p.softStepQ / q, (unsigned)p.softStartTicks);
+
+  PeltierDrive d;
+  DriveCheck   c;
+  uint32_t     rng    = 0x9E3779B9u;
+  uint64_t     ticks  = 0;
+  double       tickNs = 0.0;
+  for (uint32_t s = 0; s < steps; s++) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    // 1/8 은 정지, 나머지는 소수부가 있는 임의 목표
+    int32_t target = (rng & 7) == 0 ? 0 : (int32_t)(rng % (uint32_t)p.maxQ);
+    bool    wasOff = d.level() == 0;
+    d.setTarget(target);
+
+    // 목표까지 슬루 (변화량 확인)
+    int32_t  prev    = d.level();
+    uint32_t onTicks = 0;
+    auto     t0      = std::chrono::steady_clock::now();
+    uint32_t code    = 0;
+    for (uint32_t i = 0; i < 4096 && (d.level() != target || i == 0); i++) {
+      code = d.tick(p);
+      ticks++;
+      if (target == 0) {
+        if (code != 0 || d.level() != 0) c.offFails++;
+        break;
+      }
+      int32_t limit = wasOff && onTicks < p.softStartTicks ? p.softStepQ : p.slewStepQ;
+      int32_t delta = d.level() - prev;
+      if (delta > limit || delta < -limit) c.slewFails++;
+      if ((int32_t)code > PELTIER_ABS_MAX_PWM) c.maxFails++;
+      prev = d.level();
+      onTicks++;
+    }
+    if (target == 0) continue;
+
+    // 정착 후 창 평균
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < DITHER_WINDOW; i++) {
+      code = d.tick(p);
+      sum += code;
+      if ((int32_t)code > PELTIER_ABS_MAX_PWM) c.maxFails++;
+    }
+    ticks += DITHER_WINDOW;
+    tickNs += (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+    double err = fabs((double)sum / DITHER_WINDOW - target / q);
+    if (err > c.ditherErrMax) c.ditherErrMax = err;
+    if (err > 1.0 / DITHER_WINDOW + 1e-9) c.ditherFails++;
+  }
+
+  printf("[BENCH] drive: %u steps %llu ticks %.1f ns/tick | dither max|mean-target|=%.5f codes (limit %.5f) "
+         "-> effective ~%.0f levels over %u ticks\n",
+         (unsigned)steps, (unsigned long long)ticks, ticks ? tickNs / ticks : 0.0, c.ditherErrMax,
+         1.0 / DITHER_WINDOW, (double)PELTIER_ABS_MAX_PWM * DITHER_WINDOW, (unsigned)DITHER_WINDOW);
+  printf("[BENCH] drive: violations dither=%u slew=%u off=%u max=%u -> %s\n", (unsigned)c.ditherFails,
+         (unsigned)c.slewFails, (unsigned)c.offFails, (unsigned)c.maxFails,
+         c.ditherFails + c.slewFails + c.offFails + c.maxFails ? "FAIL" : "ok");
+  return c.ditherFails + c.slewFails + c.offFails + c.maxFails ? 1 : 0;
+}
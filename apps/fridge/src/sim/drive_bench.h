@@ -0,0 +1,11 @@
+#pragma once
+
+#include <stdint.h>
+
+// 펠티어 구동 레이어 검증 + 벤치마크 (호스트 전용).
+// PeltierDrive 에 무작위 목표 계단을 넣고 틱마다 다음을 확인한다:
+//   - 디더링: 목표에 도달한 뒤 N 틱 평균 코드가 목표(소수부 포함)와 1/N 코드 이내
+//   - 슬루: 틱당 듀티 변화가 slewStep (켜진 직후 softStartTicks 동안 softStep) 이하
+//   - 정지: 목표 0 이면 다음 틱 바로 0, 출력은 상한을 넘지 않음
+// 어긴 항목이 있으면 1 을 반환한다. 틱 1회 시간과 8비트 대비 실효 해상도도 출력.
+int runDriveBench(uint32_t steps);
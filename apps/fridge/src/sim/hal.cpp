@@ -0,0 +1,277 @@
+#include <Arduino.h>
+#include <Preferences.h>
+#include <stdarg.h>
+#include <malloc.h>
+#include <stdlib.h>
+#include <chrono>
+#include <map>
+#include "mqtt_out.h"
+#include "sim.h"
+
+// ==================== 가상 시계 ====================
+static uint64_t      gNowMs    = 0;
+static sim::StepHook gStepHook = nullptr;
+
+namespace sim {
+uint64_t nowMs() { return gNowMs; }
+
+void advance(uint32_t ms) {
+  gNowMs += ms;
+  if (gStepHook) gStepHook(ms);
+}
+
+void setStepHook(StepHook hook) { gStepHook = hook; }
+}  // namespace sim
+
+unsigned long millis() { return (unsigned long)gNowMs; }
+unsigned long micros() { return (unsigned long)(gNowMs * 1000ULL); }
+
+void delay(unsigned long ms) {
+  // 플랜트 적분 간격을 일정하게 유지하기 위해 10ms 단위로 나눠 진행
+  while (ms > 0) {
+    uint32_t step = ms > 10 ? 10 : (uint32_t)ms;
+    sim::advance(step);
+    ms -= step;
+  }
+}
+
+// ==================== LEDC ====================
+static const int LEDC_CHANNELS = 16;
+static uint8_t   gLedcRes[LEDC_CHANNELS];
+static uint32_t  gLedcDuty[LEDC_CHANNELS];
+
+uint32_t ledcSetup(uint8_t chan, uint32_t freq, uint8_t resBits) {
+  if (chan >= LEDC_CHANNELS) return 0;
+  gLedcRes[chan]  = resBits;
+  gLedcDuty[chan] = 0;
+  return freq;
+}
+
+void ledcAttachPin(uint8_t pin, uint8_t chan) { (void)pin; (void)chan; }
+
+void ledcWrite(uint8_t chan, uint32_t duty) {
+  if (chan >= LEDC_CHANNELS) return;
+  gLedcDuty[chan] = duty;
+}
+
+float sim::pwmDuty(uint8_t chan) {
+  if (chan >= LEDC_CHANNELS || gLedcRes[chan] == 0) return 0.0f;
+  uint32_t full = (1UL << gLedcRes[chan]) - 1;
+  float d = (float)gLedcDuty[chan] / (float)full;
+  return d > 1.0f ? 1.0f : d;
+}
+
+// ==================== Serial ====================
+HardwareSerial Serial;
+
+size_t HardwareSerial::print(const char* s)      { return (size_t)fputs(s, stdout); }
+size_t HardwareSerial::print(char c)             { return (size_t)(fputc(c, stdout) != EOF); }
+size_t HardwareSerial::print(int v)              { return (size_t)::printf("%d", v); }
+size_t HardwareSerial::print(unsigned int v)     { return (size_t)::printf("%u", v); }
+size_t HardwareSerial::print(long v)             { return (size_t)::printf("%ld", v); }
+size_t HardwareSerial::print(unsigned long v)    { return (size_t)::printf("%lu", v); }
+size_t HardwareSerial::print(double v, int digits) { return (size_t)::printf("%.*f", digits, v); }
+size_t HardwareSerial::write(const uint8_t* data, size_t len) { return fwrite(data, 1, len, stdout); }
+void   HardwareSerial::flush()                    { fflush(stdout); }
+
+size_t HardwareSerial::printf(const char* fmt, ...) {
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vprintf(fmt, ap);
+  va_end(ap);
+  return n < 0 ? 0 : (size_t)n;
+}
+
+// ==================== 힙 ====================
+// ESP32 기본 힙 크기 근사. 실제 할당량은 malloc_usable_size 로 집계
+// malloc 자체를 가로챈다 (glibc 의 __libc_* 로 넘김): operator new 뿐 아니라 라이브러리의 malloc
+// (ArduinoJson 기본 할당자, JsonPool 이 넘친 블록 등) 도 잡힌다.
+static const uint32_t SIM_HEAP_BYTES = 200 * 1024;
+static uint64_t gHeapAllocs    = 0;
+static int64_t  gHeapLive      = 0;
+static int64_t  gHeapPeak      = 0;
+static int      gHeapUncounted = 0;   // HeapUncounted 중첩 깊이
+
+extern "C" {
+void* __libc_malloc(size_t n);
+void* __libc_calloc(size_t n, size_t size);
+void* __libc_realloc(void* p, size_t n);
+void  __libc_free(void* p);
+}
+
+static void heapTake(void* p) {
+  if (!p || gHeapUncounted) return;
+  gHeapAllocs++;
+  gHeapLive += (int64_t)malloc_usable_size(p);
+  if (gHeapLive > gHeapPeak) gHeapPeak = gHeapLive;
+}
+
+static void heapGive(void* p) {
+  if (!p || gHeapUncounted) return;
+  gHeapLive -= (int64_t)malloc_usable_size(p);
+}
+
+extern "C" void* malloc(size_t n) {
+  void* p = __libc_malloc(n);
+  heapTake(p);
+  return p;
+}
+
+extern "C" void* calloc(size_t n, size_t size) {
+  void* p = __libc_calloc(n, size);
+  heapTake(p);
+  return p;
+}
+
+extern "C" void* realloc(void* p, size_t n) {
+  heapGive(p);
+  void* q = __libc_realloc(p, n);
+  if (q)     heapTake(q);
+  else if (n) heapTake(p);   // 실패하면 원래 블록이 그대로 남는다 (n = 0 이면 놓은 것)
+  return q;
+}
+
+extern "C" void free(void* p) {
+  heapGive(p);
+  __libc_free(p);
+}
+
+uint64_t sim::heapAllocCount() { return gHeapAllocs; }
+
+sim::HeapUncounted::HeapUncounted() { gHeapUncounted++; }
+sim::HeapUncounted::~HeapUncounted() { gHeapUncounted--; }
+
+uint32_t EspClass::getFreeHeap()    { return SIM_HEAP_BYTES - (uint32_t)gHeapLive; }
+uint32_t EspClass::getMinFreeHeap() { return SIM_HEAP_BYTES - (uint32_t)gHeapPeak; }
+
+uint32_t EspClass::getCycleCount() {
+  static const auto t0 = std::chrono::steady_clock::now();
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+  return (uint32_t)((uint64_t)ns * 240 / 1000);
+}
+
+// ==================== ESP ====================
+EspClass    ESP;
+static bool     gRestartRequested = false;
+static uint32_t gRestartUnsent    = 0;
+static uint32_t gRestartPwmOn     = 0;
+
+// 실제로는 여기서 돌아오지 않으므로 발행 큐에 남은 메시지는 이 순간 사라지고, 켜져 있던 펠티어는 전 듀티에서 끊긴다
+void EspClass::restart() {
+  if (!gRestartRequested) {
+    gRestartUnsent += mqttOutStats().depth;
+    for (int ch = 0; ch < LEDC_CHANNELS; ch++)
+      if (gLedcDuty[ch]) gRestartPwmOn++;
+  }
+  gRestartRequested = true;
+}
+
+uint32_t sim::restartUnsent() { return gRestartUnsent; }
+uint32_t sim::restartPwmOn() { return gRestartPwmOn; }
+
+bool sim::takeRestartRequest() {
+  bool r = gRestartRequested;
+  gRestartRequested = false;
+  return r;
+}
+
+// ==================== DHT ====================
+static sim::DhtFrameSource gDhtSource = nullptr;
+
+void sim::setDhtFrameSource(DhtFrameSource source) { gDhtSource = source; }
+
+size_t sim::dhtCaptureFrame(uint8_t zone, DhtPulse* out, size_t max) {
+  return gDhtSource ? gDhtSource(zone, out, max) : 0;
+}
+
+// ==================== Preferences ====================
+// 키: "<namespace>/<key>", 값: 원시 바이트
+static std::map<std::string, std::string> gNvs;
+static uint64_t                           gNvsWrites = 0;
+
+uint64_t sim::nvsWriteCount() { return gNvsWrites; }
+
+static std::string nvsKey(const String& ns, const char* key) { return ns + "/" + key; }
+
+bool Preferences::begin(const char* name, bool readOnly, const char* partition) {
+  (void)partition;
+  ns_       = name;
+  readOnly_ = readOnly;
+  open_     = true;
+  return true;
+}
+
+void Preferences::end() { open_ = false; }
+
+bool Preferences::clear() {
+  if (!open_ || readOnly_) return false;
+  std::string prefix = ns_ + "/";
+  for (auto it = gNvs.begin(); it != gNvs.end();) {
+    if (it->first.compare(0, prefix.size(), prefix) == 0) it = gNvs.erase(it);
+    else ++it;
+  }
+  return true;
+}
+
+bool Preferences::remove(const char* key) {
+  if (!open_ || readOnly_) return false;
+  return gNvs.erase(nvsKey(ns_, key)) > 0;
+}
+
+bool Preferences::isKey(const char* key) {
+  return open_ && gNvs.count(nvsKey(ns_, key)) > 0;
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t len) {
+  if (!open_ || readOnly_) return 0;
+  gNvs[nvsKey(ns_, key)] = std::string((const char*)value, len);
+  gNvsWrites++;
+  return len;
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+  if (!open_) return 0;
+  auto it = gNvs.find(nvsKey(ns_, key));
+  return it == gNvs.end() ? 0 : it->second.size();
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) {
+  if (!open_) return 0;
+  auto it = gNvs.find(nvsKey(ns_, key));
+  if (it == gNvs.end() || it->second.size() > maxLen) return 0;
+  memcpy(buf, it->second.data(), it->second.size());
+  return it->second.size();
+}
+
+template <typename T>
+static T nvsGet(Preferences& p, const char* key, T def) {
+  T v;
+  if (p.getBytesLength(key) != sizeof(T)) return def;
+  p.getBytes(key, &v, sizeof(T));
+  return v;
+}
+
+size_t Preferences::putBool(const char* key, bool value)       { uint8_t v = value ? 1 : 0; return putBytes(key, &v, 1); }
+size_t Preferences::putInt(const char* key, int32_t value)     { return putBytes(key, &value, sizeof(value)); }
+size_t Preferences::putUInt(const char* key, uint32_t value)   { return putBytes(key, &value, sizeof(value)); }
+size_t Preferences::putFloat(const char* key, float value)     { return putBytes(key, &value, sizeof(value)); }
+size_t Preferences::putString(const char* key, const char* value) { return putBytes(key, value, strlen(value)); }
+
+bool     Preferences::getBool(const char* key, bool defaultValue)      { return nvsGet<uint8_t>(*this, key, defaultValue ? 1 : 0) != 0; }
+int32_t  Preferences::getInt(const char* key, int32_t defaultValue)    { return nvsGet<int32_t>(*this, key, defaultValue); }
+uint32_t Preferences::getUInt(const char* key, uint32_t defaultValue)  { return nvsGet<uint32_t>(*this, key, defaultValue); }
+float    Preferences::getFloat(const char* key, float defaultValue)    { return nvsGet<float>(*this, key, defaultValue); }
+
+String Preferences::getString(const char* key, const String& defaultValue) {
+  if (!open_) return defaultValue;
+  auto it = gNvs.find(nvsKey(ns_, key));
+  return it == gNvs.end() ? defaultValue : it->second;
+}
+
+size_t Preferences::getString(const char* key, char* value, size_t maxLen) {
+  if (!open_ || maxLen == 0) return 0;
+  auto it = gNvs.find(nvsKey(ns_, key));
+  if (it == gNvs.end() || it->second.size() + 1 > maxLen) return 0;
+  memcpy(value, it->second.c_str(), it->second.size() + 1);
+  return it->second.size() + 1;
+}
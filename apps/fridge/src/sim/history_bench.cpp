@@ -0,0 +1,138 @@
+#include "history_bench.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <chrono>
+#include <vector>
+#include "config.h"
+#include "history.h"
+#include "lttb.h"
+#include "sim.h"
+#include "state.h"
+
+// ==================== 합성 곡선 ====================
+// 목표 계단(발효 → 콜드 크래시) 으로 지수 수렴 + 냉각 ON/OFF 톱니 + 문 열림 스파이크 + 잡음.
+// 값은 이력 샘플과 같은 0.1°C 로 양자화.
+static std::vector<float> makeTrace(uint32_t n, std::vector<float>& targets) {
+  std::vector<float> tr(n);
+  targets.assign(n, 0.0f);
+  uint32_t rng    = 0x2545F491u;
+  float    temp   = 20.0f;
+  float    target = 18.0f;
+  float    saw    = 0.0f;
+  for (uint32_t i = 0; i < n; i++) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    if (i % 3600 == 0) target = (i / 3600) % 3 == 2 ? 2.0f : 18.0f + (float)(i / 3600 % 2);
+    temp += (target - temp) * 0.002f;
+    saw   = fmodf(saw + 0.004f, 0.6f);
+    if (rng % 2000 == 0) temp += 3.0f;   // 문 열림
+    float noise = ((float)(rng & 0xFFFF) / 65536.0f - 0.5f) * 0.2f;
+    tr[i]       = roundf((temp + saw - 0.3f + noise) * 10.0f) / 10.0f;
+    targets[i]  = target;
+  }
+  return tr;
+}
+
+// 고른 점 사이를 직선으로 이었을 때 원본과의 평균 오차, 그리고 30분 창마다 최고/최저가
+// 얼마나 깎였는지 (그래프에서 문 열림 스파이크나 냉각 톱니가 사라지는 정도)
+static const uint32_t BENCH_WINDOW = 900;   // 30분 (2초 주기)
+
+static void downsampleError(const std::vector<float>& tr, const std::vector<uint32_t>& idx,
+                            double& meanErr, double& envErr) {
+  meanErr = 0.0;
+  for (size_t k = 0; k + 1 < idx.size(); k++) {
+    uint32_t a = idx[k], b = idx[k + 1];
+    for (uint32_t i = a; i < b; i++) {
+      double est = tr[a] + (tr[b] - tr[a]) * (double)(i - a) / (b - a);
+      meanErr += fabs(est - tr[i]);
+    }
+  }
+  meanErr /= tr.size();
+
+  envErr         = 0.0;
+  uint32_t wins  = 0;
+  size_t   k     = 0;
+  for (uint32_t w0 = 0; w0 < tr.size(); w0 += BENCH_WINDOW, wins++) {
+    uint32_t w1 = w0 + BENCH_WINDOW < tr.size() ? w0 + BENCH_WINDOW : (uint32_t)tr.size();
+    float    rawHi = -1e9f, rawLo = 1e9f, hi = -1e9f, lo = 1e9f;
+    for (uint32_t i = w0; i < w1; i++) {
+      rawHi = fmaxf(rawHi, tr[i]);
+      rawLo = fminf(rawLo, tr[i]);
+    }
+    for (; k < idx.size() && idx[k] < w1; k++) {
+      hi = fmaxf(hi, tr[idx[k]]);
+      lo = fminf(lo, tr[idx[k]]);
+    }
+    if (hi < lo) continue;   // 이 창에 고른 점이 없음 (점이 아주 적을 때)
+    envErr += (rawHi - hi) + (lo - rawLo);
+  }
+  envErr /= wins;
+}
+
+struct CountSink {
+  uint32_t maxChunk = 0;
+};
+
+int runHistoryBench(uint32_t queries) {
+  if (queries == 0) queries = 1;
+  const uint32_t n          = HISTORY_SAMPLES;
+  const double   perHourB   = sizeof(HistorySample) * 3600.0 / HISTORY_STEP_SEC;
+  printf("[BENCH] history layout: %u B/sample, %.0f B/h/zone (%.1f KiB), %u zones x %u samples = %u B, span %.2f h/zone\n",
+         (unsigned)sizeof(HistorySample), perHourB, perHourB / 1024.0, (unsigned)ZONE_COUNT, (unsigned)n,
+         (unsigned)(n * sizeof(HistorySample) * ZONE_COUNT), n * HISTORY_STEP_SEC / 3600.0);
+
+  std::vector<float> targets;
+  std::vector<float> tr = makeTrace(n, targets);
+  historyBegin();
+  gZone[0].hasTarget = true;
+  for (uint32_t i = 0; i < n; i++) {
+    sim::advance(CONTROL_PERIOD_MS);
+    ControlSnapshot s;
+    s.zone          = 0;
+    s.ms            = millis();
+    s.temp          = tr[i];
+    s.humidity      = 60.0f + 5.0f * sinf(i * 0.001f);
+    s.power         = (i / 150) % 2 ? 80 : 0;
+    s.coolingActive = s.power > 0;
+    gZone[0].target = targets[i];
+    historyAdd(s);
+  }
+  HistoryStats hs = historyStats(0);
+  printf("[BENCH] filled %u/%u samples (%.2f h), gap fills=%u, %u queries per setting\n",
+         (unsigned)hs.count, (unsigned)hs.capacity, hs.spanSec / 3600.0, (unsigned)hs.gapFills, (unsigned)queries);
+
+  static const uint32_t POINTS[] = {100, 300, 1000, HISTORY_POINTS_MAX};
+  for (uint32_t points : POINTS) {
+    CountSink     sink;
+    HistoryResult r     = {};
+    double        bestUs = 1e30;
+    for (uint32_t q = 0; q < queries; q++) {
+      auto t0 = std::chrono::steady_clock::now();
+      r = historyWriteJson(0, 0, UINT32_MAX, points,
+                           [](const char*, size_t len, void* ctx) {
+                             CountSink& s = *(CountSink*)ctx;
+                             if (len > s.maxChunk) s.maxChunk = (uint32_t)len;
+                           },
+                           &sink);
+      auto   t1 = std::chrono::steady_clock::now();
+      double us = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count() / 1000.0;
+      if (us < bestUs) bestUs = us;
+    }
+
+    // 같은 점 수로 LTTB vs 등간격 솎아내기
+    std::vector<uint32_t> lttbIdx, strideIdx;
+    lttbSelect(n, points, [&](uint32_t i) { return tr[i]; }, [&](uint32_t i) { lttbIdx.push_back(i); });
+    for (uint32_t k = 0; k < lttbIdx.size(); k++)
+      strideIdx.push_back((uint32_t)((uint64_t)k * (n - 1) / (lttbIdx.size() - 1)));
+    double lMean, lEnv, sMean, sEnv;
+    downsampleError(tr, lttbIdx, lMean, lEnv);
+    downsampleError(tr, strideIdx, sMean, sEnv);
+    printf("[BENCH] points=%-5u %8.1f us/query  %6u B  %3u chunks (max %u B)  "
+           "lttb err=%.3f env=%.2fC  stride err=%.3f env=%.2fC\n",
+           (unsigned)r.points, bestUs, (unsigned)r.bytes, (unsigned)r.chunks, (unsigned)sink.maxChunk,
+           lMean, lEnv, sMean, sEnv);
+  }
+  return 0;
+}
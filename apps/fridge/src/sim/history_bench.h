@@ -0,0 +1,8 @@
+#pragma once
+
+#include <stdint.h>
+
+// /history 벤치마크 (호스트 전용).
+// 존 0 이력 링을 합성 발효 온도 곡선으로 가득 채우고, 점 수별로 LTTB + chunked JSON 생성 시간,
+// 응답 크기, 원본 대비 선형 보간 오차(같은 점 수의 단순 솎아내기와 비교)를 출력한다.
+int runHistoryBench(uint32_t queries);
@@ -0,0 +1,66 @@
+#pragma once
+
+// 네이티브(호스트) 빌드용 Arduino 최소 호환 계층.
+// 공용 코드(control/storage/telemetry/commands)가 그대로 컴파일되도록
+// 실제로 사용하는 API만 흉내낸다. 구현은 src/sim/hal.cpp.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+
+using String = std::string;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+
+// LEDC (ESP32 PWM)
+uint32_t ledcSetup(uint8_t chan, uint32_t freq, uint8_t resBits);
+void     ledcAttachPin(uint8_t pin, uint8_t chan);
+void     ledcWrite(uint8_t chan, uint32_t duty);
+
+class HardwareSerial {
+ public:
+  void begin(unsigned long) {}
+  void end() {}
+  void setTxBufferSize(size_t) {}
+  explicit operator bool() const { return true; }
+
+  // stdout 은 막히지 않는다: TX 버퍼가 늘 비어 있는 것처럼
+  int    availableForWrite() { return 4096; }
+  size_t write(const uint8_t* data, size_t len);
+  void   flush();
+
+  size_t print(const char* s);
+  size_t print(const String& s) { return print(s.c_str()); }
+  size_t print(char c);
+  size_t print(int v);
+  size_t print(unsigned int v);
+  size_t print(long v);
+  size_t print(unsigned long v);
+  size_t print(double v, int digits = 2);
+
+  size_t println() { return print("\n"); }
+  template <typename T>
+  size_t println(const T& v) { size_t n = print(v); return n + println(); }
+  size_t println(double v, int digits) { size_t n = print(v, digits); return n + println(); }
+
+  size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+};
+extern HardwareSerial Serial;
+
+// 힙 통계: 시뮬레이터의 operator new/delete 집계로 흉내낸다 (hal.cpp)
+class EspClass {
+ public:
+  void     restart();
+  uint32_t getFreeHeap();
+  uint32_t getMaxAllocHeap() { return getFreeHeap(); }
+  uint32_t getMinFreeHeap();
+  // 호스트 단조 시계를 240MHz 사이클로 환산 (실제 실행 시간 측정용)
+  uint32_t getCycleCount();
+  uint32_t getCpuFreqMHz() { return 240; }
+};
+extern EspClass ESP;
@@ -0,0 +1,16 @@
+#pragma once
+
+// 네이티브 빌드용 256dpi MQTTClient 대체: 연결 상태와 수신 처리만 (발행은 mqtt_out → sim/mqtt_sim.cpp 브로커).
+
+#include <Arduino.h>
+
+class MQTTClient {
+ public:
+  explicit MQTTClient(int bufSize = 128) { (void)bufSize; }
+
+  bool connect(const char* clientId, const char* username = nullptr, const char* password = nullptr);
+  bool connected();
+  bool sessionPresent() { return false; }   // clean session
+  bool disconnect();
+  bool loop();   // 때가 된 브로커 응답 전달 (PUBREC 에는 라이브러리처럼 PUBREL 로 답함)
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+// 네이티브 빌드용 NVS(Preferences) 대체: 프로세스 메모리에 보관하며
+// 시뮬레이션 재부팅(ESP.restart) 사이에서도 값이 유지된다.
+
+#include <Arduino.h>
+
+class Preferences {
+ public:
+  bool begin(const char* name, bool readOnly = false, const char* partition = nullptr);
+  void end();
+
+  bool   clear();
+  bool   remove(const char* key);
+  bool   isKey(const char* key);
+
+  size_t putBool(const char* key, bool value);
+  size_t putInt(const char* key, int32_t value);
+  size_t putUInt(const char* key, uint32_t value);
+  size_t putFloat(const char* key, float value);
+  size_t putString(const char* key, const char* value);
+  size_t putString(const char* key, const String& value) { return putString(key, value.c_str()); }
+  size_t putBytes(const char* key, const void* value, size_t len);
+
+  bool     getBool(const char* key, bool defaultValue = false);
+  int32_t  getInt(const char* key, int32_t defaultValue = 0);
+  uint32_t getUInt(const char* key, uint32_t defaultValue = 0);
+  float    getFloat(const char* key, float defaultValue = NAN);
+  String   getString(const char* key, const String& defaultValue = String());
+  size_t   getString(const char* key, char* value, size_t maxLen);
+  size_t   getBytesLength(const char* key);
+  size_t   getBytes(const char* key, void* buf, size_t maxLen);
+
+ private:
+  String ns_;
+  bool   open_     = false;
+  bool   readOnly_ = false;
+};
@@ -0,0 +1,149 @@
+#include <MQTTClient.h>
+#include <string.h>
+#include "mqtt_out.h"
+#include "sim.h"
+
+// 네이티브 빌드용 MQTT 연결 + 브로커: mqtt_out 이 쓴 패킷을 해석해 발행 훅으로 넘기고,
+// PUBACK / PUBREC / PUBCOMP 를 가상 시간 RTT 뒤에 MQTTClient::loop() 에서 돌려준다.
+// 응답은 확률적으로 잃어버릴 수 있다 (재전송 / DUP 처리 확인용). QoS2 는 PUBREL 전까지 같은 id 를 한 번만 전달.
+
+static const uint32_t ACK_RING = 64;
+
+struct PendingAck {
+  uint64_t dueMs;
+  uint8_t  type;   // 4 PUBACK / 5 PUBREC / 7 PUBCOMP
+  uint16_t id;
+};
+
+static bool             gNetUp      = true;    // 하네스 끊김 구간
+static bool             gSession    = false;   // connect() ~ 끊김
+static sim::PublishHook gPublishHook = nullptr;
+static uint32_t         gRttMs      = 30;
+static float            gAckLoss    = 0.0f;
+static uint32_t         gLossRng    = 0x2545F491u;
+static PendingAck       gAcks[ACK_RING];
+static uint32_t         gAckHead    = 0;
+static uint32_t         gAckCount   = 0;
+static bool             gHeld[0x10000];        // PUBREC 보낸 QoS2 id (PUBREL 까지)
+static sim::BrokerStats gBroker     = {};
+
+static bool linkUp() { return gNetUp && gSession; }
+
+void sim::setMqttConnected(bool connected) {
+  gNetUp = connected;
+  if (!connected) {
+    gSession  = false;
+    gAckCount = 0;   // 연결과 함께 나가던 응답도 사라짐
+  }
+}
+
+void sim::setPublishHook(PublishHook hook) { gPublishHook = hook; }
+
+void sim::setMqttLink(uint32_t rttMs, float ackLoss) {
+  gRttMs   = rttMs;
+  gAckLoss = ackLoss;
+}
+
+sim::BrokerStats sim::brokerStats() { return gBroker; }
+
+static bool lose() {
+  if (gAckLoss <= 0.0f) return false;
+  gLossRng = gLossRng * 1664525u + 1013904223u;
+  return (float)(gLossRng >> 8) / (float)(1u << 24) < gAckLoss;
+}
+
+static void scheduleAck(uint8_t type, uint16_t id) {
+  if (gAckCount >= ACK_RING || lose()) {
+    gBroker.acksLost++;
+    return;
+  }
+  gAcks[(gAckHead + gAckCount++) % ACK_RING] = {sim::nowMs() + gRttMs, type, id};
+}
+
+static void onPubrel(uint16_t id) {
+  gHeld[id] = false;
+  scheduleAck(7, id);
+}
+
+bool MQTTClient::connect(const char* clientId, const char* username, const char* password) {
+  (void)clientId;
+  (void)username;
+  (void)password;
+  if (!gNetUp) return false;
+  gSession  = true;
+  gAckCount = 0;
+  memset(gHeld, 0, sizeof(gHeld));   // clean session
+  return true;
+}
+
+bool MQTTClient::connected() { return linkUp(); }
+
+bool MQTTClient::disconnect() {
+  gSession  = false;
+  gAckCount = 0;
+  return true;
+}
+
+bool MQTTClient::loop() {
+  uint64_t now = sim::nowMs();
+  while (linkUp() && gAckCount && gAcks[gAckHead].dueMs <= now) {
+    PendingAck a = gAcks[gAckHead];
+    gAckHead = (gAckHead + 1) % ACK_RING;
+    gAckCount--;
+    mqttOutOnAck(a.type, a.id);
+    if (a.type == 5) onPubrel(a.id);   // 라이브러리가 PUBREC 에 바로 PUBREL 로 답한다
+  }
+  return linkUp();
+}
+
+bool mqttLinkReady() { return linkUp(); }
+
+// mqtt_out 은 소켓이 받아준 만큼 쓰므로 여기서는 항상 패킷 단위로 들어온다
+int mqttLinkWrite(const uint8_t* buf, size_t len) {
+  if (!linkUp()) return -1;
+  if (len < 2) return (int)len;
+  uint8_t type = buf[0] >> 4;
+  size_t  rem = 0, pos = 1;
+  for (uint8_t shift = 0; pos < len; shift += 7) {
+    rem |= (size_t)(buf[pos] & 0x7F) << shift;
+    if (!(buf[pos++] & 0x80)) break;
+  }
+  const uint8_t* p   = buf + pos;
+  const uint8_t* end = p + rem;
+  if (end > buf + len) return (int)len;
+
+  if (type == 6 && rem >= 2) {   // PUBREL (재전송)
+    onPubrel((uint16_t)(p[0] << 8 | p[1]));
+    return (int)len;
+  }
+  if (type != 3) return (int)len;
+
+  uint8_t qos  = (buf[0] >> 1) & 0x03;
+  bool    dup  = buf[0] & 0x08;
+  size_t  tlen = (size_t)(p[0] << 8 | p[1]);
+  char    topic[64];
+  if (tlen >= sizeof(topic)) return (int)len;
+  memcpy(topic, p + 2, tlen);
+  topic[tlen] = '\0';
+  p += 2 + tlen;
+  uint16_t id = 0;
+  if (qos) {
+    id = (uint16_t)(p[0] << 8 | p[1]);
+    p += 2;
+  }
+
+  gBroker.received++;
+  if (dup) gBroker.dupReceived++;
+  bool deliver = true;
+  if (qos == 2) {
+    deliver   = !gHeld[id];
+    gHeld[id] = true;
+  }
+  if (deliver) {
+    gBroker.delivered++;
+    if (gPublishHook) gPublishHook(topic, (const char*)p, (size_t)(end - p), qos);
+  }
+  if (qos == 1) scheduleAck(4, id);
+  if (qos == 2) scheduleAck(5, id);
+  return (int)len;
+}
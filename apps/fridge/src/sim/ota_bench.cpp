@@ -0,0 +1,352 @@
+#include "ota_bench.h"
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "config.h"
+#include "ota.h"
+#include "ota_image.h"
+#include "sim.h"
+
+// ==================== 이미지 만들기 ====================
+static const uint32_t LZ_HASH_BITS  = 15;
+static const int      LZ_CHAIN_MAX  = 128;    // 위치당 따라갈 후보 수
+
+static uint32_t lzHash(const uint8_t* p) {
+  return (((uint32_t)p[0] << 10) ^ ((uint32_t)p[1] << 5) ^ p[2]) & ((1u << LZ_HASH_BITS) - 1);
+}
+
+static void lzssEncode(const std::vector<uint8_t>& in, std::vector<uint8_t>& out) {
+  const size_t n = in.size();
+  std::vector<int32_t> head(1u << LZ_HASH_BITS, -1);
+  std::vector<int32_t> prev(n, -1);
+  auto insert = [&](size_t i) {
+    if (i + OtaLzDecoder::MIN_MATCH > n) return;
+    uint32_t h = lzHash(&in[i]);
+    prev[i]    = head[h];
+    head[h]    = (int32_t)i;
+  };
+
+  size_t  ctrlPos = 0;
+  uint8_t bit     = 8;
+  for (size_t i = 0; i < n;) {
+    if (bit == 8) {
+      ctrlPos = out.size();
+      out.push_back(0);
+      bit = 0;
+    }
+    size_t bestLen = 0, bestDist = 0;
+    if (i + OtaLzDecoder::MIN_MATCH <= n) {
+      size_t maxLen = n - i < OtaLzDecoder::MAX_MATCH ? n - i : OtaLzDecoder::MAX_MATCH;
+      int    depth  = LZ_CHAIN_MAX;
+      for (int32_t c = head[lzHash(&in[i])]; c >= 0 && i - c <= OtaLzDecoder::WINDOW && depth--; c = prev[c]) {
+        size_t len = 0;
+        while (len < maxLen && in[c + len] == in[i + len]) len++;
+        if (len > bestLen) {
+          bestLen  = len;
+          bestDist = i - c;
+          if (len == maxLen) break;
+        }
+      }
+    }
+    if (bestLen >= OtaLzDecoder::MIN_MATCH) {
+      uint32_t d = (uint32_t)bestDist - 1;
+      out.push_back((uint8_t)(d & 0xFF));
+      out.push_back((uint8_t)((d >> 8) | (bestLen - OtaLzDecoder::MIN_MATCH) << 4));
+      for (size_t k = 0; k < bestLen; k++) insert(i + k);
+      i += bestLen;
+    } else {
+      out[ctrlPos] |= (uint8_t)(1u << bit);
+      out.push_back(in[i]);
+      insert(i);
+      i++;
+    }
+    bit++;
+  }
+}
+
+bool otaPackImage(const std::vector<uint8_t>& fw, uint8_t codec, std::vector<uint8_t>& out) {
+  if (fw.empty()) return false;
+  std::vector<uint8_t> body;
+  if (codec == OTA_CODEC_LZSS) lzssEncode(fw, body);
+  else                         body = fw;
+
+  OtaImageHeader h = {};
+  h.magic      = OTA_IMAGE_MAGIC;
+  h.version    = OTA_IMAGE_VERSION;
+  h.codec      = codec;
+  h.headerSize = sizeof(OtaImageHeader);
+  h.rawSize    = (uint32_t)fw.size();
+  h.packedSize = (uint32_t)body.size();
+  Sha256 sha;
+  sha.begin();
+  sha.update(fw.data(), fw.size());
+  sha.finish(h.sha256);
+  if (otaHeaderCheck(h)) return false;
+
+  out.resize(sizeof(h));
+  memcpy(out.data(), &h, sizeof(h));
+  out.insert(out.end(), body.begin(), body.end());
+  return true;
+}
+
+bool otaReadFile(const char* path, std::vector<uint8_t>& out) {
+  FILE* f = fopen(path, "rb");
+  if (!f) return false;
+  out.clear();
+  uint8_t buf[16384];
+  size_t  n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) out.insert(out.end(), buf, buf + n);
+  fclose(f);
+  return !out.empty();
+}
+
+int runOtaPack(const char* inPath, const char* outPath) {
+  std::vector<uint8_t> fw, img;
+  if (!otaReadFile(inPath, fw)) {
+    fprintf(stderr, "cannot read firmware: %s\n", inPath);
+    return 2;
+  }
+  if (!otaPackImage(fw, OTA_CODEC_LZSS, img) || img.size() >= sizeof(OtaImageHeader) + fw.size())
+    otaPackImage(fw, OTA_CODEC_STORED, img);
+  FILE* f = fopen(outPath, "wb");
+  if (!f || fwrite(img.data(), 1, img.size(), f) != img.size()) {
+    fprintf(stderr, "cannot write image: %s\n", outPath);
+    if (f) fclose(f);
+    return 2;
+  }
+  fclose(f);
+  printf("[OTA] packed %s -> %s: %s %u -> %u bytes (%.1f%%)\n", inPath, outPath,
+         img[5] == OTA_CODEC_LZSS ? "lzss" : "stored", (unsigned)fw.size(), (unsigned)img.size(),
+         100.0 * img.size() / fw.size());
+  return 0;
+}
+
+// ==================== 올리기 ====================
+// 펌웨어 WebServer 의 raw 본문 버퍼 (HTTP_RAW_BUFLEN) 만큼씩 otaChunkWrite 가 불린다
+static const uint32_t BENCH_SEGMENT   = 1436;
+static const uint32_t BENCH_CHUNK     = 65536;   // PUT 한 번 크기 (클라이언트 스크립트와 같게)
+static const uint32_t BENCH_MAX_PUTS  = 10000;
+
+struct UploadPlan {
+  float    dropProb   = 0.0f;   // PUT 이 도중에 끊길 확률
+  uint32_t overlapMax = 0;      // 재개할 때 received 보다 최대 이만큼 앞에서 다시 보냄
+  bool     probeGap   = false;  // received 뒤를 한 번 보내서 gap 으로 거절되는지
+  uint32_t stopAt     = 0;      // 0 이 아니면 이 바이트까지만 보내고 멈춤
+  bool     fresh      = false;  // 받던 세션이 있어도 첫 PUT 은 offset 0 (새 이미지)
+};
+
+struct UploadResult {
+  uint32_t puts     = 0;
+  uint32_t drops    = 0;
+  uint32_t rejected = 0;
+  bool     gapSeen  = false;
+};
+
+static uint32_t gRng = 0x2545F491u;
+
+static uint32_t rnd() {
+  gRng ^= gRng << 13;
+  gRng ^= gRng >> 17;
+  gRng ^= gRng << 5;
+  return gRng;
+}
+
+// PUT /ota?offset=off 하나: 본문 [off, off+len) 를 세그먼트로 나눠 넣다가 cut 바이트 뒤에 끊김
+static const char* putChunk(const std::vector<uint8_t>& img, uint32_t off, uint32_t len, uint32_t cut) {
+  if (otaChunkBegin(off)) {
+    uint32_t end = off + (cut < len ? cut : len);
+    for (uint32_t p = off; p < end;) {
+      uint32_t seg = 1 + rnd() % BENCH_SEGMENT;
+      if (seg > end - p) seg = end - p;
+      otaChunkWrite(&img[p], seg);
+      p += seg;
+    }
+  }
+  return otaChunkEnd();
+}
+
+// ota.h 의 curl 반복과 같은 클라이언트: GET received → 거기서부터 PUT, 실패 / 완료면 멈춤
+static UploadResult upload(const std::vector<uint8_t>& img, const UploadPlan& plan) {
+  UploadResult r;
+  uint32_t     size = plan.stopAt ? plan.stopAt : (uint32_t)img.size();
+  bool         probed = false;
+  while (r.puts < BENCH_MAX_PUTS) {
+    OtaStatus s = otaStatus();
+    if (r.puts && s.state != OTA_RECEIVING) break;
+    uint32_t off = s.state == OTA_RECEIVING && !(plan.fresh && !r.puts) ? s.received : 0;
+    if (off >= size) break;
+    if (plan.probeGap && !probed && off > 0) {
+      probed = true;
+      r.puts++;
+      const char* err = putChunk(img, off + 100, 200, UINT32_MAX);
+      r.gapSeen = err && !strcmp(err, "gap");
+      if (otaStatus().received != off) r.gapSeen = false;   // 거절된 조각이 상태를 바꾸면 안 된다
+    }
+    if (off && plan.overlapMax) {
+      uint32_t back = rnd() % (plan.overlapMax + 1);
+      off -= back < off ? back : off;
+    }
+    uint32_t len = size - off < BENCH_CHUNK ? size - off : BENCH_CHUNK;
+    uint32_t cut = UINT32_MAX;
+    if (plan.dropProb > 0.0f && (rnd() % 10000) < (uint32_t)(plan.dropProb * 10000.0f)) {
+      cut = rnd() % len;
+      r.drops++;
+    }
+    r.puts++;
+    if (putChunk(img, off, len, cut)) r.rejected++;
+  }
+  return r;
+}
+
+// ==================== 시나리오 ====================
+struct OtaCase {
+  const char* name;
+  uint8_t     codec;
+  UploadPlan  plan;
+  int32_t     flipAt;      // >= 0: 이미지의 이 위치 바이트를 뒤집어 올림
+  bool        expectOk;
+  const char* expectErr;   // expectOk=false 일 때 기대 오류 (nullptr = 실패면 무엇이든)
+};
+
+static bool partitionMatches(const std::vector<uint8_t>& fw) {
+  uint32_t       len;
+  const uint8_t* p = sim::otaPartition(&len);
+  return len == fw.size() && memcmp(p, fw.data(), len) == 0;
+}
+
+static bool runCase(const OtaCase& c, const std::vector<uint8_t>& fw, const std::vector<uint8_t>& packed) {
+  otaBegin();   // 재부팅과 같다
+  sim::takeOtaBootSwitch();
+  std::vector<uint8_t> img = packed;
+  if (c.flipAt >= 0) img[(size_t)c.flipAt] ^= 0x5A;
+
+  auto         t0 = std::chrono::steady_clock::now();
+  UploadResult r  = upload(img, c.plan);
+  double       ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+  OtaStatus    s  = otaStatus();
+  bool         switched = sim::takeOtaBootSwitch();
+
+  bool ok;
+  if (c.expectOk) ok = s.state == OTA_READY && switched && partitionMatches(fw);
+  else            ok = s.state == OTA_FAILED && !switched && (!c.expectErr || (s.error && !strcmp(s.error, c.expectErr)));
+  if (c.plan.probeGap && !r.gapSeen) ok = false;
+
+  printf("[BENCH] ota: %-14s %-6s state=%-9s error=%-15s received=%u/%u written=%u puts=%u drops=%u "
+         "resumes=%u dup=%u rejected=%u %.1f ms (%.1f MB/s) -> %s\n",
+         c.name, c.codec == OTA_CODEC_LZSS ? "lzss" : "stored", otaStateName(s.state), s.error ? s.error : "-",
+         (unsigned)s.received, (unsigned)s.total, (unsigned)s.written, (unsigned)r.puts, (unsigned)r.drops,
+         (unsigned)s.resumes, (unsigned)s.duplicateBytes, (unsigned)r.rejected, ms,
+         ms > 0.0 ? s.written / ms / 1000.0 : 0.0, ok ? "ok" : "FAIL");
+  return ok;
+}
+
+// 받는 중에 다른 이미지가 offset 0 으로 오면 새 세션으로 다시 시작하는지
+static bool runRestartCase(const std::vector<uint8_t>& fw, const std::vector<uint8_t>& stored,
+                           const std::vector<uint8_t>& lz) {
+  otaBegin();
+  sim::takeOtaBootSwitch();
+  UploadPlan half;
+  half.stopAt = (uint32_t)stored.size() / 2;
+  upload(stored, half);
+  uint32_t firstReceived = otaStatus().received;
+  UploadPlan fresh;
+  fresh.fresh = true;
+  upload(lz, fresh);
+  OtaStatus s  = otaStatus();
+  bool      ok = firstReceived == half.stopAt && s.state == OTA_READY && s.sessions == 2 && s.codec == OTA_CODEC_LZSS &&
+            sim::takeOtaBootSwitch() && partitionMatches(fw);
+  printf("[BENCH] ota: %-14s stored %u B -> lzss: sessions=%u state=%s -> %s\n", "new_image", (unsigned)firstReceived,
+         (unsigned)s.sessions, otaStateName(s.state), ok ? "ok" : "FAIL");
+  return ok;
+}
+
+// 절반에서 멈춘 세션이 OTA_SESSION_IDLE_MS 뒤 폐기되고, 처음부터 다시 받을 수 있는지
+static bool runTimeoutCase(const std::vector<uint8_t>& fw, const std::vector<uint8_t>& lz) {
+  otaBegin();
+  sim::takeOtaBootSwitch();
+  UploadPlan half;
+  half.stopAt = (uint32_t)lz.size() / 2;
+  upload(lz, half);
+  sim::advance(OTA_SESSION_IDLE_MS + 1);
+  otaTick();
+  OtaStatus stale = otaStatus();
+  upload(lz, UploadPlan());
+  OtaStatus s  = otaStatus();
+  bool      ok = stale.state == OTA_FAILED && stale.error && !strcmp(stale.error, "timeout") &&
+            s.state == OTA_READY && sim::takeOtaBootSwitch() && partitionMatches(fw);
+  printf("[BENCH] ota: %-14s idle %us -> %s, then retry: state=%s -> %s\n", "timeout",
+         (unsigned)(OTA_SESSION_IDLE_MS / 1000), stale.error ? stale.error : "-", otaStateName(s.state),
+         ok ? "ok" : "FAIL");
+  return ok;
+}
+
+static bool nullSink(const uint8_t*, size_t, void*) { return true; }
+
+int runOtaBench(const char* fwPath) {
+  std::vector<uint8_t> fw, stored, lz;
+  if (!otaReadFile(fwPath, fw)) {
+    fprintf(stderr, "cannot read firmware: %s\n", fwPath);
+    return 2;
+  }
+  auto t0 = std::chrono::steady_clock::now();
+  if (!otaPackImage(fw, OTA_CODEC_STORED, stored) || !otaPackImage(fw, OTA_CODEC_LZSS, lz)) {
+    fprintf(stderr, "cannot pack %s (too large?)\n", fwPath);
+    return 2;
+  }
+  double packMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+  printf("[BENCH] ota: %s raw=%u lzss=%u (%.1f%%, %.0f ms to pack) window=%u\n", fwPath, (unsigned)fw.size(),
+         (unsigned)lz.size(), 100.0 * lz.size() / stored.size(), packMs, (unsigned)OtaLzDecoder::WINDOW);
+
+  // 풀기 / SHA-256 처리량 (세션 / 플래시 없이)
+  const int reps = 8;
+  static OtaLzDecoder dec;
+  t0 = std::chrono::steady_clock::now();
+  bool decOk = true;
+  for (int i = 0; i < reps; i++) {
+    dec.begin((uint32_t)fw.size());
+    decOk = dec.feed(&lz[sizeof(OtaImageHeader)], lz.size() - sizeof(OtaImageHeader), nullSink, nullptr) &&
+            dec.finished() && decOk;
+  }
+  double decMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / reps;
+  t0 = std::chrono::steady_clock::now();
+  uint8_t digest[32];
+  for (int i = 0; i < reps; i++) {
+    Sha256 sha;
+    sha.begin();
+    sha.update(fw.data(), fw.size());
+    sha.finish(digest);
+  }
+  double shaMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / reps;
+  printf("[BENCH] ota: lzss decode %.1f MB/s, sha256 %.1f MB/s (host) -> %s\n", fw.size() / decMs / 1000.0,
+         fw.size() / shaMs / 1000.0, decOk ? "ok" : "FAIL");
+
+  const int32_t body = (int32_t)sizeof(OtaImageHeader);
+  UploadPlan    clean;
+  UploadPlan    flaky;
+  flaky.dropProb   = 0.3f;
+  flaky.overlapMax = 4096;
+  flaky.probeGap   = true;
+  const OtaCase cases[] = {
+    {"stored",         OTA_CODEC_STORED, clean, -1,                                 true,  nullptr},
+    {"lzss",           OTA_CODEC_LZSS,   clean, -1,                                 true,  nullptr},
+    {"resume",         OTA_CODEC_LZSS,   flaky, -1,                                 true,  nullptr},
+    {"resume",         OTA_CODEC_STORED, flaky, -1,                                 true,  nullptr},
+    {"corrupt_body",   OTA_CODEC_LZSS,   clean, body + (int32_t)(lz.size() - body) / 2, false, nullptr},
+    {"corrupt_body",   OTA_CODEC_STORED, clean, body + (int32_t)fw.size() / 2,     false, "sha256_mismatch"},
+    {"bad_magic",      OTA_CODEC_LZSS,   clean, 0,                                  false, "bad_magic"},
+    {"bad_sha256",     OTA_CODEC_LZSS,   clean, body - 1,                           false, "sha256_mismatch"},
+  };
+  uint32_t fails = decOk ? 0 : 1;
+  for (const OtaCase& c : cases)
+    if (!runCase(c, fw, c.codec == OTA_CODEC_LZSS ? lz : stored)) fails++;
+  if (!runRestartCase(fw, stored, lz)) fails++;
+  if (!runTimeoutCase(fw, lz)) fails++;
+
+  // 장치에서 전송 시간 ~ 본문 크기: 압축으로 줄어든 만큼 WiFi 로 받는 시간이 준다
+  // (압축이 안 되는 이미지는 LZSS 가 오히려 커지므로 증감을 부호째 출력)
+  printf("[BENCH] ota: transfer %u -> %u bytes (%+.1f%%), %u failures -> %s\n", (unsigned)stored.size(),
+         (unsigned)lz.size(), 100.0 * lz.size() / stored.size() - 100.0, (unsigned)fails, fails ? "FAIL" : "ok");
+  return fails ? 1 : 0;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+// OTA 이미지 도구 + 검증 (호스트 전용).
+//   otaPackImage : 펌웨어 → ota_image.h 형식 (LZSS 는 해시 체인 탐욕 일치, 창 4KB)
+//   runOtaPack   : --ota-pack IN OUT. LZSS 가 더 크면 stored 로 만든다
+//   runOtaBench  : --bench-ota FILE. FILE 을 묶어 ota.cpp 세션으로 올리는 시나리오를 돌린다
+//                  (stored / lzss / 끊김 + 이어받기 + 겹친 재전송 / 본문 손상 / 헤더 손상 / SHA 불일치 /
+//                   받는 중 새 이미지 / 유휴 시간 초과). 검증에 실패한 이미지로 부팅 파티션이 바뀌거나
+//                  정상 이미지가 파티션과 다르면 1. 압축률과 풀기 / SHA-256 처리량도 출력
+bool otaPackImage(const std::vector<uint8_t>& fw, uint8_t codec, std::vector<uint8_t>& out);
+int  runOtaPack(const char* inPath, const char* outPath);
+int  runOtaBench(const char* fwPath);
+
+// 파일 전체 읽기 (false = 열 수 없음 / 빈 파일)
+bool otaReadFile(const char* path, std::vector<uint8_t>& out);
@@ -0,0 +1,47 @@
+#include <vector>
+#include "ota.h"
+#include "sim.h"
+
+// 네이티브 빌드용 OTA 파티션: 프로세스 메모리 버퍼. 크기는 기본 파티션 테이블의 앱 슬롯 (1.25MB).
+
+static const uint32_t SIM_OTA_PARTITION = 0x140000;
+
+static std::vector<uint8_t> partition;
+static bool                 writing      = false;
+static bool                 bootSwitched = false;
+
+bool otaFlashBegin(uint32_t rawSize) {
+  if (rawSize > SIM_OTA_PARTITION) return false;
+  partition.clear();
+  partition.reserve(rawSize);
+  writing = true;
+  return true;
+}
+
+bool otaFlashWrite(const uint8_t* data, size_t len) {
+  if (!writing || partition.size() + len > SIM_OTA_PARTITION) return false;
+  partition.insert(partition.end(), data, data + len);
+  return true;
+}
+
+bool otaFlashEnd() {
+  if (!writing) return false;
+  writing      = false;
+  bootSwitched = true;
+  return true;
+}
+
+void otaFlashAbort() {
+  writing = false;
+}
+
+const uint8_t* sim::otaPartition(uint32_t* len) {
+  *len = (uint32_t)partition.size();
+  return partition.data();
+}
+
+bool sim::takeOtaBootSwitch() {
+  bool r       = bootSwitched;
+  bootSwitched = false;
+  return r;
+}
@@ -0,0 +1,159 @@
+#include "pid_bench.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <chrono>
+#include <vector>
+#include "config.h"
+#include "pid_core.h"
+#include "state.h"
+
+// ==================== 기존 구현 (float, % → PWM 변환) ====================
+// 고정소수점 코어로 바꾸기 전 control.cpp pidCompute() 의 PID 연산부를 그대로 옮김
+struct LegacyFloatPid {
+  float kp        = PID_KP_DEFAULT;
+  float ki        = PID_KI_DEFAULT;
+  float kd        = PID_KD_DEFAULT;
+  float integral  = 0.0f;
+  float prevError = 0.0f;
+  bool  firstRun  = true;
+
+  void reset() {
+    integral  = 0.0f;
+    prevError = 0.0f;
+    firstRun  = true;
+  }
+
+  int update(float error) {
+    float dt = PID_COMPUTE_SEC;
+    float P  = kp * error;
+    if (fabsf(error) > PID_DEADBAND) integral += error * dt;
+    if (integral > PID_INTEGRAL_MAX) integral = PID_INTEGRAL_MAX;
+    if (integral < PID_INTEGRAL_MIN) integral = PID_INTEGRAL_MIN;
+    float I = ki * integral;
+    float D = 0.0f;
+    if (!firstRun) D = kd * ((error - prevError) / dt);
+    prevError = error;
+    firstRun  = false;
+    float output = P + I + D;
+    if (output < 0.0f)   output = 0.0f;
+    if (output > 100.0f) output = 100.0f;
+    int pwm = (int)((output / 100.0f) * (float)PELTIER_ABS_MAX_PWM);
+    if (pwm < 0)                   pwm = 0;
+    if (pwm > PELTIER_ABS_MAX_PWM) pwm = PELTIER_ABS_MAX_PWM;
+    return pwm;
+  }
+};
+
+template <typename Q>
+struct CoreEngine {
+  PidCore<Q, PeltierPidLimits> core;
+  void reset() { core.reset(); }
+  int  update(float error) { return core.update(Q::from(error)); }
+};
+
+// ==================== 오차 트레이스 ====================
+// 느린 진동 + 목표 변경 계단 + 센서 잡음, DHT21 처럼 0.1°C 양자화.
+// 일정 간격마다 냉각 재시작(리셋)을 넣어 적분이 한쪽 끝에 붙어 있지 않게 한다.
+static const uint32_t BENCH_RESET_EVERY = 1800;   // 1시간 (2초 주기)
+
+static std::vector<float> makeTrace(uint32_t n) {
+  std::vector<float> tr(n);
+  uint32_t rng   = 0x9E3779B9u;
+  float    level = 3.0f;
+  for (uint32_t i = 0; i < n; i++) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    if (i % 5000 == 0) level = (float)(rng % 80) / 10.0f - 1.0f;   // -1 ~ 7°C
+    float noise = ((float)(rng & 0xFFFF) / 65536.0f - 0.5f) * 0.3f;
+    float v     = level * (0.6f + 0.4f * cosf((float)i * 0.002f)) + noise;
+    tr[i]       = roundf(v * 10.0f) / 10.0f;
+  }
+  return tr;
+}
+
+// ==================== 측정 ====================
+struct BenchResult {
+  double   nsPerUpdate;
+  uint32_t hash;
+  bool     deterministic;
+};
+
+static uint32_t fnv1a(const std::vector<int>& v) {
+  uint32_t h = 2166136261u;
+  for (int x : v) {
+    h ^= (uint32_t)x;
+    h *= 16777619u;
+  }
+  return h;
+}
+
+template <typename E>
+static void runOnce(E& e, const std::vector<float>& tr, std::vector<int>& out) {
+  e.reset();
+  for (size_t i = 0; i < tr.size(); i++) {
+    if (i % BENCH_RESET_EVERY == 0) e.reset();
+    out[i] = e.update(tr[i]);
+  }
+}
+
+template <typename E>
+static BenchResult bench(const std::vector<float>& tr, std::vector<int>& out) {
+  static const int REPS = 7;
+  BenchResult r;
+  r.nsPerUpdate = 1e30;
+  std::vector<int> first(tr.size());
+  for (int rep = 0; rep < REPS; rep++) {
+    E    e;
+    auto t0 = std::chrono::steady_clock::now();
+    runOnce(e, tr, out);
+    auto   t1 = std::chrono::steady_clock::now();
+    double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+    if (ns / tr.size() < r.nsPerUpdate) r.nsPerUpdate = ns / tr.size();
+    if (rep == 0) first = out;
+  }
+  r.hash          = fnv1a(out);
+  r.deterministic = (first == out);
+  return r;
+}
+
+static void report(const char* name, const BenchResult& r, const std::vector<int>& out,
+                   const std::vector<int>& ref, double refNs) {
+  uint32_t mismatches = 0;
+  int      maxDiff    = 0;
+  double   absSum     = 0.0;
+  for (size_t i = 0; i < out.size(); i++) {
+    int d = out[i] - ref[i];
+    if (d < 0) d = -d;
+    if (d) mismatches++;
+    if (d > maxDiff) maxDiff = d;
+    absSum += d;
+  }
+  printf("[BENCH] %-14s %7.2f ns/update  x%.2f  max|dpwm|=%d  mismatch=%.3f%%  mean|dpwm|=%.4f  hash=%08x  %s\n",
+         name, r.nsPerUpdate, refNs / r.nsPerUpdate, maxDiff,
+         100.0 * mismatches / out.size(), absSum / out.size(), (unsigned)r.hash,
+         r.deterministic ? "deterministic" : "NON-DETERMINISTIC");
+}
+
+int runPidBench(uint32_t samples) {
+  if (samples < BENCH_RESET_EVERY) samples = BENCH_RESET_EVERY;
+  std::vector<float> tr = makeTrace(samples);
+  std::vector<int>   ref(samples), out(samples);
+
+  printf("[BENCH] PID engines: %u samples, out max=%d PWM, reference = legacy float (%% -> PWM)\n",
+         (unsigned)samples, PELTIER_ABS_MAX_PWM);
+
+  BenchResult legacy = bench<LegacyFloatPid>(tr, ref);
+  report("legacy-float", legacy, ref, ref, legacy.nsPerUpdate);
+
+  BenchResult r = bench<CoreEngine<FloatQ> >(tr, out);
+  report("core-float", r, out, ref, legacy.nsPerUpdate);
+  r = bench<CoreEngine<FixedQ<PID_Q_FRAC_BITS> > >(tr, out);
+  report("core-q15.16", r, out, ref, legacy.nsPerUpdate);
+  r = bench<CoreEngine<FixedQ<12> > >(tr, out);
+  report("core-q19.12", r, out, ref, legacy.nsPerUpdate);
+  r = bench<CoreEngine<FixedQ<8> > >(tr, out);
+  report("core-q23.8", r, out, ref, legacy.nsPerUpdate);
+  return legacy.deterministic ? 0 : 1;
+}
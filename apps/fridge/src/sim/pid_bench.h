@@ -0,0 +1,8 @@
+#pragma once
+
+#include <stdint.h>
+
+// PID 엔진 비교 벤치마크 (호스트 전용).
+// 같은 오차 트레이스를 기존 float 구현, PidCore<FloatQ>, PidCore<FixedQ<N>> 에 넣고
+// 갱신 1회당 시간, 기존 구현 대비 PWM 차이, 두 번 실행 결과의 일치 여부(해시)를 출력한다.
+int runPidBench(uint32_t samples);
@@ -0,0 +1,60 @@
+#include "plant.h"
+
+#include <math.h>
+
+ThermalPlant::ThermalPlant(const PlantParams& p)
+    : p_(p), airC_(p.initialC), beerC_(p.initialC), rng_(p.seed ? p.seed : 1) {}
+
+void ThermalPlant::step(float dtSec) {
+  float d = duty_ < 0.0f ? 0.0f : (duty_ > 1.0f ? 1.0f : duty_);
+
+  // 펠티어 흡열량: 외기와의 온도차가 클수록 감소
+  float dT     = p_.ambientC - (float)airC_;
+  float derate = 1.0f - (dT > 0.0f ? dT : 0.0f) / p_.peltierDeltaTMax;
+  if (derate < 0.0f) derate = 0.0f;
+  float qPeltier = d * p_.peltierMaxW * derate;
+
+  // 발효열: 가우시안 형태의 활동 곡선
+  float qFerment = 0.0f;
+  if (p_.fermentPeakW > 0.0f) {
+    float h = (float)(elapsedSec_ / 3600.0);
+    float z = (h - p_.fermentPeakH) / p_.fermentWidthH;
+    qFerment = p_.fermentPeakW * expf(-0.5f * z * z);
+  }
+
+  double qAmb  = p_.airAmbientWPerK * (p_.ambientC - airC_);
+  double qBeer = p_.airBeerWPerK * (beerC_ - airC_);
+
+  airC_  += (qAmb + qBeer - qPeltier) / p_.airCapJPerK * dtSec;
+  beerC_ += (-qBeer + qFerment) / p_.beerCapJPerK * dtSec;
+
+  energyJ_    += (double)(d * p_.peltierElecW) * dtSec;
+  elapsedSec_ += dtSec;
+}
+
+float ThermalPlant::sampleTemperature() {
+  if (p_.sensorDropout > 0.0f && uniform() < p_.sensorDropout) return NAN;
+  float t = (float)airC_ + p_.sensorNoiseC * gaussian();
+  return roundf(t * 10.0f) / 10.0f;   // DHT21 분해능 0.1°C
+}
+
+float ThermalPlant::sampleHumidity() {
+  float h = p_.humidityPct + 0.5f * gaussian();
+  return roundf(h * 10.0f) / 10.0f;
+}
+
+float ThermalPlant::uniform() {
+  // xorshift32
+  rng_ ^= rng_ << 13;
+  rng_ ^= rng_ >> 17;
+  rng_ ^= rng_ << 5;
+  return (float)(rng_ >> 8) / 16777216.0f;
+}
+
+float ThermalPlant::gaussian() {
+  // Box-Muller
+  float u1 = uniform();
+  float u2 = uniform();
+  if (u1 < 1e-7f) u1 = 1e-7f;
+  return sqrtf(-2.0f * logf(u1)) * cosf(6.2831853f * u2);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdint.h>
+
+// ===================== 냉장고 열 모델 =====================
+// 2-노드 집중 정수 모델: 냉장고 내부 공기(+벽체)와 발효조(맥주).
+//   C_air  dT_air/dt  = UA_amb (T_amb - T_air) + UA_beer (T_beer - T_air) - Q_peltier
+//   C_beer dT_beer/dt = UA_beer (T_air - T_beer) + Q_ferment
+// 펠티어 흡열량은 듀티에 비례하고, 외기와의 온도차가 커질수록 선형으로 줄어든다.
+// DHT21 은 공기 온도를 0.1°C 단위로 양자화하여 읽는다.
+struct PlantParams {
+  float ambientC         = 24.0f;     // 외기 온도 (°C)
+  float initialC         = 24.0f;     // 시작 시 내부/맥주 온도 (°C)
+  float airCapJPerK      = 6000.0f;   // 공기 + 벽체 열용량
+  float beerCapJPerK     = 84000.0f;  // 맥주 20L
+  float airAmbientWPerK  = 1.6f;      // 단열재 통한 열손실
+  float airBeerWPerK     = 4.0f;      // 발효조 벽 열전달
+  float peltierMaxW      = 90.0f;     // 듀티 100%, ΔT=0 흡열량
+  float peltierDeltaTMax = 60.0f;     // 흡열량이 0 이 되는 ΔT (외기 - 내부)
+  float peltierElecW     = 110.0f;    // 듀티 100% 소비전력
+  float fermentPeakW     = 8.0f;      // 발효열 최대값 (0 = 비활성)
+  float fermentPeakH     = 30.0f;     // 발효열 최대 시점 (h)
+  float fermentWidthH    = 18.0f;     // 발효열 분포 폭 (h)
+  float humidityPct      = 62.0f;     // 내부 습도
+  float sensorNoiseC     = 0.05f;     // 센서 잡음 (표준편차)
+  float sensorDropout    = 0.0f;      // 읽기 실패(NaN) 확률
+  uint32_t seed          = 1;
+};
+
+class ThermalPlant {
+ public:
+  explicit ThermalPlant(const PlantParams& p);
+
+  // duty: 0~1 (LEDC 출력 비율)
+  void  setDuty(float duty) { duty_ = duty; }
+  void  step(float dtSec);
+
+  float airC() const  { return (float)airC_; }
+  float beerC() const { return (float)beerC_; }
+  float duty() const  { return duty_; }
+  double elapsedSec() const { return elapsedSec_; }
+  double energyWh() const   { return energyJ_ / 3600.0; }
+
+  PlantParams& params() { return p_; }
+
+  // 문 열림: 내부 공기의 fraction 만큼을 외기로 교체 (센서 입장에서는 계단 변화)
+  void openDoor(float fraction) { airC_ += fraction * (p_.ambientC - airC_); }
+
+  // DHT21 읽기 흉내
+  float sampleTemperature();
+  float sampleHumidity();
+
+ private:
+  float uniform();   // [0, 1)
+  float gaussian();  // N(0, 1)
+
+  PlantParams p_;
+  double   airC_;    // 10ms 적분 시 float 로는 증분이 유효숫자 아래로 떨어진다
+  double   beerC_;
+  float    duty_       = 0.0f;
+  double   elapsedSec_ = 0.0;
+  double   energyJ_    = 0.0;
+  uint32_t rng_;
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+// 시뮬레이터 내부 API (네이티브 빌드 전용).
+// 가상 시계, LEDC 출력, 센서 입력, MQTT 연결 상태를 hal.cpp 가 들고 있고
+// sim_main.cpp 가 플랜트 모델과 연결한다.
+
+#include <stddef.h>
+#include <stdint.h>
+#include "dht_decode.h"
+
+namespace sim {
+
+// 가상 시계: delay() 가 호출될 때만 앞으로 간다
+uint64_t nowMs();
+void     advance(uint32_t ms);
+
+// 시계가 진행될 때마다 호출 (플랜트 적분용)
+typedef void (*StepHook)(uint32_t dtMs);
+void setStepHook(StepHook hook);
+
+// LEDC 채널 듀티 (0~1)
+float pwmDuty(uint8_t chan);
+
+// DHT 펄스열 공급원 (존별 센서): 캡처된 펄스 개수 반환 (0 = 센서 무응답)
+typedef size_t (*DhtFrameSource)(uint8_t zone, DhtPulse* out, size_t max);
+void   setDhtFrameSource(DhtFrameSource source);
+size_t dhtCaptureFrame(uint8_t zone, DhtPulse* out, size_t max);
+
+// MQTT (mqtt_sim.cpp). 발행 훅은 브로커가 PUBLISH 를 받는 순간 (QoS2 중복은 한 번만)
+typedef void (*PublishHook)(const char* topic, const char* payload, size_t len, int qos);
+void setMqttConnected(bool connected);   // 네트워크 (끊으면 세션도 끊김, 다시 붙으면 connect() 필요)
+void setPublishHook(PublishHook hook);
+void setMqttLink(uint32_t rttMs, float ackLoss);   // 브로커 응답 지연 / 응답 분실 확률 (0~1)
+struct BrokerStats {
+  uint32_t received;      // 받은 PUBLISH (재전송 포함)
+  uint32_t dupReceived;   // 그중 DUP 플래그
+  uint32_t delivered;     // 발행 훅으로 넘긴 것 (QoS2 중복 제외)
+  uint32_t acksLost;
+};
+BrokerStats brokerStats();
+
+// 힙 할당 횟수 (malloc / calloc / realloc 누적, operator new 포함). 주기 경로의 할당 여부 확인용
+uint64_t heapAllocCount();
+// 브로커 / 하네스 쪽 작업 (기기 힙이 아님): 살아 있는 동안의 할당은 집계하지 않는다.
+// 구간 안에서 잡은 블록은 구간 안에서 놓아야 한다
+struct HeapUncounted {
+  HeapUncounted();
+  ~HeapUncounted();
+};
+
+// NVS 항목 기록 횟수 (Preferences::put* 누적). 플래시 마모 비교용
+uint64_t nvsWriteCount();
+
+// ESP.restart() 요청 여부 (읽으면 초기화)
+bool takeRestartRequest();
+// ESP.restart() 때 mqtt_out 큐에 남아 있던 메시지 (누적)
+uint32_t restartUnsent();
+// ESP.restart() 때 듀티가 0 이 아니던 LEDC 채널 (누적, controlForceOff 확인용)
+uint32_t restartPwmOn();
+
+// SSE 구독자 (stream_sim.cpp). 연결은 다음 streamNetAccept() 에서 수락된다.
+// rateBytesPerSec = 클라이언트가 소켓에서 읽어가는 속도 (0 = 멈춘 클라이언트)
+struct StreamClientStats {
+  int      httpStatus;     // 응답 상태 코드 (0 = 아직 없음)
+  uint32_t bytes;          // 받은 바이트
+  uint32_t statusEvents;
+  uint32_t pidEvents;
+  uint32_t pings;
+  bool     closed;         // 장치가 연결을 닫음
+};
+int               streamClientOpen(const char* request, uint32_t rateBytesPerSec);
+StreamClientStats streamClientStats(int client);
+
+// OTA 파티션 (ota_sim.cpp). 실제 파티션 테이블의 앱 슬롯 크기와 같은 메모리 버퍼
+const uint8_t* otaPartition(uint32_t* len);   // 마지막으로 쓴 이미지 (len = 쓴 바이트)
+bool           takeOtaBootSwitch();           // otaFlashEnd 로 부팅 파티션이 바뀌었는지 (읽으면 초기화)
+
+// SNTP 서버 (sntp_sim.cpp). 기기 시계가 driftPpm 만큼 빠르다고 보고 참 시각을 준다.
+// 왕복 delayMs (±50%, 비대칭), 요청 분실 확률 loss, downUntilMs 전에는 응답 없음
+void     setSntpLink(uint32_t delayMs, float loss, double driftPpm, uint64_t downUntilMs);
+uint64_t trueUnixMs(uint64_t monoMs);   // 가상 시각 monoMs 의 참 unix ms
+struct SntpServerStats {
+  uint32_t requests;
+  uint32_t lost;
+  uint32_t replies;
+};
+SntpServerStats sntpServerStats();
+
+}  // namespace sim
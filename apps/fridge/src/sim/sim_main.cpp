@@ -0,0 +1,1065 @@
+// ===================== 네이티브 시뮬레이터 =====================
+// 펌웨어 제어 경로(센서 → PID → 펠티어 → 상태 발행 / 명령 처리)를
+// 가상 시계와 냉장고 열 모델 위에서 실시간보다 빠르게 돌린다.
+//
+//   pio run -e native
+//   .pio/build/native/program --hours 48 --csv run.csv
+//
+// 옵션
+//   --hours H        시뮬레이션 길이 (기본 48)
+//   --profile FILE   목표 온도 프로파일 ("<시간(h)> <온도|off>" 한 줄씩, '#' 주석)
+//   --schedule FILE  프로파일 대신 발효 스케줄을 기기에 한 번 올림 ("ramp|hold <온도> <시간(h)>" 한 줄씩)
+//   --ambient C      외기 온도 (기본 24)
+//   --ferment W      발효열 최대값 W (기본 8, 0 = 끔)
+//   --dropout P      센서 무응답 확률 (0~1)
+//   --dht-faults P   DHT 펄스열 손상 확률 (0~1, 비트 반전/펄스 늘어짐/끊김/무응답 균등)
+//   --fault-zone Z   손상 주입을 존 Z 센서로만 한정 (다른 존으로 번지지 않는지 확인)
+//   --dht-decode F   시뮬레이션 대신 기록된 펄스열 파일을 디코드해 결과 출력
+//                    (한 줄 = 한 프레임, 지속시간(us) 나열: 양수 HIGH, 음수 LOW)
+//   --bench-pid N    PID 엔진 벤치마크 (N 샘플, float vs 고정소수점) 후 종료
+//   --bench-history N  /history 벤치마크 (링을 채운 뒤 점 수별 N 회 질의) 후 종료
+//   --bench-drive N  펠티어 구동 레이어 검증 (무작위 목표 N 번: 디더링 평균/슬루/정지) 후 종료
+//   --bench-ota FILE OTA 검증 후 종료: FILE 을 이미지로 묶어 stored / lzss / 끊김 + 이어받기 / 손상 /
+//                    받는 중 새 이미지 / 시간 초과 시나리오로 올린다 (예: 이 실행 파일 자신)
+//   --ota-pack IN OUT  펌웨어 IN 을 OTA 이미지 OUT (.fzo) 으로 묶고 종료 (PUT /ota 로 올릴 파일)
+//   --bench-control S  제어 회귀 벤치마크 후 종료 (S = all | 시나리오 이름 쉼표 구분 | none)
+//                    시나리오: target_step, door, heat_wave, sensor_dropout. 결과는 JSON
+//     --trace FILE     기록 트레이스도 재생 (fridge_logs CSV 또는 --csv 출력, 여러 번 지정 가능)
+//     --bench-out FILE JSON 보고서 파일 (기본 stdout)
+//     --baseline FILE  이 보고서와 비교해 허용치를 넘으면 종료 코드 1
+//   --seed N         센서 잡음 시드
+//   --outage S:D     S시간부터 D시간 동안 MQTT 끊김 (여러 번 지정 가능)
+//   --door H         H시간에 문 열림: 내부 공기 80% 가 외기로 바뀜 (여러 번 지정 가능)
+//   --burst H:N      H시간부터 0.5초 간격으로 set_target N 번 (UI 연타, 여러 번 지정 가능)
+//   --restart H      H시간에 restart 명령 (여러 번 지정 가능)
+//   --ota H          H시간에 자기 실행 파일을 묶어 PUT /ota 로 올린다 (느린 WiFi 속도, 중간에 한 번 끊김).
+//                    검증이 끝나면 재부팅 (펠티어는 재부팅 직전에만 꺼짐)
+//   --cold-boot      재부팅 때 RTC 기록(PID 상태)을 버린다 (웜 부팅과 비교)
+//   --clock-drift PPM  기기 시계가 SNTP 서버보다 PPM 만큼 빠름 (음수 = 느림, 드리프트 추정 확인)
+//   --ntp-delay MS   SNTP 왕복 (±50%, 가는 길 / 오는 길 비대칭, 기본 30)
+//   --ntp-loss P     SNTP 요청 분실 확률 (0~1)
+//   --ntp-down S     처음 S초 동안 SNTP 응답 없음 (시각을 모르는 동안 상태를 모았다가 시각을 붙이는지 확인)
+//   --mqtt-rtt MS    브로커 응답 지연 (가상 시간, 기본 30)
+//   --mqtt-loss P    브로커 응답(PUBACK/PUBREC/PUBCOMP) 분실 확률 (0~1, 재전송 확인)
+//   --redeliver N    모든 명령을 같은 id 로 N 번 더 전달 (QoS1 재전송 / 영속 세션 재전달,
+//                    restart 는 재부팅 직후에도 한 번 더)
+//   --stream N       SSE 구독자 N 개 (GET /stream, 충분히 빠르게 읽음)
+//   --stream-slow N  읽지 않는 SSE 구독자 N 개 (백프레셔로 끊기는지 확인)
+//   --batch          바이너리 상태 배치 토픽 사용 (STATUS_BATCH_ENABLED 대신)
+//   --no-agg         분 단위 집계 토픽 끄기
+//   --metrics        종료 시 /metrics 응답 출력 (최악 크기 확인은 --metrics 없이도 매번 한다)
+//   --logs LEVEL     종료 시 /logs?level=LEVEL 응답 출력 (기록 링에 남은 줄)
+//   --csv FILE       샘플 기록 파일
+//   --csv-every S    샘플 기록 간격 (초, 기본 60)
+//   --verbose        펌웨어 디버그 로그 출력 (isDEBUG)
+//
+// 존 수는 펌웨어와 같은 빌드 플래그(-DFRIDGE_ZONE_COUNT=N)로 정한다. 존마다 시드가 다른
+// 플랜트를 하나씩 두고, 프로파일 목표는 모든 존에 보낸다.
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <MQTTClient.h>
+#include <Preferences.h>
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+#include "config.h"
+#include "state.h"
+#include "control.h"
+#include "storage.h"
+#include "telemetry.h"
+#include "telemetry_buffer.h"
+#include "telemetry_agg.h"
+#include "commands.h"
+#include "event_stream.h"
+#include "metrics.h"
+#include "mqtt_out.h"
+#include "report_policy.h"
+#include "dht_decode.h"
+#include "status_codec.h"
+#include "dht_wire.h"
+#include "pid_bench.h"
+#include "history_bench.h"
+#include "control_bench.h"
+#include "drive_bench.h"
+#include "ota_bench.h"
+#include "ota.h"
+#include "ota_image.h"
+#include "history.h"
+#include "schedule.h"
+#include "timesync.h"
+#include "warm_boot.h"
+#include "log.h"
+#include "plant.h"
+#include "scheduler.h"
+#include "sim.h"
+#include "zone.h"
+
+// ===== Objects (펌웨어 main.cpp 와 동일한 이름) =====
+bool        isDEBUG = false;
+Preferences prefs;
+MQTTClient  mqtt(1024);
+
+static const uint32_t SIM_HARNESS_MS  = 1000;  // 프로파일/끊김/재부팅 확인 간격 (가상 시각)
+static const float    SIM_DOOR_FRACTION = 0.8f;
+static const uint32_t SIM_STREAM_RATE = 20000;   // --stream 구독자가 읽는 속도 (바이트/초, 느린 WiFi 수준)
+static const uint32_t SIM_OTA_RATE    = 40000;   // --ota 업로드 속도 (바이트/초)
+static const uint32_t SIM_OTA_TICK_MS = 100;
+static const uint32_t SIM_OTA_PUT     = 65536;   // PUT 한 번 크기 (ota.h 의 curl 반복과 같게)
+static const uint32_t SIM_OTA_SEGMENT = 1436;    // WebServer raw 본문 버퍼
+static const uint32_t SIM_OTA_RETRY_MS = 5000;   // 끊긴 뒤 클라이언트가 다시 붙기까지
+
+void updateRuntimeFields() {
+  gStatus.uptimeSec     = millis() / 1000;
+  gStatus.wifiRssi      = -55;
+  gStatus.mqttConnected = mqtt.connected();
+  gStatus.tsMs          = nowUnixMs();
+  gStatus.heapFree      = ESP.getFreeHeap();
+  gStatus.heapMaxBlock  = ESP.getMaxAllocHeap();
+  gStatus.heapMinFree   = ESP.getMinFreeHeap();
+}
+
+// ==================== 프로파일 ====================
+struct ProfileStep {
+  double hour;
+  bool   hasTarget;
+  float  target;
+};
+
+// 기본 48시간 프로파일: 1차 발효 → 다이아세틸 레스트 → 콜드 크래시
+static std::vector<ProfileStep> defaultProfile() {
+  return {
+    { 0.0,  true, 18.0f},
+    {36.0,  true, 20.0f},
+    {44.0,  true,  2.0f},
+  };
+}
+
+static bool loadProfile(const char* path, std::vector<ProfileStep>& out) {
+  FILE* f = fopen(path, "r");
+  if (!f) return false;
+  out.clear();
+  char line[128];
+  while (fgets(line, sizeof(line), f)) {
+    if (line[0] == '#' || line[0] == '\n') continue;
+    double h;
+    char   val[32];
+    if (sscanf(line, "%lf %31s", &h, val) != 2) continue;
+    if (strcmp(val, "off") == 0) out.push_back({h, false, 0.0f});
+    else                         out.push_back({h, true, (float)atof(val)});
+  }
+  fclose(f);
+  return true;
+}
+
+// set_schedule 명령 하나로 (구간 길이는 분)
+static bool loadSchedule(const char* path, char* payload, size_t cap) {
+  FILE* f = fopen(path, "r");
+  if (!f) return false;
+  int n = snprintf(payload, cap, "{\"cmd\":\"set_schedule\",\"id\":\"sim-sched\",\"value\":{\"segments\":[");
+  char line[128];
+  bool first = true;
+  while (fgets(line, sizeof(line), f)) {
+    if (line[0] == '#' || line[0] == '\n') continue;
+    char   kind[8];
+    float  temp;
+    double h;
+    if (sscanf(line, "%7s %f %lf", kind, &temp, &h) != 3) continue;
+    n += snprintf(payload + n, cap - n, "%s[\"%s\",%.1f,%ld]", first ? "" : ",", kind, temp, lround(h * 60.0));
+    first = false;
+  }
+  fclose(f);
+  n += snprintf(payload + n, cap - n, "]}}");
+  return !first && (size_t)n < cap;
+}
+
+// ==================== 측정 ====================
+// 존(플랜트)마다 따로 쌓는 값
+struct ZoneMetrics {
+  double   steadySec      = 0.0;   // 목표 변경 후 정착 대기 시간을 제외한 구간
+  double   sqErrSum       = 0.0;   // Σ err² dt
+  float    maxUndershoot  = 0.0f;  // target - air 최대값 (냉각 전용이라 아래로 넘침)
+  float    maxOvershoot   = 0.0f;  // air - target 최대값
+  double   dutySum        = 0.0;   // Σ duty dt
+  uint32_t coolingStarts  = 0;
+  uint32_t dhtFrames      = 0;
+  uint32_t dhtInjected[5] = {0, 0, 0, 0, 0};   // DhtFault 별 주입 횟수
+  double   trackLostSec   = 0.0;   // 추정 온도가 실제 공기 온도와 1°C 이상 벌어진 시간
+  bool     prevCooling    = false;
+  uint64_t edgeMs         = 0;     // 아직 상태 토픽으로 나가지 않은 냉각 전이 시각 (0 = 없음)
+  bool     edgeTaken      = false; // onStep 이 보기 전에 상태 토픽으로 이미 나간 전이
+};
+
+struct SimMetrics {
+  ZoneMetrics zone[ZONE_COUNT];
+  uint32_t statusPublish  = 0;
+  uint32_t ackPublish     = 0;
+  uint32_t backlogPublish = 0;
+  uint32_t batchPublish   = 0;
+  uint32_t batchSamples   = 0;   // 디코드해서 확인한 샘플 수
+  uint32_t batchDecodeErrs = 0;
+  uint64_t statusBytes    = 0;   // JSON 상태 토픽 누적 페이로드
+  uint64_t batchBytes     = 0;
+  uint32_t aggPublish     = 0;
+  uint32_t aggSamples     = 0;   // 집계에 들어간 스냅샷 수 (모든 존 합)
+  uint64_t aggBytes       = 0;
+  double   aggEnergyWh    = 0.0; // 존 0
+  double   aggCoolSec     = 0.0; // 존 0
+  uint32_t statusReasons[REPORT_REASON_COUNT] = {};   // JSON 상태의 "reason" 별
+  uint32_t edgeReports    = 0;   // 냉각 전이 → 첫 상태 발행 지연
+  uint64_t edgeLatSumMs   = 0;
+  uint64_t edgeLatMaxMs   = 0;
+  uint32_t reboots        = 0;
+  uint64_t rebootMs       = 0;   // 마지막 재부팅 시각
+  float    rebootDevMax   = 0.0f;// 재부팅 후 RESTART_WATCH_SEC 동안 목표 대비 최대 상승 (존 0, 공기)
+  uint32_t doorOpens      = 0;
+  uint32_t statusNoTs     = 0;   // ts=0 으로 나간 JSON 상태
+  uint64_t statusTsErrMax = 0;   // JSON 상태 ts 와 참 시각의 최대 차이 (ms)
+  uint32_t backlogRecords = 0;
+  uint32_t backlogNoTs    = 0;
+  uint64_t timeErrMax     = 0;   // 첫 동기 이후 nowUnixMs() 와 참 시각의 최대 차이 (하네스 1초 간격)
+  double   timeErrSq      = 0.0;
+  uint32_t timeErrCount   = 0;
+};
+
+static const double SETTLE_SEC = 30.0 * 60.0;   // 목표 변경 후 30분은 정착 구간으로 제외
+static const double RESTART_WATCH_SEC = 15.0 * 60.0;   // 재부팅 후 온도 이탈을 보는 구간
+
+static ThermalPlant*  gPlant[ZONE_COUNT] = {};
+static SimMetrics     gMetrics;
+static double         gLastTargetChangeSec = 0.0;
+static FILE*          gCsv         = nullptr;
+static uint32_t       gCsvEveryMs  = 60000;
+static uint64_t       gNextCsvMs   = 0;
+
+static float    gDhtFaultProb = 0.0f;
+static int      gFaultZone    = -1;   // -1 = 모든 존
+static uint32_t gFaultRng     = 0x9E3779B9u;
+
+static float faultRandom() {
+  gFaultRng ^= gFaultRng << 13;
+  gFaultRng ^= gFaultRng >> 17;
+  gFaultRng ^= gFaultRng << 5;
+  return (float)(gFaultRng >> 8) / 16777216.0f;
+}
+
+// 존 플랜트 공기 온도 → DHT21 펄스열 (+ 손상 주입)
+static size_t simDhtFrame(uint8_t zone, DhtPulse* out, size_t max) {
+  ZoneMetrics& m = gMetrics.zone[zone];
+  m.dhtFrames++;
+  float t = gPlant[zone]->sampleTemperature();
+  float h = gPlant[zone]->sampleHumidity();
+  if (isnan(t)) {
+    m.dhtInjected[DHT_FAULT_SILENT]++;
+    return 0;
+  }
+  size_t n = dhtEncodeFrame(t, h, out, max);
+  bool   faultZone = gFaultZone < 0 || gFaultZone == zone;
+  if (faultZone && gDhtFaultProb > 0.0f && faultRandom() < gDhtFaultProb) {
+    DhtFault f = (DhtFault)(1 + (int)(faultRandom() * 4.0f) % 4);
+    dhtInjectFault(f, faultRandom(), out, n);
+    m.dhtInjected[f]++;
+  }
+  return n;
+}
+
+// 기록된 펄스열 디코드: 한 줄에 한 프레임, 양수 = HIGH us, 음수 = LOW us
+static int decodeRecordedFrames(const char* path) {
+  FILE* f = fopen(path, "r");
+  if (!f) {
+    fprintf(stderr, "cannot read pulse file: %s\n", path);
+    return 2;
+  }
+  char     line[2048];
+  uint32_t frame = 0;
+  uint32_t byStatus[4] = {0, 0, 0, 0};
+  while (fgets(line, sizeof(line), f)) {
+    if (line[0] == '#' || line[0] == '\n') continue;
+    DhtPulse pulses[128];
+    size_t   n = 0;
+    char*    p = line;
+    char*    end;
+    for (long v = strtol(p, &end, 10); end != p && n < 128; v = strtol(p, &end, 10)) {
+      pulses[n++] = {(uint8_t)(v > 0 ? 1 : 0), (uint16_t)(v > 0 ? v : -v)};
+      p = end;
+    }
+    DhtReading r;
+    DhtStatus  st = dhtDecode(pulses, n, r);
+    byStatus[st]++;
+    if (st == DHT_OK)
+      printf("frame %u: ok temp=%.1f hum=%.1f raw=%02x %02x %02x %02x %02x\n", (unsigned)++frame,
+             r.temp, r.humidity, r.raw[0], r.raw[1], r.raw[2], r.raw[3], r.raw[4]);
+    else
+      printf("frame %u: %s (%u pulses)\n", (unsigned)++frame, dhtStatusName(st), (unsigned)n);
+  }
+  fclose(f);
+  printf("ok=%u no_response=%u timing=%u checksum=%u\n",
+         (unsigned)byStatus[DHT_OK], (unsigned)byStatus[DHT_ERR_NO_RESPONSE],
+         (unsigned)byStatus[DHT_ERR_TIMING], (unsigned)byStatus[DHT_ERR_CHECKSUM]);
+  return 0;
+}
+
+// 발행 토픽 → 종류 (존은 구분하지 않고 합산)
+static ZoneTopic topicKind(const char* topic) {
+  for (uint8_t z = 0; z < ZONE_COUNT; z++)
+    for (uint8_t t = 0; t < ZONE_TOPIC_COUNT; t++)
+      if (strcmp(topic, zoneTopic(z, (ZoneTopic)t)) == 0) return (ZoneTopic)t;
+  return ZONE_TOPIC_COUNT;
+}
+
+static void onPublish(const char* topic, const char* payload, size_t len, int qos) {
+  (void)qos;
+  sim::HeapUncounted broker;   // 여기서부터는 브로커 쪽 파싱
+  ZoneTopic kind = topicKind(topic);
+  if (kind == ZONE_TOPIC_STATUS) {
+    gMetrics.statusPublish++;
+    gMetrics.statusBytes += len;
+    JsonDocument doc;
+    if (!deserializeJson(doc, payload, len)) {
+      const char* reason = doc["reason"] | "";
+      for (uint8_t r = 0; r < REPORT_REASON_COUNT; r++)
+        if (strcmp(reason, reportReasonName((ReportReason)r)) == 0) gMetrics.statusReasons[r]++;
+      uint64_t ts   = doc["ts"].as<uint64_t>();
+      uint64_t real = sim::trueUnixMs(sim::nowMs());
+      uint64_t err  = ts > real ? ts - real : real - ts;
+      if (!ts) gMetrics.statusNoTs++;
+      else if (err > gMetrics.statusTsErrMax) gMetrics.statusTsErrMax = err;
+    }
+    for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+      ZoneMetrics& m = gMetrics.zone[z];
+      if (strcmp(topic, zoneTopic(z, ZONE_TOPIC_STATUS)) != 0) continue;
+      // 제어 태스크 → statusTick 이 같은 가상 시각 안에 발행하면 onStep 보다 먼저 온다
+      bool unseen = pid.coolingActive[z] != m.prevCooling;
+      if (!m.edgeMs && !unseen) continue;
+      uint64_t lat = m.edgeMs ? sim::nowMs() - m.edgeMs : 0;
+      if (unseen) m.edgeTaken = true;
+      gMetrics.edgeReports++;
+      gMetrics.edgeLatSumMs += lat;
+      if (lat > gMetrics.edgeLatMaxMs) gMetrics.edgeLatMaxMs = lat;
+      m.edgeMs = 0;
+    }
+  }
+  else if (kind == ZONE_TOPIC_STATUS_BATCH) {
+    StatusRecord recs[STATUS_BATCH_MAX_SAMPLES];
+    int n = statusBatchDecode((const uint8_t*)payload, len, recs, STATUS_BATCH_MAX_SAMPLES);
+    gMetrics.batchPublish++;
+    gMetrics.batchBytes += len;
+    // 델타 누적이 어긋나면 값이 센서 범위를 벗어나 흘러간다
+    bool ok = n > 0;
+    for (int i = 0; ok && i < n; i++) {
+      if (recs[i].temp10 != STATUS_REC_NULL16 &&
+          (recs[i].temp10 < SENSOR_TEMP_MIN * 10 || recs[i].temp10 > SENSOR_TEMP_MAX * 10)) ok = false;
+      if (recs[i].hum10 != STATUS_REC_NULL16 && (recs[i].hum10 < 0 || recs[i].hum10 > 1000)) ok = false;
+    }
+    if (ok) gMetrics.batchSamples += (uint32_t)n;
+    else    gMetrics.batchDecodeErrs++;
+  }
+  else if (kind == ZONE_TOPIC_STATUS_AGG) {
+    JsonDocument doc;
+    gMetrics.aggPublish++;
+    gMetrics.aggBytes += len;
+    if (!deserializeJson(doc, payload, len)) {
+      gMetrics.aggSamples += doc["samples"].as<uint32_t>();
+      if (strcmp(topic, zoneTopic(0, ZONE_TOPIC_STATUS_AGG)) == 0) {
+        gMetrics.aggEnergyWh += doc["energy_wh"].as<double>();
+        gMetrics.aggCoolSec  += doc["cooling_sec"].as<double>();
+      }
+    }
+  }
+  else if (kind == ZONE_TOPIC_ACK) gMetrics.ackPublish++;
+  else if (kind == ZONE_TOPIC_STATUS_BACKLOG) {
+    gMetrics.backlogPublish++;
+    JsonDocument doc;
+    if (!deserializeJson(doc, payload, len)) {
+      for (JsonVariantConst rec : doc["records"].as<JsonArray>()) {
+        gMetrics.backlogRecords++;
+        if (!rec[0].as<uint32_t>()) gMetrics.backlogNoTs++;
+      }
+    }
+  }
+}
+
+static void onStep(uint32_t dtMs) {
+  float dt   = dtMs / 1000.0f;
+  bool  csv  = gCsv && sim::nowMs() >= gNextCsvMs;
+  if (csv) gNextCsvMs += gCsvEveryMs;
+
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    ThermalPlant&     plant = *gPlant[z];
+    ZoneMetrics&      m     = gMetrics.zone[z];
+    const ZoneStatus& zs    = gZone[z];
+    plant.setDuty(sim::pwmDuty(zoneConfig(z).pwmChannel));
+    plant.step(dt);
+
+    m.dutySum += plant.duty() * dt;
+    if (isfinite(zs.temp) && fabsf(zs.temp - plant.airC()) > 1.0f) m.trackLostSec += dt;
+    if (pid.coolingActive[z] && !m.prevCooling) m.coolingStarts++;
+    if (pid.coolingActive[z] != m.prevCooling) {
+      if (!m.edgeTaken && !m.edgeMs) m.edgeMs = sim::nowMs();
+      m.edgeTaken = false;
+    }
+    m.prevCooling = pid.coolingActive[z];
+
+    if (z == 0 && gMetrics.reboots && zs.hasTarget &&
+        sim::nowMs() - gMetrics.rebootMs < (uint64_t)(RESTART_WATCH_SEC * 1000.0)) {
+      float dev = plant.airC() - zs.target;
+      if (dev > gMetrics.rebootDevMax) gMetrics.rebootDevMax = dev;
+    }
+
+    double t = plant.elapsedSec();
+    if (zs.hasTarget && t - gLastTargetChangeSec >= SETTLE_SEC) {
+      float err = plant.airC() - zs.target;
+      m.steadySec += dt;
+      m.sqErrSum  += (double)err * err * dt;
+      if (err > m.maxOvershoot)   m.maxOvershoot  = err;
+      if (-err > m.maxUndershoot) m.maxUndershoot = -err;
+    }
+
+    if (csv) {
+      char target[16] = "";
+      if (zs.hasTarget) snprintf(target, sizeof(target), "%.1f", zs.target);
+      if (ZONE_COUNT > 1) fprintf(gCsv, "%s,", zoneConfig(z).name);
+      fprintf(gCsv, "%.0f,%s,%.2f,%.3f,%.3f,%d,%d,%d\n",
+              t, target,
+              zs.temp, plant.airC(), plant.beerC(),
+              zs.power, pid.outputPWM[z], pid.coolingActive[z] ? 1 : 0);
+    }
+  }
+}
+
+// ==================== 부팅 ====================
+static void simBoot() {
+  logBegin();
+  warmBegin();
+  timeBegin();
+  pid     = PIDState();
+  gStatus = StatusState();
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) gZone[z] = ZoneStatus();
+  loadFromNVS();
+  scheduleBegin();
+  otaBegin();
+  commandsBegin();
+  bufferBegin();
+  aggBegin();
+  reportBegin();
+  historyBegin();
+  controlBegin();
+  streamBegin();
+  // 재부팅하면 연결도 새로 (mqtt 작업이 다시 붙는다)
+  mqtt.disconnect();
+  mqttOutBegin();
+}
+
+// 펌웨어 net 작업과 같은 순서: mqtt.loop() 콜백이 큐에 넣고 → commandsTick() 실행
+static uint32_t gRedeliver = 0;
+
+static void deliverCommand(uint8_t zone, const char* payload) {
+  for (uint32_t i = 0; i <= gRedeliver; i++) handleCommandMessage(zone, payload, strlen(payload));
+  commandsTick();
+}
+
+// 프로파일 단계는 모든 존의 cmd 토픽으로 (id 중복 판별은 존마다 따로라 같은 id 를 써도 된다)
+static void sendTarget(const ProfileStep& step, uint32_t seq) {
+  char payload[96];
+  if (step.hasTarget)
+    snprintf(payload, sizeof(payload), "{\"cmd\":\"set_target\",\"id\":\"sim-%u\",\"value\":%.2f}",
+             (unsigned)seq, step.target);
+  else
+    snprintf(payload, sizeof(payload), "{\"cmd\":\"set_target\",\"id\":\"sim-%u\",\"value\":null}",
+             (unsigned)seq);
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) deliverCommand(z, payload);
+  gLastTargetChangeSec = gPlant[0]->elapsedSec();
+}
+
+struct Outage {
+  uint64_t startMs;
+  uint64_t endMs;
+};
+
+static bool parseOutage(const char* spec, std::vector<Outage>& out) {
+  double startH, durH;
+  if (sscanf(spec, "%lf:%lf", &startH, &durH) != 2 || startH < 0.0 || durH <= 0.0) return false;
+  out.push_back({(uint64_t)(startH * 3600.0 * 1000.0), (uint64_t)((startH + durH) * 3600.0 * 1000.0)});
+  return true;
+}
+
+static bool inOutage(const std::vector<Outage>& outages, uint64_t nowMs) {
+  for (const Outage& o : outages)
+    if (nowMs >= o.startMs && nowMs < o.endMs) return true;
+  return false;
+}
+
+// ==================== 스케줄러 ====================
+// 펌웨어 loop() 와 같은 타이머 휠을 가상 시계로 돌린다.
+//   control : 제어 태스크 주기 + 스냅샷 알림으로 깨어난 loop 의 statusTick()
+//   drive   : 펠티어 구동 틱 (펌웨어는 esp_timer)
+//   mqtt    : 펌웨어 mqtt 작업 (끊겨 있으면 연결 + 보고 정책 초기화 + 발행 큐 재전송 준비)
+//   net     : 펌웨어 net 작업의 mqtt.loop() (브로커 응답) + mqttOutTick() + OTA 재부팅 확인, 응답 대기 중이면 빠르게
+//   drain   : 재전송 배치
+//   nvs     : 설정 변경 write-behind 기록
+//   burst   : --burst 명령 연타 주입
+//   stream  : --stream 이 있을 때만, 펌웨어 net 작업의 streamTick()
+//   ota     : --ota 가 있을 때만, PUT /ota 업로드 클라이언트
+//   ntp     : 펌웨어 ntp 작업 (SNTP 요청 / 응답 확인, sntp_sim.cpp 서버)
+//   log     : 로그 대기 링 → 기록 링 (+ --verbose 면 시리얼)
+//   harness : 프로파일 목표 변경, MQTT 끊김 구간 (재부팅 요청은 작업 실행 직후 메인 루프에서)
+static TimerWheel<64, 12> simSched(SCHED_TICK_MS);
+
+static void controlJob(void*) {
+  controlStep();
+  statusTick();
+}
+
+static void mqttJob(void*) {
+  if (mqtt.connected() || !mqtt.connect("sim")) return;
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) reportReset(z);
+  mqttOutOnConnect(mqtt.sessionPresent());
+}
+
+static int gNetJob = -1;
+
+static void netJob(void*) {
+  mqtt.loop();
+  mqttOutTick();
+  // 펌웨어 net 작업과 같다: 검증이 끝난 이미지가 있으면 재부팅 (펠티어는 여기서만 끈다)
+  otaTick();
+  if (otaRebootDue()) {
+    storageFlush();
+    controlForceOff();
+    mqttOutDrain(MQTT_OUT_RETRY_MS);
+    ESP.restart();
+  }
+  simSched.schedule(gNetJob, mqttOutBusy() ? NET_POLL_ACTIVE_MS : NET_POLL_IDLE_MS);
+}
+
+static void drainJob(void*) {
+  if (mqtt.connected()) bufferDrain();
+}
+
+static void nvsJob(void*) {
+  storageTick();
+}
+
+static int gLogJob = -1;
+static int gNtpJob = -1;
+
+static void ntpJob(void*) {
+  simSched.schedule(gNtpJob, timeTick());
+}
+
+static void logJob(void*) {
+  simSched.schedule(gLogJob, logDrain() ? LOG_DRAIN_MS : LOG_IDLE_MS);
+}
+
+struct Burst {
+  uint64_t startMs;
+  uint32_t count;
+  uint32_t sent;
+};
+
+// --ota: ota.h 의 curl 반복처럼 received 부터 PUT 을 이어 보낸다. dropAt 에서 연결이 한 번 끊긴다
+struct SimOta {
+  std::vector<uint8_t> img;
+  uint64_t  startMs   = 0;
+  uint32_t  dropAt    = 0;
+  bool      open      = false;
+  uint32_t  cursor    = 0;
+  uint32_t  putEnd    = 0;
+  uint32_t  puts      = 0;
+  uint64_t  idleUntil = 0;
+  uint64_t  firstMs   = 0;
+  uint64_t  doneMs    = 0;
+  OtaStatus result    = {};   // 재부팅하면 세션이 사라지므로 끝날 때 복사
+};
+
+static void simOtaJob(void* arg) {
+  SimOta& o = *(SimOta*)arg;
+  if (o.doneMs || sim::nowMs() < o.startMs || sim::nowMs() < o.idleUntil) return;
+  if (!o.open) {
+    OtaStatus s = otaStatus();
+    if (o.puts && s.state != OTA_RECEIVING) {
+      o.result = s;
+      o.doneMs = sim::nowMs();
+      return;
+    }
+    if (!o.puts) o.firstMs = sim::nowMs();
+    o.cursor = s.state == OTA_RECEIVING ? s.received : 0;
+    o.putEnd = o.img.size() - o.cursor < SIM_OTA_PUT ? (uint32_t)o.img.size() : o.cursor + SIM_OTA_PUT;
+    o.puts++;
+    o.open = otaChunkBegin(o.cursor);
+    if (!o.open) {
+      otaChunkEnd();
+      return;
+    }
+  }
+  uint32_t budget = SIM_OTA_RATE * SIM_OTA_TICK_MS / 1000;
+  while (budget && o.cursor < o.putEnd) {
+    uint32_t seg = o.putEnd - o.cursor;
+    if (seg > SIM_OTA_SEGMENT) seg = SIM_OTA_SEGMENT;
+    if (seg > budget) seg = budget;
+    bool drop = o.dropAt > o.cursor && o.dropAt <= o.cursor + seg;
+    if (drop) seg = o.dropAt - o.cursor;
+    otaChunkWrite(&o.img[o.cursor], seg);
+    o.cursor += seg;
+    budget   -= seg;
+    if (drop) {
+      o.dropAt    = 0;
+      o.putEnd    = o.cursor;
+      o.idleUntil = sim::nowMs() + SIM_OTA_RETRY_MS;
+    }
+  }
+  if (o.cursor == o.putEnd) {
+    otaChunkEnd();
+    o.open = false;
+  }
+}
+
+// /metrics 최악 크기: 지금 본문의 시리즈마다 값을 최대 자릿수로 (정수 11자리, _sum 20자리) 바꿔 더한다.
+// 값이 있을 때만 나오는 명령 요약도 세도록 빈 히스토그램에 샘플을 하나씩 넣는다 (실행이 끝난 뒤에만 호출)
+static size_t metricsWorstCase() {
+  for (uint8_t i = 0; i < METRIC_CMD_COUNT; i++) {
+    if (!gCmdApplyHist[i].count()) gCmdApplyHist[i].record(1);
+    if (!gCmdAckHist[i].count()) gCmdAckHist[i].record(1);
+  }
+  static char body[METRICS_TEXT_MAX * 2];
+  size_t len = buildMetricsText(body, sizeof(body));
+  len += buildSchedMetrics(simSched, body + len, sizeof(body) - len);
+  size_t worst = 0;
+  for (const char* line = body; line < body + len;) {
+    const char* end = (const char*)memchr(line, '\n', (size_t)(body + len - line));
+    if (!end) end = body + len;
+    size_t n = (size_t)(end - line);
+    if (line[0] != '#') {
+      const char* val = end;
+      while (val > line && val[-1] != ' ') val--;
+      const char* name = line;
+      while (name < end && *name != '{' && *name != ' ') name++;
+      bool sum = name - line >= 4 && !memcmp(name - 4, "_sum", 4);
+      n = (size_t)(val - line) + (sum ? 20 : 11);
+    }
+    worst += n + 1;
+    line = end + 1;
+  }
+  return worst;
+}
+
+int main(int argc, char** argv) {
+  double      hours       = 48.0;
+  const char* profilePath = nullptr;
+  const char* schedulePath = nullptr;
+  static char schedulePayload[CMD_PAYLOAD_MAX];
+  const char* csvPath     = nullptr;
+  PlantParams params;
+  bool        dumpMetrics = false;
+  const char* dumpLogs    = nullptr;
+  std::vector<Outage> outages;
+  std::vector<double> doors;
+  std::vector<Burst>  bursts;
+  std::vector<double> restarts;
+  uint32_t    streamFast  = 0;
+  uint32_t    mqttRttMs   = 30;
+  float       mqttLoss    = 0.0f;
+  uint32_t    streamSlow  = 0;
+  double      clockDriftPpm = 0.0;
+  uint32_t    ntpDelayMs  = 30;
+  float       ntpLoss     = 0.0f;
+  double      ntpDownSec  = 0.0;
+  bool        benchControl = false;
+  double      otaAtH      = -1.0;
+  ControlBenchOptions benchOpt;
+
+  for (int i = 1; i < argc; i++) {
+    const char* a    = argv[i];
+    const char* next = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    if      (!strcmp(a, "--hours")     && next) { hours = atof(next); i++; }
+    else if (!strcmp(a, "--profile")   && next) { profilePath = next; i++; }
+    else if (!strcmp(a, "--schedule")  && next) { schedulePath = next; i++; }
+    else if (!strcmp(a, "--ambient")   && next) { params.ambientC = params.initialC = (float)atof(next); i++; }
+    else if (!strcmp(a, "--ferment")   && next) { params.fermentPeakW = (float)atof(next); i++; }
+    else if (!strcmp(a, "--dropout")   && next) { params.sensorDropout = (float)atof(next); i++; }
+    else if (!strcmp(a, "--dht-faults") && next) { gDhtFaultProb = (float)atof(next); i++; }
+    else if (!strcmp(a, "--fault-zone") && next) {
+      gFaultZone = zoneFromArg(next);
+      if (gFaultZone < 0) { fprintf(stderr, "bad --fault-zone (0..%u or name): %s\n", (unsigned)ZONE_COUNT - 1, next); return 2; }
+      i++;
+    }
+    else if (!strcmp(a, "--dht-decode") && next) { return decodeRecordedFrames(next); }
+    else if (!strcmp(a, "--bench-pid") && next) { return runPidBench((uint32_t)strtoul(next, nullptr, 10)); }
+    else if (!strcmp(a, "--bench-history") && next) { return runHistoryBench((uint32_t)strtoul(next, nullptr, 10)); }
+    else if (!strcmp(a, "--bench-drive") && next) { return runDriveBench((uint32_t)strtoul(next, nullptr, 10)); }
+    else if (!strcmp(a, "--bench-ota") && next) { return runOtaBench(next); }
+    else if (!strcmp(a, "--ota-pack") && next && i + 2 < argc) { return runOtaPack(next, argv[i + 2]); }
+    else if (!strcmp(a, "--bench-control") && next) { benchControl = true; benchOpt.scenarios = next; i++; }
+    else if (!strcmp(a, "--trace")     && next) { benchOpt.traces.push_back(next); i++; }
+    else if (!strcmp(a, "--bench-out") && next) { benchOpt.outPath = next; i++; }
+    else if (!strcmp(a, "--baseline")  && next) { benchOpt.baselinePath = next; i++; }
+    else if (!strcmp(a, "--seed")      && next) { params.seed = (uint32_t)strtoul(next, nullptr, 10); i++; }
+    else if (!strcmp(a, "--outage")    && next) {
+      if (!parseOutage(next, outages)) { fprintf(stderr, "bad --outage (START_H:DUR_H): %s\n", next); return 2; }
+      i++;
+    }
+    else if (!strcmp(a, "--door")      && next) { doors.push_back(atof(next)); i++; }
+    else if (!strcmp(a, "--burst")     && next) {
+      double   startH;
+      unsigned n;
+      if (sscanf(next, "%lf:%u", &startH, &n) != 2) { fprintf(stderr, "bad --burst (START_H:N): %s\n", next); return 2; }
+      bursts.push_back({(uint64_t)(startH * 3600.0 * 1000.0), n, 0});
+      i++;
+    }
+    else if (!strcmp(a, "--restart")   && next) { restarts.push_back(atof(next)); i++; }
+    else if (!strcmp(a, "--ota")       && next) { otaAtH = atof(next); i++; }
+    else if (!strcmp(a, "--clock-drift") && next) { clockDriftPpm = atof(next); i++; }
+    else if (!strcmp(a, "--ntp-delay") && next) { ntpDelayMs = (uint32_t)strtoul(next, nullptr, 10); i++; }
+    else if (!strcmp(a, "--ntp-loss")  && next) { ntpLoss = (float)atof(next); i++; }
+    else if (!strcmp(a, "--ntp-down")  && next) { ntpDownSec = atof(next); i++; }
+    else if (!strcmp(a, "--mqtt-rtt")  && next) { mqttRttMs = (uint32_t)strtoul(next, nullptr, 10); i++; }
+    else if (!strcmp(a, "--mqtt-loss") && next) { mqttLoss = (float)atof(next); i++; }
+    else if (!strcmp(a, "--redeliver") && next) { gRedeliver = (uint32_t)strtoul(next, nullptr, 10); i++; }
+    else if (!strcmp(a, "--stream")    && next) { streamFast = (uint32_t)strtoul(next, nullptr, 10); i++; }
+    else if (!strcmp(a, "--stream-slow") && next) { streamSlow = (uint32_t)strtoul(next, nullptr, 10); i++; }
+    else if (!strcmp(a, "--batch"))             { setStatusBatchEnabled(true); }
+    else if (!strcmp(a, "--no-agg"))            { setStatusAggEnabled(false); }
+    else if (!strcmp(a, "--cold-boot"))         { warmSetEnabled(false); }
+    else if (!strcmp(a, "--metrics"))           { dumpMetrics = true; }
+    else if (!strcmp(a, "--logs")      && next) { dumpLogs = next; i++; }
+    else if (!strcmp(a, "--csv")       && next) { csvPath = next; i++; }
+    else if (!strcmp(a, "--csv-every") && next) { gCsvEveryMs = (uint32_t)(atof(next) * 1000.0); i++; }
+    else if (!strcmp(a, "--verbose"))           { isDEBUG = true; }
+    else {
+      fprintf(stderr, "unknown option: %s\n", a);
+      return 2;
+    }
+  }
+
+  if (benchControl) return runControlBench(benchOpt);
+
+  std::vector<ProfileStep> profile = defaultProfile();
+  if (profilePath && !loadProfile(profilePath, profile)) {
+    fprintf(stderr, "cannot read profile: %s\n", profilePath);
+    return 2;
+  }
+  if (schedulePath) {
+    if (!loadSchedule(schedulePath, schedulePayload, sizeof(schedulePayload))) {
+      fprintf(stderr, "cannot read schedule (or longer than %u bytes): %s\n", (unsigned)CMD_PAYLOAD_MAX, schedulePath);
+      return 2;
+    }
+    profile.clear();   // 목표는 기기가 스케줄로 직접
+  }
+
+  SimOta ota;
+  if (otaAtH >= 0.0) {
+    std::vector<uint8_t> fw;
+    if (!otaReadFile(argv[0], fw) || !otaPackImage(fw, OTA_CODEC_LZSS, ota.img)) {
+      fprintf(stderr, "cannot pack %s for --ota\n", argv[0]);
+      return 2;
+    }
+    ota.startMs = (uint64_t)(otaAtH * 3600.0 * 1000.0);
+    ota.dropAt  = (uint32_t)(ota.img.size() * 2 / 5);
+  }
+
+  if (csvPath) {
+    gCsv = fopen(csvPath, "w");
+    if (!gCsv) {
+      fprintf(stderr, "cannot open csv: %s\n", csvPath);
+      return 2;
+    }
+    fprintf(gCsv, "%st_sec,target,sensor,air,beer,power,pwm,cooling\n", ZONE_COUNT > 1 ? "zone," : "");
+  }
+
+  // 존마다 시드만 다른 플랜트 (센서 잡음/무응답이 존끼리 독립)
+  std::vector<ThermalPlant> plants;
+  plants.reserve(ZONE_COUNT);
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    PlantParams p = params;
+    p.seed += z * 7919u;
+    plants.emplace_back(p);
+    gPlant[z] = &plants[z];
+  }
+  ThermalPlant& plant = plants[0];
+  sim::setStepHook(onStep);
+  sim::setDhtFrameSource(simDhtFrame);
+  sim::setPublishHook(onPublish);
+  sim::setMqttConnected(true);
+  sim::setMqttLink(mqttRttMs, mqttLoss);
+  sim::setSntpLink(ntpDelayMs, ntpLoss, clockDriftPpm, (uint64_t)(ntpDownSec * 1000.0));
+
+  simBoot();
+  mqttJob(nullptr);   // 하네스가 t=0 에 넣는 명령의 ack 가 연결 전에 나가지 않게
+
+  // 느린 구독자를 먼저 붙여서 빠른 구독자가 자리를 못 얻는 경우(503)도 보이게
+  std::vector<int> streamClients;
+  for (uint32_t i = 0; i < streamSlow + streamFast; i++)
+    streamClients.push_back(sim::streamClientOpen("GET /stream HTTP/1.1\r\nHost: fridge\r\n\r\n",
+                                                  i < streamSlow ? 0 : SIM_STREAM_RATE));
+
+  const uint64_t endMs   = (uint64_t)(hours * 3600.0 * 1000.0);
+  size_t         nextStep = 0;
+  uint32_t       cmdSeq   = 0;
+  uint64_t       wakeups  = 0;
+  clock_t        wallStart = clock();
+  uint64_t       allocsAtBoot = sim::heapAllocCount();
+
+  struct Harness {
+    const std::vector<ProfileStep>* profile;
+    const std::vector<Outage>*      outages;
+    std::vector<double>*            doors;
+    std::vector<Burst>*             bursts;
+    std::vector<double>*            restarts;
+    size_t*                         nextStep;
+    uint32_t*                       cmdSeq;
+    int                             controlJob;
+    char                            lastRestart[96];
+    const char*                     schedule;   // 첫 온도가 나오면 한 번 (첫 ramp 가 지금 온도에서 시작)
+  } h = {&profile, &outages, &doors, &bursts, &restarts, &nextStep, &cmdSeq, -1, "",
+         schedulePath ? schedulePayload : nullptr};
+
+  simSched.begin(millis());
+  h.controlJob = simSched.add("control", controlJob, nullptr, CONTROL_PERIOD_MS, CONTROL_PERIOD_MS);
+  simSched.add("drive", [](void*) { peltierDriveTick(); }, nullptr, PELTIER_DRIVE_TICK_MS, 0);
+  simSched.add("mqtt", mqttJob, nullptr, 1000, 0);
+  gNetJob = simSched.add("net", netJob, nullptr, 0, 0);
+  simSched.add("drain", drainJob, nullptr, TELEMETRY_DRAIN_MS, TELEMETRY_DRAIN_MS);
+  simSched.add("nvs", nvsJob, nullptr, NVS_TICK_MS, NVS_TICK_MS);
+  gLogJob = simSched.add("log", logJob, nullptr, 0, 0);
+  gNtpJob = simSched.add("ntp", ntpJob, nullptr, 0, 0);   // 시뮬레이터의 WiFi 는 처음부터 연결
+  // UI 연타: 0.5초마다 목표를 0.1°C 씩 바꿔 보낸다
+  if (!bursts.empty()) simSched.add("burst", [](void* arg) {
+    for (Burst& b : *(std::vector<Burst>*)arg) {
+      if (b.sent >= b.count || sim::nowMs() < b.startMs) continue;
+      char payload[96];
+      snprintf(payload, sizeof(payload), "{\"cmd\":\"set_target\",\"id\":\"burst-%u\",\"value\":%.1f}",
+               (unsigned)b.sent, gZone[0].target + (b.sent % 2 ? 0.1f : -0.1f));
+      deliverCommand(0, payload);
+      b.sent++;
+    }
+  }, &bursts, 500, 0);
+  if (otaAtH >= 0.0) simSched.add("ota", simOtaJob, &ota, SIM_OTA_TICK_MS, 0);
+  if (!streamClients.empty()) simSched.add("stream", [](void*) { streamTick(); }, nullptr, NET_POLL_IDLE_MS, 0);
+  simSched.add("harness", [](void* arg) {
+    Harness& h = *(Harness*)arg;
+    while (*h.nextStep < h.profile->size() &&
+           sim::nowMs() >= (uint64_t)((*h.profile)[*h.nextStep].hour * 3600.0 * 1000.0)) {
+      sendTarget((*h.profile)[(*h.nextStep)++], ++*h.cmdSeq);
+    }
+    if (h.schedule && isfinite(gZone[0].temp)) {
+      for (uint8_t z = 0; z < ZONE_COUNT; z++) deliverCommand(z, h.schedule);
+      gLastTargetChangeSec = gPlant[0]->elapsedSec();
+      h.schedule = nullptr;
+    }
+    sim::setMqttConnected(!inOutage(*h.outages, sim::nowMs()));
+    // 기기 시각 vs 참 시각 (첫 SNTP 동기 이후)
+    if (timeSynced()) {
+      int64_t  d   = (int64_t)(nowUnixMs() - sim::trueUnixMs(sim::nowMs()));
+      uint64_t err = (uint64_t)(d < 0 ? -d : d);
+      if (err > gMetrics.timeErrMax) gMetrics.timeErrMax = err;
+      gMetrics.timeErrSq += (double)d * (double)d;
+      gMetrics.timeErrCount++;
+    }
+    for (double& doorH : *h.doors) {
+      if (doorH >= 0.0 && sim::nowMs() >= (uint64_t)(doorH * 3600.0 * 1000.0)) {
+        for (uint8_t z = 0; z < ZONE_COUNT; z++) gPlant[z]->openDoor(SIM_DOOR_FRACTION);
+        gMetrics.doorOpens++;
+        doorH = -1.0;
+      }
+    }
+    for (double& restartH : *h.restarts) {
+      if (restartH >= 0.0 && sim::nowMs() >= (uint64_t)(restartH * 3600.0 * 1000.0)) {
+        snprintf(h.lastRestart, sizeof(h.lastRestart), "{\"cmd\":\"restart\",\"id\":\"sim-%u\"}",
+                 (unsigned)++*h.cmdSeq);
+        deliverCommand(0, h.lastRestart);
+        restartH = -1.0;
+      }
+    }
+  }, &h, SIM_HARNESS_MS, 0);
+
+  while (sim::nowMs() < endMs) {
+    simSched.runDue(millis());
+    // ESP.restart() 는 돌아오지 않는다: 요청한 작업 바로 뒤에 재부팅 (다른 작업이 끼어들어 발행하지 않게)
+    if (sim::takeRestartRequest()) {
+      gMetrics.reboots++;
+      gMetrics.rebootMs = sim::nowMs();
+      simBoot();
+      simSched.schedule(h.controlJob, CONTROL_PERIOD_MS);   // 새 제어 태스크는 부팅 시점 기준
+      // 영속 세션: 재부팅 후 재연결하면 브로커가 같은 restart 를 다시 전달할 수 있다
+      if (gRedeliver && h.lastRestart[0]) deliverCommand(0, h.lastRestart);
+    }
+    wakeups++;
+    // 펌웨어 loop() 의 ulTaskNotifyTake(다음 마감) 에 해당
+    uint32_t waitMs = simSched.msUntilNext(millis());
+    delay(waitMs > 0 ? waitMs : 1);
+  }
+
+  double   wallSec    = (double)(clock() - wallStart) / CLOCKS_PER_SEC;
+  uint64_t loopAllocs = sim::heapAllocCount() - allocsAtBoot;
+  logFlush();
+  if (gCsv) fclose(gCsv);
+
+  // 아래 단일 값 요약은 존 0 기준, 존이 여럿이면 존별 줄을 따로 출력
+  const ZoneMetrics& m0 = gMetrics.zone[0];
+  double simSec = plant.elapsedSec();
+  double rms    = m0.steadySec > 0.0 ? sqrt(m0.sqErrSum / m0.steadySec) : NAN;
+
+  printf("[SIM] simulated      %.1f h (%.2f s wall, x%.0f)\n",
+         simSec / 3600.0, wallSec, wallSec > 0.0 ? simSec / wallSec : 0.0);
+  printf("[SIM] final          air=%.2fC beer=%.2fC target=%.1fC\n",
+         plant.airC(), plant.beerC(), gZone[0].target);
+  printf("[SIM] steady RMS err %.3f C over %.1f h\n", rms, m0.steadySec / 3600.0);
+  printf("[SIM] max over/under %.2f / %.2f C\n", m0.maxOvershoot, m0.maxUndershoot);
+  printf("[SIM] peltier        duty=%.1f%% energy=%.1f Wh starts=%u\n",
+         simSec > 0.0 ? 100.0 * m0.dutySum / simSec : 0.0,
+         plant.energyWh(), (unsigned)m0.coolingStarts);
+  printf("[SIM] mqtt           status=%u ack=%u backlog=%u reboots=%u (unsent at reboot=%u, pwm on at reboot=%u)\n",
+         (unsigned)gMetrics.statusPublish, (unsigned)gMetrics.ackPublish,
+         (unsigned)gMetrics.backlogPublish, (unsigned)gMetrics.reboots, (unsigned)sim::restartUnsent(),
+         (unsigned)sim::restartPwmOn());
+  if (gMetrics.reboots) {
+    BootInfo bi = bootInfo();
+    printf("[SIM] last boot      reason=%s warm_zones=%u first_pwm=%u ms first_publish=%u ms, "
+           "air above target within %.0f min of reboot: max %.2f C\n",
+           bi.reason, (unsigned)bi.zonesRestored, (unsigned)bi.firstPwmMs, (unsigned)bi.firstPublishMs,
+           RESTART_WATCH_SEC / 60.0, gMetrics.rebootDevMax);
+  }
+  MqttOutStats     mo = mqttOutStats();
+  sim::BrokerStats bk = sim::brokerStats();
+  printf("[SIM] mqtt out       queued=%u completed=%u rejected=%u expired=%u retransmits=%u depth_max=%u "
+         "rtt p50=%ums p99=%ums max=%ums broker dup=%u acks_lost=%u\n",
+         (unsigned)mo.queued, (unsigned)mo.completed, (unsigned)mo.rejected, (unsigned)mo.expired,
+         (unsigned)mo.retransmits, (unsigned)mo.depthMax, (unsigned)(mqttOutRtt().percentile(0.50f) / 1000),
+         (unsigned)(mqttOutRtt().percentile(0.99f) / 1000), (unsigned)(mqttOutRtt().max() / 1000),
+         (unsigned)bk.dupReceived, (unsigned)bk.acksLost);
+  printf("[SIM] status bytes   json=%llu (%u msgs) batch=%llu (%u msgs, %u samples, %u decode errs)\n",
+         (unsigned long long)gMetrics.statusBytes, (unsigned)gMetrics.statusPublish,
+         (unsigned long long)gMetrics.batchBytes, (unsigned)gMetrics.batchPublish,
+         (unsigned)gMetrics.batchSamples, (unsigned)gMetrics.batchDecodeErrs);
+  printf("[SIM] status report  cooling edge -> status avg=%.0f ms max=%llu ms (%u edges), reasons:",
+         gMetrics.edgeReports ? (double)gMetrics.edgeLatSumMs / gMetrics.edgeReports : 0.0,
+         (unsigned long long)gMetrics.edgeLatMaxMs, (unsigned)gMetrics.edgeReports);
+  for (uint8_t r = REPORT_FIRST; r < REPORT_REASON_COUNT; r++)
+    if (gMetrics.statusReasons[r]) printf(" %s=%u", reportReasonName((ReportReason)r), (unsigned)gMetrics.statusReasons[r]);
+  printf("\n");
+  ScheduleProgress sp = scheduleProgress(0);
+  if (sp.state != SCHED_STATE_NONE)
+    printf("[SIM] schedule       %s step %u/%u elapsed=%.1f h of %.1f h setpoint=%.2fC (zone 0)\n",
+           scheduleStateName(sp.state), (unsigned)sp.step + 1, (unsigned)sp.steps,
+           sp.elapsedSec / 3600.0, sp.totalSec / 3600.0, sp.setpoint);
+  AggStats as = aggStats();
+  printf("[SIM] aggregates     %u msgs %llu B, %u samples, pending=%u dropped=%u energy=%.1f Wh (plant %.1f) cooling=%.1f h\n",
+         (unsigned)gMetrics.aggPublish, (unsigned long long)gMetrics.aggBytes, (unsigned)gMetrics.aggSamples,
+         (unsigned)as.pending, (unsigned)as.dropped, gMetrics.aggEnergyWh, plant.energyWh(),
+         gMetrics.aggCoolSec / 3600.0);
+  updateRuntimeFields();
+  printf("[SIM] scheduler      %llu wakeups", (unsigned long long)wakeups);
+  for (uint32_t i = 0; i < simSched.capacity(); i++) {
+    decltype(simSched)::JobStats js;
+    if (simSched.stats((int)i, js))
+      printf(" %s=%u(late<=%ums)", js.name, (unsigned)js.runs, (unsigned)js.lateMaxMs);
+  }
+  printf("\n");
+  printf("[SIM] heap           loop allocs=%llu free=%u min_free=%u\n",
+         (unsigned long long)loopAllocs, (unsigned)gStatus.heapFree, (unsigned)gStatus.heapMinFree);
+  BufferStats bs = bufferStats();
+  printf("[SIM] buffer         buffered=%u replayed=%u dropped=%u high_water=%u left=%u+%u batches=%u\n",
+         (unsigned)bs.buffered, (unsigned)bs.replayed, (unsigned)bs.dropped, (unsigned)bs.highWater,
+         (unsigned)bs.ramCount, (unsigned)bs.spillCount, (unsigned)bs.batches);
+  printf("[SIM] dht frames     %u injected bitflip=%u stretch=%u truncate=%u silent=%u\n",
+         (unsigned)m0.dhtFrames,
+         (unsigned)m0.dhtInjected[DHT_FAULT_BITFLIP], (unsigned)m0.dhtInjected[DHT_FAULT_STRETCH],
+         (unsigned)m0.dhtInjected[DHT_FAULT_TRUNCATE], (unsigned)m0.dhtInjected[DHT_FAULT_SILENT]);
+  printf("[SIM] dht decoded    checksum=%u timing=%u no_response=%u range=%u outlier=%u recovered=%u\n",
+         (unsigned)gControl[0].sensorChecksumErrs, (unsigned)gControl[0].sensorTimingErrs,
+         (unsigned)gControl[0].sensorNoResponse, (unsigned)gControl[0].sensorRangeRejects,
+         (unsigned)gControl[0].sensorOutliers, (unsigned)gControl[0].sensorRecoveries);
+  // 제어 주기 예산: 존마다 센서 캡처를 기다리므로 실행 시간이 존 수에 비례한다
+  printf("[SIM] control        zones=%u exec_max=%uus budget=%uus overruns=%u sensor p99=%uus pid p99=%uus\n",
+         (unsigned)ZONE_COUNT, (unsigned)gControl[0].execMaxUs, (unsigned)(CONTROL_PERIOD_MS * 1000UL),
+         (unsigned)gControl[0].overruns, (unsigned)gStageHist[STAGE_SENSOR].percentile(0.99f),
+         (unsigned)gStageHist[STAGE_PID].percentile(0.99f));
+  for (uint8_t z = 0; ZONE_COUNT > 1 && z < ZONE_COUNT; z++) {
+    const ZoneMetrics&     m = gMetrics.zone[z];
+    const ControlSnapshot& c = gControl[z];
+    uint32_t injected = 0;
+    for (uint8_t f = 1; f < 5; f++) injected += m.dhtInjected[f];
+    printf("[SIM] zone %-9s rms=%.3fC starts=%u duty=%.1f%% dht frames=%u injected=%u "
+           "rejected=%u (checksum=%u timing=%u no_response=%u outlier=%u) track_lost=%.0fs\n",
+           zoneConfig(z).name, m.steadySec > 0.0 ? sqrt(m.sqErrSum / m.steadySec) : NAN,
+           (unsigned)m.coolingStarts, simSec > 0.0 ? 100.0 * m.dutySum / simSec : 0.0,
+           (unsigned)m.dhtFrames, (unsigned)injected,
+           (unsigned)(c.sensorChecksumErrs + c.sensorTimingErrs + c.sensorNoResponse +
+                      c.sensorRangeRejects + c.sensorOutliers),
+           (unsigned)c.sensorChecksumErrs, (unsigned)c.sensorTimingErrs,
+           (unsigned)c.sensorNoResponse, (unsigned)c.sensorOutliers, m.trackLostSec);
+  }
+  StorageStats ss = storageStats();
+  printf("[SIM] nvs            requests=%u commits=%u skipped=%u lifetime=%u flash_writes=%llu\n",
+         (unsigned)ss.requests, (unsigned)ss.commits, (unsigned)ss.skipped,
+         (unsigned)ss.lifetimeWrites, (unsigned long long)sim::nvsWriteCount());
+  LogStats ls = logStats();
+  printf("[SIM] log            level=%s records=%u ring_drops=%u overwritten=%u serial_skipped=%u\n",
+         logLevelName(logLevel()), (unsigned)ls.records, (unsigned)ls.ringDrops, (unsigned)ls.overwritten,
+         (unsigned)ls.serialSkipped);
+  if (otaAtH >= 0.0) {
+    const OtaStatus& r = ota.result;
+    printf("[SIM] ota            %s error=%s image=%u B (raw %u) puts=%u resumes=%u dup=%u download=%.1f s\n",
+           ota.doneMs ? otaStateName(r.state) : "unfinished", r.error ? r.error : "-", (unsigned)ota.img.size(),
+           (unsigned)r.rawSize, (unsigned)ota.puts, (unsigned)r.resumes, (unsigned)r.duplicateBytes,
+           ota.doneMs ? (ota.doneMs - ota.firstMs) / 1000.0 : 0.0);
+  }
+  TimeStats            tms = timeStats();
+  sim::SntpServerStats sss = sim::sntpServerStats();
+  printf("[SIM] time           source=%s first_sync=%u ms syncs=%u/%u req (lost=%u timeouts=%u rejected=%u steps=%u) "
+         "drift est=%+.2f ppm (true %+.2f) poll=%us err rms=%.1f ms max=%llu ms\n",
+         timeSourceName(tms.source), (unsigned)tms.firstSyncMs, (unsigned)tms.syncs, (unsigned)sss.requests,
+         (unsigned)sss.lost, (unsigned)tms.timeouts, (unsigned)tms.rejects, (unsigned)tms.steps,
+         tms.driftPpb / 1000.0, clockDriftPpm, (unsigned)(tms.pollMs / 1000),
+         gMetrics.timeErrCount ? sqrt(gMetrics.timeErrSq / gMetrics.timeErrCount) : 0.0,
+         (unsigned long long)gMetrics.timeErrMax);
+  printf("[SIM] timestamps     status ts=0: %u, status |ts-true| max=%llu ms, backlog records=%u (ts=0: %u, backstamped=%u)\n",
+         (unsigned)gMetrics.statusNoTs, (unsigned long long)gMetrics.statusTsErrMax, (unsigned)gMetrics.backlogRecords,
+         (unsigned)gMetrics.backlogNoTs, (unsigned)bs.backstamped);
+  CommandStats cs = commandStats();
+  printf("[SIM] commands       received=%u executed=%u duplicates=%u drops=%u cached=%u ack p50=%uus p99=%uus\n",
+         (unsigned)cs.received, (unsigned)cs.executed, (unsigned)cs.duplicates, (unsigned)cs.queueDrops,
+         (unsigned)cs.cached, (unsigned)gCmdAckHist[METRIC_CMD_SET_TARGET].percentile(0.50f),
+         (unsigned)gCmdAckHist[METRIC_CMD_SET_TARGET].percentile(0.99f));
+  printf("[SIM] sensor track   |est-air|>1C for %.0f s, doors=%u rate=%+.3fC/min\n",
+         m0.trackLostSec, (unsigned)gMetrics.doorOpens, gControl[0].tempRate * 60.0f);
+  if (!streamClients.empty()) {
+    StreamStats st    = streamStats();
+    uint32_t    edges = 0;
+    for (uint8_t z = 0; z < ZONE_COUNT; z++) edges += gControl[z].pidStarts + gControl[z].pidStops;
+    printf("[SIM] stream         accepted=%u rejected=%u slow_drops=%u events=%u bytes=%u pid edges=%u\n",
+           (unsigned)st.accepted, (unsigned)st.rejected, (unsigned)st.slowDrops, (unsigned)st.events,
+           (unsigned)st.bytes, (unsigned)edges);
+    for (size_t i = 0; i < streamClients.size(); i++) {
+      sim::StreamClientStats cs = sim::streamClientStats(streamClients[i]);
+      printf("[SIM] stream client  #%u %-4s http=%d status=%u pid=%u pings=%u bytes=%u %s\n", (unsigned)i,
+             i < streamSlow ? "slow" : "fast", cs.httpStatus, (unsigned)cs.statusEvents, (unsigned)cs.pidEvents,
+             (unsigned)cs.pings, (unsigned)cs.bytes, cs.closed ? "closed" : "open");
+    }
+  }
+  if (dumpLogs) {
+    uint8_t level = LOG_LVL_DEBUG;
+    if (!logLevelFromName(dumpLogs, level)) fprintf(stderr, "unknown log level %s\n", dumpLogs);
+    uint32_t lines = 0;
+    uint32_t next  = logWriteText(0, level, LOG_CAT_ALL, [](const char* line, size_t len, void* ctx) {
+      fwrite(line, 1, len, stdout);
+      ++*(uint32_t*)ctx;
+    }, &lines);
+    printf("[SIM] logs           %u lines (level<=%s), next=%lu\n", (unsigned)lines, logLevelName(level),
+           (unsigned long)next);
+  }
+  if (dumpMetrics) {
+    static char metricsBuf[METRICS_TEXT_MAX];
+    size_t len = buildMetricsText(metricsBuf, sizeof(metricsBuf));
+    len += buildSchedMetrics(simSched, metricsBuf + len, sizeof(metricsBuf) - len);
+    printf("%s[SIM] metrics        %u bytes\n", metricsBuf, (unsigned)len);
+  }
+  size_t metricsWorst = metricsWorstCase();
+  printf("[SIM] metrics worst  %u / %u bytes\n", (unsigned)metricsWorst, (unsigned)METRICS_TEXT_MAX);
+  if (metricsWorst > METRICS_TEXT_MAX) {
+    fprintf(stderr, "/metrics worst case %u B exceeds METRICS_TEXT_MAX %u B\n", (unsigned)metricsWorst,
+            (unsigned)METRICS_TEXT_MAX);
+    return 1;
+  }
+  return 0;
+}
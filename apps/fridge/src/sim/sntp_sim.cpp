@@ -0,0 +1,88 @@
+#include <string.h>
+#include "sim.h"
+#include "timesync.h"
+
+// 네이티브 빌드용 SNTP 서버. 기준 시각은 2026-01-01T00:00:00Z 에서 가상 시계로 흐르되,
+// 기기 시계(가상 시계)가 driftPpm 만큼 빠르다고 본다: 참 시각 = 시작 + t × (1 - drift).
+// 왕복은 delayMs 를 중심으로 ±50% 흔들리고, 가는 길 / 오는 길 비율도 30~70% 사이에서 바뀐다
+// (SNTP 가 왕복/2 로 보정하고 남는 오차). 요청은 loss 확률로 사라진다.
+
+static const uint64_t SIM_EPOCH_START_MS = 1767225600000ULL;
+static const uint32_t NTP_UNIX_DELTA     = 2208988800UL;
+
+struct Reply {
+  uint64_t at;
+  uint8_t  pkt[48];
+};
+
+// 날아가는 중인 응답 (요청 하나에 응답 하나, 보통 0~1개). 시뮬레이터 힙 집계에 잡히지 않게 고정 크기
+static const uint32_t    REPLY_RING = 8;
+static Reply             replies[REPLY_RING];
+static uint32_t          replyHead  = 0;
+static uint32_t          replyCount = 0;
+static uint32_t          gDelayMs  = 30;
+static float             gLoss     = 0.0f;
+static double            gDriftPpm = 0.0;
+static uint64_t          gDownUntil = 0;
+static uint32_t          gRng      = 0x2545F491u;
+static sim::SntpServerStats gStats = {};
+
+static float uniform() {
+  gRng = gRng * 1664525u + 1013904223u;
+  return (float)(gRng >> 8) / (float)(1u << 24);
+}
+
+uint64_t sim::trueUnixMs(uint64_t monoMs) {
+  return SIM_EPOCH_START_MS + monoMs - (uint64_t)((double)monoMs * gDriftPpm * 1e-6);
+}
+
+void sim::setSntpLink(uint32_t delayMs, float loss, double driftPpm, uint64_t downUntilMs) {
+  gDelayMs   = delayMs;
+  gLoss      = loss;
+  gDriftPpm  = driftPpm;
+  gDownUntil = downUntilMs;
+}
+
+sim::SntpServerStats sim::sntpServerStats() { return gStats; }
+
+static void putTs(uint8_t* p, uint64_t unixMs) {
+  uint32_t sec  = (uint32_t)(unixMs / 1000 + NTP_UNIX_DELTA);
+  uint32_t frac = (uint32_t)(((unixMs % 1000) << 32) / 1000);
+  for (int i = 0; i < 4; i++) {
+    p[i]     = (uint8_t)(sec >> (24 - 8 * i));
+    p[4 + i] = (uint8_t)(frac >> (24 - 8 * i));
+  }
+}
+
+int sntpNetSend(const uint8_t* pkt, size_t len) {
+  uint64_t now = sim::nowMs();
+  gStats.requests++;
+  if (len < 48 || now < gDownUntil || (gLoss > 0.0f && uniform() < gLoss)) {
+    gStats.lost++;
+    return 1;   // 보낸 것은 맞다 (응답이 안 올 뿐)
+  }
+  uint32_t rtt = (uint32_t)(gDelayMs * (0.5f + uniform()));
+  uint32_t out = (uint32_t)(rtt * (0.3f + 0.4f * uniform()));
+  if (replyCount == REPLY_RING) {
+    gStats.lost++;
+    return 1;
+  }
+  Reply& r = replies[(replyHead + replyCount++) % REPLY_RING];
+  r.at = now + rtt;
+  memset(r.pkt, 0, sizeof(r.pkt));
+  r.pkt[0] = (0 << 6) | (4 << 3) | 4;   // LI 0, VN 4, mode 4 (server)
+  r.pkt[1] = 2;                         // stratum
+  memcpy(r.pkt + 24, pkt + 40, 8);      // originate = 요청 transmit
+  putTs(r.pkt + 32, sim::trueUnixMs(now + out));
+  putTs(r.pkt + 40, sim::trueUnixMs(now + out));
+  return 1;
+}
+
+int sntpNetRecv(uint8_t* buf, size_t cap) {
+  if (!replyCount || replies[replyHead].at > sim::nowMs() || cap < 48) return 0;
+  memcpy(buf, replies[replyHead].pkt, 48);
+  replyHead = (replyHead + 1) % REPLY_RING;
+  replyCount--;
+  gStats.replies++;
+  return 48;
+}
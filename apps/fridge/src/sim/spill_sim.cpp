@@ -0,0 +1,33 @@
+#include <deque>
+#include "telemetry_buffer.h"
+
+// 네이티브 빌드용 플래시 스필: 프로세스 메모리의 deque. 용량은 실제 SPIFFS 파티션
+// (1.375MB / 16B 슬롯 - 여유 섹터)과 같게 잡는다.
+
+static const uint32_t SIM_SPILL_CAPACITY = (0x160000 / 4096 - 1) * 256;
+
+static std::deque<StatusRecord> spill;
+
+bool spillBegin() {
+  spill.clear();
+  return true;
+}
+
+bool spillAppend(const StatusRecord& r) {
+  if (spill.size() >= SIM_SPILL_CAPACITY) return false;
+  spill.push_back(r);
+  return true;
+}
+
+size_t spillPeek(StatusRecord* out, size_t max) {
+  size_t n = 0;
+  for (; n < max && n < spill.size(); n++) out[n] = spill[n];
+  return n;
+}
+
+void spillConsume(size_t n) {
+  while (n-- > 0 && !spill.empty()) spill.pop_front();
+}
+
+uint32_t spillCount()    { return (uint32_t)spill.size(); }
+uint32_t spillCapacity() { return SIM_SPILL_CAPACITY; }
@@ -0,0 +1,134 @@
+#include <string.h>
+#include <string>
+#include <vector>
+#include "config.h"
+#include "event_stream.h"
+#include "sim.h"
+
+// 네이티브 빌드용 SSE 소켓: 장치 쪽 송신 버퍼(lwip TCP_SND_BUF 와 같은 크기)를
+// 클라이언트가 정해진 속도로 비워 간다. 읽은 바이트는 클라이언트 쪽에서 줄 단위로
+// 해석해 상태 코드와 이벤트 수를 센다.
+
+static const uint32_t SIM_SOCK_BUF = 5744;
+
+struct SimStreamClient {
+  std::string request;
+  uint32_t    rate     = 0;       // 읽는 속도 (바이트/초)
+  int         handle   = -1;      // 수락 전 / 닫힌 뒤 = -1
+  bool        accepted = false;
+  uint32_t    inFlight = 0;       // 소켓 버퍼에 남은 바이트
+  uint64_t    drainMs  = 0;
+  char        line[64];
+  size_t      lineLen  = 0;
+  sim::StreamClientStats st = {};
+};
+
+static std::vector<SimStreamClient> simClients;
+static int handleOwner[STREAM_MAX_CLIENTS + 1];
+
+static SimStreamClient* ownerOf(int h) {
+  if (h < 0 || h > (int)STREAM_MAX_CLIENTS || handleOwner[h] < 0) return nullptr;
+  return &simClients[handleOwner[h]];
+}
+
+static void drain(SimStreamClient& c) {
+  uint64_t now = sim::nowMs();
+  uint64_t n   = (now - c.drainMs) * c.rate / 1000;
+  if (n == 0) return;   // 1바이트도 못 읽었으면 시각을 그대로 둬서 나머지를 누적
+  c.inFlight = n >= c.inFlight ? 0 : c.inFlight - (uint32_t)n;
+  c.drainMs  = now;
+}
+
+static void onLine(SimStreamClient& c) {
+  c.line[c.lineLen] = '\0';
+  int code;
+  if (c.st.httpStatus == 0 && sscanf(c.line, "HTTP/1.1 %d", &code) == 1) c.st.httpStatus = code;
+  else if (!strcmp(c.line, "event: status")) c.st.statusEvents++;
+  else if (!strcmp(c.line, "event: pid"))    c.st.pidEvents++;
+  else if (!strcmp(c.line, ": ping"))        c.st.pings++;
+  c.lineLen = 0;
+}
+
+// 청크 경계에 걸친 줄도 이어서 해석
+static void receive(SimStreamClient& c, const char* buf, size_t len) {
+  c.st.bytes += (uint32_t)len;
+  for (size_t i = 0; i < len; i++) {
+    char ch = buf[i];
+    if (ch == '\r') continue;
+    if (ch == '\n') { onLine(c); continue; }
+    if (c.lineLen < sizeof(c.line) - 1) c.line[c.lineLen++] = ch;
+  }
+}
+
+bool streamNetBegin() {
+  for (int& o : handleOwner) o = -1;
+  // 재부팅: 열려 있던 연결은 모두 끊긴다
+  for (SimStreamClient& c : simClients)
+    if (c.handle >= 0) {
+      c.handle    = -1;
+      c.st.closed = true;
+    }
+  return true;
+}
+
+int streamNetAccept() {
+  for (size_t i = 0; i < simClients.size(); i++) {
+    SimStreamClient& c = simClients[i];
+    if (c.accepted) continue;
+    for (int h = 0; h <= (int)STREAM_MAX_CLIENTS; h++) {
+      if (handleOwner[h] >= 0) continue;
+      handleOwner[h] = (int)i;
+      c.handle       = h;
+      c.accepted     = true;
+      c.drainMs      = sim::nowMs();
+      return h;
+    }
+    return -1;
+  }
+  return -1;
+}
+
+// 요청은 한 번에 다 도착한 것으로
+int streamNetRead(int h, char* buf, size_t cap) {
+  SimStreamClient* c = ownerOf(h);
+  if (!c) return -1;
+  size_t n = c->request.size() < cap ? c->request.size() : cap;
+  memcpy(buf, c->request.data(), n);
+  c->request.erase(0, n);
+  return (int)n;
+}
+
+int streamNetWrite(int h, const char* buf, size_t len) {
+  SimStreamClient* c = ownerOf(h);
+  if (!c) return -1;
+  drain(*c);
+  uint32_t room = SIM_SOCK_BUF - c->inFlight;
+  size_t   n    = len < room ? len : room;
+  c->inFlight += (uint32_t)n;
+  receive(*c, buf, n);
+  return (int)n;
+}
+
+void streamNetClose(int h) {
+  SimStreamClient* c = ownerOf(h);
+  if (!c) return;
+  c->handle      = -1;
+  c->st.closed   = true;
+  handleOwner[h] = -1;
+}
+
+namespace sim {
+
+int streamClientOpen(const char* request, uint32_t rateBytesPerSec) {
+  SimStreamClient c;
+  c.request = request;
+  c.rate    = rateBytesPerSec;
+  simClients.push_back(c);
+  return (int)simClients.size() - 1;
+}
+
+StreamClientStats streamClientStats(int client) {
+  return simClients[client].st;
+}
+
+}  // namespace sim
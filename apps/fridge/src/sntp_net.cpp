@@ -0,0 +1,86 @@
+#ifdef ESP32
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <lwip/dns.h>
+#include <lwip/sockets.h>
+#include "timesync.h"
+#include "log.h"
+
+// ==================== SNTP 소켓 ====================
+// NTPClient(WiFiUDP) 는 forceUpdate() 안에서 DNS 조회와 응답을 기다리며 loop 를 막았다.
+// 여기서는 DNS 결과를 lwIP 콜백으로 받고, UDP 소켓은 논블로킹이라 보내기 / 받기 모두 바로 돌아온다.
+// 요청마다 이름을 다시 조회한다 (보통 lwIP 캐시에서 바로, TTL 이 지나면 풀의 다른 서버로).
+
+enum DnsState : uint8_t { DNS_IDLE, DNS_BUSY, DNS_DONE, DNS_FAILED };
+
+static int               sock       = -1;
+static volatile uint8_t  dnsState   = DNS_IDLE;   // 콜백은 tcpip 태스크에서
+static volatile uint32_t dnsAddr    = 0;          // 네트워크 바이트 순서
+static uint32_t          serverAddr = 0;          // 마지막 요청을 보낸 주소 (다른 곳에서 온 데이터그램은 버림)
+
+static void onDns(const char*, const ip_addr_t* addr, void*) {
+  if (addr) {
+    dnsAddr  = ip4_addr_get_u32(ip_2_ip4(addr));
+    dnsState = DNS_DONE;
+  } else {
+    dnsState = DNS_FAILED;
+  }
+}
+
+static bool openSocket() {
+  if (sock >= 0) return true;
+  sock = lwip_socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+  if (sock < 0) {
+    LOG_W(TIME, "socket failed errno=%d", errno);
+    return false;
+  }
+  lwip_fcntl(sock, F_SETFL, lwip_fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+  return true;
+}
+
+int sntpNetSend(const uint8_t* pkt, size_t len) {
+  if (WiFi.status() != WL_CONNECTED || !openSocket()) return -1;
+  switch (dnsState) {
+    case DNS_BUSY:
+      return 0;
+    case DNS_FAILED:
+      dnsState = DNS_IDLE;
+      LOG_D(TIME, "dns lookup failed: %s", NTP_SERVER);
+      return -1;
+    case DNS_IDLE: {
+      ip_addr_t addr;
+      dnsState  = DNS_BUSY;
+      err_t err = dns_gethostbyname(NTP_SERVER, &addr, onDns, nullptr);
+      if (err == ERR_INPROGRESS) return 0;
+      dnsState = DNS_IDLE;
+      if (err != ERR_OK) return -1;
+      dnsAddr = ip4_addr_get_u32(ip_2_ip4(&addr));
+      break;
+    }
+    case DNS_DONE:
+      dnsState = DNS_IDLE;
+      break;
+  }
+
+  struct sockaddr_in to = {};
+  to.sin_family      = AF_INET;
+  to.sin_port        = htons(NTP_PORT);
+  to.sin_addr.s_addr = dnsAddr;
+  serverAddr         = dnsAddr;
+  int n = lwip_sendto(sock, pkt, len, 0, (struct sockaddr*)&to, sizeof(to));
+  return n == (int)len ? 1 : -1;
+}
+
+int sntpNetRecv(uint8_t* buf, size_t cap) {
+  if (sock < 0) return 0;
+  for (;;) {
+    struct sockaddr_in from = {};
+    socklen_t          fl   = sizeof(from);
+    int n = lwip_recvfrom(sock, buf, cap, MSG_DONTWAIT, (struct sockaddr*)&from, &fl);
+    if (n <= 0) return 0;   // EWOULDBLOCK = 아직 없음
+    if (from.sin_addr.s_addr == serverAddr && from.sin_port == htons(NTP_PORT)) return n;
+  }
+}
+
+#endif
@@ -0,0 +1,121 @@
+#include "status_codec.h"
+
+static const uint8_t STATUS_BATCH_FLAG_PELTIER = 0x01;
+static const uint8_t STATUS_BATCH_COOLING_BIT  = 0x80;
+
+static bool isNull16(int16_t v) { return v == STATUS_REC_NULL16; }
+
+// 둘 다 null 이거나 둘 다 값이 있고 i8 범위 안이면 델타 표현 가능
+static bool deltaFits(int16_t prev, int16_t cur, int8_t& d) {
+  if (isNull16(prev) || isNull16(cur)) {
+    d = 0;
+    return isNull16(prev) == isNull16(cur);
+  }
+  int32_t diff = (int32_t)cur - (int32_t)prev;
+  if (diff < -127 || diff > 127) return false;
+  d = (int8_t)diff;
+  return true;
+}
+
+bool StatusBatch::tryAdd(const StatusRecord& r, uint32_t ms, uint32_t maxSamples) {
+  if (maxSamples > STATUS_BATCH_MAX_SAMPLES) maxSamples = STATUS_BATCH_MAX_SAMPLES;
+  uint8_t power = (uint8_t)((r.power > 100 ? 100 : r.power) |
+                            ((r.flags & STATUS_REC_FLAG_COOLING) ? STATUS_BATCH_COOLING_BIT : 0));
+
+  if (n_ == 0) {
+    first_   = r;
+    prev_    = r;
+    firstMs_ = ms;
+    prevMs_  = ms;
+    samples_[0][0] = 0;
+    samples_[0][1] = 0;
+    samples_[0][2] = 0;
+    samples_[0][3] = power;
+    n_ = 1;
+    return true;
+  }
+
+  if (n_ >= maxSamples) return false;
+  if (r.target10 != first_.target10) return false;
+  if ((r.ts == 0) != (first_.ts == 0)) return false;   // NTP 동기 시점에서 끊는다
+  if ((r.flags & STATUS_REC_FLAG_PELTIER) != (first_.flags & STATUS_REC_FLAG_PELTIER)) return false;
+
+  uint32_t dt = (ms - prevMs_ + 500) / 1000;
+  if (dt > 255) return false;
+  int8_t dTemp, dHum;
+  if (!deltaFits(prev_.temp10, r.temp10, dTemp)) return false;
+  if (!deltaFits(prev_.hum10, r.hum10, dHum)) return false;
+
+  samples_[n_][0] = (uint8_t)dt;
+  samples_[n_][1] = (uint8_t)dTemp;
+  samples_[n_][2] = (uint8_t)dHum;
+  samples_[n_][3] = power;
+  n_++;
+  prevMs_ += dt * 1000;
+  // 델타는 직전 샘플 값 기준으로 누적되므로 null 이 아닌 값만 따라간다
+  prev_ = r;
+  return true;
+}
+
+static void putU16(uint8_t* p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static void putU32(uint8_t* p, uint32_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+}
+
+size_t StatusBatch::encode(uint8_t* out, size_t cap) const {
+  size_t len = encodedSize(n_);
+  if (n_ == 0 || cap < len) return 0;
+  out[0] = STATUS_BATCH_VERSION;
+  out[1] = (uint8_t)n_;
+  out[2] = (first_.flags & STATUS_REC_FLAG_PELTIER) ? STATUS_BATCH_FLAG_PELTIER : 0;
+  out[3] = 0;
+  putU32(out + 4, first_.ts);
+  putU16(out + 8, (uint16_t)first_.temp10);
+  putU16(out + 10, (uint16_t)first_.hum10);
+  putU16(out + 12, (uint16_t)first_.target10);
+  uint8_t* p = out + STATUS_BATCH_HEADER_SIZE;
+  for (uint32_t i = 0; i < n_; i++, p += STATUS_BATCH_SAMPLE_SIZE) {
+    p[0] = samples_[i][0];
+    p[1] = samples_[i][1];
+    p[2] = samples_[i][2];
+    p[3] = samples_[i][3];
+  }
+  return len;
+}
+
+static uint16_t getU16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint32_t getU32(const uint8_t* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+int statusBatchDecode(const uint8_t* buf, size_t len, StatusRecord* out, size_t max) {
+  if (len < STATUS_BATCH_HEADER_SIZE || buf[0] != STATUS_BATCH_VERSION) return -1;
+  uint32_t n = buf[1];
+  if (n == 0 || len != StatusBatch::encodedSize(n)) return -1;
+
+  StatusRecord cur;
+  cur.ts       = getU32(buf + 4);
+  cur.temp10   = (int16_t)getU16(buf + 8);
+  cur.hum10    = (int16_t)getU16(buf + 10);
+  cur.target10 = (int16_t)getU16(buf + 12);
+  uint8_t peltier = (buf[2] & STATUS_BATCH_FLAG_PELTIER) ? STATUS_REC_FLAG_PELTIER : 0;
+
+  const uint8_t* p = buf + STATUS_BATCH_HEADER_SIZE;
+  size_t k = 0;
+  for (uint32_t i = 0; i < n; i++, p += STATUS_BATCH_SAMPLE_SIZE) {
+    if (cur.ts) cur.ts += p[0];
+    if (!isNull16(cur.temp10)) cur.temp10 = (int16_t)(cur.temp10 + (int8_t)p[1]);
+    if (!isNull16(cur.hum10))  cur.hum10  = (int16_t)(cur.hum10 + (int8_t)p[2]);
+    cur.power = p[3] & 0x7F;
+    cur.flags = peltier | ((p[3] & STATUS_BATCH_COOLING_BIT) ? STATUS_REC_FLAG_COOLING : 0);
+    if (k < max) out[k++] = cur;
+  }
+  return (int)k;
+}
@@ -0,0 +1,261 @@
+#include <Arduino.h>
+#include <string.h>
+#include "storage.h"
+#include "zone.h"
+#include "log.h"
+
+char lastRestartCmdId[CMD_ID_MAX] = "";
+
+// 존마다 자기 네임스페이스(ZONE_TABLE[z].nvsNamespace)에 같은 형식의 blob 하나.
+// 재시작 id 는 장치 공통이므로 존 0 blob 에만 기록한다.
+static const char* NVS_BLOB_KEY  = "state";
+static const char* NVS_SCHED_KEY = "sched";
+
+// ---------- 영속 상태 (NVS blob 하나) ----------
+// 필드를 추가하면 버전을 올리고 loadBlob() 에서 이전 버전을 처리한다
+static const uint8_t NVS_BLOB_VERSION = 1;
+
+struct __attribute__((packed)) PersistedState {
+  uint8_t  version;
+  uint8_t  hasTarget;
+  uint8_t  peltierEnabled;
+  uint8_t  reserved;
+  float    target;
+  float    kp;
+  float    ki;
+  float    kd;
+  uint32_t writes;               // 이 blob 을 기록한 누적 횟수
+  char     restartId[CMD_ID_MAX];
+};
+
+static PersistedState persisted[ZONE_COUNT];   // 마지막으로 플래시에 있는 내용
+static PersistedState pending[ZONE_COUNT];     // RAM 최신 값
+static uint32_t       dirtyMask    = 0;        // 기록 대기 중인 존 (bit = 존 번호)
+static FermSchedule   schedPersisted[ZONE_COUNT];
+static FermSchedule   schedPending[ZONE_COUNT];
+static uint32_t       schedDirtyMask = 0;
+static bool           dirty        = false;
+static unsigned long  firstDirtyMs = 0;
+static unsigned long  lastDirtyMs  = 0;
+static StorageStats   stats        = {};
+
+static void defaults(PersistedState& s) {
+  memset(&s, 0, sizeof(s));
+  s.version        = NVS_BLOB_VERSION;
+  s.peltierEnabled = 1;
+  s.kp             = PID_KP_DEFAULT;
+  s.ki             = PID_KI_DEFAULT;
+  s.kd             = PID_KD_DEFAULT;
+}
+
+// blob 이 없으면 개별 키로 저장하던 이전 형식에서 가져온다
+static void loadLegacyKeys(PersistedState& s) {
+  s.hasTarget      = prefs.getBool("has_target", false) ? 1 : 0;
+  s.target         = prefs.getFloat("target", 0.0f);
+  s.peltierEnabled = prefs.getBool("peltier_en", true) ? 1 : 0;
+  prefs.getString("restart_id", s.restartId, sizeof(s.restartId));
+}
+
+static bool loadBlob(PersistedState& s) {
+  if (prefs.getBytesLength(NVS_BLOB_KEY) != sizeof(PersistedState)) return false;
+  PersistedState tmp;
+  if (prefs.getBytes(NVS_BLOB_KEY, &tmp, sizeof(tmp)) != sizeof(tmp)) return false;
+  if (tmp.version != NVS_BLOB_VERSION) return false;
+  tmp.restartId[CMD_ID_MAX - 1] = '\0';
+  s = tmp;
+  return true;
+}
+
+static void loadSchedule(FermSchedule& s) {
+  memset(&s, 0, sizeof(s));
+  if (prefs.getBytesLength(NVS_SCHED_KEY) != sizeof(FermSchedule)) return;
+  FermSchedule tmp;
+  if (prefs.getBytes(NVS_SCHED_KEY, &tmp, sizeof(tmp)) != sizeof(tmp)) return;
+  if (tmp.version != SCHEDULE_VERSION || tmp.count > SCHEDULE_SEGMENTS_MAX) return;
+  s = tmp;
+}
+
+static void loadZone(uint8_t z) {
+  PersistedState& p = persisted[z];
+  defaults(p);
+  prefs.begin(zoneConfig(z).nvsNamespace, true);
+  bool fromBlob = loadBlob(p);
+  // 개별 키 형식은 단일 존 시절 것이므로 존 0 네임스페이스에만 있다
+  if (!fromBlob && z == 0) loadLegacyKeys(p);
+  loadSchedule(schedPersisted[z]);
+  prefs.end();
+  // 검사 전에 저장된 게인은 NaN / 음수 / 과대값일 수 있다. 그대로 쓰면 부팅마다 제어가 망가지므로 기본값으로
+  if (!pidGainValid(p.kp) || !pidGainValid(p.ki) || !pidGainValid(p.kd)) {
+    LOG_W(NVS, "%s stored PID gains out of range (kp=%.2f ki=%.2f kd=%.2f), using defaults",
+          zoneConfig(z).name, p.kp, p.ki, p.kd);
+    p.kp = PID_KP_DEFAULT;
+    p.ki = PID_KI_DEFAULT;
+    p.kd = PID_KD_DEFAULT;
+  }
+  pending[z]      = p;
+  schedPending[z] = schedPersisted[z];
+
+  ZoneStatus& zs    = gZone[z];
+  zs.hasTarget      = p.hasTarget != 0;
+  zs.target         = p.target;
+  zs.peltierEnabled = p.peltierEnabled != 0;
+  // 제어 태스크 시작 전이므로 pid 를 직접 초기화해도 된다
+  pid.kp[z] = p.kp;
+  pid.ki[z] = p.ki;
+  pid.kd[z] = p.kd;
+  pid.core.setGains(z, p.kp, p.ki, p.kd);
+  gControl[z].kp = p.kp;
+  gControl[z].ki = p.ki;
+  gControl[z].kd = p.kd;
+  LOG_I(NVS, "%s %s hasTarget=%s target=%.2f peltierEnabled=%s kp=%.2f ki=%.2f kd=%.2f writes=%u",
+        zoneConfig(z).name, fromBlob ? "blob" : (z == 0 ? "legacy keys" : "defaults"),
+        zs.hasTarget ? "true" : "false", zs.target, zs.peltierEnabled ? "true" : "false",
+        p.kp, p.ki, p.kd, (unsigned)p.writes);
+}
+
+static uint32_t lifetimeWrites() {
+  uint32_t n = 0;
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) n += persisted[z].writes;
+  return n;
+}
+
+void loadFromNVS() {
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) loadZone(z);
+  dirty          = false;
+  dirtyMask      = 0;
+  schedDirtyMask = 0;
+  stats.lifetimeWrites = lifetimeWrites();
+  memcpy(lastRestartCmdId, persisted[0].restartId, sizeof(lastRestartCmdId));
+  LOG_I(NVS, "lastRestartCmdId=%s", lastRestartCmdId);
+}
+
+// ---------- write-behind ----------
+// 병합 타이밍은 존 공통: 마지막 변경 후 한 번에 dirty 인 존들을 모두 기록
+static void touch() {
+  unsigned long now = millis();
+  if (!dirty) firstDirtyMs = now;
+  lastDirtyMs = now;
+  dirty       = true;
+  stats.requests++;
+}
+
+static void markDirty(uint8_t z) {
+  dirtyMask |= 1UL << z;
+  touch();
+}
+
+void storeTarget(uint8_t zone, bool hasTarget, float target) {
+  if (zone >= ZONE_COUNT) return;
+  pending[zone].hasTarget = hasTarget ? 1 : 0;
+  pending[zone].target    = target;
+  markDirty(zone);
+}
+
+void storePeltierEnabled(uint8_t zone, bool en) {
+  if (zone >= ZONE_COUNT) return;
+  pending[zone].peltierEnabled = en ? 1 : 0;
+  markDirty(zone);
+}
+
+void storePidGains(uint8_t zone, float kp, float ki, float kd) {
+  if (zone >= ZONE_COUNT) return;
+  pending[zone].kp = kp;
+  pending[zone].ki = ki;
+  pending[zone].kd = kd;
+  markDirty(zone);
+}
+
+void storeRestartCmdId(const char* id) {
+  strncpy(pending[0].restartId, id, sizeof(pending[0].restartId) - 1);
+  pending[0].restartId[sizeof(pending[0].restartId) - 1] = '\0';
+  markDirty(0);
+}
+
+void storeSchedule(uint8_t zone, const FermSchedule& s) {
+  if (zone >= ZONE_COUNT) return;
+  schedPending[zone] = s;
+  schedDirtyMask |= 1UL << zone;
+  touch();
+}
+
+bool storedSchedule(uint8_t zone, FermSchedule& out) {
+  if (zone >= ZONE_COUNT || schedPending[zone].count == 0) return false;
+  out = schedPending[zone];
+  return true;
+}
+
+// 스케줄 blob (쓰기 횟수는 상태 blob 쪽에만 센다)
+static bool commitSchedule(uint8_t z) {
+  if (memcmp(&schedPending[z], &schedPersisted[z], sizeof(FermSchedule)) == 0) {
+    stats.skipped++;
+    return true;
+  }
+  prefs.begin(zoneConfig(z).nvsNamespace, false);
+  size_t n = schedPending[z].count ? prefs.putBytes(NVS_SCHED_KEY, &schedPending[z], sizeof(FermSchedule))
+                                   : (prefs.remove(NVS_SCHED_KEY) ? sizeof(FermSchedule) : 0);
+  prefs.end();
+  if (n != sizeof(FermSchedule)) {
+    stats.failures++;
+    LOG_E(NVS, "%s schedule commit failed", zoneConfig(z).name);
+    return false;
+  }
+  schedPersisted[z] = schedPending[z];
+  stats.commits++;
+  return true;
+}
+
+// false = 기록 실패 (다시 시도해야 함)
+static bool commitZone(uint8_t z) {
+  PersistedState& p = pending[z];
+  PersistedState& f = persisted[z];
+  // writes 는 비교에서 제외: 내용이 같으면 플래시를 건드리지 않는다
+  p.writes = f.writes;
+  if (memcmp(&p, &f, sizeof(p)) == 0) {
+    stats.skipped++;
+    return true;
+  }
+  p.writes = f.writes + 1;
+  prefs.begin(zoneConfig(z).nvsNamespace, false);
+  size_t n = prefs.putBytes(NVS_BLOB_KEY, &p, sizeof(p));
+  prefs.end();
+  if (n != sizeof(p)) {
+    stats.failures++;
+    LOG_E(NVS, "%s commit failed", zoneConfig(z).name);
+    return false;
+  }
+  f = p;
+  stats.commits++;
+  LOG_I(NVS, "%s commit #%u (%u requests since boot)",
+        zoneConfig(z).name, (unsigned)f.writes, (unsigned)stats.requests);
+  return true;
+}
+
+static void commit() {
+  uint32_t failed = 0, schedFailed = 0;
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    if ((dirtyMask & (1UL << z)) && !commitZone(z)) failed |= 1UL << z;
+    if ((schedDirtyMask & (1UL << z)) && !commitSchedule(z)) schedFailed |= 1UL << z;
+  }
+  dirtyMask            = failed;
+  schedDirtyMask       = schedFailed;
+  dirty                = (failed | schedFailed) != 0;   // 실패한 것만 다음 tick 에 다시 시도
+  if (dirty) lastDirtyMs = millis();
+  stats.lifetimeWrites = lifetimeWrites();
+}
+
+void storageTick() {
+  if (!dirty) return;
+  unsigned long now = millis();
+  if (now - lastDirtyMs < NVS_COALESCE_MS && now - firstDirtyMs < NVS_MAX_DELAY_MS) return;
+  commit();
+}
+
+void storageFlush() {
+  if (dirty) commit();
+}
+
+StorageStats storageStats() {
+  StorageStats s = stats;
+  s.pending      = dirty;
+  return s;
+}
@@ -0,0 +1,61 @@
+#ifdef ESP32
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <errno.h>
+#include <lwip/sockets.h>
+#include "config.h"
+#include "event_stream.h"
+
+// ==================== SSE 소켓 ====================
+// WiFiServer 로 수락만 하고, 송신은 lwip send(MSG_DONTWAIT) 로 직접 한다.
+// WiFiClient::write() 는 소켓 버퍼가 찰 때까지 재시도하며 loop 를 붙잡기 때문.
+
+static WiFiServer server(STREAM_PORT);
+static WiFiClient conns[STREAM_MAX_CLIENTS + 1];   // 마지막 칸 = 거절 응답용
+// 칸 사용 여부. WiFiClient 의 bool 은 connected() 라 상대가 먼저 끊으면 거짓이 되지만,
+// event_stream 이 streamNetClose() 하기 전까지 그 핸들은 아직 주인이 있다.
+static bool       used[STREAM_MAX_CLIENTS + 1];
+
+bool streamNetBegin() {
+  server.begin();
+  server.setNoDelay(true);
+  for (int h = 0; h <= (int)STREAM_MAX_CLIENTS; h++) used[h] = false;
+  return true;
+}
+
+int streamNetAccept() {
+  if (!server.hasClient()) return -1;
+  for (int h = 0; h <= (int)STREAM_MAX_CLIENTS; h++) {
+    if (used[h]) continue;
+    conns[h] = server.available();
+    if (!conns[h]) return -1;
+    used[h] = true;
+    return h;
+  }
+  // 거절 칸까지 차 있으면 (직전 거절이 아직 안 닫힘) 다음 틱에
+  return -1;
+}
+
+int streamNetRead(int h, char* buf, size_t cap) {
+  WiFiClient& c = conns[h];
+  if (!c.connected()) return -1;
+  int avail = c.available();
+  if (avail <= 0) return 0;
+  return c.read((uint8_t*)buf, (size_t)avail < cap ? (size_t)avail : cap);
+}
+
+int streamNetWrite(int h, const char* buf, size_t len) {
+  WiFiClient& c = conns[h];
+  if (!c.connected()) return -1;
+  int n = send(c.fd(), buf, len, MSG_DONTWAIT);
+  if (n >= 0) return n;
+  return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+}
+
+void streamNetClose(int h) {
+  conns[h].stop();
+  used[h] = false;
+}
+
+#endif  // ESP32
@@ -0,0 +1,570 @@
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <math.h>
+#include "control.h"
+#include "telemetry.h"
+#include "telemetry_buffer.h"
+#include "telemetry_agg.h"
+#include "status_codec.h"
+#include "storage.h"
+#include "metrics.h"
+#include "mqtt_out.h"
+#include "commands.h"
+#include "event_stream.h"
+#include "history.h"
+#include "report_policy.h"
+#include "schedule.h"
+#include "json_pool.h"
+#include "text_writer.h"
+#include "timesync.h"
+#include "warm_boot.h"
+#include "zone.h"
+#include "log.h"
+#include "ota.h"
+
+StatusState     gStatus;
+ZoneStatus      gZone[ZONE_COUNT];
+ControlSnapshot gControl[ZONE_COUNT];
+
+// 바이너리 상태 배치 (존마다 따로 쌓아서 존별 토픽으로)
+static bool        statusBatchOn = STATUS_BATCH_ENABLED;
+static StatusBatch statusBatch[ZONE_COUNT];
+static uint8_t     statusBatchBuf[StatusBatch::encodedSize(STATUS_BATCH_SAMPLES)];
+static uint32_t    statusBatchSent    = 0;
+static uint32_t    statusBatchSamples = 0;
+
+// ---------- Status JSON ----------
+// 주기 발행 경로 전용 버퍼 (loop 태스크에서만 사용)
+static char statusBuf[384];   // 스케줄 진행 포함 ~300B
+static char ackBuf[256];
+// JsonDocument 고정 풀. 상태: extras 포함 ~125 멤버 + 존 / 사유 / 스케줄 / 부팅 / 시각 문자열
+static JsonPool<jsonPoolBytes(3, 256)> statusPool;
+static JsonPool<jsonPoolBytes(1, 64)>  healthPool;
+static JsonPool<jsonPoolBytes(1, 160)> ackPool;   // id / cmd / error 복사
+
+size_t buildStatusJson(uint8_t zone, char* out, size_t cap, bool includeExtras, const char* reason) {
+  JsonDocument doc(statusPool.reset());   // extras(boot/heap/pid/control/sensor/buffer/time/batch/agg/report/nvs/commands/stream) 포함 시 ~1700B
+  const ZoneStatus&      zs = gZone[zone];
+  const ControlSnapshot& cs = gControl[zone];
+  // 존이 하나면 기존 페이로드 그대로 (존 구분은 토픽으로도 되지만 /status 응답에는 필요)
+  if (ZONE_COUNT > 1) doc["zone"] = zoneConfig(zone).name;
+  if (isfinite(zs.temp))
+    doc["temp"] = (float)(roundf(zs.temp * 10.0f) / 10.0f);
+  else
+    doc["temp"] = nullptr;
+  if (isfinite(zs.humidity))
+    doc["humidity"] = (float)(roundf(zs.humidity * 10.0f) / 10.0f);
+  else
+    doc["humidity"] = nullptr;
+  // temp 는 필터 추정값. 원본 측정값과 추정 변화율(°C/분)도 함께
+  if (isfinite(zs.tempRaw))
+    doc["temp_raw"] = (float)(roundf(zs.tempRaw * 10.0f) / 10.0f);
+  else
+    doc["temp_raw"] = nullptr;
+  doc["temp_rate"] = (float)(roundf(zs.tempRate * 60.0f * 100.0f) / 100.0f);
+
+  doc["power"]           = zs.power;
+  doc["peltier_enabled"] = zs.peltierEnabled;
+
+  if (zs.hasTarget)
+    doc["target"] = (float)zs.target;
+  else
+    doc["target"] = nullptr;
+
+  doc["ts"] = gStatus.tsMs;   // unix ms (0 = 시각 모름)
+  if (reason) doc["reason"] = reason;
+
+  // 발효 스케줄 진행 (있을 때만)
+  ScheduleProgress sp = scheduleProgress(zone);
+  if (sp.state != SCHED_STATE_NONE) {
+    JsonObject sched  = doc.createNestedObject("schedule");
+    sched["state"]    = scheduleStateName(sp.state);
+    sched["step"]     = sp.step + 1;
+    sched["steps"]    = sp.steps;
+    sched["elapsed"]  = sp.elapsedSec;
+    sched["total"]    = sp.totalSec;
+  }
+
+  if (includeExtras) {
+    doc["uptime"]         = gStatus.uptimeSec;
+    doc["wifi_rssi"]      = gStatus.wifiRssi;
+    doc["mqtt_connected"] = gStatus.mqttConnected;
+    // 마지막 부팅: 리셋 사유, 웜 복원한 존 수, 부팅 → WiFi / 첫 출력 / 첫 발행 (ms, 0 = 아직)
+    BootInfo bi              = bootInfo();
+    JsonObject bootObj       = doc.createNestedObject("boot");
+    bootObj["reason"]        = bi.reason;
+    bootObj["warm_zones"]    = bi.zonesRestored;
+    bootObj["wifi_cached"]   = bi.wifiCached;
+    bootObj["wifi_ms"]       = bi.wifiMs;
+    bootObj["first_pwm_ms"]  = bi.firstPwmMs;
+    bootObj["first_publish_ms"] = bi.firstPublishMs;
+    // 힙 상태
+    JsonObject heapInfo     = doc.createNestedObject("heap");
+    heapInfo["free"]        = gStatus.heapFree;
+    heapInfo["max_block"]   = gStatus.heapMaxBlock;
+    heapInfo["min_free"]    = gStatus.heapMinFree;
+    // PID 디버그 정보 (제어 태스크 최신 스냅샷)
+    JsonObject pidInfo    = doc.createNestedObject("pid");
+    pidInfo["kp"]         = cs.kp;
+    pidInfo["ki"]         = cs.ki;
+    pidInfo["kd"]         = cs.kd;
+    pidInfo["integral"]   = (float)(roundf(cs.integral * 10.0f) / 10.0f);
+    pidInfo["output_pct"] = (float)(roundf(cs.outputPct * 10.0f) / 10.0f);
+    pidInfo["pwm"]        = cs.outputPWM;
+    pidInfo["pwm_max"]    = PELTIER_ABS_MAX_PWM;   // LEDC 해상도에 따라 (11비트 → 1739)
+    pidInfo["cooling"]    = cs.coolingActive;
+    // 제어 주기 타이밍 (모든 존 공통)
+    JsonObject ctlInfo       = doc.createNestedObject("control");
+    ctlInfo["period_ms"]     = CONTROL_PERIOD_MS;
+    ctlInfo["zones"]         = ZONE_COUNT;
+    ctlInfo["seq"]           = cs.seq;
+    ctlInfo["jitter_max_us"] = cs.jitterMaxUs;
+    ctlInfo["jitter_avg_us"] = cs.jitterAvgUs;
+    ctlInfo["exec_max_us"]   = cs.execMaxUs;
+    ctlInfo["overruns"]      = cs.overruns;
+    ctlInfo["snap_drops"]    = cs.snapDrops;
+    ctlInfo["cmd_drops"]     = controlCmdDrops();
+    // 센서 실패/거부 사유별 누적 (이 존)
+    JsonObject sensorInfo    = doc.createNestedObject("sensor");
+    sensorInfo["no_response"] = cs.sensorNoResponse;
+    sensorInfo["timing"]      = cs.sensorTimingErrs;
+    sensorInfo["checksum"]    = cs.sensorChecksumErrs;
+    sensorInfo["range"]       = cs.sensorRangeRejects;
+    sensorInfo["outliers"]    = cs.sensorOutliers;
+    sensorInfo["recoveries"]  = cs.sensorRecoveries;
+    // 저장 후 전달 버퍼
+    BufferStats bs           = bufferStats();
+    JsonObject bufInfo       = doc.createNestedObject("buffer");
+    bufInfo["ram"]           = bs.ramCount;
+    bufInfo["ram_cap"]       = bs.ramCapacity;
+    bufInfo["spill"]         = bs.spillCount;
+    bufInfo["spill_cap"]     = bs.spillCapacity;
+    bufInfo["high_water"]    = bs.highWater;
+    bufInfo["buffered"]      = bs.buffered;
+    bufInfo["replayed"]      = bs.replayed;
+    bufInfo["dropped"]       = bs.dropped;
+    bufInfo["batches"]       = bs.batches;
+    bufInfo["publish_fails"] = bs.publishFails;
+    bufInfo["backstamped"]   = bs.backstamped;
+    // 시각 (SNTP 기준 / 마지막 샘플 오차 / 추정 드리프트)
+    TimeStats tms            = timeStats();
+    JsonObject timeInfo      = doc.createNestedObject("time");
+    timeInfo["source"]       = timeSourceName(tms.source);
+    timeInfo["offset_ms"]    = tms.offsetMs;
+    timeInfo["rtt_ms"]       = tms.rttMs;
+    timeInfo["drift_ppm"]    = (float)tms.driftPpb / 1000.0f;
+    timeInfo["poll_s"]       = tms.pollMs / 1000;
+    // 바이너리 상태 배치
+    JsonObject batchInfo     = doc.createNestedObject("batch");
+    batchInfo["enabled"]     = statusBatchOn;
+    batchInfo["pending"]     = statusBatch[zone].count();
+    batchInfo["sent"]        = statusBatchSent;
+    batchInfo["samples"]     = statusBatchSamples;
+    batchInfo["fails"]       = gMetricCounters.batchPublishFails;
+    // 분 단위 집계
+    AggStats as              = aggStats();
+    JsonObject aggInfo       = doc.createNestedObject("agg");
+    aggInfo["enabled"]       = statusAggEnabled();
+    aggInfo["pending"]       = as.pending;
+    aggInfo["published"]     = as.published;
+    aggInfo["dropped"]       = as.dropped;
+    // 보고 정책 (이 존)
+    const ReportPolicy& rp   = reportPolicy(zone);
+    JsonObject reportInfo    = doc.createNestedObject("report");
+    reportInfo["heartbeat"]  = rp.heartbeatSec;
+    reportInfo["temp_band"]  = rp.tempBand;
+    reportInfo["humidity_band"] = rp.humBand;
+    reportInfo["power_band"] = rp.powerBand;
+    // NVS write-behind
+    StorageStats ss          = storageStats();
+    JsonObject nvsInfo       = doc.createNestedObject("nvs");
+    nvsInfo["requests"]      = ss.requests;
+    nvsInfo["commits"]       = ss.commits;
+    nvsInfo["skipped"]       = ss.skipped;
+    nvsInfo["failures"]      = ss.failures;
+    nvsInfo["lifetime_writes"] = ss.lifetimeWrites;
+    nvsInfo["pending"]       = ss.pending;
+    // 명령 큐 / 중복 캐시
+    CommandStats cs          = commandStats();
+    JsonObject cmdInfo       = doc.createNestedObject("commands");
+    cmdInfo["received"]      = cs.received;
+    cmdInfo["executed"]      = cs.executed;
+    cmdInfo["duplicates"]    = cs.duplicates;
+    cmdInfo["queue_drops"]   = cs.queueDrops;
+    cmdInfo["cached"]        = cs.cached;
+    // SSE 구독자
+    StreamStats st           = streamStats();
+    JsonObject streamInfo    = doc.createNestedObject("stream");
+    streamInfo["clients"]    = st.clients;
+    streamInfo["accepted"]   = st.accepted;
+    streamInfo["rejected"]   = st.rejected;
+    streamInfo["slow_drops"] = st.slowDrops;
+    streamInfo["events"]     = st.events;
+  }
+
+  return serializeJson(doc, out, cap);
+}
+
+size_t buildHealthJson(char* out, size_t cap, bool ok, const char* errCodeOrNull) {
+  JsonDocument doc(healthPool.reset());
+  doc["status"] = ok ? "ok" : "error";
+  if (!ok) doc["error"] = errCodeOrNull;
+  doc["uptime"] = gStatus.uptimeSec;
+  return serializeJson(doc, out, cap);
+}
+
+// ---------- MQTT publish helpers ----------
+void publishAck(uint8_t zone, const char* id, const char* cmd, bool success,
+                const char* errorOrNull,
+                AckValueMode valueMode,
+                float fvalue, bool bvalue,
+                MqttOutDone done) {
+  JsonDocument doc(ackPool.reset());
+  doc["id"]      = id;
+  doc["cmd"]     = cmd;
+  doc["success"] = success;
+  doc["error"]   = success ? nullptr : errorOrNull;
+  if      (valueMode == ACK_VALUE_FLOAT) doc["value"] = fvalue;
+  else if (valueMode == ACK_VALUE_NULL)  doc["value"] = nullptr;
+  else if (valueMode == ACK_VALUE_BOOL)  doc["value"] = bvalue;
+  doc["ts"] = nowUnixMs();
+
+  const char* topic = zoneTopic(zone, ZONE_TOPIC_ACK);
+  size_t len = serializeJson(doc, ackBuf, sizeof(ackBuf));
+  LOG_I(CMD, "ACK(QoS2) -> %s id=%s cmd=%s success=%s", topic, id, cmd, success ? "true" : "false");
+  if (!mqttOutPublish(topic, ackBuf, len, 2, done)) {
+    gMetricCounters.ackPublishFails++;
+    if (done) done(0, false);
+  }
+}
+
+bool publishStatus(uint8_t zone, ReportReason reason) {
+  StageTimer stage(STAGE_PUBLISH);
+  const char* topic = zoneTopic(zone, ZONE_TOPIC_STATUS);
+  size_t len = buildStatusJson(zone, statusBuf, sizeof(statusBuf), false, reportReasonName(reason));
+  LOG_D(STATUS, "STATUS(QoS1) -> %s reason=%s bytes=%u", topic, reportReasonName(reason), (unsigned)len);
+  bool ok = mqttOutPublish(topic, statusBuf, len, 1);
+  if (ok) bootMarkPublish();
+  else    gMetricCounters.statusPublishFails++;
+  reportMark(zone, reason, millis());
+  return ok;
+}
+
+// 보고 정책이 보내라고 하면 발행. 실패한 상태는 버퍼에 (bufferStore 가 간격 조절)
+static void reportStatus(uint8_t zone) {
+  ReportReason r = reportCheck(zone, millis());
+  if (r != REPORT_NONE && !publishStatus(zone, r)) bufferStore(makeStatusRecord(zone));
+}
+
+void statusReportNow(uint8_t zone) {
+  if (zone >= ZONE_COUNT || !mqtt.connected() || timeHolding()) return;
+  reportStatus(zone);
+  streamStatus(zone);
+  streamFlush();
+}
+
+// ---------- Binary status batch ----------
+static bool flushStatusBatch(uint8_t zone) {
+  StatusBatch& b = statusBatch[zone];
+  if (b.empty()) return true;
+  const char* topic = zoneTopic(zone, ZONE_TOPIC_STATUS_BATCH);
+  size_t len = b.encode(statusBatchBuf, sizeof(statusBatchBuf));
+  bool   ok  = len > 0 && mqttOutPublish(topic, statusBatchBuf, len, 1);
+  LOG_I(STATUS, "STATUS BATCH(QoS1) -> %s samples=%u bytes=%u %s", topic,
+        (unsigned)b.count(), (unsigned)len, ok ? "ok" : "FAILED");
+  if (ok) {
+    statusBatchSent++;
+    statusBatchSamples += b.count();
+  } else {
+    // 발행 실패 = 끊김 또는 발행 큐가 가득 참. 이후 상태는 저장 후 전달 버퍼가 맡는다
+    gMetricCounters.batchPublishFails++;
+  }
+  b.clear();
+  return ok;
+}
+
+static void sampleStatusBatch(uint8_t zone) {
+  StatusBatch&  b   = statusBatch[zone];
+  StatusRecord  r   = makeStatusRecord(zone);
+  unsigned long now = millis();
+  if (r.flags & STATUS_REC_FLAG_MONO) r.ts = 0;   // 배치 형식의 ts 0 = 시각 모름
+  if (!b.tryAdd(r, now, STATUS_BATCH_SAMPLES)) {
+    flushStatusBatch(zone);
+    b.tryAdd(r, now, STATUS_BATCH_SAMPLES);
+  }
+  if (b.count() >= STATUS_BATCH_SAMPLES || now - b.firstMs() >= STATUS_BATCH_MAX_AGE_MS)
+    flushStatusBatch(zone);
+}
+
+void setStatusBatchEnabled(bool on) {
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    if (statusBatchOn && !on && mqtt.connected()) flushStatusBatch(z);
+    statusBatch[z].clear();
+  }
+  statusBatchOn = on;
+}
+
+bool statusBatchEnabled() { return statusBatchOn; }
+
+// 제어 태스크 스냅샷을 받아 존별 상태를 갱신하고, 새 값이 있는 존마다 발행 여부 판단
+void statusTick() {
+  StageTimer stage(STAGE_STATUS);
+  ControlSnapshot s;
+  uint32_t fresh = 0;   // 새 스냅샷을 받은 존 (bit = 존 번호)
+  while (controlPoll(s)) {
+    if (s.zone >= ZONE_COUNT) continue;
+    // 존마다 가장 최근 것만 사용
+    ZoneStatus& zs = gZone[s.zone];
+    bool wasCooling  = gControl[s.zone].coolingActive;
+    gControl[s.zone] = s;
+    zs.temp          = s.temp;
+    zs.humidity      = s.humidity;
+    zs.tempRaw       = s.tempRaw;
+    zs.tempRate      = s.tempRate;
+    zs.power         = s.power;
+    fresh |= 1UL << s.zone;
+    historyAdd(s);
+    aggAdd(s);
+    // 전이는 스냅샷마다 (같은 틱에 여러 개 와도 놓치지 않게)
+    if (s.coolingActive != wasCooling) streamPidEdge(s.zone, s.coolingActive);
+  }
+  if (!fresh) return;
+  updateRuntimeFields();
+  scheduleTick();   // 스케줄 목표를 반영한 뒤 발행 판단
+
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    if (!(fresh & (1UL << z))) continue;
+    // 연결이 없거나 발행이 실패한 상태는 버퍼에 저장 (bufferStore 가 간격 조절).
+    // 부팅 직후 시각을 모르면 ts=0 으로 내보내지 않고 버퍼에 두었다가 동기 후 시각을 붙여 보낸다
+    if (!mqtt.connected() || timeHolding()) {
+      bufferStore(makeStatusRecord(z));
+    } else {
+      if (statusBatchOn) sampleStatusBatch(z);
+      reportStatus(z);
+    }
+    streamStatus(z);
+  }
+  aggFlush();
+  streamFlush();
+}
+
+// ---------- Metrics (Prometheus 텍스트) ----------
+static void putSummary(TextWriter& tw, const char* name, const char* label, const LatencyHist& h) {
+  tw.put("%s{%s,quantile=\"0.5\"} %lu\n", name, label, (unsigned long)h.percentile(0.50f));
+  tw.put("%s{%s,quantile=\"0.99\"} %lu\n", name, label, (unsigned long)h.percentile(0.99f));
+  tw.put("%s_sum{%s} %llu\n", name, label, (unsigned long long)h.sum());
+  tw.put("%s_count{%s} %lu\n", name, label, (unsigned long)h.count());
+}
+
+static void putCounter(TextWriter& tw, const char* name, const char* label, uint32_t v) {
+  if (label) tw.put("%s{%s} %lu\n", name, label, (unsigned long)v);
+  else       tw.put("%s %lu\n", name, (unsigned long)v);
+}
+
+// 존별 시리즈 라벨: zone="<name>"[,extra]
+static const char* zoneLabel(char* buf, size_t cap, uint8_t z, const char* extra) {
+  if (extra) snprintf(buf, cap, "zone=\"%s\",%s", zoneConfig(z).name, extra);
+  else       snprintf(buf, cap, "zone=\"%s\"", zoneConfig(z).name);
+  return buf;
+}
+
+size_t buildMetricsText(char* out, size_t cap) {
+  TextWriter tw(out, cap);
+  char label[64];
+
+  // 구간별 실행 시간
+  tw.put("# HELP fridge_stage_latency_us Execution time per loop/control stage (us)\n");
+  tw.put("# TYPE fridge_stage_latency_us summary\n");
+  for (uint8_t i = 0; i < STAGE_COUNT; i++) {
+    snprintf(label, sizeof(label), "stage=\"%s\"", metricStageName((MetricStage)i));
+    putSummary(tw, "fridge_stage_latency_us", label, gStageHist[i]);
+  }
+  tw.put("# TYPE fridge_stage_latency_max_us gauge\n");
+  for (uint8_t i = 0; i < STAGE_COUNT; i++) {
+    snprintf(label, sizeof(label), "stage=\"%s\"", metricStageName((MetricStage)i));
+    putCounter(tw, "fridge_stage_latency_max_us", label, gStageHist[i].max());
+  }
+
+  // 제어 주기 오차
+  tw.put("# HELP fridge_control_jitter_us |actual control period - nominal| (us)\n");
+  tw.put("# TYPE fridge_control_jitter_us summary\n");
+  putSummary(tw, "fridge_control_jitter_us", "task=\"control\"", gControlJitter);
+  tw.put("# TYPE fridge_control_jitter_max_us gauge\n");
+  putCounter(tw, "fridge_control_jitter_max_us", nullptr, gControlJitter.max());
+  tw.put("# TYPE fridge_control_overruns_total counter\n");
+  putCounter(tw, "fridge_control_overruns_total", nullptr, gControl[0].overruns);
+  tw.put("# TYPE fridge_control_queue_drops_total counter\n");
+  putCounter(tw, "fridge_control_queue_drops_total", "queue=\"snapshot\"", gControl[0].snapDrops);
+  putCounter(tw, "fridge_control_queue_drops_total", "queue=\"command\"", controlCmdDrops());
+  tw.put("# TYPE fridge_control_zones gauge\n");
+  putCounter(tw, "fridge_control_zones", nullptr, ZONE_COUNT);
+
+  // 센서 실패/거부 (존별)
+  tw.put("# TYPE fridge_sensor_rejects_total counter\n");
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    const ControlSnapshot& cs = gControl[z];
+    putCounter(tw, "fridge_sensor_rejects_total", zoneLabel(label, sizeof(label), z, "reason=\"no_response\""), cs.sensorNoResponse);
+    putCounter(tw, "fridge_sensor_rejects_total", zoneLabel(label, sizeof(label), z, "reason=\"timing\""), cs.sensorTimingErrs);
+    putCounter(tw, "fridge_sensor_rejects_total", zoneLabel(label, sizeof(label), z, "reason=\"checksum\""), cs.sensorChecksumErrs);
+    putCounter(tw, "fridge_sensor_rejects_total", zoneLabel(label, sizeof(label), z, "reason=\"range\""), cs.sensorRangeRejects);
+    putCounter(tw, "fridge_sensor_rejects_total", zoneLabel(label, sizeof(label), z, "reason=\"outlier\""), cs.sensorOutliers);
+  }
+  tw.put("# TYPE fridge_sensor_filter_recoveries_total counter\n");
+  for (uint8_t z = 0; z < ZONE_COUNT; z++)
+    putCounter(tw, "fridge_sensor_filter_recoveries_total", zoneLabel(label, sizeof(label), z, nullptr), gControl[z].sensorRecoveries);
+
+  // PID 냉각 전이 (존별)
+  tw.put("# TYPE fridge_pid_transitions_total counter\n");
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    putCounter(tw, "fridge_pid_transitions_total", zoneLabel(label, sizeof(label), z, "edge=\"start\""), gControl[z].pidStarts);
+    putCounter(tw, "fridge_pid_transitions_total", zoneLabel(label, sizeof(label), z, "edge=\"stop\""), gControl[z].pidStops);
+  }
+
+  // MQTT
+  tw.put("# TYPE fridge_mqtt_connects_total counter\n");
+  putCounter(tw, "fridge_mqtt_connects_total", nullptr, gMetricCounters.mqttConnects);
+  tw.put("# TYPE fridge_mqtt_connect_failures_total counter\n");
+  putCounter(tw, "fridge_mqtt_connect_failures_total", nullptr, gMetricCounters.mqttConnectFails);
+  tw.put("# TYPE fridge_publish_failures_total counter\n");
+  putCounter(tw, "fridge_publish_failures_total", "topic=\"status\"", gMetricCounters.statusPublishFails);
+  putCounter(tw, "fridge_publish_failures_total", "topic=\"ack\"", gMetricCounters.ackPublishFails);
+  putCounter(tw, "fridge_publish_failures_total", "topic=\"batch\"", gMetricCounters.batchPublishFails);
+  putCounter(tw, "fridge_publish_failures_total", "topic=\"backlog\"", bufferStats().publishFails);
+  AggStats as = aggStats();
+  putCounter(tw, "fridge_publish_failures_total", "topic=\"agg\"", as.publishFails);
+  // 발행 파이프라인: 큐 깊이 / 응답 대기 / 재전송 / 왕복 시간 (창 크기 조정용)
+  MqttOutStats mo = mqttOutStats();
+  tw.put("# TYPE fridge_mqtt_out_queue_depth gauge\n");
+  putCounter(tw, "fridge_mqtt_out_queue_depth", nullptr, mo.depth);
+  tw.put("# TYPE fridge_mqtt_out_queue_depth_max gauge\n");
+  putCounter(tw, "fridge_mqtt_out_queue_depth_max", nullptr, mo.depthMax);
+  tw.put("# TYPE fridge_mqtt_out_inflight gauge\n");
+  putCounter(tw, "fridge_mqtt_out_inflight", nullptr, mo.inflight);
+  tw.put("# TYPE fridge_mqtt_out_messages_total counter\n");
+  putCounter(tw, "fridge_mqtt_out_messages_total", "result=\"completed\"", mo.completed);
+  putCounter(tw, "fridge_mqtt_out_messages_total", "result=\"rejected\"", mo.rejected);
+  putCounter(tw, "fridge_mqtt_out_messages_total", "result=\"expired\"", mo.expired);
+  tw.put("# TYPE fridge_mqtt_out_retransmits_total counter\n");
+  putCounter(tw, "fridge_mqtt_out_retransmits_total", nullptr, mo.retransmits);
+  tw.put("# TYPE fridge_mqtt_out_bytes_total counter\n");
+  putCounter(tw, "fridge_mqtt_out_bytes_total", nullptr, mo.bytes);
+  tw.put("# HELP fridge_mqtt_rtt_us PUBLISH to PUBACK (QoS1) / PUBCOMP (QoS2), retransmitted messages excluded\n");
+  tw.put("# TYPE fridge_mqtt_rtt_us summary\n");
+  putSummary(tw, "fridge_mqtt_rtt_us", "dir=\"out\"", mqttOutRtt());
+  tw.put("# TYPE fridge_mqtt_rtt_max_us gauge\n");
+  putCounter(tw, "fridge_mqtt_rtt_max_us", nullptr, mqttOutRtt().max());
+  tw.put("# TYPE fridge_status_reports_total counter\n");
+  for (uint8_t i = REPORT_FIRST; i < REPORT_REASON_COUNT; i++) {
+    snprintf(label, sizeof(label), "reason=\"%s\"", reportReasonName((ReportReason)i));
+    putCounter(tw, "fridge_status_reports_total", label, reportCount((ReportReason)i));
+  }
+  tw.put("# TYPE fridge_agg_windows_total counter\n");
+  putCounter(tw, "fridge_agg_windows_total", "result=\"published\"", as.published);
+  putCounter(tw, "fridge_agg_windows_total", "result=\"dropped\"", as.dropped);
+  tw.put("# TYPE fridge_agg_pending gauge\n");
+  putCounter(tw, "fridge_agg_pending", nullptr, as.pending);
+
+  // 명령: 종류별 적용 / 수신~ack 지연, 큐/중복 카운터
+  tw.put("# HELP fridge_cmd_latency_us Command latency per kind (apply = execute, ack = MQTT rx to ack publish)\n");
+  tw.put("# TYPE fridge_cmd_latency_us summary\n");
+  for (uint8_t i = 0; i < METRIC_CMD_COUNT; i++) {
+    if (gCmdApplyHist[i].count()) {
+      snprintf(label, sizeof(label), "cmd=\"%s\",phase=\"apply\"", metricCmdName((MetricCmd)i));
+      putSummary(tw, "fridge_cmd_latency_us", label, gCmdApplyHist[i]);
+    }
+    if (gCmdAckHist[i].count()) {
+      snprintf(label, sizeof(label), "cmd=\"%s\",phase=\"ack\"", metricCmdName((MetricCmd)i));
+      putSummary(tw, "fridge_cmd_latency_us", label, gCmdAckHist[i]);
+    }
+  }
+  CommandStats cs = commandStats();
+  tw.put("# TYPE fridge_cmd_total counter\n");
+  putCounter(tw, "fridge_cmd_total", "result=\"received\"", cs.received);
+  putCounter(tw, "fridge_cmd_total", "result=\"executed\"", cs.executed);
+  putCounter(tw, "fridge_cmd_total", "result=\"duplicate\"", cs.duplicates);
+  putCounter(tw, "fridge_cmd_total", "result=\"queue_drop\"", cs.queueDrops);
+  putCounter(tw, "fridge_cmd_total", "result=\"oversize\"", cs.oversize);
+  tw.put("# TYPE fridge_cmd_cache_evictions_total counter\n");
+  putCounter(tw, "fridge_cmd_cache_evictions_total", nullptr, cs.evictions);
+
+  // SSE 구독자
+  StreamStats st = streamStats();
+  tw.put("# TYPE fridge_stream_clients gauge\n");
+  putCounter(tw, "fridge_stream_clients", nullptr, st.clients);
+  tw.put("# TYPE fridge_stream_events_total counter\n");
+  putCounter(tw, "fridge_stream_events_total", nullptr, st.events);
+  tw.put("# TYPE fridge_stream_bytes_total counter\n");
+  putCounter(tw, "fridge_stream_bytes_total", nullptr, st.bytes);
+  tw.put("# TYPE fridge_stream_drops_total counter\n");
+  putCounter(tw, "fridge_stream_drops_total", "reason=\"slow\"", st.slowDrops);
+  putCounter(tw, "fridge_stream_drops_total", "reason=\"closed\"", st.disconnects);
+  putCounter(tw, "fridge_stream_drops_total", "reason=\"rejected\"", st.rejected);
+
+  // 힙 / 가동 시간
+  tw.put("# TYPE fridge_heap_free_bytes gauge\n");
+  putCounter(tw, "fridge_heap_free_bytes", nullptr, gStatus.heapFree);
+  tw.put("# TYPE fridge_heap_min_free_bytes gauge\n");
+  putCounter(tw, "fridge_heap_min_free_bytes", nullptr, gStatus.heapMinFree);
+  tw.put("# TYPE fridge_heap_max_block_bytes gauge\n");
+  putCounter(tw, "fridge_heap_max_block_bytes", nullptr, gStatus.heapMaxBlock);
+  tw.put("# TYPE fridge_json_pool_overflows_total counter\n");
+  putCounter(tw, "fridge_json_pool_overflows_total", nullptr, gMetricCounters.jsonPoolOverflows);
+  // NVS write-behind (요청 대비 실제 기록 = 병합 효과, 누적 기록 = 마모)
+  StorageStats ss = storageStats();
+  tw.put("# TYPE fridge_nvs_requests_total counter\n");
+  putCounter(tw, "fridge_nvs_requests_total", nullptr, ss.requests);
+  tw.put("# TYPE fridge_nvs_commits_total counter\n");
+  putCounter(tw, "fridge_nvs_commits_total", nullptr, ss.commits);
+  tw.put("# TYPE fridge_nvs_commit_failures_total counter\n");
+  putCounter(tw, "fridge_nvs_commit_failures_total", nullptr, ss.failures);
+  tw.put("# TYPE fridge_nvs_lifetime_writes counter\n");
+  putCounter(tw, "fridge_nvs_lifetime_writes", nullptr, ss.lifetimeWrites);
+  // 로그 (버린 줄: 태스크 링이 참 / 링 없는 태스크 / 기록 링에서 밀림 / 시리얼이 못 따라감)
+  LogStats ls = logStats();
+  tw.put("# TYPE fridge_log_records_total counter\n");
+  putCounter(tw, "fridge_log_records_total", nullptr, ls.records);
+  tw.put("# TYPE fridge_log_dropped_total counter\n");
+  putCounter(tw, "fridge_log_dropped_total", "reason=\"ring_full\"", ls.ringDrops);
+  putCounter(tw, "fridge_log_dropped_total", "reason=\"foreign_task\"", ls.foreignDrops);
+  putCounter(tw, "fridge_log_dropped_total", "reason=\"overwritten\"", ls.overwritten);
+  putCounter(tw, "fridge_log_dropped_total", "reason=\"serial_slow\"", ls.serialSkipped);
+  // OTA (이번 세션 바이트: 받은 이미지 / 플래시에 쓴 펌웨어 / 재전송으로 겹친 것, 세션 수는 부팅 후 누적)
+  OtaStatus os = otaStatus();
+  tw.put("# TYPE fridge_ota_bytes gauge\n");
+  putCounter(tw, "fridge_ota_bytes", "kind=\"received\"", os.received);
+  putCounter(tw, "fridge_ota_bytes", "kind=\"written\"", os.written);
+  putCounter(tw, "fridge_ota_bytes", "kind=\"duplicate\"", os.duplicateBytes);
+  tw.put("# TYPE fridge_ota_sessions_total counter\n");
+  putCounter(tw, "fridge_ota_sessions_total", "result=\"completed\"", os.completed);
+  putCounter(tw, "fridge_ota_sessions_total", "result=\"failed\"", os.failures);
+  // 시각 (SNTP): 마지막 샘플 오차 / 왕복, 추정 드리프트, 요청 결과, 한 번에 맞춘 횟수, 현재 기준
+  TimeStats tms = timeStats();
+  tw.put("# TYPE fridge_time_offset_ms gauge\n");
+  tw.put("fridge_time_offset_ms %ld\n", (long)tms.offsetMs);
+  tw.put("# TYPE fridge_time_drift_ppb gauge\n");
+  tw.put("fridge_time_drift_ppb %ld\n", (long)tms.driftPpb);
+  tw.put("# TYPE fridge_time_rtt_ms gauge\n");
+  putCounter(tw, "fridge_time_rtt_ms", nullptr, tms.rttMs);
+  tw.put("# TYPE fridge_time_requests_total counter\n");
+  putCounter(tw, "fridge_time_requests_total", "result=\"synced\"", tms.syncs);
+  putCounter(tw, "fridge_time_requests_total", "result=\"timeout\"", tms.timeouts);
+  putCounter(tw, "fridge_time_requests_total", "result=\"rejected\"", tms.rejects);
+  tw.put("# TYPE fridge_time_steps_total counter\n");
+  putCounter(tw, "fridge_time_steps_total", nullptr, tms.steps);
+  tw.put("# TYPE fridge_time_source gauge\n");
+  tw.put("fridge_time_source{source=\"%s\"} 1\n", timeSourceName(tms.source));
+  tw.put("# TYPE fridge_status_backstamped_total counter\n");
+  putCounter(tw, "fridge_status_backstamped_total", nullptr, bufferStats().backstamped);
+
+  tw.put("# TYPE fridge_uptime_seconds counter\n");
+  putCounter(tw, "fridge_uptime_seconds", nullptr, gStatus.uptimeSec);
+  // 부팅 → WiFi / 첫 펠티어 출력 / 첫 상태 발행 (0 = 아직), 웜 부팅으로 복원한 존 수
+  BootInfo bi = bootInfo();
+  tw.put("# TYPE fridge_boot_ms gauge\n");
+  putCounter(tw, "fridge_boot_ms", "phase=\"wifi\"", bi.wifiMs);
+  putCounter(tw, "fridge_boot_ms", "phase=\"first_pwm\"", bi.firstPwmMs);
+  putCounter(tw, "fridge_boot_ms", "phase=\"first_publish\"", bi.firstPublishMs);
+  tw.put("# TYPE fridge_boot_warm_zones gauge\n");
+  putCounter(tw, "fridge_boot_warm_zones", nullptr, bi.zonesRestored);
+  return tw.w;
+}
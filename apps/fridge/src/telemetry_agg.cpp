@@ -0,0 +1,181 @@
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <math.h>
+#include "json_pool.h"
+#include "mqtt_out.h"
+#include "record_ring.h"
+#include "telemetry_agg.h"
+#include "timesync.h"
+#include "zone.h"
+#include "log.h"
+
+// 열린 창 누적값 (존별)
+struct AggWindow {
+  bool     open        = false;
+  uint32_t key         = 0;       // 창 번호 (시각을 모를 때는 단조 시각 기준 + 최상위 비트)
+  uint32_t ts          = 0;
+  uint16_t samples     = 0;
+  uint16_t coolSamples = 0;
+  uint16_t tCount      = 0;
+  uint16_t hCount      = 0;
+  float    tMin = 0.0f, tMax = 0.0f, tSum = 0.0f;
+  float    hMin = 0.0f, hMax = 0.0f, hSum = 0.0f;
+  float    outSum      = 0.0f;
+  float    outMax      = 0.0f;
+  float    dutySum     = 0.0f;    // outputPWM / PELTIER_PWM_MAX 합
+  uint32_t rejectBase  = 0;       // 창 시작 직전의 거부 누적
+};
+
+static const uint32_t AGG_UNSYNCED_KEY = 0x80000000u;
+
+static bool      aggOn = STATUS_AGG_ENABLED;
+static AggWindow window[ZONE_COUNT];
+static uint32_t  lastRejectTotal[ZONE_COUNT] = {};
+static RecordRing<StatusAggregate, STATUS_AGG_BACKLOG> pending[ZONE_COUNT];
+static AggStats  stats = {};
+static char      aggBuf[384];
+static JsonPool<jsonPoolBytes(1, 224)> aggPool;   // putTenths 키 7개 복사
+
+static uint32_t rejectTotal(const ControlSnapshot& s) {
+  return s.sensorNoResponse + s.sensorTimingErrs + s.sensorChecksumErrs + s.sensorRangeRejects + s.sensorOutliers;
+}
+
+static int16_t tenths(float v) {
+  return (int16_t)lroundf(v * 10.0f);
+}
+
+static void closeWindow(uint8_t z) {
+  AggWindow& w = window[z];
+  if (!w.open) return;
+  const ZoneStatus& zs = gZone[z];
+  StatusAggregate a;
+  a.ts        = w.ts;
+  // 시각을 모를 때 연 창 (키 = 단조 시각 분): 그사이 동기됐으면 창 시작에 시각을 붙인다
+  if (!a.ts && (w.key & AGG_UNSYNCED_KEY))
+    a.ts = (uint32_t)(timeAt((uint64_t)(w.key & ~AGG_UNSYNCED_KEY) * STATUS_AGG_WINDOW_SEC * 1000) / 1000);
+  a.samples   = w.samples;
+  a.coolSec   = (uint16_t)(w.coolSamples * (CONTROL_PERIOD_MS / 1000));
+  a.tMin10    = w.tCount ? tenths(w.tMin) : STATUS_AGG_NULL16;
+  a.tMax10    = w.tCount ? tenths(w.tMax) : STATUS_AGG_NULL16;
+  a.tMean10   = w.tCount ? tenths(w.tSum / w.tCount) : STATUS_AGG_NULL16;
+  a.hMin10    = w.hCount ? tenths(w.hMin) : STATUS_AGG_NULL16;
+  a.hMax10    = w.hCount ? tenths(w.hMax) : STATUS_AGG_NULL16;
+  a.hMean10   = w.hCount ? tenths(w.hSum / w.hCount) : STATUS_AGG_NULL16;
+  a.target10  = zs.hasTarget ? tenths(zs.target) : STATUS_AGG_NULL16;
+  a.outMean10 = (uint16_t)lroundf(w.outSum / w.samples * 10.0f);
+  a.outMax10  = (uint16_t)lroundf(w.outMax * 10.0f);
+  uint32_t total = lastRejectTotal[z];
+  a.rejects   = (uint16_t)(total >= w.rejectBase ? total - w.rejectBase : total);
+  // 듀티 × 정격 전력 × 주기 → mWh
+  a.energyMwh = (uint32_t)lroundf(w.dutySum * PELTIER_RATED_W * (CONTROL_PERIOD_MS / 1000.0f) / 3.6f);
+  if (!pending[z].push(a)) stats.dropped++;
+  stats.windows++;
+  w.open = false;
+}
+
+void aggBegin() {
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    window[z]          = AggWindow();
+    lastRejectTotal[z] = 0;   // 제어 쪽 카운터도 부팅 시 0 부터
+    pending[z].clear();
+  }
+  stats = {};
+}
+
+void aggAdd(const ControlSnapshot& s) {
+  if (!aggOn || s.zone >= ZONE_COUNT) return;
+  AggWindow& w = window[s.zone];
+
+  uint32_t nowSec = nowUnix();
+  uint32_t key    = nowSec ? nowSec / STATUS_AGG_WINDOW_SEC
+                         : ((s.ms / 1000) / STATUS_AGG_WINDOW_SEC) | AGG_UNSYNCED_KEY;
+  if (w.open && w.key != key) closeWindow(s.zone);
+  if (!w.open) {
+    w            = AggWindow();
+    w.open       = true;
+    w.key        = key;
+    w.ts         = nowSec ? key * STATUS_AGG_WINDOW_SEC : 0;
+    w.rejectBase = lastRejectTotal[s.zone];
+  }
+
+  w.samples++;
+  if (isfinite(s.temp)) {
+    if (w.tCount == 0 || s.temp < w.tMin) w.tMin = s.temp;
+    if (w.tCount == 0 || s.temp > w.tMax) w.tMax = s.temp;
+    w.tSum += s.temp;
+    w.tCount++;
+  }
+  if (isfinite(s.humidity)) {
+    if (w.hCount == 0 || s.humidity < w.hMin) w.hMin = s.humidity;
+    if (w.hCount == 0 || s.humidity > w.hMax) w.hMax = s.humidity;
+    w.hSum += s.humidity;
+    w.hCount++;
+  }
+  w.outSum += s.outputPct;
+  if (s.outputPct > w.outMax) w.outMax = s.outputPct;
+  w.dutySum += (float)s.outputPWM / (float)PELTIER_PWM_MAX;
+  if (s.coolingActive) w.coolSamples++;
+  lastRejectTotal[s.zone] = rejectTotal(s);
+}
+
+static void putTenths(JsonDocument& doc, const char* key, int16_t v) {
+  if (v == STATUS_AGG_NULL16) doc[key] = nullptr;
+  else                        doc[key] = (float)v / 10.0f;
+}
+
+size_t buildAggregateJson(const StatusAggregate& a, char* out, size_t cap) {
+  JsonDocument doc(aggPool.reset());
+  doc["v"]       = 1;
+  doc["ts"]      = a.ts;
+  doc["period"]  = STATUS_AGG_WINDOW_SEC;
+  doc["samples"] = a.samples;
+  putTenths(doc, "temp_min", a.tMin10);
+  putTenths(doc, "temp_max", a.tMax10);
+  putTenths(doc, "temp_mean", a.tMean10);
+  putTenths(doc, "humidity_min", a.hMin10);
+  putTenths(doc, "humidity_max", a.hMax10);
+  putTenths(doc, "humidity_mean", a.hMean10);
+  doc["output_mean"] = (float)a.outMean10 / 10.0f;
+  doc["output_max"]  = (float)a.outMax10 / 10.0f;
+  doc["cooling_sec"] = a.coolSec;
+  doc["energy_wh"]   = (float)a.energyMwh / 1000.0f;
+  doc["rejects"]     = a.rejects;
+  putTenths(doc, "target", a.target10);
+  return serializeJson(doc, out, cap);
+}
+
+void aggFlush() {
+  if (!mqtt.connected()) return;
+  uint32_t budget = STATUS_AGG_PUBLISH_MAX;
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    while (budget > 0 && !pending[z].empty()) {
+      const char* topic = zoneTopic(z, ZONE_TOPIC_STATUS_AGG);
+      size_t      len   = buildAggregateJson(pending[z].oldest(), aggBuf, sizeof(aggBuf));
+      bool        ok    = mqttOutPublish(topic, aggBuf, len, 1);
+      LOG_D(STATUS, "AGG(QoS1) -> %s bytes=%u %s", topic, (unsigned)len, ok ? "ok" : "FAILED");
+      if (!ok) {
+        // 남은 것은 다음 statusTick 에 (끊겼으면 재연결 후). 큐에 들어간 것은 재전송을 mqtt_out 이 맡는다
+        stats.publishFails++;
+        return;
+      }
+      pending[z].drop(1);
+      stats.published++;
+      budget--;
+    }
+  }
+}
+
+void setStatusAggEnabled(bool on) {
+  if (!on)
+    for (uint8_t z = 0; z < ZONE_COUNT; z++) window[z].open = false;
+  aggOn = on;
+}
+
+bool statusAggEnabled() { return aggOn; }
+
+AggStats aggStats() {
+  AggStats s = stats;
+  s.pending  = 0;
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) s.pending += pending[z].size();
+  return s;
+}
@@ -0,0 +1,181 @@
+#include <Arduino.h>
+#include <math.h>
+#include "mqtt_out.h"
+#include "record_ring.h"
+#include "state.h"
+#include "telemetry_buffer.h"
+#include "text_writer.h"
+#include "timesync.h"
+#include "zone.h"
+#include "log.h"
+
+static RecordRing<StatusRecord, TELEMETRY_RING_RECORDS> ring;
+static BufferStats   stats       = {};
+static bool          spillReady  = false;
+static unsigned long lastStoreMs[ZONE_COUNT] = {};
+static uint32_t      storedMask  = 0;   // 한 번이라도 저장한 존
+
+// 응답을 기다리는 묶음: 존별 메시지가 모두 PUBACK 을 받으면 그만큼 지운다
+static uint32_t drainPending = 0;   // 응답 대기 메시지
+static uint32_t drainRecords = 0;   // 묶음의 기록 수
+static uint32_t drainMono    = 0;   // 그중 시각을 붙인 기록
+static bool     drainFailed  = false;
+
+// 배치 직렬화 버퍼: 기록당 최대 ~40자
+static char batchBuf[64 + TELEMETRY_BATCH_MAX * 44];
+
+static int16_t toTenths(float v) {
+  if (!isfinite(v)) return STATUS_REC_NULL16;
+  return (int16_t)lroundf(v * 10.0f);
+}
+
+StatusRecord makeStatusRecord(uint8_t zone) {
+  const ZoneStatus& zs = gZone[zone];
+  StatusRecord r;
+  bool mono  = gStatus.tsMs == 0;
+  r.ts       = mono ? (uint32_t)(timeMonoMs() / 1000) : (uint32_t)(gStatus.tsMs / 1000);
+  r.temp10   = toTenths(zs.temp);
+  r.hum10    = toTenths(zs.humidity);
+  r.target10 = zs.hasTarget ? toTenths(zs.target) : STATUS_REC_NULL16;
+  r.power    = (uint8_t)zs.power;
+  r.flags    = (zs.peltierEnabled ? STATUS_REC_FLAG_PELTIER : 0) |
+               (gControl[zone].coolingActive ? STATUS_REC_FLAG_COOLING : 0) |
+               (mono ? STATUS_REC_FLAG_MONO : 0) |
+               (uint8_t)(zone << STATUS_REC_ZONE_SHIFT);
+  return r;
+}
+
+void bufferBegin() {
+  ring.clear();
+  storedMask        = 0;
+  drainPending      = 0;
+  stats             = {};
+  stats.ramCapacity = TELEMETRY_RING_RECORDS;
+  spillReady        = TELEMETRY_FLASH_SPILL && spillBegin();
+  stats.spillCapacity = spillReady ? spillCapacity() : 0;
+  LOG_I(STATUS, "ram=%u records spill=%u records",
+        (unsigned)stats.ramCapacity, (unsigned)stats.spillCapacity);
+}
+
+void bufferStore(const StatusRecord& r) {
+  uint8_t       z   = statusRecordZone(r);
+  unsigned long now = millis();
+  if (z >= ZONE_COUNT) return;
+  if ((storedMask & (1UL << z)) && now - lastStoreMs[z] < TELEMETRY_RECORD_MS) return;
+  lastStoreMs[z] = now;
+  storedMask    |= 1UL << z;
+
+  // RAM 링이 가득 차면 가장 오래된 기록을 플래시로 넘긴 뒤 자리를 만든다
+  if (ring.full()) {
+    if (spillReady && spillAppend(ring.oldest())) ring.drop(1);
+    else                                          stats.dropped++;
+  }
+  ring.push(r);
+  stats.buffered++;
+
+  uint32_t total = ring.size() + (spillReady ? spillCount() : 0);
+  if (total > stats.highWater) stats.highWater = total;
+}
+
+// 0.1 단위 정수를 소수 한 자리로 (null 허용)
+static void putTenths(TextWriter& tw, int16_t v) {
+  if (v == STATUS_REC_NULL16) { tw.put(",null"); return; }
+  int a = v < 0 ? -v : v;
+  tw.put(",%s%d.%d", v < 0 ? "-" : "", a / 10, a % 10);
+}
+
+// 단조 시각으로 남긴 기록은 지금 아는 시각 모델로 되돌려 붙인다
+static uint32_t recordUnix(const StatusRecord& r) {
+  if (!(r.flags & STATUS_REC_FLAG_MONO)) return r.ts;
+  return (uint32_t)(timeAt((uint64_t)r.ts * 1000) / 1000);
+}
+
+// {"v":1,"records":[[ts,temp,humidity,power,target,flags],...]}
+static size_t serializeBatch(const StatusRecord* recs, size_t n) {
+  TextWriter tw(batchBuf, sizeof(batchBuf));
+  tw.put("{\"v\":1,\"records\":[");
+  for (size_t i = 0; i < n; i++) {
+    const StatusRecord& r = recs[i];
+    tw.put("%s[%lu", i ? "," : "", (unsigned long)recordUnix(r));
+    putTenths(tw, r.temp10);
+    putTenths(tw, r.hum10);
+    tw.put(",%u", (unsigned)r.power);
+    putTenths(tw, r.target10);
+    tw.put(",%u]", (unsigned)(r.flags & STATUS_REC_FLAG_MASK));
+  }
+  tw.put("]}");
+  return tw.ok ? tw.w : 0;
+}
+
+// 보낸 묶음은 가장 오래된 기록들이다. 끊긴 사이 RAM 링이 차서 플래시로 넘어가도 순서는 그대로라
+// 플래시 쪽부터 n 개를 지우면 된다
+static void consumeOldest(uint32_t n) {
+  uint32_t fromSpill = spillReady ? spillCount() : 0;
+  if (fromSpill > n) fromSpill = n;
+  if (fromSpill) spillConsume(fromSpill);
+  ring.drop(n - fromSpill);
+}
+
+static void onDrainDone(uint32_t tag, bool ok) {
+  (void)tag;
+  if (!ok) drainFailed = true;
+  if (--drainPending) return;
+  if (drainFailed) {
+    // 하나라도 포기했으면 아무것도 지우지 않고 다음 drain 에 묶음 전체를 다시
+    stats.publishFails++;
+    return;
+  }
+  consumeOldest(drainRecords);
+  stats.replayed    += drainRecords;
+  stats.backstamped += drainMono;
+  stats.batches++;
+  LOG_I(STATUS, "replayed %u records (ram=%u spill=%u left)", (unsigned)drainRecords,
+        (unsigned)ring.size(), (unsigned)(spillReady ? spillCount() : 0));
+}
+
+bool bufferDrain() {
+  // 직전 묶음의 응답을 기다리는 동안은 보내지 않는다 (브로커 속도로 재전송).
+  // 시각을 모르면 단조 시각 기록에 붙일 시각이 없으니 동기될 때까지 둔다
+  if (drainPending || bufferEmpty() || !nowUnix()) return false;
+
+  // 플래시에 있는 것이 더 오래된 기록이므로 먼저 보낸다
+  StatusRecord batch[TELEMETRY_BATCH_MAX];
+  size_t fromSpill = spillReady ? spillPeek(batch, TELEMETRY_BATCH_MAX) : 0;
+  size_t n         = fromSpill;
+  for (uint32_t i = 0; n < TELEMETRY_BATCH_MAX && i < ring.size(); i++) batch[n++] = ring.peek(i);
+
+  // 존마다 자기 backlog 토픽으로. 모든 존 메시지가 PUBACK 을 받아야 지운다. 큐에 못 넣었거나
+  // 재전송을 포기하면 아무것도 지우지 않고 다음 drain 에 묶음 전체를 다시 보낸다 (최소 한 번 전달)
+  StatusRecord zoneBatch[TELEMETRY_BATCH_MAX];
+  drainRecords = (uint32_t)n;
+  drainMono    = 0;
+  for (size_t i = 0; i < n; i++)
+    if (batch[i].flags & STATUS_REC_FLAG_MONO) drainMono++;
+  drainFailed  = false;
+  drainPending = 1;   // 모든 존을 넣을 때까지 완료 처리를 막는다
+  for (uint8_t z = 0; z < ZONE_COUNT && !drainFailed; z++) {
+    size_t zn = 0;
+    for (size_t i = 0; i < n; i++)
+      if (statusRecordZone(batch[i]) == z) zoneBatch[zn++] = batch[i];
+    if (zn == 0) continue;
+    size_t len = serializeBatch(zoneBatch, zn);
+    drainPending++;
+    if (len == 0 || !mqttOutPublish(zoneTopic(z, ZONE_TOPIC_STATUS_BACKLOG), batchBuf, len, 1, onDrainDone, z)) {
+      drainPending--;
+      drainFailed = true;
+    }
+  }
+  onDrainDone(0, !drainFailed);
+  return !drainFailed;
+}
+
+bool bufferEmpty() {
+  return ring.empty() && (!spillReady || spillCount() == 0);
+}
+
+BufferStats bufferStats() {
+  BufferStats s = stats;
+  s.ramCount    = ring.size();
+  s.spillCount  = spillReady ? spillCount() : 0;
+  return s;
+}
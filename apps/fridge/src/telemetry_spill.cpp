@@ -0,0 +1,66 @@
+#ifdef ESP32
+
+#include <Arduino.h>
+#include <esp_partition.h>
+#include "telemetry_buffer.h"
+
+// ==================== 플래시 스필 ====================
+// 기본 파티션 테이블의 SPIFFS 영역(파일시스템 미사용)을 원시 순환 로그로 쓴다.
+// 16바이트 슬롯에 StatusRecord(12B) 하나씩, 섹터(4KB = 256슬롯) 단위로 미리 지운다.
+// 인덱스는 RAM 에만 있으므로 재부팅 후에는 비어 있는 것으로 시작한다.
+
+static const uint32_t SPILL_SLOT_BYTES   = 16;
+static const uint32_t SPILL_SECTOR_BYTES = 4096;
+static const uint32_t SPILL_SLOTS_PER_SECTOR = SPILL_SECTOR_BYTES / SPILL_SLOT_BYTES;
+
+static const esp_partition_t* part = nullptr;
+static uint32_t capacitySlots = 0;
+static uint32_t readSlot      = 0;
+static uint32_t writeSlot     = 0;
+static uint32_t count         = 0;
+
+bool spillBegin() {
+  part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS, nullptr);
+  if (!part) return false;
+  capacitySlots = (part->size / SPILL_SECTOR_BYTES) * SPILL_SLOTS_PER_SECTOR;
+  readSlot = writeSlot = count = 0;
+  return capacitySlots > SPILL_SLOTS_PER_SECTOR;
+}
+
+bool spillAppend(const StatusRecord& r) {
+  if (!part) return false;
+  if (writeSlot % SPILL_SLOTS_PER_SECTOR == 0) {
+    // 새 섹터를 지워야 하므로, 아직 읽지 않은 기록이 든 섹터와 겹치지 않게 한 섹터 여유를 둔다
+    if (count + SPILL_SLOTS_PER_SECTOR > capacitySlots) return false;
+    if (esp_partition_erase_range(part, writeSlot * SPILL_SLOT_BYTES, SPILL_SECTOR_BYTES) != ESP_OK)
+      return false;
+  } else if (count >= capacitySlots) {
+    return false;
+  }
+  if (esp_partition_write(part, writeSlot * SPILL_SLOT_BYTES, &r, sizeof(r)) != ESP_OK) return false;
+  writeSlot = (writeSlot + 1) % capacitySlots;
+  count++;
+  return true;
+}
+
+size_t spillPeek(StatusRecord* out, size_t max) {
+  size_t n = 0;
+  uint32_t slot = readSlot;
+  while (n < max && n < count) {
+    if (esp_partition_read(part, slot * SPILL_SLOT_BYTES, &out[n], sizeof(StatusRecord)) != ESP_OK) break;
+    slot = (slot + 1) % capacitySlots;
+    n++;
+  }
+  return n;
+}
+
+void spillConsume(size_t n) {
+  if (n > count) n = count;
+  readSlot = (readSlot + n) % capacitySlots;
+  count   -= n;
+}
+
+uint32_t spillCount()    { return count; }
+uint32_t spillCapacity() { return capacitySlots; }
+
+#endif  // ESP32
@@ -0,0 +1,265 @@
+#include <Arduino.h>
+#include <string.h>
+#include "state.h"
+#include "timesync.h"
+#include "warm_boot.h"
+#include "log.h"
+#ifdef ESP32
+#include <esp_timer.h>
+#endif
+
+static const size_t   NTP_PACKET      = 48;
+static const uint64_t NTP_UNIX_DELTA  = 2208988800ULL;   // 1900-01-01 → 1970-01-01 (초)
+static const uint32_t FREQ_REBASE_MS  = 8 * TIME_FREQ_MIN_MS;   // 드리프트 기준 샘플을 앞으로 옮기는 구간
+                                                                 // (온도에 따라 바뀌는 드리프트를 따라가게)
+
+// ===== 시계 모델 =====
+static TimeSource source     = TIME_NONE;
+static uint64_t   anchorMono = 0;
+static int64_t    anchorUnix = 0;    // anchorMono 때의 unix ms
+static int32_t    driftPpb   = 0;
+static int32_t    slewMs     = 0;    // anchor 이후 TIME_SLEW_MS_PER_S 로 더해 갈 보정
+static uint64_t   lastOut    = 0;    // nowUnixMs() 가 마지막으로 돌려준 값
+static uint64_t   bootMono   = 0;
+static bool       refValid   = false;   // 드리프트 기준 샘플 (단조 / 서버 시각)
+static uint64_t   refMono    = 0;
+static int64_t    refUnix    = 0;
+
+// ===== 요청 =====
+static bool      waiting   = false;
+static uint64_t  sentMono  = 0;   // T1
+static uint64_t  pollMono  = 0;   // 응답이 없던 마지막 확인 (T4 는 이것과 응답을 찾은 확인의 중간)
+static uint8_t   cookie[8];       // 요청 transmit 자리에 넣고 응답 originate 와 비교
+static uint32_t  cookieSeq = 0;
+static TimeStats st        = {};
+
+const char* timeSourceName(TimeSource s) {
+  switch (s) {
+    case TIME_NONE: return "none";
+    case TIME_WARM: return "warm";
+    case TIME_SNTP: return "sntp";
+  }
+  return "?";
+}
+
+uint64_t timeMonoMs() {
+#ifdef ESP32
+  return (uint64_t)esp_timer_get_time() / 1000ULL;   // millis() 와 같은 타이머, 49일에 넘치지 않음
+#else
+  return (uint64_t)millis();
+#endif
+}
+
+// slew 를 뺀 모델. m 이 anchor 보다 앞이어도 (back-stamp) 같은 식
+static int64_t modelAt(uint64_t m) {
+  int64_t d = (int64_t)(m - anchorMono);
+  return anchorUnix + d - d * driftPpb / 1000000000LL;
+}
+
+static int64_t slewAt(uint64_t m) {
+  if (!slewMs || m <= anchorMono) return 0;
+  int64_t lim = (int64_t)(m - anchorMono) * TIME_SLEW_MS_PER_S / 1000;
+  if (slewMs > 0) return slewMs < lim ? slewMs : lim;
+  return -slewMs < lim ? slewMs : -lim;
+}
+
+static void anchor(uint64_t m, int64_t unixMs) {
+  anchorMono = m;
+  anchorUnix = unixMs;
+  slewMs     = 0;
+}
+
+void timeBegin() {
+  bootMono = timeMonoMs();
+  source   = TIME_NONE;
+  driftPpb = 0;
+  slewMs   = 0;
+  lastOut  = 0;
+  refValid = false;
+  waiting  = false;
+  st       = {};
+  st.pollMs = NTP_RETRY_MS;
+  uint64_t warm = warmEpochMs();
+  if (warm) {
+    anchor(timeMonoMs(), (int64_t)warm);
+    source = TIME_WARM;
+  }
+}
+
+uint64_t nowUnixMs() {
+  if (source == TIME_NONE) return 0;
+  uint64_t m = timeMonoMs();
+  int64_t  t = modelAt(m) + slewAt(m);
+  if (t <= 0) return 0;
+  if ((uint64_t)t < lastOut) return lastOut;   // 뒤로 가는 step 은 따라잡을 때까지 멈춰 있음
+  lastOut = (uint64_t)t;
+  return lastOut;
+}
+
+uint32_t nowUnix() {
+  return (uint32_t)(nowUnixMs() / 1000);
+}
+
+uint64_t timeAt(uint64_t monoMs) {
+  if (source == TIME_NONE) return 0;
+  int64_t t = modelAt(monoMs) + slewAt(monoMs);
+  return t > 0 ? (uint64_t)t : 0;
+}
+
+bool timeSynced() {
+  return source == TIME_SNTP;
+}
+
+bool timeHolding() {
+  return source == TIME_NONE && timeMonoMs() - bootMono < TIME_SYNC_WAIT_MS;
+}
+
+TimeStats timeStats() {
+  TimeStats s = st;
+  s.source    = source;
+  s.driftPpb  = driftPpb;
+  return s;
+}
+
+// ===== 패킷 =====
+static uint32_t rd32(const uint8_t* p) {
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+// NTP 타임스탬프(초.소수 32.32) → unix ms. 최상위 비트가 0 이면 2036년 이후 (era 1)
+static int64_t ntpToUnixMs(const uint8_t* p) {
+  uint64_t sec  = rd32(p);
+  uint64_t frac = rd32(p + 4);
+  if (!(sec & 0x80000000ULL)) sec += 1ULL << 32;
+  return (int64_t)((sec - NTP_UNIX_DELTA) * 1000ULL + ((frac * 1000ULL) >> 32));
+}
+
+// 서버 응답 확인: nullptr = 사용 가능
+static const char* checkReply(const uint8_t* p, int len) {
+  if (len < (int)NTP_PACKET) return "short";
+  uint8_t li = p[0] >> 6, vn = (p[0] >> 3) & 7, mode = p[0] & 7;
+  if (mode != 4 || vn < 3) return "mode";
+  if (memcmp(p + 24, cookie, sizeof(cookie)) != 0) return "cookie";   // 지난 요청 / 위조
+  if (p[1] == 0) return "kod";                                       // kiss-o'-death
+  if (li == 3 || p[1] > 15) return "unsynced";
+  if (!rd32(p + 40)) return "zero";
+  return nullptr;
+}
+
+// ===== 샘플 반영 =====
+// t4 (단조) 에 서버 시각이 server 였다
+static void applySample(uint64_t t4, int64_t server, uint32_t rtt) {
+  int64_t err = server - (modelAt(t4) + slewMs);   // 진행 중인 slew 가 끝났다고 보고 남는 오차
+  if (err > INT32_MAX) err = INT32_MAX;
+  if (err < INT32_MIN) err = INT32_MIN;
+  st.offsetMs   = (int32_t)err;
+  st.rttMs      = rtt;
+  st.lastSyncMs = (uint32_t)t4;
+  if (!st.syncs) st.firstSyncMs = (uint32_t)(timeMonoMs() - bootMono);
+  st.syncs++;
+
+  // 주파수: 기준 샘플 이후 단조 시계가 서버보다 얼마나 더 갔나
+  if (source == TIME_SNTP && refValid && t4 - refMono >= TIME_FREQ_MIN_MS) {
+    int64_t dm  = (int64_t)(t4 - refMono);
+    int64_t raw = (dm - (server - refUnix)) * 1000000000LL / dm;
+    const int64_t lim = (int64_t)TIME_DRIFT_MAX_PPM * 1000;
+    if (raw > lim)  raw = lim;
+    if (raw < -lim) raw = -lim;
+    driftPpb += (int32_t)((float)(raw - driftPpb) * TIME_FREQ_GAIN);
+    if ((uint64_t)dm >= FREQ_REBASE_MS) refValid = false;
+  }
+
+  // 위상: 크면 한 번에, 작으면 지금까지 더한 slew 를 anchor 에 넣고 남은 오차를 새 slew 로
+  int64_t mag = err < 0 ? -err : err;
+  if (source != TIME_SNTP || mag > (int64_t)TIME_STEP_MS) {
+    if (source != TIME_SNTP) lastOut = 0;   // 웜 부팅 추정에서 처음 맞출 때는 뒤로 가도 된다
+    anchor(t4, server);
+    st.steps++;
+    LOG_I(TIME, "step %+lldms (%s) rtt=%ums", (long long)err, timeSourceName(source), (unsigned)rtt);
+  } else {
+    int64_t cur = modelAt(t4) + slewAt(t4);
+    anchor(t4, cur);
+    slewMs = (int32_t)(server - cur);
+  }
+  if (!refValid) {
+    refMono  = t4;
+    refUnix  = server;
+    refValid = true;
+  }
+  source = TIME_SNTP;
+
+  // 오차가 작으면 폴링 간격을 늘리고, 크면 처음부터
+  if (mag <= (int64_t)TIME_STABLE_MS && st.syncs > 1)
+    st.pollMs = st.pollMs * 2 < NTP_REFRESH_MS ? st.pollMs * 2 : NTP_REFRESH_MS;
+  else
+    st.pollMs = NTP_POLL_MIN_MS;
+  LOG_D(TIME, "sample offset=%+dms rtt=%ums drift=%+dppb next=%us", (int)st.offsetMs, (unsigned)rtt,
+        (int)driftPpb, (unsigned)(st.pollMs / 1000));
+  warmSaveEpoch(nowUnixMs());
+}
+
+static uint32_t retryMs() {
+  return source == TIME_SNTP ? NTP_POLL_MIN_MS : NTP_RETRY_MS;
+}
+
+// ===== ntp 작업 =====
+uint32_t timeTick() {
+  uint8_t  buf[NTP_PACKET + 20];   // 확장 필드 / 인증 꼬리가 붙어도 앞 48바이트만 본다
+  uint64_t now = timeMonoMs();
+
+  if (waiting) {
+    int n;
+    while ((n = sntpNetRecv(buf, sizeof(buf))) > 0) {
+      const char* bad = checkReply(buf, n);
+      if (bad) {
+        st.rejects++;
+        LOG_D(TIME, "reply rejected: %s", bad);
+        if (!strcmp(bad, "kod")) {
+          waiting = false;
+          return retryMs();
+        }
+        continue;
+      }
+      waiting = false;
+      uint64_t t4  = (pollMono + now) / 2;
+      int64_t  t2  = ntpToUnixMs(buf + 32);
+      int64_t  t3  = ntpToUnixMs(buf + 40);
+      int64_t  rtt = (int64_t)(t4 - sentMono) - (t3 - t2);
+      if (t3 < t2 || rtt > (int64_t)NTP_RTT_MAX_MS) {
+        st.rejects++;
+        LOG_D(TIME, "reply rejected: rtt=%lldms", (long long)rtt);
+        return retryMs();
+      }
+      if (rtt < 0) rtt = 0;   // 응답 확인 간격(SCHED_TICK_MS)보다 짧은 왕복
+      applySample(t4, t3 + rtt / 2, (uint32_t)rtt);
+      return st.pollMs;
+    }
+    if (now - sentMono >= NTP_TIMEOUT_MS) {
+      waiting = false;
+      st.timeouts++;
+      LOG_D(TIME, "timeout");
+      return retryMs();
+    }
+    pollMono = now;
+    return SCHED_TICK_MS;
+  }
+
+  // 지난 요청에 늦게 온 응답은 버린다 (쿠키가 달라 어차피 거절되지만 소켓을 비움)
+  while (sntpNetRecv(buf, sizeof(buf)) > 0) {}
+
+  uint8_t pkt[NTP_PACKET];
+  memset(pkt, 0, sizeof(pkt));
+  pkt[0] = (0 << 6) | (4 << 3) | 3;   // LI 0, VN 4, mode 3 (client)
+  // 쿠키: 서버는 transmit 을 originate 로 그대로 돌려준다. 시각을 몰라도 되도록 단조 시각 + 순번
+  uint64_t c = (now << 16) ^ ((uint64_t)++cookieSeq * 0x9E3779B97F4A7C15ULL);
+  for (int i = 0; i < 8; i++) cookie[i] = (uint8_t)(c >> (56 - 8 * i));
+  memcpy(pkt + 40, cookie, sizeof(cookie));
+
+  int r = sntpNetSend(pkt, sizeof(pkt));
+  if (r == 0) return NET_POLL_IDLE_MS;   // 서버 주소 조회 중
+  if (r < 0)  return retryMs();
+  waiting  = true;
+  sentMono = pollMono = now;
+  st.requests++;
+  return SCHED_TICK_MS;
+}
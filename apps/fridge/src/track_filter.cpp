@@ -0,0 +1,85 @@
+#include "track_filter.h"
+
+// 초기화 직후 변화율 불확실성 (단위/s). 실내 공기 온도가 이보다 빨리 변하는 일은 드물다
+static const float TRACK_INIT_RATE_SIGMA = 0.05f;
+
+void TrackFilter::reset() {
+  ready_      = false;
+  x_          = 0.0f;
+  v_          = 0.0f;
+  p00_        = 0.0f;
+  p01_        = 0.0f;
+  p11_        = 0.0f;
+  lastInnov_  = 0.0f;
+  outlierRun_ = 0;
+}
+
+void TrackFilter::init(float z) {
+  ready_      = true;
+  x_          = z;
+  v_          = 0.0f;
+  p00_        = p_.measNoise * p_.measNoise;
+  p01_        = 0.0f;
+  p11_        = TRACK_INIT_RATE_SIGMA * TRACK_INIT_RATE_SIGMA;
+  lastInnov_  = 0.0f;
+  outlierRun_ = 0;
+}
+
+TrackResult TrackFilter::update(float z, float dt) {
+  if (!ready_) {
+    init(z);
+    return TRACK_INIT;
+  }
+  if (dt < 0.0f) dt = 0.0f;
+
+  // --- 예측: x += v·dt, P = F P Fᵀ + Q ---
+  float q   = p_.accelNoise * p_.accelNoise;
+  float dt2 = dt * dt;
+  x_   += v_ * dt;
+  p00_ += dt * 2.0f * p01_ + dt2 * p11_ + q * dt2 * dt2 * 0.25f;
+  p01_ += dt * p11_ + q * dt2 * dt * 0.5f;
+  p11_ += q * dt2;
+
+  // --- 혁신 게이트 ---
+  float r = p_.measNoise * p_.measNoise;
+  float y = z - x_;
+  float s = p00_ + r;
+  lastInnov_ = y;
+  if (y * y > p_.gateSigma * p_.gateSigma * s) {
+    if (outlierRun_ == 0 || z < outlierMin_) outlierMin_ = z;
+    if (outlierRun_ == 0 || z > outlierMax_) outlierMax_ = z;
+    if (outlierRun_ < 255) outlierRun_++;
+    if (outlierRun_ >= p_.recoverN) {
+      if (outlierMax_ - outlierMin_ <= p_.recoverBand) {
+        init(z);
+        return TRACK_RECOVERED;
+      }
+      // 흩어진 값이면 가장 최근 것부터 다시 모은다
+      outlierRun_ = 1;
+      outlierMin_ = z;
+      outlierMax_ = z;
+    }
+    return TRACK_OUTLIER;
+  }
+  outlierRun_ = 0;
+
+  // --- 갱신 ---
+  float k0 = p00_ / s;
+  float k1 = p01_ / s;
+  x_   += k0 * y;
+  v_   += k1 * y;
+  p11_ -= k1 * p01_;
+  p01_ -= k0 * p01_;
+  p00_ -= k0 * p00_;
+  return TRACK_ACCEPTED;
+}
+
+const char* trackResultName(TrackResult r) {
+  switch (r) {
+    case TRACK_INIT:      return "init";
+    case TRACK_ACCEPTED:  return "accepted";
+    case TRACK_OUTLIER:   return "outlier";
+    case TRACK_RECOVERED: return "recovered";
+  }
+  return "unknown";
+}
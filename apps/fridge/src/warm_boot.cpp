@@ -0,0 +1,218 @@
+#include <Arduino.h>
+#include <stddef.h>
+#include <string.h>
+#include "warm_boot.h"
+#include "log.h"
+#ifdef ESP32
+#include <esp_system.h>
+#include <esp32/rtc.h>
+#endif
+
+static const uint32_t WARM_MAGIC   = 0x57524D42;   // "WRMB"
+static const uint16_t WARM_VERSION = 1;            // 레이아웃이 바뀌면 올린다 (OTA 뒤 옛 기록을 읽지 않게)
+
+// ===== 리셋을 넘어 남는 기록 =====
+struct WarmNet {
+  uint32_t magic;
+  uint16_t version;
+  uint8_t  hasWifi;
+  uint8_t  hasEpoch;
+  WarmWifi wifi;
+  int64_t  epochBaseMs;   // NTP 시각(ms) - rtcMs()
+  uint32_t crc;
+};
+
+struct WarmControl {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t zones;
+  uint64_t savedMs;       // rtcMs()
+  WarmZone zone[ZONE_COUNT];
+  uint32_t crc;
+};
+
+#ifdef ESP32
+RTC_NOINIT_ATTR static WarmNet     rtcNet;
+RTC_NOINIT_ATTR static WarmControl rtcCtl;
+#else
+// 시뮬레이터 재부팅(simBoot)은 정적 변수를 건드리지 않는다
+static WarmNet     rtcNet;
+static WarmControl rtcCtl;
+static bool        simBooted = false;
+#endif
+
+static WarmNet           net;            // loop 태스크 작업 사본 (저장할 때 통째로 rtcNet 에)
+static WarmControl       restored;       // 이번 부팅에 쓸 제어 기록 (warmBegin 에서 한 번)
+static bool              restoredValid = false;
+static bool              warmEnabled   = true;
+static unsigned long     bootBaseMs    = 0;
+static BootInfo          boot          = {};
+static volatile uint32_t firstPwmMs    = 0;   // 제어 태스크가 씀
+static volatile uint8_t  zonesRestored = 0;
+
+// 리셋을 넘어 이어지는 시계 (ms). ESP32 는 RTC 타이머 (전원 투입 때만 0부터), 네이티브는 가상 시계
+static uint64_t rtcMs() {
+#ifdef ESP32
+  return esp_rtc_get_time_us() / 1000ULL;
+#else
+  return (uint64_t)millis();
+#endif
+}
+
+static uint32_t sinceBoot() {
+  uint32_t ms = (uint32_t)(millis() - bootBaseMs);
+  return ms ? ms : 1;   // 0 = 아직
+}
+
+// CRC-32 (IEEE, 비트 단위). 기록이 수십 바이트라 표 없이
+static uint32_t crc32(const void* data, size_t len) {
+  const uint8_t* p   = (const uint8_t*)data;
+  uint32_t       crc = 0xFFFFFFFFu;
+  while (len--) {
+    crc ^= *p++;
+    for (uint8_t k = 0; k < 8; k++) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+  }
+  return ~crc;
+}
+
+template <typename T>
+static bool recordValid(const T& r) {
+  return r.magic == WARM_MAGIC && r.version == WARM_VERSION && r.crc == crc32(&r, offsetof(T, crc));
+}
+
+template <typename T>
+static void recordSeal(T& r) {
+  r.magic   = WARM_MAGIC;
+  r.version = WARM_VERSION;
+  r.crc     = crc32(&r, offsetof(T, crc));
+}
+
+static const char* resetReasonName() {
+#ifdef ESP32
+  switch (esp_reset_reason()) {
+    case ESP_RST_POWERON:   return "poweron";
+    case ESP_RST_EXT:       return "ext";
+    case ESP_RST_SW:        return "sw";
+    case ESP_RST_PANIC:     return "panic";
+    case ESP_RST_INT_WDT:
+    case ESP_RST_TASK_WDT:
+    case ESP_RST_WDT:       return "wdt";
+    case ESP_RST_DEEPSLEEP: return "deepsleep";
+    case ESP_RST_BROWNOUT:  return "brownout";
+    default:                return "unknown";
+  }
+#else
+  return simBooted ? "sw" : "poweron";
+#endif
+}
+
+void warmBegin() {
+#ifdef ESP32
+  bootBaseMs = 0;   // millis() 가 이미 부팅 기준 (setup() 이전 시간 포함)
+#else
+  bootBaseMs = millis();
+  simBooted  = true;
+#endif
+  boot          = BootInfo();
+  boot.reason   = resetReasonName();
+  firstPwmMs    = 0;
+  zonesRestored = 0;
+
+  // 전원 투입 직후의 RTC 메모리는 쓰레기값 (CRC 로도 걸러지지만 사유로 먼저)
+  bool keep = warmEnabled && strcmp(boot.reason, "poweron") != 0 && strcmp(boot.reason, "unknown") != 0;
+
+  if (keep && recordValid(rtcNet)) net = rtcNet;
+  else                             memset(&net, 0, sizeof(net));
+
+  uint64_t now  = rtcMs();
+  restoredValid = keep && recordValid(rtcCtl) && rtcCtl.zones == ZONE_COUNT &&
+                  now >= rtcCtl.savedMs && now - rtcCtl.savedMs <= WARM_MAX_AGE_MS;
+  if (restoredValid) restored = rtcCtl;
+  rtcCtl.magic = 0;   // 한 번만 쓴다 (제어 태스크가 첫 주기에 새로 기록)
+
+  LOG_I(SYS, "reset=%s wifi_cache=%d epoch=%d control=%s", boot.reason,
+        (int)net.hasWifi, (int)net.hasEpoch, restoredValid ? "warm" : "cold");
+}
+
+BootInfo bootInfo() {
+  BootInfo b      = boot;
+  b.firstPwmMs    = firstPwmMs;
+  b.zonesRestored = zonesRestored;
+  return b;
+}
+
+// ==================== loop 태스크 ====================
+bool warmWifi(WarmWifi& out) {
+  if (!net.hasWifi) return false;
+  out             = net.wifi;
+  boot.wifiCached = true;
+  return true;
+}
+
+static void saveNet() {
+  recordSeal(net);
+  rtcNet = net;
+}
+
+void warmSaveWifi(const WarmWifi& w) {
+  net.wifi    = w;
+  net.hasWifi = 1;
+  saveNet();
+}
+
+void warmForgetWifi() {
+  if (!net.hasWifi) return;
+  net.hasWifi = 0;
+  saveNet();
+}
+
+void warmSaveEpoch(uint64_t unixMs) {
+  if (!unixMs) return;
+  net.epochBaseMs = (int64_t)unixMs - (int64_t)rtcMs();
+  net.hasEpoch    = 1;
+  saveNet();
+}
+
+// RTC 타이머는 부팅 때 보정된 내부 RC 라 수 분 단위로는 초 단위 오차. SNTP 가 맞추기 전까지만 쓴다
+uint64_t warmEpochMs() {
+  if (!net.hasEpoch) return 0;
+  int64_t t = net.epochBaseMs + (int64_t)rtcMs();
+  return t > 0 ? (uint64_t)t : 0;
+}
+
+void bootMarkWifi() {
+  if (!boot.wifiMs) boot.wifiMs = sinceBoot();
+}
+
+void bootMarkPublish() {
+  if (!boot.firstPublishMs) boot.firstPublishMs = sinceBoot();
+}
+
+// ==================== 제어 태스크 ====================
+bool warmZone(uint8_t z, WarmZone& out) {
+  if (!restoredValid || z >= ZONE_COUNT) return false;
+  out = restored.zone[z];
+  return true;
+}
+
+void warmSaveControl(const WarmZone* zones) {
+  WarmControl r;
+  memset(&r, 0, sizeof(r));   // 패딩까지 정해진 값으로 (CRC 대상)
+  r.zones   = ZONE_COUNT;
+  r.savedMs = rtcMs();
+  memcpy(r.zone, zones, sizeof(r.zone));
+  recordSeal(r);
+  rtcCtl = r;
+}
+
+void warmNoteRestored() {
+  zonesRestored = zonesRestored + 1;
+}
+
+void bootMarkPwm() {
+  if (!firstPwmMs) firstPwmMs = sinceBoot();
+}
+
+void warmSetEnabled(bool on) {
+  warmEnabled = on;
+}
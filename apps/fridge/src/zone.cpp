@@ -0,0 +1,45 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "zone.h"
+
+static const char* const TOPIC_SUFFIX[ZONE_TOPIC_COUNT] = {
+  TOPIC_STATUS, TOPIC_CMD, TOPIC_ACK, TOPIC_STATUS_BACKLOG, TOPIC_STATUS_BATCH, TOPIC_STATUS_AGG,
+};
+
+static char topics[ZONE_COUNT][ZONE_TOPIC_COUNT][TOPIC_MAX];
+static bool topicsBuilt = false;
+
+static void buildTopics() {
+  for (uint8_t z = 0; z < ZONE_COUNT; z++) {
+    for (uint8_t t = 0; t < ZONE_TOPIC_COUNT; t++) {
+      if (ZONE_COUNT == 1)
+        snprintf(topics[z][t], TOPIC_MAX, "%s/%s", TOPIC_ROOT, TOPIC_SUFFIX[t]);
+      else
+        snprintf(topics[z][t], TOPIC_MAX, "%s/%s/%s", TOPIC_ROOT, ZONE_TABLE[z].name, TOPIC_SUFFIX[t]);
+    }
+  }
+  topicsBuilt = true;
+}
+
+const char* zoneTopic(uint8_t zone, ZoneTopic t) {
+  if (!topicsBuilt) buildTopics();
+  if (zone >= ZONE_COUNT || t >= ZONE_TOPIC_COUNT) return "";
+  return topics[zone][t];
+}
+
+int zoneFromCmdTopic(const char* topic) {
+  for (uint8_t z = 0; z < ZONE_COUNT; z++)
+    if (strcmp(topic, zoneTopic(z, ZONE_TOPIC_CMD)) == 0) return z;
+  return -1;
+}
+
+int zoneFromArg(const char* arg) {
+  if (!arg || !arg[0]) return -1;
+  for (uint8_t z = 0; z < ZONE_COUNT; z++)
+    if (strcmp(arg, ZONE_TABLE[z].name) == 0) return z;
+  char* end;
+  long  v = strtol(arg, &end, 10);
+  if (*end != '\0' || v < 0 || v >= ZONE_COUNT) return -1;
+  return (int)v;
+}
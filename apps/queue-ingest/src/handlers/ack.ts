@@ -6,6 +6,7 @@ export async function handleAck(payload: string) {
 	try {
 		const ack = JSON.parse(payload) as AckPayload;
 		const value = ack.value?.toString() ?? null;
+		const ts = new Date(ack.ts > 0 ? ack.ts : Date.now());
 
 		if (ack.success) {
 			console.log(
@@ -20,17 +21,17 @@ export async function handleAck(payload: string) {
 				.values({
 					cmd_id: ack.id,
 					type: ack.cmd,
-					ts: new Date(ack.ts * 1000),
+					ts,
 					value: value,
 					completed: true,
-					completed_at: new Date(ack.ts * 1000),
+					completed_at: ts,
 				})
 				.onConflictDoUpdate({
 					target: [commands.cmd_id],
 					set: {
 						completed: true,
 						value: value,
-						completed_at: new Date(ack.ts * 1000),
+						completed_at: ts,
 					},
 				});
 		}
@@ -47,7 +48,7 @@ export async function handleAck(payload: string) {
 				.values({
 					cmd_id: ack.id,
 					type: ack.cmd,
-					ts: new Date(ack.ts * 1000),
+					ts,
 					value: value,
 					completed: false,
 					error: ack.error,
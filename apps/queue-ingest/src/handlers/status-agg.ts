@@ -0,0 +1,56 @@
+import chalk from 'chalk';
+import { StatusAggregatePayload } from '@craft-brew/protocol';
+import { db, fridgeMinutes } from '@craft-brew/database';
+import { redis } from '../lib/redis';
+
+const num = (v: number | null) => (v === null ? null : v.toString());
+
+/**
+ * 기기가 만든 분 단위 집계 저장
+ * - 창 하나 = fridge_minutes 한 줄, INSERT 한 번 (재전송은 PK 충돌로 무시)
+ * - NTP 동기 전 창(ts=0)은 받은 시각 직전 분으로 둠
+ * - 실시간 상태(redis)는 status 토픽이 담당
+ */
+export async function handleStatusAgg(payload: string) {
+	try {
+		const agg = JSON.parse(payload) as StatusAggregatePayload;
+		if (agg.v !== 1 || !agg.samples) {
+			console.error(chalk.redBright('[AGG]'), 'unsupported payload');
+			return;
+		}
+
+		const period = agg.period || 60;
+		const ts =
+			agg.ts && agg.ts > 0
+				? agg.ts
+				: Math.floor(Date.now() / 1000 / period) * period - period;
+		const beer = await redis.getBeer();
+
+		await db
+			.insert(fridgeMinutes)
+			.values({
+				recordedAt: new Date(ts * 1000),
+				samples: agg.samples,
+				tempMin: num(agg.temp_min),
+				tempMax: num(agg.temp_max),
+				tempMean: num(agg.temp_mean),
+				humidityMin: num(agg.humidity_min),
+				humidityMax: num(agg.humidity_max),
+				humidityMean: num(agg.humidity_mean),
+				outputMean: agg.output_mean.toString(),
+				outputMax: agg.output_max.toString(),
+				coolingSec: agg.cooling_sec,
+				energyWh: agg.energy_wh.toString(),
+				sensorRejects: agg.rejects,
+				targetTemp: num(agg.target),
+				beerId: beer?.id ?? null,
+			})
+			.onConflictDoNothing();
+		console.log(chalk.green('[AGG]'), `saved minute ${ts}`);
+	} catch (error) {
+		console.error(
+			chalk.redBright('[AGG] error:'),
+			chalk.red((error as Error).message),
+		);
+	}
+}
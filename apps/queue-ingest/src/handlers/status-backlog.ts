@@ -0,0 +1,56 @@
+import chalk from 'chalk';
+import { StatusBacklogPayload } from '@craft-brew/protocol';
+import { db, fridgeLogs, InsertFridgeLog } from '@craft-brew/database';
+import { redis } from '../lib/redis';
+
+const DB_SAVE_BUCKET_SEC = 60;
+
+/**
+ * MQTT 끊김 동안 기기에 쌓였다가 재전송된 기록 저장
+ * - 실시간 상태(redis)는 건드리지 않음 (과거 값이므로)
+ * - 실시간 저장과 같은 1분 간격으로 솎아서 fridge_logs 에 저장
+ */
+export async function handleStatusBacklog(payload: string) {
+	try {
+		const backlog = JSON.parse(payload) as StatusBacklogPayload;
+		if (backlog.v !== 1 || !Array.isArray(backlog.records)) {
+			console.error(chalk.redBright('[BACKLOG]'), 'unsupported payload');
+			return;
+		}
+
+		const beer = await redis.getBeer();
+		const rows: InsertFridgeLog[] = [];
+		let lastBucket = -1;
+
+		for (const [ts, temp, humidity, power, target] of backlog.records) {
+			// NTP 동기 전 기록(ts=0)이나 센서 값이 없는 기록은 시간축에 둘 수 없음
+			if (!ts || temp === null) continue;
+			const bucket = Math.floor(ts / DB_SAVE_BUCKET_SEC);
+			if (bucket === lastBucket) continue;
+			lastBucket = bucket;
+
+			rows.push({
+				recordedAt: new Date(ts * 1000),
+				temperature: temp.toString(),
+				humidity: humidity?.toString() ?? null,
+				peltierPower: power,
+				targetTemp: target?.toString() ?? null,
+				beerId: beer?.id ?? null,
+			});
+		}
+
+		console.log(
+			chalk.blue('[BACKLOG]'),
+			`received ${backlog.records.length} records, ${rows.length} to save`,
+		);
+		if (rows.length === 0) return;
+
+		await db.insert(fridgeLogs).values(rows).onConflictDoNothing();
+		console.log(chalk.green('[BACKLOG]'), 'saved to db');
+	} catch (error) {
+		console.error(
+			chalk.redBright('[BACKLOG] error:'),
+			chalk.red((error as Error).message),
+		);
+	}
+}
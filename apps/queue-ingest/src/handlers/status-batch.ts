@@ -0,0 +1,72 @@
+import chalk from 'chalk';
+import { decodeStatusBatch } from '@craft-brew/protocol';
+import { db, fridgeLogs, InsertFridgeLog } from '@craft-brew/database';
+import { redis } from '../lib/redis';
+
+const DB_SAVE_THROTTLE_SEC = 60;
+
+/**
+ * 바이너리 상태 배치 처리
+ * - 마지막 샘플로 실시간 상태(redis) 갱신
+ * - 실시간 JSON 과 같은 1분 간격으로 솎아서 fridge_logs 에 한 번에 저장
+ */
+export async function handleStatusBatch(message: Buffer) {
+	try {
+		const batch = decodeStatusBatch(message);
+		if (!batch) {
+			console.error(chalk.redBright('[BATCH]'), 'invalid payload');
+			return;
+		}
+
+		// NTP 미동기 배치는 수신 시각을 마지막 샘플 시각으로 보고 역산
+		const nowSec = Math.floor(Date.now() / 1000);
+		const lastOffset = batch.offsets[batch.offsets.length - 1];
+		const samples = batch.samples.map((s, i) => ({
+			...s,
+			ts: s.ts > 0 ? s.ts : nowSec - (lastOffset - batch.offsets[i]),
+		}));
+		console.log(chalk.blue('[BATCH]'), `received ${samples.length} samples`);
+
+		const last = samples[samples.length - 1];
+		await redis.setStatus({
+			temp: last.temp,
+			humidity: last.humidity,
+			power: last.power,
+			target: last.target,
+			updatedAt: last.ts,
+		});
+
+		const beer = await redis.getBeer();
+		let lastDBSaveAt = (await redis.getLastDBSaveAt()) ?? 0;
+		const rows: InsertFridgeLog[] = [];
+
+		for (const s of samples) {
+			if (s.temp === null) continue;
+			if (s.ts - lastDBSaveAt < DB_SAVE_THROTTLE_SEC) continue;
+			lastDBSaveAt = s.ts;
+			await redis.addReading(s.temp, s.humidity ?? 0);
+			rows.push({
+				recordedAt: new Date(s.ts * 1000),
+				temperature: s.temp.toString(),
+				humidity: s.humidity?.toString() ?? null,
+				peltierPower: s.power,
+				targetTemp: s.target?.toString() ?? null,
+				beerId: beer?.id ?? null,
+			});
+		}
+
+		if (rows.length === 0) {
+			console.log(chalk.gray('[BATCH]'), 'db save skipped (throttled)');
+			return;
+		}
+
+		await db.insert(fridgeLogs).values(rows).onConflictDoNothing();
+		await redis.setLastDBSaveAt(lastDBSaveAt);
+		console.log(chalk.green('[BATCH]'), `saved ${rows.length} rows to db`);
+	} catch (error) {
+		console.error(
+			chalk.redBright('[BATCH] error:'),
+			chalk.red((error as Error).message),
+		);
+	}
+}
@@ -13,8 +13,9 @@ export async function handleStatus(payload: string) {
 		const status = JSON.parse(payload) as StatusPayload;
 		console.log(chalk.blue('[STATUS]'), 'received', status);
 
-		const nowSec = Math.floor(Date.now() / 1000);
-		const ts = status.ts && status.ts > 0 ? status.ts : nowSec;
+		// 펌웨어 ts 는 unix ms (0 = 시각 모름 → 받은 시각)
+		const tsMs = status.ts && status.ts > 0 ? status.ts : Date.now();
+		const ts = Math.floor(tsMs / 1000);
 
 		await redis.setStatus({
 			temp: status.temp,
@@ -37,7 +38,7 @@ export async function handleStatus(payload: string) {
 			const beer = await redis.getBeer();
 
 			const existedLog = await db.query.fridgeLogs.findFirst({
-				where: eq(fridgeLogs.recordedAt, new Date(ts * 1000)),
+				where: eq(fridgeLogs.recordedAt, new Date(tsMs)),
 			});
 
 			if (existedLog) {
@@ -46,7 +47,7 @@ export async function handleStatus(payload: string) {
 			}
 
 			await db.insert(fridgeLogs).values({
-				recordedAt: new Date(ts * 1000),
+				recordedAt: new Date(tsMs),
 				temperature: status.temp?.toString(),
 				humidity: status.humidity?.toString(),
 				peltierPower: status.power,
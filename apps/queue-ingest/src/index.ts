@@ -5,6 +5,9 @@ import './cron';
 import { config } from './config';
 import { TOPICS } from './topics';
 import { handleStatus } from './handlers/status';
+import { handleStatusBacklog } from './handlers/status-backlog';
+import { handleStatusBatch } from './handlers/status-batch';
+import { handleStatusAgg } from './handlers/status-agg';
 import { handleAck } from './handlers/ack';
 import { recoverMissedStats } from './cron/daily-stats';
 
@@ -28,24 +31,35 @@ mqttClient.on('connect', (connack) => {
 		)}`,
 	);
 
-	mqttClient.subscribe([TOPICS.STATUS_SUB], { qos: 1 }, (err, granted) => {
-		if (err) {
-			console.error(
-				`${tag} ${chalk.redBright('subscribe error:')} ${chalk.red(
-					err.message,
+	mqttClient.subscribe(
+		[
+			TOPICS.STATUS_SUB,
+			TOPICS.STATUS_BACKLOG_SUB,
+			TOPICS.STATUS_BATCH_SUB,
+			TOPICS.STATUS_AGG_SUB,
+		],
+		{ qos: 1 },
+		(err, granted) => {
+			if (err) {
+				console.error(
+					`${tag} ${chalk.redBright('subscribe error:')} ${chalk.red(
+						err.message,
+					)}`,
+				);
+				return;
+			}
+			console.log(
+				`${tag} ${chalk.cyanBright('subscribed to topics')} ${chalk.gray(
+					`${TOPICS.STATUS_SUB}, ${TOPICS.STATUS_BACKLOG_SUB}, ${TOPICS.STATUS_BATCH_SUB}, ${TOPICS.STATUS_AGG_SUB}`,
 				)}`,
 			);
-			return;
-		}
-		console.log(
-			`${tag} ${chalk.cyanBright('subscribed to topics')} ${chalk.gray(
-				TOPICS.STATUS_SUB,
-			)}`,
-		);
-		if (granted?.[0]?.qos === 128) {
-			console.error(`${tag} broker rejected subscription (ACL / not allowed)`);
-		}
-	});
+			if (granted?.some((g) => g.qos === 128)) {
+				console.error(
+					`${tag} broker rejected subscription (ACL / not allowed)`,
+				);
+			}
+		},
+	);
 
 	mqttClient.subscribe([TOPICS.ACK], { qos: 2 }, (err) => {
 		if (err) {
@@ -65,6 +79,13 @@ mqttClient.on('connect', (connack) => {
 });
 
 mqttClient.on('message', (topic, message) => {
+	// 바이너리 배치는 문자열로 바꾸지 않고 그대로 넘김
+	if (topic === TOPICS.STATUS_BATCH_PUB) {
+		console.log(`${tag} RX topic=${topic} bytes=${message.length}`);
+		handleStatusBatch(message);
+		return;
+	}
+
 	const payload = message.toString();
 	console.log(`${tag} RX topic=${topic} payload=${payload.toString()}`);
 
@@ -72,6 +93,12 @@ mqttClient.on('message', (topic, message) => {
 		case TOPICS.STATUS_PUB:
 			handleStatus(payload);
 			break;
+		case TOPICS.STATUS_BACKLOG_PUB:
+			handleStatusBacklog(payload);
+			break;
+		case TOPICS.STATUS_AGG_PUB:
+			handleStatusAgg(payload);
+			break;
 		case TOPICS.ACK:
 			handleAck(payload);
 			break;
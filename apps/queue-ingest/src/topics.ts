@@ -1,5 +1,11 @@
 export const TOPICS = {
 	STATUS_PUB: '/homebrew/status',
 	STATUS_SUB: '$share/status-writer//homebrew/status',
+	STATUS_BACKLOG_PUB: '/homebrew/status/backlog',
+	STATUS_BACKLOG_SUB: '$share/status-writer//homebrew/status/backlog',
+	STATUS_BATCH_PUB: '/homebrew/status/batch',
+	STATUS_BATCH_SUB: '$share/status-writer//homebrew/status/batch',
+	STATUS_AGG_PUB: '/homebrew/status/agg',
+	STATUS_AGG_SUB: '$share/status-writer//homebrew/status/agg',
 	ACK: '/homebrew/ack',
 } as const;
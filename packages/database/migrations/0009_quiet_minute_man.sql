@@ -0,0 +1,23 @@
+CREATE TABLE IF NOT EXISTS "fridge_minutes" (
+	"recorded_at" timestamp PRIMARY KEY NOT NULL,
+	"samples" smallint NOT NULL,
+	"temp_min" numeric(4, 1),
+	"temp_max" numeric(4, 1),
+	"temp_mean" numeric(4, 1),
+	"humidity_min" numeric(4, 1),
+	"humidity_max" numeric(4, 1),
+	"humidity_mean" numeric(4, 1),
+	"output_mean" numeric(4, 1) NOT NULL,
+	"output_max" numeric(4, 1) NOT NULL,
+	"cooling_sec" smallint NOT NULL,
+	"energy_wh" numeric(7, 3) NOT NULL,
+	"sensor_rejects" smallint NOT NULL,
+	"target_temp" numeric(3, 1),
+	"beer_id" integer
+);
+--> statement-breakpoint
+DO $$ BEGIN
+ ALTER TABLE "fridge_minutes" ADD CONSTRAINT "fridge_minutes_beer_id_beers_id_fk" FOREIGN KEY ("beer_id") REFERENCES "public"."beers"("id") ON DELETE no action ON UPDATE no action;
+EXCEPTION
+ WHEN duplicate_object THEN null;
+END $$;
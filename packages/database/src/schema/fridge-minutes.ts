@@ -0,0 +1,35 @@
+import {
+	pgTable,
+	timestamp,
+	decimal,
+	smallint,
+	integer,
+} from 'drizzle-orm/pg-core';
+import { beers } from './beers';
+
+// 기기가 보낸 분 단위 집계 (status/agg). 분마다 한 줄, 샘플을 솎지 않은 값
+export const fridgeMinutes = pgTable('fridge_minutes', {
+	recordedAt: timestamp('recorded_at', { mode: 'date' }).primaryKey(), // 창 시작
+
+	samples: smallint('samples').notNull(),
+
+	tempMin: decimal('temp_min', { precision: 4, scale: 1 }),
+	tempMax: decimal('temp_max', { precision: 4, scale: 1 }),
+	tempMean: decimal('temp_mean', { precision: 4, scale: 1 }),
+	humidityMin: decimal('humidity_min', { precision: 4, scale: 1 }),
+	humidityMax: decimal('humidity_max', { precision: 4, scale: 1 }),
+	humidityMean: decimal('humidity_mean', { precision: 4, scale: 1 }),
+
+	outputMean: decimal('output_mean', { precision: 4, scale: 1 }).notNull(), // PID 출력 (%)
+	outputMax: decimal('output_max', { precision: 4, scale: 1 }).notNull(),
+	coolingSec: smallint('cooling_sec').notNull(),
+	energyWh: decimal('energy_wh', { precision: 7, scale: 3 }).notNull(),
+	sensorRejects: smallint('sensor_rejects').notNull(),
+	targetTemp: decimal('target_temp', { precision: 3, scale: 1 }),
+
+	beerId: integer('beer_id').references(() => beers.id),
+});
+
+export type FridgeMinute = typeof fridgeMinutes.$inferSelect;
+
+export type InsertFridgeMinute = typeof fridgeMinutes.$inferInsert;
@@ -1,4 +1,5 @@
 export * from './beers';
 export * from './fridge-logs';
+export * from './fridge-minutes';
 export * from './commands';
 export * from './daily-stats';
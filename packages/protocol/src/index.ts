@@ -1,7 +1,11 @@
 export interface StatusPayload {
 	qos: 1;
-	/** 온도 (°C) */
+	/** 온도 (°C, 칼만 필터 추정값) */
 	temp: number;
+	/** 필터 전 측정 온도 (°C) */
+	temp_raw?: number | null;
+	/** 추정 온도 변화율 (°C/분) */
+	temp_rate?: number;
 	/** 습도 (%) */
 	humidity: number;
 	/** 펠티어 사용 여부 */
@@ -10,17 +14,71 @@ export interface StatusPayload {
 	power: number;
 	/** 목표 온도 (°C) */
 	target: number;
-	/** 타임스탬프 (ms) */
+	/** 타임스탬프 (unix ms, 기기가 시각을 모르면 0) */
 	ts: number;
+	/** 발행 사유 (보고 정책: 이벤트 / dead-band / heartbeat) */
+	reason?: StatusReportReason;
+	/** 발효 스케줄 진행 (스케줄이 있을 때만) */
+	schedule?: ScheduleProgress;
 }
 
+export interface ScheduleProgress {
+	/** waiting = 시작 전이거나 기기 시각 미동기 */
+	state: 'waiting' | 'running' | 'done';
+	/** 진행 중 구간 (1부터) */
+	step: number;
+	steps: number;
+	/** 스케줄 시작부터 경과 (s) */
+	elapsed: number;
+	/** 전체 길이 (s) */
+	total: number;
+}
+
+export type StatusReportReason =
+	| 'first'
+	| 'sensor_fault'
+	| 'sensor_ok'
+	| 'cooling_start'
+	| 'cooling_stop'
+	| 'target'
+	| 'peltier'
+	| 'power'
+	| 'temp'
+	| 'humidity'
+	| 'heartbeat';
+
 export interface ConnectPayload {
 	qos: 1;
 	/** 타임스탬프 (ms) */
 	ts: number;
 }
 
-export type Command = 'set_target' | 'set_peltier' | 'restart';
+export type Command = 'set_target' | 'set_peltier' | 'restart' | 'set_report' | 'set_schedule';
+
+/** set_report 값 (존별 상태 보고 정책, 빠진 필드는 그대로) */
+export interface ReportPolicyValue {
+	/** 변화가 없을 때 발행 간격 (s, 10~3600) */
+	heartbeat?: number;
+	/** 온도 dead-band (°C, 0.1~5) */
+	temp?: number;
+	/** 습도 dead-band (%, 0.5~50) */
+	humidity?: number;
+	/** 이만큼 바뀌면 바로 발행하는 출력 계단 (%p, 1~100) */
+	power?: number;
+}
+
+/**
+ * 스케줄 구간 [종류, 목표(°C), 길이(분)]
+ * ramp = 직전 구간 끝 값(첫 구간은 업로드 당시 목표)에서 직선으로, hold = 유지
+ */
+export type ScheduleSegment = ['ramp' | 'hold', number, number];
+
+/** set_schedule 값 (최대 8구간, null = 지금 목표에서 멈추고 취소). set_target 도 스케줄을 취소한다 */
+export interface ScheduleValue {
+	/** 시작 시각 (unix s, 없으면 받은 시각) */
+	start?: number;
+	segments: ScheduleSegment[];
+}
 
 export interface AckPayload {
 	qos: 2;
@@ -34,7 +92,7 @@ export interface AckPayload {
 	success: boolean;
 	/** 에러 메시지 */
 	error: string | null;
-	/** 타임스탬프 (ms) */
+	/** 타임스탬프 (unix ms, 기기가 시각을 모르면 0) */
 	ts: number;
 }
 
@@ -43,9 +101,142 @@ export interface CommandPayload {
 	/** 명령 ID */
 	id: string;
 	/** 명령 값 */
-	value: number | null;
+	value: number | ReportPolicyValue | ScheduleValue | null;
 	/** 명령 */
 	cmd: Command;
 	/** 타임스탬프 (ms) */
 	ts: number;
 }
+
+/**
+ * 재전송 상태 기록
+ * [ts(s), temp(°C), humidity(%), power(%), target(°C), flags]
+ * flags: bit0 = 펠티어 사용, bit1 = 냉각 중
+ */
+export type StatusBacklogRecord = [
+	number,
+	number | null,
+	number | null,
+	number,
+	number | null,
+	number,
+];
+
+export interface StatusBacklogPayload {
+	qos: 1;
+	/** 포맷 버전 */
+	v: 1;
+	/** MQTT 끊김 동안 쌓인 기록 (오래된 순) */
+	records: StatusBacklogRecord[];
+}
+
+/**
+ * 바이너리 상태 배치 (/homebrew/status/batch, v1)
+ * 레이아웃은 apps/fridge/include/status_codec.h 와 동일 (리틀 엔디언)
+ *
+ * 헤더 14바이트: version u8, count u8, flags u8 (bit0 = 펠티어 사용), reserved u8,
+ *   ts u32 (첫 샘플, unix 초, 0 = NTP 미동기), temp i16, humidity i16, target i16 (0.1 단위, -32768 = null)
+ * 샘플 4바이트 × count: dt u8 (초), temp 델타 i8, humidity 델타 i8, power u8 (bit7 = 냉각 중)
+ */
+export const STATUS_BATCH_VERSION = 1;
+export const STATUS_BATCH_HEADER_SIZE = 14;
+export const STATUS_BATCH_SAMPLE_SIZE = 4;
+
+const STATUS_BATCH_NULL16 = -32768;
+
+export interface StatusBatchSample {
+	/** 타임스탬프 (s), NTP 미동기 배치면 0 */
+	ts: number;
+	/** 온도 (°C) */
+	temp: number | null;
+	/** 습도 (%) */
+	humidity: number | null;
+	/** 펠티어 활성화 정도 (%) */
+	power: number;
+	/** 목표 온도 (°C) */
+	target: number | null;
+	/** 펠티어 사용 여부 */
+	peltier_enabled: boolean;
+	/** 냉각 중 여부 */
+	cooling: boolean;
+}
+
+export interface StatusBatch {
+	/** 첫 샘플 기준 누적 간격 (s). ts 가 0 인 배치의 시각 복원용 */
+	offsets: number[];
+	samples: StatusBatchSample[];
+}
+
+/** 형식이 맞지 않으면 null */
+export function decodeStatusBatch(buf: Uint8Array): StatusBatch | null {
+	if (buf.length < STATUS_BATCH_HEADER_SIZE) return null;
+	const view = new DataView(buf.buffer, buf.byteOffset, buf.byteLength);
+	const version = view.getUint8(0);
+	const count = view.getUint8(1);
+	if (version !== STATUS_BATCH_VERSION || count === 0) return null;
+	if (buf.length !== STATUS_BATCH_HEADER_SIZE + count * STATUS_BATCH_SAMPLE_SIZE)
+		return null;
+
+	const peltierEnabled = (view.getUint8(2) & 0x01) !== 0;
+	const baseTs = view.getUint32(4, true);
+	let temp10 = view.getInt16(8, true);
+	let hum10 = view.getInt16(10, true);
+	const target10 = view.getInt16(12, true);
+	const target = target10 === STATUS_BATCH_NULL16 ? null : target10 / 10;
+
+	const offsets: number[] = [];
+	const samples: StatusBatchSample[] = [];
+	let offset = 0;
+	for (let i = 0; i < count; i++) {
+		const p = STATUS_BATCH_HEADER_SIZE + i * STATUS_BATCH_SAMPLE_SIZE;
+		offset += view.getUint8(p);
+		if (temp10 !== STATUS_BATCH_NULL16) temp10 += view.getInt8(p + 1);
+		if (hum10 !== STATUS_BATCH_NULL16) hum10 += view.getInt8(p + 2);
+		const power = view.getUint8(p + 3);
+
+		offsets.push(offset);
+		samples.push({
+			ts: baseTs ? baseTs + offset : 0,
+			temp: temp10 === STATUS_BATCH_NULL16 ? null : temp10 / 10,
+			humidity: hum10 === STATUS_BATCH_NULL16 ? null : hum10 / 10,
+			power: power & 0x7f,
+			target,
+			peltier_enabled: peltierEnabled,
+			cooling: (power & 0x80) !== 0,
+		});
+	}
+	return { offsets, samples };
+}
+
+/**
+ * 분 단위 집계 (/homebrew/status/agg, v1)
+ * 제어 주기(2초) 샘플을 빠짐없이 묶은 창 하나. 온도/습도/목표는 0.1 단위로 반올림된 값
+ */
+export interface StatusAggregatePayload {
+	qos: 1;
+	/** 포맷 버전 */
+	v: 1;
+	/** 창 시작 (unix 초, NTP 미동기 = 0) */
+	ts: number;
+	/** 창 길이 (s) */
+	period: number;
+	/** 창 안의 샘플 수 */
+	samples: number;
+	temp_min: number | null;
+	temp_max: number | null;
+	temp_mean: number | null;
+	humidity_min: number | null;
+	humidity_max: number | null;
+	humidity_mean: number | null;
+	/** PID 출력 평균 / 최대 (%) */
+	output_mean: number;
+	output_max: number;
+	/** 냉각 ON 누적 (s) */
+	cooling_sec: number;
+	/** PWM 듀티 × 정격 전력 적산 (Wh) */
+	energy_wh: number;
+	/** 센서 실패/거부 수 */
+	rejects: number;
+	/** 창이 닫힐 때의 목표 온도 (°C) */
+	target: number | null;
+}